@@ -20,6 +20,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/DataStructure.h>
+#include <activemq/commands/DataStructurePool.h>
 
 #include <string>
 #include <sstream>
@@ -35,6 +36,18 @@ namespace commands{
 
         virtual ~BaseDataStructure() {}
 
+        /**
+         * Commands are created and destroyed for every message, their memory is
+         * recycled through the DataStructurePool instead of the heap.
+         */
+        static void* operator new(std::size_t size) {
+            return DataStructurePool::allocate(size);
+        }
+
+        static void operator delete(void* pointer, std::size_t size) {
+            DataStructurePool::release(pointer, size);
+        }
+
         virtual bool isMarshalAware() const {
             return false;
         }
@@ -19,9 +19,9 @@
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/state/CommandVisitor.h>
 #include <decaf/internal/util/StringUtils.h>
+#include <decaf/lang/Long.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/util/HashCode.h>
-#include <sstream>
 
 using namespace std;
 using namespace activemq;
@@ -43,20 +43,20 @@ using namespace decaf::internal::util;
 
 ////////////////////////////////////////////////////////////////////////////////
 ConsumerId::ConsumerId() :
-    BaseDataStructure(), connectionId(""), sessionId(0), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), sessionId(0), value(0), parentId(), hashCode(0) {
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ConsumerId::ConsumerId(const ConsumerId& other) :
-    BaseDataStructure(), connectionId(""), sessionId(0), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), sessionId(0), value(0), parentId(), hashCode(0) {
 
     this->copyDataStructure(&other);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ConsumerId::ConsumerId(const SessionId& sessionId, long long consumerId) :
-    BaseDataStructure(), connectionId(""), sessionId(0), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), sessionId(0), value(0), parentId(), hashCode(0) {
 
     this->connectionId = sessionId.getConnectionId();
     this->sessionId = sessionId.getValue();
@@ -109,13 +109,11 @@ unsigned char ConsumerId::getDataStructureType() const {
 ////////////////////////////////////////////////////////////////////////////////
 std::string ConsumerId::toString() const {
 
-    ostringstream stream;
+    std::string result(this->connectionId);
+    result.append(1, ':').append(Long::toString(this->sessionId));
+    result.append(1, ':').append(Long::toString(this->value));
 
-    stream << this->connectionId << ":"
-           << this->sessionId << ":"
-           << this->value;
-
-    return stream.str();
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,15 +129,15 @@ bool ConsumerId::equals(const DataStructure* value) const {
         return false;
     }
 
-    if (this->getConnectionId() != valuePtr->getConnectionId()) {
-        return false;
-    }
     if (this->getSessionId() != valuePtr->getSessionId()) {
         return false;
     }
     if (this->getValue() != valuePtr->getValue()) {
         return false;
     }
+    if (this->getConnectionId() != valuePtr->getConnectionId()) {
+        return false;
+    }
     if (!BaseDataStructure::equals(value)) {
         return false;
     }
@@ -153,12 +151,15 @@ const std::string& ConsumerId::getConnectionId() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& ConsumerId::getConnectionId() {
+    // The caller may change the connection id through the reference.
+    this->hashCode.set(0);
     return connectionId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ConsumerId::setConnectionId(const std::string& connectionId) {
     this->connectionId = connectionId;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -169,6 +170,7 @@ long long ConsumerId::getSessionId() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ConsumerId::setSessionId(long long sessionId) {
     this->sessionId = sessionId;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -179,6 +181,7 @@ long long ConsumerId::getValue() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ConsumerId::setValue(long long value) {
     this->value = value;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -188,9 +191,13 @@ int ConsumerId::compareTo(const ConsumerId& value) const {
         return 0;
     }
 
-    int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
-    if (connectionIdComp != 0) {
-        return connectionIdComp;
+    // Ids from the same connection carry identical strings, which is far
+    // cheaper to check than comparing them without regard to case.
+    if (this->connectionId != value.connectionId) {
+        int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
+        if (connectionIdComp != 0) {
+            return connectionIdComp;
+        }
     }
 
     if (this->sessionId > value.sessionId) {
@@ -231,7 +238,20 @@ ConsumerId& ConsumerId::operator= (const ConsumerId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int ConsumerId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+
+    // Computed from the fields rather than from toString() and kept until one
+    // of them changes, zero marks a hash that hasn't been computed yet.  Threads
+    // that race to compute it store the same value.
+    int result = this->hashCode.get();
+    if (result == 0) {
+        unsigned int hash = (unsigned int) decaf::util::HashCode<std::string>()(this->connectionId);
+        hash = 31 * hash + (unsigned int) decaf::util::HashCode<long long>()(this->sessionId);
+        hash = 31 * hash + (unsigned int) decaf::util::HashCode<long long>()(this->value);
+        result = hash != 0 ? (int) hash : 1;
+        this->hashCode.set(result);
+    }
+
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,380 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataStructurePool.h"
+
+#include <decaf/lang/ThreadLocal.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <new>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+const std::size_t DataStructurePool::MAX_BLOCK_SIZE = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Block sizes are multiples of this, a request is rounded up to the next one.
+    const std::size_t GRANULARITY = 16;
+
+    const std::size_t NUM_SIZE_CLASSES = DataStructurePool::MAX_BLOCK_SIZE / GRANULARITY;
+
+    // Each size class keeps at most this many bytes of released blocks.
+    const std::size_t MAX_RETAINED_BYTES = 256 * 1024;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    class SizeClass {
+    private:
+
+        SizeClass(const SizeClass&);
+        SizeClass& operator=(const SizeClass&);
+
+    public:
+
+        Mutex mutex;
+        FreeBlock* head;
+        std::size_t count;
+        std::size_t limit;
+        long long allocations;
+        long long heapAllocations;
+
+        SizeClass() : mutex(), head(NULL), count(0), limit(0), allocations(0), heapAllocations(0) {}
+
+        ~SizeClass() {
+            while (head != NULL) {
+                FreeBlock* block = head;
+                head = head->next;
+                ::operator delete(block);
+            }
+        }
+    };
+
+    SizeClass* sizeClasses = NULL;
+
+    // Counts the blocks that are allocated while the pool isn't running or that
+    // are too large for it, both always come from the heap.
+    AtomicInteger* unpooledAllocations = NULL;
+
+    // Blocks handed out by the caches of threads that have ended before their
+    // counts were added to a size class.
+    AtomicInteger* retiredAllocations = NULL;
+
+    inline std::size_t sizeClassOf(std::size_t size) {
+        return size == 0 ? 0 : (size - 1) / GRANULARITY;
+    }
+
+    inline std::size_t blockSizeOf(std::size_t index) {
+        return (index + 1) * GRANULARITY;
+    }
+
+    // Roughly how many bytes of each size a thread keeps for itself, never fewer
+    // than two blocks or more than sixteen.
+    const std::size_t CACHE_BYTES = 4096;
+
+    inline std::size_t cacheLimitOf(std::size_t index) {
+        std::size_t limit = CACHE_BYTES / blockSizeOf(index);
+        return limit < 2 ? 2 : (limit > 16 ? 16 : limit);
+    }
+
+    // Blocks move between a thread and the shared lists half a cache at a time.
+    inline std::size_t batchSizeOf(std::size_t index) {
+        return cacheLimitOf(index) / 2;
+    }
+
+    // The ThreadLocal assigns a new cache from an empty one, so a cache is never
+    // copied while it holds blocks.  A cache is destroyed while the threading library
+    // holds its own locks, so the blocks it still holds go back to the heap without
+    // taking the size class locks.
+    class ThreadCache {
+    public:
+
+        FreeBlock* heads[NUM_SIZE_CLASSES];
+        std::size_t counts[NUM_SIZE_CLASSES];
+
+        // Blocks handed out since the count was last added to the size class.
+        int allocations[NUM_SIZE_CLASSES];
+
+        ThreadCache() {
+            for (std::size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+                heads[i] = NULL;
+                counts[i] = 0;
+                allocations[i] = 0;
+            }
+        }
+
+        ~ThreadCache() {
+            for (std::size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+                if (allocations[i] > 0 && retiredAllocations != NULL) {
+                    retiredAllocations->addAndGet(allocations[i]);
+                }
+                while (heads[i] != NULL) {
+                    FreeBlock* block = heads[i];
+                    heads[i] = block->next;
+                    ::operator delete(block);
+                }
+            }
+        }
+    };
+
+    class ThreadCaches : public ThreadLocal<ThreadCache> {
+    public:
+
+        // Unlike current() this doesn't create a cache for a thread that has none.
+        ThreadCache* peek() const {
+            return static_cast<ThreadCache*>(getRawValue());
+        }
+
+        ThreadCache* current() {
+            return &get();
+        }
+    };
+
+    ThreadCaches* threadCaches = NULL;
+
+    void* allocateFromCache(ThreadCache* cache, std::size_t index) {
+
+        FreeBlock* block = cache->heads[index];
+
+        if (block == NULL) {
+
+            SizeClass& sizeClass = sizeClasses[index];
+            std::size_t batch = batchSizeOf(index);
+
+            synchronized(&sizeClass.mutex) {
+
+                std::size_t taken = 0;
+                while (sizeClass.head != NULL && taken < batch) {
+                    FreeBlock* next = sizeClass.head->next;
+                    sizeClass.head->next = cache->heads[index];
+                    cache->heads[index] = sizeClass.head;
+                    sizeClass.head = next;
+                    taken++;
+                }
+
+                sizeClass.count -= taken;
+                cache->counts[index] = taken;
+
+                // Blocks count when they are handed out, not when they move into
+                // the cache, so the count is caught up a batch at a time.
+                sizeClass.allocations += cache->allocations[index];
+                cache->allocations[index] = 0;
+
+                if (taken == 0) {
+                    sizeClass.allocations++;
+                    sizeClass.heapAllocations++;
+                }
+            }
+
+            block = cache->heads[index];
+            if (block == NULL) {
+                return ::operator new(blockSizeOf(index));
+            }
+        }
+
+        cache->heads[index] = block->next;
+        cache->counts[index]--;
+        cache->allocations[index]++;
+        return block;
+    }
+
+    void releaseToCache(ThreadCache* cache, std::size_t index, void* block) {
+
+        FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = cache->heads[index];
+        cache->heads[index] = freeBlock;
+
+        if (++cache->counts[index] <= cacheLimitOf(index)) {
+            return;
+        }
+
+        // A thread that only releases, such as a session freeing what the transport
+        // thread created, hands a batch back for the allocating thread to take.
+        FreeBlock* overflow = NULL;
+        std::size_t batch = batchSizeOf(index);
+        SizeClass& sizeClass = sizeClasses[index];
+
+        synchronized(&sizeClass.mutex) {
+
+            for (std::size_t i = 0; i < batch; ++i) {
+                FreeBlock* returned = cache->heads[index];
+                cache->heads[index] = returned->next;
+
+                if (sizeClass.count < sizeClass.limit) {
+                    returned->next = sizeClass.head;
+                    sizeClass.head = returned;
+                    sizeClass.count++;
+                } else {
+                    returned->next = overflow;
+                    overflow = returned;
+                }
+            }
+
+            sizeClass.allocations += cache->allocations[index];
+            cache->allocations[index] = 0;
+        }
+
+        cache->counts[index] -= batch;
+
+        while (overflow != NULL) {
+            FreeBlock* next = overflow->next;
+            ::operator delete(overflow);
+            overflow = next;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::initialize() {
+
+    unpooledAllocations = new AtomicInteger();
+    retiredAllocations = new AtomicInteger();
+    sizeClasses = new SizeClass[NUM_SIZE_CLASSES];
+    threadCaches = new ThreadCaches();
+
+    for (std::size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        std::size_t limit = MAX_RETAINED_BYTES / blockSizeOf(i);
+        sizeClasses[i].limit = limit < 16 ? 16 : limit;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::shutdown() {
+
+    // Frees the blocks still held by each thread's cache.
+    delete threadCaches;
+    threadCaches = NULL;
+
+    SizeClass* classes = sizeClasses;
+    sizeClasses = NULL;
+    delete [] classes;
+
+    delete unpooledAllocations;
+    unpooledAllocations = NULL;
+
+    delete retiredAllocations;
+    retiredAllocations = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* DataStructurePool::allocate(std::size_t size) {
+
+    if (size > MAX_BLOCK_SIZE) {
+        if (unpooledAllocations != NULL) {
+            unpooledAllocations->incrementAndGet();
+        }
+        return ::operator new(size);
+    }
+
+    std::size_t index = sizeClassOf(size);
+
+    // Blocks are always allocated at the full size of their class so that any of
+    // them can later be reused for another object of the same class.
+    if (sizeClasses == NULL) {
+        return ::operator new(blockSizeOf(index));
+    }
+
+    return allocateFromCache(threadCaches->current(), index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::release(void* block, std::size_t size) {
+
+    if (block == NULL) {
+        return;
+    }
+
+    if (size <= MAX_BLOCK_SIZE && sizeClasses != NULL) {
+        releaseToCache(threadCaches->current(), sizeClassOf(size), block);
+        return;
+    }
+
+    ::operator delete(block);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long DataStructurePool::getAllocationCount() {
+
+    if (sizeClasses == NULL) {
+        return 0;
+    }
+
+    // Other threads' caches are only counted up to their last batch.
+    ThreadCache* cache = threadCaches->peek();
+
+    long long result = unpooledAllocations->get() + retiredAllocations->get();
+    for (std::size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        synchronized(&sizeClasses[i].mutex) {
+            result += sizeClasses[i].allocations;
+        }
+        if (cache != NULL) {
+            result += cache->allocations[i];
+        }
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long DataStructurePool::getHeapAllocationCount() {
+
+    if (sizeClasses == NULL) {
+        return 0;
+    }
+
+    long long result = unpooledAllocations->get();
+    for (std::size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        synchronized(&sizeClasses[i].mutex) {
+            result += sizeClasses[i].heapAllocations;
+        }
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long DataStructurePool::getPooledCount() {
+
+    if (sizeClasses == NULL) {
+        return 0;
+    }
+
+    ThreadCache* cache = threadCaches->peek();
+
+    long long result = 0;
+    for (std::size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        synchronized(&sizeClasses[i].mutex) {
+            result += (long long) sizeClasses[i].count;
+        }
+        if (cache != NULL) {
+            result += (long long) cache->counts[i];
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMMANDS_DATASTRUCTUREPOOL_H_
+#define _ACTIVEMQ_COMMANDS_DATASTRUCTUREPOOL_H_
+
+#include <activemq/util/Config.h>
+
+#include <cstddef>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace commands {
+
+    /**
+     * Recycles the memory of the commands and data structures that are created and
+     * destroyed for every message, such as MessageDispatch, MessageAck, the message
+     * types and the ids they carry.
+     *
+     * BaseDataStructure routes its operator new and delete here, so objects created by
+     * the marshallers' createObject factories or by the client code and released by
+     * a Pointer are covered without any change to how they are used.  Memory is kept
+     * in free lists of fixed size blocks, and objects larger than the biggest block
+     * size always come from the heap.
+     *
+     * Each thread allocates from and releases to a small free list of its own, so the
+     * common case takes no lock.  When a thread's list runs dry it takes a batch from
+     * a shared list, and when it grows past its limit it hands a batch back, so a
+     * thread that only releases, such as a session freeing the dispatches that the
+     * transport thread created, feeds the thread that allocates.  The shared lists
+     * only keep a bounded number of blocks so a burst of traffic doesn't leave its
+     * memory pinned to the pool.  The few blocks left in a thread's list when it
+     * ends are returned to the heap.
+     *
+     * Before the library is initialized and after it is shut down all blocks come from
+     * and go back to the heap, a block may be safely released in either state.
+     *
+     * The counters can be used to check that a steady flow of messages is served from
+     * the pool instead of the heap.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API DataStructurePool {
+    private:
+
+        DataStructurePool();
+        DataStructurePool(const DataStructurePool&);
+        DataStructurePool& operator=(const DataStructurePool&);
+
+    public:
+
+        /**
+         * The largest object size in bytes that is served from the pool.
+         */
+        static const std::size_t MAX_BLOCK_SIZE;
+
+    public:
+
+        /**
+         * Returns a block of at least the given size, reusing a released block when
+         * one is available.
+         *
+         * @param size
+         *      The number of bytes needed.
+         *
+         * @return the allocated block.
+         *
+         * @throws std::bad_alloc if the heap is exhausted.
+         */
+        static void* allocate(std::size_t size);
+
+        /**
+         * Releases a block returned from allocate, it is kept for reuse if there is
+         * room in the pool and freed otherwise.
+         *
+         * @param block
+         *      The block to release, NULL is ignored.
+         * @param size
+         *      The size the block was allocated with.
+         */
+        static void release(void* block, std::size_t size);
+
+        /**
+         * @return the number of blocks that have been handed out by allocate.  Blocks
+         *         handed out by another thread are only counted once that thread
+         *         next moves a batch to or from the shared free lists.
+         */
+        static long long getAllocationCount();
+
+        /**
+         * @return the number of blocks that allocate had to get from the heap.
+         */
+        static long long getHeapAllocationCount();
+
+        /**
+         * @return the number of released blocks currently held for reuse in the shared
+         *         free lists and the calling thread's own list.
+         */
+        static long long getPooledCount();
+
+    private:
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMMANDS_DATASTRUCTUREPOOL_H_ */
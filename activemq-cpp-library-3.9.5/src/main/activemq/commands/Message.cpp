@@ -21,6 +21,7 @@
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/state/CommandVisitor.h>
 #include <activemq/wireformat/openwire/marshal/BaseDataStreamMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/PreparedMessageMarshaller.h>
 #include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
 #include <decaf/lang/System.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
@@ -48,7 +49,7 @@ Message::Message() :
       groupID(""), groupSequence(0), correlationId(""), persistent(false), expiration(0), priority(0), replyTo(NULL), timestamp(0), 
       type(""), content(), marshalledProperties(), dataStructure(NULL), targetConsumerId(NULL), compressed(false), redeliveryCounter(0), 
       brokerPath(), arrival(0), userID(""), recievedByDFBridge(false), droppable(false), cluster(), brokerInTime(0), brokerOutTime(0), 
-      jMSXGroupFirstForConsumer(false), ackHandler(NULL), properties(), readOnlyProperties(false), readOnlyBody(false), connection(NULL) {
+      jMSXGroupFirstForConsumer(false), ackHandler(NULL), properties(), readOnlyProperties(false), readOnlyBody(false), preparedMarshaller(), connection(NULL) {
 
 }
 
@@ -56,6 +57,16 @@ Message::Message() :
 Message::~Message() {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const Pointer<wireformat::openwire::marshal::PreparedMessageMarshaller>& Message::getPreparedMarshaller() const {
+    return this->preparedMarshaller;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Message::setPreparedMarshaller(const Pointer<wireformat::openwire::marshal::PreparedMessageMarshaller>& marshaller) {
+    this->preparedMarshaller = marshaller;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Message* Message::cloneDataStructure() const {
     std::auto_ptr<Message> message(new Message());
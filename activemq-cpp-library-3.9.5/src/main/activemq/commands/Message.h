@@ -43,6 +43,11 @@ namespace core{
     class ActiveMQAckHandler;
     class ActiveMQConnection;
 }
+namespace wireformat{
+namespace openwire{
+namespace marshal{
+    class PreparedMessageMarshaller;
+}}}
 namespace commands{
 
     using decaf::lang::Pointer;
@@ -110,6 +115,10 @@ namespace commands{
         // Indicates if the Message Body are Read Only
         bool readOnlyBody;
 
+        // Writes the parts of this Message that it shares with the prepared Message
+        // it was sent from, NULL unless it was sent from one.
+        Pointer<wireformat::openwire::marshal::PreparedMessageMarshaller> preparedMarshaller;
+
     protected:
 
         core::ActiveMQConnection* connection;
@@ -272,6 +281,37 @@ namespace commands{
             this->readOnlyBody = value;
         }
 
+        /**
+         * Exchanges the Message Content with the given vector, a body that was built
+         * elsewhere is taken over without copying it.
+         * @param content - the new Content, receives the old Content.
+         */
+        void swapContent(std::vector<unsigned char>& content) {
+            this->content.swap(content);
+        }
+
+        /**
+         * Exchanges the Marshalled Properties with the given vector without copying.
+         * @param marshalledProperties - the new Marshalled Properties, receives the old ones.
+         */
+        void swapMarshalledProperties(std::vector<unsigned char>& marshalledProperties) {
+            this->marshalledProperties.swap(marshalledProperties);
+        }
+
+        /**
+         * Gets the marshaller that holds the marshaled headers of the prepared Message
+         * this Message is being sent from.
+         * @return the prepared marshaller, or NULL if the Message was not prepared.
+         */
+        const Pointer<wireformat::openwire::marshal::PreparedMessageMarshaller>& getPreparedMarshaller() const;
+
+        /**
+         * Sets the marshaller that holds the marshaled headers of the prepared Message
+         * this Message is being sent from, it is not copied when the Message is.
+         * @param marshaller - the prepared marshaller, or NULL.
+         */
+        void setPreparedMarshaller(const Pointer<wireformat::openwire::marshal::PreparedMessageMarshaller>& marshaller);
+
         virtual const Pointer<ProducerId>& getProducerId() const;
         virtual Pointer<ProducerId>& getProducerId();
         virtual void setProducerId(const Pointer<ProducerId>& producerId);
@@ -44,27 +44,27 @@ using namespace decaf::internal::util;
 
 ////////////////////////////////////////////////////////////////////////////////
 MessageId::MessageId() :
-    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key("") {
+    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key(""), hashCode(0) {
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 MessageId::MessageId(const MessageId& other) :
-    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key("") {
+    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key(""), hashCode(0) {
 
     this->copyDataStructure(&other);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 MessageId::MessageId(const std::string& messageKey) :
-    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key("") {
+    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key(""), hashCode(0) {
 
     this->setValue(messageKey);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 MessageId::MessageId(const Pointer<ProducerInfo>& producerInfo, long long producerSequenceId) :
-    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key("") {
+    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key(""), hashCode(0) {
 
     this->producerId = producerInfo->getProducerId();
     this->producerSequenceId = producerSequenceId;
@@ -72,7 +72,7 @@ MessageId::MessageId(const Pointer<ProducerInfo>& producerInfo, long long produc
 
 ////////////////////////////////////////////////////////////////////////////////
 MessageId::MessageId(const Pointer<ProducerId>& producerId, long long producerSequenceId) :
-    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key("") {
+    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key(""), hashCode(0) {
 
     this->producerId = producerId;
     this->producerSequenceId = producerSequenceId;
@@ -80,7 +80,7 @@ MessageId::MessageId(const Pointer<ProducerId>& producerId, long long producerSe
 
 ////////////////////////////////////////////////////////////////////////////////
 MessageId::MessageId(const std::string& producerId, long long producerSequenceId) :
-    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key("") {
+    BaseDataStructure(), textView(""), producerId(NULL), producerSequenceId(0), brokerSequenceId(0), key(""), hashCode(0) {
 
     this->producerId.reset(new ProducerId(producerId));
     this->producerSequenceId = producerSequenceId;
@@ -162,6 +162,12 @@ bool MessageId::equals(const DataStructure* value) const {
         return false;
     }
 
+    if (this->getProducerSequenceId() != valuePtr->getProducerSequenceId()) {
+        return false;
+    }
+    if (this->getBrokerSequenceId() != valuePtr->getBrokerSequenceId()) {
+        return false;
+    }
     if (this->getTextView() != valuePtr->getTextView()) {
         return false;
     }
@@ -172,12 +178,6 @@ bool MessageId::equals(const DataStructure* value) const {
     } else if (valuePtr->getProducerId() != NULL) {
         return false;
     }
-    if (this->getProducerSequenceId() != valuePtr->getProducerSequenceId()) {
-        return false;
-    }
-    if (this->getBrokerSequenceId() != valuePtr->getBrokerSequenceId()) {
-        return false;
-    }
     if (!BaseDataStructure::equals(value)) {
         return false;
     }
@@ -191,12 +191,17 @@ const std::string& MessageId::getTextView() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& MessageId::getTextView() {
+    // The caller may change the text through the reference.
+    this->key.clear();
+    this->hashCode.set(0);
     return textView;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void MessageId::setTextView(const std::string& textView) {
     this->textView = textView;
+    this->key.clear();
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -212,6 +217,8 @@ decaf::lang::Pointer<ProducerId>& MessageId::getProducerId() {
 ////////////////////////////////////////////////////////////////////////////////
 void MessageId::setProducerId(const decaf::lang::Pointer<ProducerId>& producerId) {
     this->producerId = producerId;
+    this->key.clear();
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -222,6 +229,8 @@ long long MessageId::getProducerSequenceId() const {
 ////////////////////////////////////////////////////////////////////////////////
 void MessageId::setProducerSequenceId(long long producerSequenceId) {
     this->producerSequenceId = producerSequenceId;
+    this->key.clear();
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -289,7 +298,17 @@ MessageId& MessageId::operator= (const MessageId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int MessageId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+
+    // Kept along with the key until the id changes, zero marks a hash that
+    // hasn't been computed yet.  Threads that race to compute it store the same value.
+    int result = this->hashCode.get();
+    if (result == 0) {
+        int hash = decaf::util::HashCode<std::string>()(this->toString());
+        result = hash != 0 ? hash : 1;
+        this->hashCode.set(result);
+    }
+
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -307,5 +326,6 @@ void MessageId::setValue(const std::string& key) {
 
     this->producerId.reset(new ProducerId(messageKey));
     this->key = messageKey;
+    this->hashCode.set(0);
 }
 
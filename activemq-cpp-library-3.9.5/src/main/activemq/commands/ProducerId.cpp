@@ -22,7 +22,6 @@
 #include <decaf/lang/Long.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/util/HashCode.h>
-#include <sstream>
 
 using namespace std;
 using namespace activemq;
@@ -44,20 +43,20 @@ using namespace decaf::internal::util;
 
 ////////////////////////////////////////////////////////////////////////////////
 ProducerId::ProducerId() :
-    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId(), hashCode(0) {
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ProducerId::ProducerId(const ProducerId& other) :
-    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId(), hashCode(0) {
 
     this->copyDataStructure(&other);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ProducerId::ProducerId( const SessionId& sessionId, long long consumerId ) : 
-    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId(), hashCode(0) {
 
     this->connectionId = sessionId.getConnectionId();
     this->sessionId = sessionId.getValue();
@@ -66,7 +65,7 @@ ProducerId::ProducerId( const SessionId& sessionId, long long consumerId ) :
 
 ////////////////////////////////////////////////////////////////////////////////
 ProducerId::ProducerId(std::string producerKey) :
-    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId(), hashCode(0) {
 
     // Parse off the producerId
     std::size_t p = producerKey.rfind( ':' );
@@ -125,13 +124,11 @@ unsigned char ProducerId::getDataStructureType() const {
 ////////////////////////////////////////////////////////////////////////////////
 std::string ProducerId::toString() const {
 
-    ostringstream stream;
+    std::string result(this->connectionId);
+    result.append(1, ':').append(Long::toString(this->sessionId));
+    result.append(1, ':').append(Long::toString(this->value));
 
-    stream << this->connectionId << ":"
-           << this->sessionId << ":"
-           << this->value;
-
-    return stream.str();
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -147,15 +144,15 @@ bool ProducerId::equals(const DataStructure* value) const {
         return false;
     }
 
-    if (this->getConnectionId() != valuePtr->getConnectionId()) {
-        return false;
-    }
     if (this->getValue() != valuePtr->getValue()) {
         return false;
     }
     if (this->getSessionId() != valuePtr->getSessionId()) {
         return false;
     }
+    if (this->getConnectionId() != valuePtr->getConnectionId()) {
+        return false;
+    }
     if (!BaseDataStructure::equals(value)) {
         return false;
     }
@@ -169,12 +166,15 @@ const std::string& ProducerId::getConnectionId() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& ProducerId::getConnectionId() {
+    // The caller may change the connection id through the reference.
+    this->hashCode.set(0);
     return connectionId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ProducerId::setConnectionId(const std::string& connectionId) {
     this->connectionId = connectionId;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,6 +185,7 @@ long long ProducerId::getValue() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ProducerId::setValue(long long value) {
     this->value = value;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -195,6 +196,7 @@ long long ProducerId::getSessionId() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ProducerId::setSessionId(long long sessionId) {
     this->sessionId = sessionId;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -204,9 +206,13 @@ int ProducerId::compareTo(const ProducerId& value) const {
         return 0;
     }
 
-    int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
-    if (connectionIdComp != 0) {
-        return connectionIdComp;
+    // Ids from the same connection carry identical strings, which is far
+    // cheaper to check than comparing them without regard to case.
+    if (this->connectionId != value.connectionId) {
+        int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
+        if (connectionIdComp != 0) {
+            return connectionIdComp;
+        }
     }
 
     if (this->value > value.value) {
@@ -247,7 +253,20 @@ ProducerId& ProducerId::operator= (const ProducerId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int ProducerId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+
+    // Computed from the fields rather than from toString() and kept until one
+    // of them changes, zero marks a hash that hasn't been computed yet.  Threads
+    // that race to compute it store the same value.
+    int result = this->hashCode.get();
+    if (result == 0) {
+        unsigned int hash = (unsigned int) decaf::util::HashCode<std::string>()(this->connectionId);
+        hash = 31 * hash + (unsigned int) decaf::util::HashCode<long long>()(this->sessionId);
+        hash = 31 * hash + (unsigned int) decaf::util::HashCode<long long>()(this->value);
+        result = hash != 0 ? (int) hash : 1;
+        this->hashCode.set(result);
+    }
+
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -271,4 +290,5 @@ void ProducerId::setProducerSessionKey( std::string sessionKey ) {
 
     // The rest is the value
     this->connectionId = sessionKey;
+    this->hashCode.set(0);
 }
@@ -22,9 +22,9 @@
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/state/CommandVisitor.h>
 #include <decaf/internal/util/StringUtils.h>
+#include <decaf/lang/Long.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/util/HashCode.h>
-#include <sstream>
 
 using namespace std;
 using namespace activemq;
@@ -46,20 +46,20 @@ using namespace decaf::internal::util;
 
 ////////////////////////////////////////////////////////////////////////////////
 SessionId::SessionId() :
-    BaseDataStructure(), connectionId(""), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), parentId(), hashCode(0) {
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 SessionId::SessionId(const SessionId& other) :
-    BaseDataStructure(), connectionId(""), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), parentId(), hashCode(0) {
 
     this->copyDataStructure(&other);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 SessionId::SessionId(const ConnectionId* connectionId, long long sessionId) :
-    BaseDataStructure(), connectionId(""), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), parentId(), hashCode(0) {
 
     this->connectionId = connectionId->getValue();
     this->value = sessionId;
@@ -67,7 +67,7 @@ SessionId::SessionId(const ConnectionId* connectionId, long long sessionId) :
 
 ////////////////////////////////////////////////////////////////////////////////
 SessionId::SessionId(const ProducerId* producerId) :
-    BaseDataStructure(), connectionId(""), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), parentId(), hashCode(0) {
 
     this->connectionId = producerId->getConnectionId();
     this->value = producerId->getSessionId();
@@ -75,7 +75,7 @@ SessionId::SessionId(const ProducerId* producerId) :
 
 ////////////////////////////////////////////////////////////////////////////////
 SessionId::SessionId(const ConsumerId* consumerId) :
-    BaseDataStructure(), connectionId(""), value(0), parentId() {
+    BaseDataStructure(), connectionId(""), value(0), parentId(), hashCode(0) {
 
     this->connectionId = consumerId->getConnectionId();
     this->value = consumerId->getSessionId();
@@ -126,11 +126,10 @@ unsigned char SessionId::getDataStructureType() const {
 ////////////////////////////////////////////////////////////////////////////////
 std::string SessionId::toString() const {
 
-    ostringstream stream;
+    std::string result(this->connectionId);
+    result.append(1, ':').append(Long::toString(this->value));
 
-    stream << this->connectionId << ":" << this->value;
-
-    return stream.str();
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -146,10 +145,10 @@ bool SessionId::equals(const DataStructure* value) const {
         return false;
     }
 
-    if (this->getConnectionId() != valuePtr->getConnectionId()) {
+    if (this->getValue() != valuePtr->getValue()) {
         return false;
     }
-    if (this->getValue() != valuePtr->getValue()) {
+    if (this->getConnectionId() != valuePtr->getConnectionId()) {
         return false;
     }
     if (!BaseDataStructure::equals(value)) {
@@ -165,12 +164,15 @@ const std::string& SessionId::getConnectionId() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& SessionId::getConnectionId() {
+    // The caller may change the connection id through the reference.
+    this->hashCode.set(0);
     return connectionId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void SessionId::setConnectionId(const std::string& connectionId) {
     this->connectionId = connectionId;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -181,6 +183,7 @@ long long SessionId::getValue() const {
 ////////////////////////////////////////////////////////////////////////////////
 void SessionId::setValue(long long value) {
     this->value = value;
+    this->hashCode.set(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -190,9 +193,13 @@ int SessionId::compareTo(const SessionId& value) const {
         return 0;
     }
 
-    int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
-    if (connectionIdComp != 0) {
-        return connectionIdComp;
+    // Ids from the same connection carry identical strings, which is far
+    // cheaper to check than comparing them without regard to case.
+    if (this->connectionId != value.connectionId) {
+        int connectionIdComp = StringUtils::compareIgnoreCase(this->connectionId.c_str(), value.connectionId.c_str());
+        if (connectionIdComp != 0) {
+            return connectionIdComp;
+        }
     }
 
     if (this->value > value.value) {
@@ -227,7 +234,19 @@ SessionId& SessionId::operator= (const SessionId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int SessionId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+
+    // Computed from the fields rather than from toString() and kept until one
+    // of them changes, zero marks a hash that hasn't been computed yet.  Threads
+    // that race to compute it store the same value.
+    int result = this->hashCode.get();
+    if (result == 0) {
+        unsigned int hash = (unsigned int) decaf::util::HashCode<std::string>()(this->connectionId);
+        hash = 31 * hash + (unsigned int) decaf::util::HashCode<long long>()(this->value);
+        result = hash != 0 ? (int) hash : 1;
+        this->hashCode.set(result);
+    }
+
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +28,7 @@
 #include <activemq/util/Config.h>
 #include <decaf/lang/Comparable.h>
 #include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <string>
 #include <vector>
 
@@ -63,6 +64,7 @@ namespace commands {
     private:
 
         mutable Pointer<ConnectionId> parentId;
+        mutable decaf::util::concurrent::atomic::AtomicInteger hashCode;
 
     public:
 
@@ -194,6 +194,7 @@ namespace core {
         long long optimizedAckScheduledAckInterval;
         long long consumerFailoverRedeliveryWaitPeriod;
         bool consumerExpiryCheckEnabled;
+        long long consumerReceiveSpinTime;
 
         std::auto_ptr<PrefetchPolicy> defaultPrefetchPolicy;
         std::auto_ptr<RedeliveryPolicy> defaultRedeliveryPolicy;
@@ -265,6 +266,7 @@ namespace core {
                              optimizedAckScheduledAckInterval(0),
                              consumerFailoverRedeliveryWaitPeriod(0),
                              consumerExpiryCheckEnabled(true),
+                             consumerReceiveSpinTime(0),
                              defaultPrefetchPolicy(NULL),
                              defaultRedeliveryPolicy(NULL),
                              exceptionListener(NULL),
@@ -1973,3 +1975,13 @@ bool ActiveMQConnection::isConsumerExpiryCheckEnabled() {
 void ActiveMQConnection::setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled) {
     this->config->consumerExpiryCheckEnabled = consumerExpiryCheckEnabled;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnection::getConsumerReceiveSpinTime() const {
+    return this->config->consumerReceiveSpinTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setConsumerReceiveSpinTime(long long consumerReceiveSpinTime) {
+    this->config->consumerReceiveSpinTime = consumerReceiveSpinTime;
+}
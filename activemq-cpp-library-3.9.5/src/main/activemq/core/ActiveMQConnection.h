@@ -836,6 +836,23 @@ namespace core {
          */
         void setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled);
 
+        /**
+         * @return the time in microseconds a consumer's receive call spins waiting for a
+         *         message before it blocks, zero when spinning is disabled.
+         */
+        long long getConsumerReceiveSpinTime() const;
+
+        /**
+         * Sets the time a consumer's receive call spins on its dispatch channel waiting
+         * for a message before it blocks.  Spinning removes a thread wake up from the
+         * delivery path of each message at the cost of keeping a CPU busy, by default
+         * spinning is disabled.
+         *
+         * @param consumerReceiveSpinTime
+         *      The time to spin in microseconds, zero disables spinning.
+         */
+        void setConsumerReceiveSpinTime(long long consumerReceiveSpinTime);
+
         /**
          * @return the current connection's OpenWire protocol version.
          */
@@ -28,6 +28,7 @@
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <activemq/exceptions/ExceptionDefines.h>
 #include <activemq/transport/TransportRegistry.h>
+#include <activemq/transport/shared/SharedTransport.h>
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/core/ActiveMQMessageAudit.h>
@@ -44,6 +45,7 @@ using namespace activemq::core;
 using namespace activemq::core::policies;
 using namespace activemq::exceptions;
 using namespace activemq::transport;
+using namespace activemq::transport::shared;
 using namespace decaf;
 using namespace decaf::net;
 using namespace decaf::util;
@@ -101,6 +103,8 @@ namespace core{
         long long optimizedAckScheduledAckInterval;
         long long consumerFailoverRedeliveryWaitPeriod;
         bool consumerExpiryCheckEnabled;
+        long long consumerReceiveSpinTime;
+        bool useSharedTransport;
 
         cms::ExceptionListener* defaultListener;
         cms::MessageTransformer* defaultTransformer;
@@ -138,6 +142,8 @@ namespace core{
                             optimizedAckScheduledAckInterval(0),
                             consumerFailoverRedeliveryWaitPeriod(0),
                             consumerExpiryCheckEnabled(true),
+                            consumerReceiveSpinTime(0),
+                            useSharedTransport(false),
                             defaultListener(NULL),
                             defaultTransformer(NULL),
                             defaultPrefetchPolicy(new DefaultPrefetchPolicy()),
@@ -229,6 +235,10 @@ namespace core{
                 properties->getProperty("connection.alwaysSessionAsync", Boolean::toString(alwaysSessionAsync)));
             this->consumerExpiryCheckEnabled = Boolean::parseBoolean(
                 properties->getProperty("connection.consumerExpiryCheckEnabled", Boolean::toString(consumerExpiryCheckEnabled)));
+            this->consumerReceiveSpinTime = Long::parseLong(
+                properties->getProperty("connection.consumerReceiveSpinTime", Long::toString(consumerReceiveSpinTime)));
+            this->useSharedTransport = Boolean::parseBoolean(
+                properties->getProperty("connection.useSharedTransport", Boolean::toString(useSharedTransport)));
 
             this->defaultPrefetchPolicy->configure(*properties);
             this->defaultRedeliveryPolicy->configure(*properties);
@@ -336,8 +346,13 @@ cms::Connection* ActiveMQConnectionFactory::doCreateConnection(const decaf::net:
                 this->settings->clientId = clientId;
             }
 
-            // Use the TransportBuilder to get our Transport
-            transport = TransportRegistry::getInstance().findFactory(uri.getScheme())->create(uri);
+            // Use the TransportBuilder to get our Transport, or a channel on the
+            // Transport that other connections to this URI already use.
+            if (this->settings->useSharedTransport) {
+                transport = SharedTransport::createChannel(uri);
+            } else {
+                transport = TransportRegistry::getInstance().findFactory(uri.getScheme())->create(uri);
+            }
 
             if (transport == NULL) {
                 throw ActiveMQException(__FILE__, __LINE__, "ActiveMQConnectionFactory::createConnection - "
@@ -427,6 +442,7 @@ void ActiveMQConnectionFactory::configureConnection(ActiveMQConnection* connecti
     connection->setConsumerFailoverRedeliveryWaitPeriod(this->settings->consumerFailoverRedeliveryWaitPeriod);
     connection->setAlwaysSessionAsync(this->settings->alwaysSessionAsync);
     connection->setConsumerExpiryCheckEnabled(this->settings->consumerExpiryCheckEnabled);
+    connection->setConsumerReceiveSpinTime(this->settings->consumerReceiveSpinTime);
 
     if (this->settings->defaultListener) {
         connection->setExceptionListener(this->settings->defaultListener);
@@ -778,3 +794,23 @@ bool ActiveMQConnectionFactory::isConsumerExpiryCheckEnabled() {
 void ActiveMQConnectionFactory::setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled) {
     this->settings->consumerExpiryCheckEnabled = consumerExpiryCheckEnabled;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnectionFactory::getConsumerReceiveSpinTime() const {
+    return this->settings->consumerReceiveSpinTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setConsumerReceiveSpinTime(long long consumerReceiveSpinTime) {
+    this->settings->consumerReceiveSpinTime = consumerReceiveSpinTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isUseSharedTransport() const {
+    return this->settings->useSharedTransport;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setUseSharedTransport(bool useSharedTransport) {
+    this->settings->useSharedTransport = useSharedTransport;
+}
@@ -686,6 +686,42 @@ namespace core {
          */
         void setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled);
 
+        /**
+         * @return the time in microseconds a consumer's receive call spins waiting for a
+         *         message before it blocks, zero when spinning is disabled.
+         */
+        long long getConsumerReceiveSpinTime() const;
+
+        /**
+         * Sets the time a consumer's receive call spins on its dispatch channel waiting
+         * for a message before it blocks.  Spinning removes a thread wake up from the
+         * delivery path of each message at the cost of keeping a CPU busy, by default
+         * spinning is disabled.
+         *
+         * @param consumerReceiveSpinTime
+         *      The time to spin in microseconds, zero disables spinning.
+         */
+        void setConsumerReceiveSpinTime(long long consumerReceiveSpinTime);
+
+        /**
+         * @return true if the connections created by this factory share one physical
+         *         Transport per broker URI.
+         */
+        bool isUseSharedTransport() const;
+
+        /**
+         * Sets whether connections created by this factory share their physical Transport
+         * with the other connections in the process that use the same broker URI.  The
+         * connections then use a single socket, reader thread and inactivity monitor, the
+         * commands read are routed to each connection by its ConnectionId.  The shared
+         * Transport is closed when the last connection using it is closed.  By default
+         * every connection has its own Transport.
+         *
+         * @param useSharedTransport
+         *      True to share the physical Transport between connections.
+         */
+        void setUseSharedTransport(bool useSharedTransport);
+
     public:
 
         /**
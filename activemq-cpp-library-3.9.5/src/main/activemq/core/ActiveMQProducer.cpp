@@ -128,3 +128,50 @@ void ActiveMQProducer::send(const cms::Destination* destination, cms::Message* m
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<PreparedMessage> ActiveMQProducer::prepare(cms::Message* message) {
+
+    try {
+        return this->kernel->prepare(NULL, message, this->kernel->getDeliveryMode(),
+                                     this->kernel->getPriority(), this->kernel->getTimeToLive());
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<PreparedMessage> ActiveMQProducer::prepare(cms::Message* message, int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+        return this->kernel->prepare(NULL, message, deliveryMode, priority, timeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<PreparedMessage> ActiveMQProducer::prepare(const cms::Destination* destination, cms::Message* message,
+                                                   int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+        return this->kernel->prepare(destination, message, deliveryMode, priority, timeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const Pointer<PreparedMessage>& prepared, cms::Message* message) {
+
+    try {
+        this->kernel->send(prepared, message, NULL);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const Pointer<PreparedMessage>& prepared, cms::Message* message, cms::AsyncCallback* callback) {
+
+    try {
+        this->kernel->send(prepared, message, callback);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
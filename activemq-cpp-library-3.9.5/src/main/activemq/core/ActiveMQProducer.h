@@ -24,6 +24,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/ProducerInfo.h>
+#include <activemq/core/PreparedMessage.h>
 #include <activemq/core/kernels/ActiveMQProducerKernel.h>
 
 namespace activemq {
@@ -78,6 +79,96 @@ namespace core {
         virtual void send(const cms::Destination* destination, cms::Message* message,
                           int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* callback);
 
+        /**
+         * Prepares a Message for sending many times to this Producer's destination with
+         * its default delivery mode, priority and time to live.
+         *
+         * The PreparedMessage keeps the Message's headers, such as its type, correlation
+         * id and reply to destination, and every send made with it carries them.  When
+         * the connection uses the loose OpenWire encoding those headers are marshaled
+         * once and reused, each send only marshals the body, properties and the fields
+         * that change from send to send.
+         *
+         * @param message
+         *      The Message whose headers every prepared send will carry.
+         *
+         * @return the new PreparedMessage.
+         *
+         * @throws CMSException if the Message can't be prepared.
+         */
+        Pointer<PreparedMessage> prepare(cms::Message* message);
+
+        /**
+         * Prepares a Message for sending many times to this Producer's destination.
+         *
+         * @param message
+         *      The Message whose headers every prepared send will carry.
+         * @param deliveryMode
+         *      The delivery mode every prepared send uses.
+         * @param priority
+         *      The priority every prepared send uses.
+         * @param timeToLive
+         *      The time to live every prepared send uses.
+         *
+         * @return the new PreparedMessage.
+         *
+         * @throws CMSException if the Message can't be prepared.
+         */
+        Pointer<PreparedMessage> prepare(cms::Message* message, int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Prepares a Message for sending many times to the given destination, which
+         * must be NULL or this Producer's destination if it was created with one.
+         *
+         * @param destination
+         *      The destination every prepared send goes to.
+         * @param message
+         *      The Message whose headers every prepared send will carry.
+         * @param deliveryMode
+         *      The delivery mode every prepared send uses.
+         * @param priority
+         *      The priority every prepared send uses.
+         * @param timeToLive
+         *      The time to live every prepared send uses.
+         *
+         * @return the new PreparedMessage.
+         *
+         * @throws CMSException if the Message can't be prepared.
+         */
+        Pointer<PreparedMessage> prepare(const cms::Destination* destination, cms::Message* message,
+                                         int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sends the body and properties of the given Message with the headers of a
+         * Message prepared by this Producer.
+         *
+         * @param prepared
+         *      The PreparedMessage returned from this Producer's prepare method.
+         * @param message
+         *      The Message whose body and properties are sent, it must be the same
+         *      type as the prepared Message.
+         *
+         * @throws CMSException if an error occurs while sending the Message.
+         */
+        void send(const Pointer<PreparedMessage>& prepared, cms::Message* message);
+
+        /**
+         * Sends the body and properties of the given Message with the headers of a
+         * Message prepared by this Producer and notifies the callback when the send
+         * completes.
+         *
+         * @param prepared
+         *      The PreparedMessage returned from this Producer's prepare method.
+         * @param message
+         *      The Message whose body and properties are sent, it must be the same
+         *      type as the prepared Message.
+         * @param callback
+         *      The callback notified when the send completes.
+         *
+         * @throws CMSException if an error occurs while sending the Message.
+         */
+        void send(const Pointer<PreparedMessage>& prepared, cms::Message* message, cms::AsyncCallback* callback);
+
         /**
          * Sets the delivery mode for this Producer
          * @param mode - The DeliveryMode to use for Message sends.
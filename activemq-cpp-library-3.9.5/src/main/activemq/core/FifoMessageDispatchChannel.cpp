@@ -17,6 +17,9 @@
 
 #include "FifoMessageDispatchChannel.h"
 
+#include <decaf/lang/Math.h>
+#include <decaf/lang/System.h>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::core;
@@ -28,7 +31,8 @@ using namespace decaf::util;
 using namespace decaf::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-FifoMessageDispatchChannel::FifoMessageDispatchChannel() : closed(false), running(false), channel() {
+FifoMessageDispatchChannel::FifoMessageDispatchChannel() :
+    closed(false), running(false), spinTime(0), spinCount(0), parkCount(0), channel() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -63,7 +67,46 @@ bool FifoMessageDispatchChannel::isEmpty() const {
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<MessageDispatch> FifoMessageDispatchChannel::dequeue(long long timeout) {
 
+    bool spun = false;
+
+    if (spinTime > 0 && timeout != 0) {
+
+        long long start = System::nanoTime();
+        long long spinLimit = spinTime * 1000;
+        if (timeout > 0 && timeout * 1000000 < spinLimit) {
+            spinLimit = timeout * 1000000;
+        }
+
+        bool done = false;
+        while (!done) {
+            synchronized(&channel) {
+                if (closed) {
+                    done = true;
+                } else if (running && !channel.isEmpty()) {
+                    spinCount++;
+                    return channel.pop();
+                }
+            }
+
+            if (System::nanoTime() - start >= spinLimit) {
+                done = true;
+            }
+        }
+
+        // Don't let the time spent spinning extend the caller's timeout.
+        if (timeout > 0) {
+            timeout = Math::max(timeout - (System::nanoTime() - start) / 1000000, 1LL);
+        }
+
+        spun = true;
+    }
+
     synchronized(&channel) {
+
+        if (spun && !closed) {
+            parkCount++;
+        }
+
         // Wait until the channel is ready to deliver messages.
         while (timeout != 0 && !closed && (channel.isEmpty() || !running)) {
             if (timeout == -1) {
@@ -153,6 +196,24 @@ int FifoMessageDispatchChannel::size() const {
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long FifoMessageDispatchChannel::getSpinCount() const {
+    synchronized(&channel) {
+        return spinCount;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FifoMessageDispatchChannel::getParkCount() const {
+    synchronized(&channel) {
+        return parkCount;
+    }
+
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<Pointer<MessageDispatch> > FifoMessageDispatchChannel::removeAll() {
     std::vector<Pointer<MessageDispatch> > result;
@@ -33,6 +33,10 @@ namespace core {
         bool closed;
         bool running;
 
+        long long spinTime;
+        long long spinCount;
+        long long parkCount;
+
         mutable decaf::util::LinkedList< Pointer<MessageDispatch> > channel;
 
     private:
@@ -78,6 +82,35 @@ namespace core {
 
         virtual std::vector<Pointer<MessageDispatch> > removeAll();
 
+        /**
+         * Sets the time a blocking dequeue spins checking for a message before it waits
+         * on the channel, this avoids a thread wake up for messages that arrive quickly
+         * at the cost of CPU.  A value of zero, the default, disables spinning.
+         *
+         * @param spinTime
+         *      The time to spin in microseconds.
+         */
+        void setSpinTime(long long spinTime) {
+            this->spinTime = spinTime;
+        }
+
+        /**
+         * @return the time in microseconds a blocking dequeue spins before it waits.
+         */
+        long long getSpinTime() const {
+            return this->spinTime;
+        }
+
+        /**
+         * @return the number of dequeues that were satisfied while spinning.
+         */
+        long long getSpinCount() const;
+
+        /**
+         * @return the number of dequeues that spun without a message and had to wait.
+         */
+        long long getParkCount() const;
+
     public:
 
         virtual void lock() {
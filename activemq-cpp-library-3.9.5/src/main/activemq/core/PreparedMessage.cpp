@@ -0,0 +1,45 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PreparedMessage.h"
+
+#include <cms/MessageFormatException.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::wireformat::openwire::marshal;
+
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessage::PreparedMessage(const Pointer<Message> prototype, int deliveryMode, int priority, long long timeToLive) :
+    marshaller(new PreparedMessageMarshaller(prototype)), deliveryMode(deliveryMode), priority(priority), timeToLive(timeToLive) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessage::~PreparedMessage() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessage::apply(Message* message) const {
+
+    if (message->getDataStructureType() != this->marshaller->getDataStructureType()) {
+        throw cms::MessageFormatException("Message is not the type it was prepared as.", NULL);
+    }
+
+    this->marshaller->apply(message);
+    message->setPreparedMarshaller(this->marshaller);
+}
@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_PREPAREDMESSAGE_H_
+#define _ACTIVEMQ_CORE_PREPAREDMESSAGE_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/wireformat/openwire/marshal/PreparedMessageMarshaller.h>
+
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace core {
+
+    using decaf::lang::Pointer;
+
+    /**
+     * A Message prepared by a producer for sending many times.  The destination,
+     * delivery mode, priority, time to live and the headers of the Message it was
+     * prepared from are fixed, and when the connection uses the loose OpenWire
+     * encoding they are marshaled once and reused for every send.  Each send only
+     * supplies the body and properties.
+     *
+     * A PreparedMessage is created by ActiveMQProducer::prepare and can only be
+     * sent with the producer that prepared it.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API PreparedMessage {
+    private:
+
+        Pointer<wireformat::openwire::marshal::PreparedMessageMarshaller> marshaller;
+        int deliveryMode;
+        int priority;
+        long long timeToLive;
+
+    private:
+
+        PreparedMessage(const PreparedMessage&);
+        PreparedMessage& operator=(const PreparedMessage&);
+
+    public:
+
+        /**
+         * Creates a new PreparedMessage for the given prototype.
+         *
+         * @param prototype
+         *      The Message holding the producer, destination and headers of every send.
+         * @param deliveryMode
+         *      The delivery mode every send uses.
+         * @param priority
+         *      The priority every send uses.
+         * @param timeToLive
+         *      The time to live every send uses.
+         *
+         * @throws NullPointerException if the prototype, its ProducerId or its
+         *         destination is NULL.
+         */
+        PreparedMessage(const Pointer<commands::Message> prototype, int deliveryMode, int priority, long long timeToLive);
+
+        virtual ~PreparedMessage();
+
+        /**
+         * @return the Id of the producer that prepared this message.
+         */
+        const Pointer<commands::ProducerId>& getProducerId() const {
+            return this->marshaller->getPrototype()->getProducerId();
+        }
+
+        /**
+         * @return the destination every send goes to.
+         */
+        const Pointer<commands::ActiveMQDestination>& getDestination() const {
+            return this->marshaller->getPrototype()->getDestination();
+        }
+
+        /**
+         * @return the delivery mode every send uses.
+         */
+        int getDeliveryMode() const {
+            return this->deliveryMode;
+        }
+
+        /**
+         * @return the priority every send uses.
+         */
+        int getPriority() const {
+            return this->priority;
+        }
+
+        /**
+         * @return the time to live every send uses.
+         */
+        long long getTimeToLive() const {
+            return this->timeToLive;
+        }
+
+        /**
+         * Copies the prepared headers onto the Message that is about to be sent and
+         * attaches the marshaller that writes them.
+         *
+         * @param message
+         *      The Message the session is sending, after its id, producer and
+         *      destination have been assigned.
+         *
+         * @throws MessageFormatException if the Message is not the same type as the
+         *         one this was prepared from.
+         */
+        void apply(commands::Message* message) const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_PREPAREDMESSAGE_H_ */
@@ -783,7 +783,9 @@ ActiveMQConsumerKernel::ActiveMQConsumerKernel(ActiveMQSessionKernel* session,
     if (this->session->getConnection()->isMessagePrioritySupported()) {
         this->internal->unconsumedMessages.reset(new SimplePriorityMessageDispatchChannel());
     } else {
-        this->internal->unconsumedMessages.reset(new FifoMessageDispatchChannel());
+        Pointer<FifoMessageDispatchChannel> channel(new FifoMessageDispatchChannel());
+        channel->setSpinTime(this->session->getConnection()->getConsumerReceiveSpinTime());
+        this->internal->unconsumedMessages = channel;
     }
 
     if (listener != NULL) {
@@ -1863,6 +1865,20 @@ int ActiveMQConsumerKernel::getMessageAvailableCount() const {
     return this->internal->unconsumedMessages->size();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumerKernel::getReceiveSpinCount() const {
+    Pointer<FifoMessageDispatchChannel> channel =
+        this->internal->unconsumedMessages.dynamicCast<FifoMessageDispatchChannel>();
+    return channel != NULL ? channel->getSpinCount() : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumerKernel::getReceiveParkCount() const {
+    Pointer<FifoMessageDispatchChannel> channel =
+        this->internal->unconsumedMessages.dynamicCast<FifoMessageDispatchChannel>();
+    return channel != NULL ? channel->getParkCount() : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::applyDestinationOptions(Pointer<ConsumerInfo> info) {
 
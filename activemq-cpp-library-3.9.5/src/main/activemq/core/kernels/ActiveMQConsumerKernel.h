@@ -275,6 +275,18 @@ namespace kernels {
          */
         int getMessageAvailableCount() const;
 
+        /**
+         * @return the number of receive calls that got a message while spinning, when the
+         *         connection's consumer receive spin time is enabled.
+         */
+        long long getReceiveSpinCount() const;
+
+        /**
+         * @return the number of receive calls that spun without getting a message and then
+         *         had to block waiting for one.
+         */
+        long long getReceiveParkCount() const;
+
         /**
          * Sets the RedeliveryPolicy this Consumer should use when a rollback is
          * performed on a transacted Consumer.  The Consumer takes ownership of the
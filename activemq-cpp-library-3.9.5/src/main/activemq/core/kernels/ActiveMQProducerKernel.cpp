@@ -18,6 +18,7 @@
 #include "ActiveMQProducerKernel.h"
 
 #include <cms/Message.h>
+#include <cms/IllegalStateException.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/commands/RemoveInfo.h>
@@ -213,67 +214,150 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
 
         this->checkClosed();
 
-        if (destination == NULL) {
+        Pointer<ActiveMQDestination> dest = resolveDestination(destination);
 
-            if (this->producerInfo->getDestination() == NULL) {
-                throw cms::UnsupportedOperationException("A destination must be specified.", NULL);
-            }
+        this->doSend(dest, message, deliveryMode, priority, timeToLive, onComplete, NULL);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
 
-            throw cms::InvalidDestinationException("Don't understand null destinations", NULL);
+////////////////////////////////////////////////////////////////////////////////
+Pointer<PreparedMessage> ActiveMQProducerKernel::prepare(const cms::Destination* destination, cms::Message* message,
+                                                         int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+
+        this->checkClosed();
+
+        if (message == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Message passed to prepare is NULL");
         }
 
-        Pointer<ActiveMQDestination> dest;
-        const ActiveMQDestination* transformed;
-
-        if (destination == this->destination.get()) {
-            dest = this->producerInfo->getDestination();
-        } else if (this->producerInfo->getDestination() == NULL) {
-            // We always need to use a copy of the users destination since we want to control
-            // its lifetime.  If the transform results in a new destination we can use that, but
-            // if its already an ActiveMQDestination then we need to clone it.
-            if (ActiveMQMessageTransformation::transformDestination(destination, &transformed)) {
-                dest.reset(const_cast<ActiveMQDestination*>(transformed));
-            } else {
-                dest.reset(transformed->cloneDataStructure());
-            }
-        } else {
-            throw cms::UnsupportedOperationException(
-                string("This producer can only send messages to: ") +
-                this->producerInfo->getDestination()->getPhysicalName(), NULL);
+        if (destination == NULL) {
+            destination = this->destination.get();
         }
 
-        if (dest == NULL) {
-            throw cms::CMSException("No destination specified", NULL);
+        Pointer<ActiveMQDestination> dest = resolveDestination(destination);
+
+        commands::Message* transformed = NULL;
+        Pointer<commands::Message> prototype;
+        if (ActiveMQMessageTransformation::transformMessage(message, this->session->getConnection(), &transformed)) {
+            prototype.reset(transformed);
+        } else {
+            prototype.reset(transformed->cloneDataStructure());
         }
 
-        cms::Message* outbound = message;
-        Pointer<cms::Message> scopedMessage;
-        if (this->transformer != NULL) {
-            if (this->transformer->producerTransform(this->session, this, message, &outbound)) {
-                // scopedMessage ensures that when we are responsible for the lifetime of the
-                // transformed message, the message remains valid until the send operation either
-                // succeeds or throws an exception.
-                scopedMessage.reset(outbound);
-            }
-            if (outbound == NULL) {
-                throw NullPointerException(__FILE__, __LINE__, "MessageTransformer set transformed message to NULL");
-            }
+        // Only the headers are kept, each send supplies the body and properties.
+        prototype->getContent().clear();
+        prototype->getMarshalledProperties().clear();
+        prototype->getBrokerPath().clear();
+        prototype->setMessageId(Pointer<MessageId>());
+        prototype->setTransactionId(Pointer<TransactionId>());
+        prototype->setRedeliveryCounter(0);
+        prototype->setTimestamp(0);
+        prototype->setExpiration(0);
+
+        prototype->setProducerId(this->producerInfo->getProducerId());
+        prototype->setDestination(dest);
+        prototype->setPersistent(deliveryMode == cms::DeliveryMode::PERSISTENT);
+        prototype->setPriority((unsigned char) priority);
+
+        return Pointer<PreparedMessage>(new PreparedMessage(prototype, deliveryMode, priority, timeToLive));
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::send(const Pointer<PreparedMessage>& prepared, cms::Message* message, cms::AsyncCallback* onComplete) {
+
+    try {
+
+        this->checkClosed();
+
+        if (prepared == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "PreparedMessage passed to send is NULL");
         }
 
-        if (this->memoryUsage.get() != NULL) {
-            try {
-                this->memoryUsage->waitForSpace();
-            } catch (InterruptedException& e) {
-                throw cms::CMSException("Send aborted due to thread interrupt.");
-            }
+        if (prepared->getProducerId() != this->producerInfo->getProducerId()) {
+            throw cms::IllegalStateException("The PreparedMessage was prepared by another producer.", NULL);
         }
 
-        this->session->send(this, dest, outbound, deliveryMode, priority, timeToLive,
-                            this->memoryUsage.get(), this->sendTimeout, onComplete);
+        this->doSend(prepared->getDestination(), message, prepared->getDeliveryMode(),
+                     prepared->getPriority(), prepared->getTimeToLive(), onComplete, prepared.get());
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQDestination> ActiveMQProducerKernel::resolveDestination(const cms::Destination* destination) {
+
+    if (destination == NULL) {
+
+        if (this->producerInfo->getDestination() == NULL) {
+            throw cms::UnsupportedOperationException("A destination must be specified.", NULL);
+        }
+
+        throw cms::InvalidDestinationException("Don't understand null destinations", NULL);
+    }
+
+    Pointer<ActiveMQDestination> dest;
+    const ActiveMQDestination* transformed;
+
+    if (destination == this->destination.get()) {
+        dest = this->producerInfo->getDestination();
+    } else if (this->producerInfo->getDestination() == NULL) {
+        // We always need to use a copy of the users destination since we want to control
+        // its lifetime.  If the transform results in a new destination we can use that, but
+        // if its already an ActiveMQDestination then we need to clone it.
+        if (ActiveMQMessageTransformation::transformDestination(destination, &transformed)) {
+            dest.reset(const_cast<ActiveMQDestination*>(transformed));
+        } else {
+            dest.reset(transformed->cloneDataStructure());
+        }
+    } else {
+        throw cms::UnsupportedOperationException(
+            string("This producer can only send messages to: ") +
+            this->producerInfo->getDestination()->getPhysicalName(), NULL);
+    }
+
+    if (dest == NULL) {
+        throw cms::CMSException("No destination specified", NULL);
+    }
+
+    return dest;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::doSend(const Pointer<ActiveMQDestination>& destination, cms::Message* message,
+                                    int deliveryMode, int priority, long long timeToLive,
+                                    cms::AsyncCallback* onComplete, const PreparedMessage* prepared) {
+
+    cms::Message* outbound = message;
+    Pointer<cms::Message> scopedMessage;
+    if (this->transformer != NULL) {
+        if (this->transformer->producerTransform(this->session, this, message, &outbound)) {
+            // scopedMessage ensures that when we are responsible for the lifetime of the
+            // transformed message, the message remains valid until the send operation either
+            // succeeds or throws an exception.
+            scopedMessage.reset(outbound);
+        }
+        if (outbound == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "MessageTransformer set transformed message to NULL");
+        }
+    }
+
+    if (this->memoryUsage.get() != NULL) {
+        try {
+            this->memoryUsage->waitForSpace();
+        } catch (InterruptedException& e) {
+            throw cms::CMSException("Send aborted due to thread interrupt.");
+        }
+    }
+
+    this->session->send(this, destination, outbound, deliveryMode, priority, timeToLive,
+                        this->memoryUsage.get(), this->sendTimeout, onComplete, prepared);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQProducerKernel::onProducerAck(const commands::ProducerAck& ack) {
 
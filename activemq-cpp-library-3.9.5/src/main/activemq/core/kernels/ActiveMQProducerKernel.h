@@ -30,6 +30,7 @@
 #include <activemq/commands/ProducerInfo.h>
 #include <activemq/commands/ProducerAck.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/core/PreparedMessage.h>
 
 #include <memory>
 
@@ -134,6 +135,49 @@ namespace kernels {
         virtual void send(const cms::Destination* destination, cms::Message* message,
                           int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* callback);
 
+    public:
+
+        /**
+         * Prepares a Message for sending many times.  The returned PreparedMessage keeps
+         * a copy of the Message's headers along with the destination, delivery mode,
+         * priority and time to live, its body and properties are not kept.
+         *
+         * @param destination
+         *      The destination the prepared sends go to, or NULL to use the one this
+         *      Producer was created with.
+         * @param message
+         *      The Message whose headers every prepared send will carry.
+         * @param deliveryMode
+         *      The delivery mode every prepared send uses.
+         * @param priority
+         *      The priority every prepared send uses.
+         * @param timeToLive
+         *      The time to live every prepared send uses.
+         *
+         * @return the new PreparedMessage.
+         *
+         * @throws CMSException if the Message can't be prepared for the destination.
+         */
+        Pointer<PreparedMessage> prepare(const cms::Destination* destination, cms::Message* message,
+                                         int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sends the body and properties of the given Message with the headers of a
+         * Message this Producer prepared.
+         *
+         * @param prepared
+         *      The PreparedMessage created by this Producer's prepare method.
+         * @param message
+         *      The Message whose body and properties are sent, it must be the same
+         *      type as the prepared Message.
+         * @param onComplete
+         *      The callback notified when the send completes, or NULL.
+         *
+         * @throws CMSException if the PreparedMessage belongs to another Producer or
+         *         the send fails.
+         */
+        void send(const Pointer<PreparedMessage>& prepared, cms::Message* message, cms::AsyncCallback* onComplete);
+
         /**
          * Set an MessageTransformer instance that is applied to all cms::Message objects before they
          * are sent on to the CMS bus.
@@ -301,6 +345,14 @@ namespace kernels {
        // Checks for the closed state and throws if so.
        void checkClosed() const;
 
+       // Finds the destination a send to the given cms::Destination goes to.
+       Pointer<commands::ActiveMQDestination> resolveDestination(const cms::Destination* destination);
+
+       // Applies the transformer and waits for space before handing the send to the session.
+       void doSend(const Pointer<commands::ActiveMQDestination>& destination, cms::Message* message,
+                   int deliveryMode, int priority, long long timeToLive,
+                   cms::AsyncCallback* onComplete, const PreparedMessage* prepared);
+
     };
 
 }}}
@@ -911,7 +911,8 @@ bool ActiveMQSessionKernel::isTransacted() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
                                  cms::Message* message, int deliveryMode, int priority, long long timeToLive,
-                                 util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete) {
+                                 util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete,
+                                 const PreparedMessage* prepared) {
 
     try {
 
@@ -991,6 +992,10 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
             amqMessage->onSend();
             amqMessage->setProducerId(producerId);
 
+            if (prepared != NULL) {
+                prepared->apply(amqMessage.get());
+            }
+
             if (onComplete == NULL && sendTimeout <= 0 && !amqMessage->isResponseRequired() && !this->connection->isAlwaysSyncSend() &&
                 (!amqMessage->isPersistent() || this->connection->isUseAsyncSend() || amqMessage->getTransactionId() != NULL)) {
 
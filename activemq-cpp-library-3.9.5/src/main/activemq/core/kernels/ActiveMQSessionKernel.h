@@ -273,12 +273,15 @@ namespace kernels {
          *      of the given message.
          * @param sendTimeout
          *      The amount of time to block during send before failing, or 0 to wait forever.
+         * @param prepared
+         *      The PreparedMessage whose headers the message is sent with, or NULL.
          *
          * @throws CMSException if an error occurs while sending the message.
          */
         void send(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
                   cms::Message* message, int deliveryMode, int priority, long long timeToLive,
-                  util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete);
+                  util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete,
+                  const PreparedMessage* prepared);
 
         /**
          * This method gets any registered exception listener of this sessions
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ByteVectorOutputStream.h"
+
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+
+using namespace activemq;
+using namespace activemq::io;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+ByteVectorOutputStream::ByteVectorOutputStream(std::vector<unsigned char>& buffer) :
+    OutputStream(), buffer(&buffer) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteVectorOutputStream::~ByteVectorOutputStream() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteVectorOutputStream::doWriteByte(unsigned char value) {
+    this->buffer->push_back(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteVectorOutputStream::doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length) {
+
+    if (length == 0) {
+        return;
+    }
+
+    if (buffer == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "passed buffer is null");
+    }
+
+    if (size < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "size parameter out of Bounds: %d.", size);
+    }
+
+    if (offset > size || offset < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "offset parameter out of Bounds: %d.", offset);
+    }
+
+    if (length < 0 || length > size - offset) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", length);
+    }
+
+    this->buffer->insert(this->buffer->end(), buffer + offset, buffer + offset + length);
+}
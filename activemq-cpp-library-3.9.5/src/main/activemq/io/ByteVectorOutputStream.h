@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_IO_BYTEVECTOROUTPUTSTREAM_H_
+#define _ACTIVEMQ_IO_BYTEVECTOROUTPUTSTREAM_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/io/OutputStream.h>
+
+#include <vector>
+
+namespace activemq {
+namespace io {
+
+    /**
+     * OutputStream that appends everything written to it onto a vector owned by the
+     * caller.  Unlike a ByteArrayOutputStream nothing needs to be copied out once
+     * writing is done, and a vector that is cleared and written again keeps the
+     * capacity it grew to.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API ByteVectorOutputStream : public decaf::io::OutputStream {
+    private:
+
+        std::vector<unsigned char>* buffer;
+
+    private:
+
+        ByteVectorOutputStream(const ByteVectorOutputStream&);
+        ByteVectorOutputStream& operator=(const ByteVectorOutputStream&);
+
+    public:
+
+        /**
+         * Creates a stream that appends to the given vector, the vector must outlive
+         * the stream.
+         *
+         * @param buffer
+         *      The vector the written bytes are appended to.
+         */
+        ByteVectorOutputStream(std::vector<unsigned char>& buffer);
+
+        virtual ~ByteVectorOutputStream();
+
+        /**
+         * @return the vector the written bytes are appended to.
+         */
+        std::vector<unsigned char>& getBuffer() const {
+            return *this->buffer;
+        }
+
+        /**
+         * @return the number of bytes the vector holds.
+         */
+        long long size() const {
+            return (long long) this->buffer->size();
+        }
+
+    protected:
+
+        virtual void doWriteByte(unsigned char value);
+
+        virtual void doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_IO_BYTEVECTOROUTPUTSTREAM_H_ */
@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GatheringOutputStream.h"
+
+#include <activemq/exceptions/ExceptionDefines.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/internal/net/tcp/TcpSocketOutputStream.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/Math.h>
+#include <decaf/lang/System.h>
+
+using namespace activemq;
+using namespace activemq::io;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::net::tcp;
+
+////////////////////////////////////////////////////////////////////////////////
+GatheringOutputStream::GatheringOutputStream(OutputStream* next, int bufferSize, int gatherThreshold, bool own) :
+    FilterOutputStream(next, own), buffer(NULL), bufferSize(bufferSize), count(0),
+    gatherThreshold(gatherThreshold), gatheredWrites(0), socketStream(NULL) {
+
+    if (bufferSize <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Size of Buffer must be greater than zero.");
+    }
+
+    this->buffer = new unsigned char[bufferSize];
+    this->socketStream = dynamic_cast<TcpSocketOutputStream*>(next);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+GatheringOutputStream::~GatheringOutputStream() {
+
+    try {
+        this->close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+
+    delete [] this->buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStream::emptyBuffer() {
+
+    if (this->outputStream == NULL) {
+        throw IOException(__FILE__, __LINE__, "GatheringOutputStream::emptyBuffer - OutputStream is closed");
+    }
+
+    if (this->count > 0) {
+        this->outputStream->write(this->buffer, this->count);
+        this->count = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStream::writeGathered(const unsigned char* data, int length) {
+
+    if (this->socketStream != NULL) {
+
+        const unsigned char* buffers[2] = { this->buffer, data };
+        int lengths[2] = { this->count, length };
+
+        this->socketStream->writev(buffers, lengths, 2);
+        this->count = 0;
+
+    } else {
+        emptyBuffer();
+        this->outputStream->write(data, length);
+    }
+
+    this->gatheredWrites++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStream::flush() {
+
+    try {
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "GatheringOutputStream::flush - Stream is closed");
+        }
+
+        emptyBuffer();
+        this->outputStream->flush();
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStream::doWriteByte(unsigned char c) {
+
+    try {
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "GatheringOutputStream::write - Stream is closed");
+        }
+
+        if (this->count >= this->bufferSize) {
+            emptyBuffer();
+        }
+
+        this->buffer[this->count++] = c;
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStream::doWriteArray(const unsigned char* buffer, int size) {
+
+    try {
+        this->doWriteArrayBounded(buffer, size, 0, size);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_RETHROW(NullPointerException)
+    AMQ_CATCH_RETHROW(IndexOutOfBoundsException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStream::doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length) {
+
+    try {
+
+        if (length == 0) {
+            return;
+        }
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "GatheringOutputStream::write - Stream is closed");
+        }
+
+        if (buffer == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "GatheringOutputStream::write - Buffer passed is Null.");
+        }
+
+        if (size < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "size parameter out of Bounds: %d.", size);
+        }
+
+        if (offset > size || offset < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "offset parameter out of Bounds: %d.", offset);
+        }
+
+        if (length < 0 || length > size - offset) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", length);
+        }
+
+        if (this->gatherThreshold > 0 && length >= this->gatherThreshold) {
+            writeGathered(buffer + offset, length);
+            return;
+        }
+
+        for (int pos = 0; pos < length;) {
+
+            if (this->count >= this->bufferSize) {
+                emptyBuffer();
+            }
+
+            int bytesToWrite = Math::min(this->bufferSize - this->count, length - pos);
+            System::arraycopy(buffer, offset + pos, this->buffer, this->count, bytesToWrite);
+
+            this->count += bytesToWrite;
+            pos += bytesToWrite;
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_RETHROW(NullPointerException)
+    AMQ_CATCH_RETHROW(IndexOutOfBoundsException)
+    AMQ_CATCHALL_THROW(IOException)
+}
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_IO_GATHERINGOUTPUTSTREAM_H_
+#define _ACTIVEMQ_IO_GATHERINGOUTPUTSTREAM_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/io/FilterOutputStream.h>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+    class TcpSocketOutputStream;
+}}}}
+
+namespace activemq {
+namespace io {
+
+    /**
+     * Buffering OutputStream filter that keeps small writes in an internal buffer
+     * like a BufferedOutputStream does, but passes large writes such as message
+     * bodies through to the target by reference instead of copying them into the
+     * buffer.  When the target is a socket stream the buffered bytes and the large
+     * block are sent together with one gathering write, otherwise the buffer is
+     * emptied and the block written directly.
+     *
+     * The caller's data is fully written before the write call returns so nothing
+     * is retained after it.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API GatheringOutputStream : public decaf::io::FilterOutputStream {
+    private:
+
+        unsigned char* buffer;
+        int bufferSize;
+        int count;
+        int gatherThreshold;
+        long long gatheredWrites;
+
+        decaf::internal::net::tcp::TcpSocketOutputStream* socketStream;
+
+    private:
+
+        GatheringOutputStream(const GatheringOutputStream&);
+        GatheringOutputStream& operator=(const GatheringOutputStream&);
+
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param next
+         *      The target output stream.
+         * @param bufferSize
+         *      The size of the internal buffer used for small writes.
+         * @param gatherThreshold
+         *      Writes of at least this many bytes bypass the internal buffer, a value
+         *      of zero or less disables the bypass.
+         * @param own
+         *      If true, this object will control the lifetime of the
+         *      output stream that it encapsulates.
+         *
+         * @throws IllegalArgumentException if the bufferSize given is not positive.
+         */
+        GatheringOutputStream(decaf::io::OutputStream* next, int bufferSize, int gatherThreshold, bool own = false);
+
+        virtual ~GatheringOutputStream();
+
+        /**
+         * @{inheritDoc}
+         */
+        virtual void flush();
+
+        /**
+         * @return the size in bytes at or above which writes bypass the buffer.
+         */
+        int getGatherThreshold() const {
+            return this->gatherThreshold;
+        }
+
+        /**
+         * @return the number of writes that were passed through without being
+         *         copied into the internal buffer.
+         */
+        long long getGatheredWriteCount() const {
+            return this->gatheredWrites;
+        }
+
+    protected:
+
+        virtual void doWriteByte(unsigned char c);
+
+        virtual void doWriteArray(const unsigned char* buffer, int size);
+
+        virtual void doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length);
+
+    private:
+
+        void emptyBuffer();
+
+        void writeGathered(const unsigned char* data, int length);
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_IO_GATHERINGOUTPUTSTREAM_H_*/
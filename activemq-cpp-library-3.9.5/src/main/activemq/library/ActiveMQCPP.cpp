@@ -21,24 +21,34 @@
 #include <activemq/wireformat/WireFormatRegistry.h>
 #include <activemq/transport/TransportRegistry.h>
 
+#include <activemq/commands/DataStructurePool.h>
 #include <activemq/util/IdGenerator.h>
 
 #include <activemq/wireformat/stomp/StompWireFormatFactory.h>
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
+#include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
 
 #include <activemq/transport/mock/MockTransportFactory.h>
+#include <activemq/transport/tcp/TcpReactor.h>
 #include <activemq/transport/tcp/TcpTransportFactory.h>
 #include <activemq/transport/tcp/SslTransportFactory.h>
 #include <activemq/transport/failover/FailoverTransportFactory.h>
+#include <activemq/transport/shared/SharedTransport.h>
+#include <activemq/transport/vm/VMBroker.h>
+#include <activemq/transport/vm/VMTransportFactory.h>
 
 using namespace activemq;
 using namespace activemq::library;
+using namespace activemq::commands;
 using namespace activemq::util;
 using namespace activemq::transport;
 using namespace activemq::transport::tcp;
 using namespace activemq::transport::mock;
 using namespace activemq::transport::failover;
+using namespace activemq::transport::shared;
+using namespace activemq::transport::vm;
 using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire::marshal;
 
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQCPP::ActiveMQCPP() {
@@ -56,6 +66,9 @@ void ActiveMQCPP::initializeLibrary(int argc, char** argv) {
     // Initialize the Decaf Library by requesting its runtime.
     decaf::lang::Runtime::initializeRuntime(argc, argv);
 
+    // Commands created from here on recycle their memory through the pool.
+    DataStructurePool::initialize();
+
     // Register all WireFormats
     ActiveMQCPP::registerWireFormats();
 
@@ -64,6 +77,18 @@ void ActiveMQCPP::initializeLibrary(int argc, char** argv) {
 
     // Start the IdGenerator Kernel
     IdGenerator::initialize();
+
+    // Create the shared reactor, its threads are only started once a transport uses it.
+    TcpReactor::initialize();
+
+    // Transports shared between connections are created on first use.
+    SharedTransport::initialize();
+
+    // In process routers are created when the first vm:// transport connects.
+    VMBroker::initialize();
+
+    // Message property maps are encoded through a buffer kept for each thread.
+    PrimitiveTypesMarshaller::initialize();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,12 +99,24 @@ void ActiveMQCPP::initializeLibrary() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQCPP::shutdownLibrary() {
 
+    PrimitiveTypesMarshaller::shutdown();
+
+    // Drop any shared transports and in process routers that are still registered.
+    VMBroker::shutdown();
+    SharedTransport::shutdown();
+
+    // Stop any reactor threads that were started.
+    TcpReactor::shutdown();
+
     // Shutdown the IdGenerator Kernel
     IdGenerator::shutdown();
 
     WireFormatRegistry::shutdown();
     TransportRegistry::shutdown();
 
+    // Commands still alive after this go back to the heap when released.
+    DataStructurePool::shutdown();
+
     // Now it should be safe to shutdown Decaf.
     decaf::lang::Runtime::shutdownRuntime();
 }
@@ -107,4 +144,5 @@ void ActiveMQCPP::registerTransports() {
     TransportRegistry::getInstance().registerFactory("nio+ssl", new SslTransportFactory());
     TransportRegistry::getInstance().registerFactory("mock", new MockTransportFactory());
     TransportRegistry::getInstance().registerFactory("failover", new FailoverTransportFactory());
+    TransportRegistry::getInstance().registerFactory("vm", new VMTransportFactory());
 }
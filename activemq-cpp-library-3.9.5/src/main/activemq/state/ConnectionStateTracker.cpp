@@ -17,17 +17,22 @@
 
 #include "ConnectionStateTracker.h"
 
+#include <activemq/state/MessageCache.h>
+
 #include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
 #include <decaf/util/HashCode.h>
 #include <decaf/util/LinkedHashMap.h>
 #include <decaf/util/MapEntry.h>
 #include <decaf/util/NoSuchElementException.h>
 #include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/util/concurrent/Mutex.h>
 
 #include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/ExceptionResponse.h>
 #include <activemq/commands/RemoveInfo.h>
 #include <activemq/core/ActiveMQConstants.h>
+#include <activemq/transport/IOTransport.h>
 #include <activemq/transport/TransportListener.h>
 #include <activemq/wireformat/WireFormat.h>
 
@@ -46,33 +51,6 @@ namespace activemq {
 namespace state {
 
 
-    class MessageCache : public LinkedHashMap<Pointer<MessageId>, Pointer<Command> > {
-    protected:
-
-        ConnectionStateTracker* parent;
-
-    public:
-
-        int currentCacheSize;
-
-    public:
-
-        MessageCache(ConnectionStateTracker* parent) :
-            LinkedHashMap<Pointer<MessageId>, Pointer<Command> >(), parent(parent), currentCacheSize(0) {
-        }
-
-        virtual ~MessageCache() {}
-
-        virtual bool removeEldestEntry(const MapEntry<Pointer<MessageId>, Pointer<Command> >& eldest) {
-            bool result = currentCacheSize > parent->getMaxMessageCacheSize();
-            if (result) {
-                Pointer<Message> message = eldest.getValue().dynamicCast<Message>();
-                currentCacheSize -= message->getSize();
-            }
-            return result;
-        }
-    };
-
     class MessagePullCache : public LinkedHashMap<std::string, Pointer<Command> > {
     protected:
 
@@ -114,13 +92,39 @@ namespace state {
         /** Store MessagePull commands for replay */
         MessagePullCache messagePullCache;
 
+        /** Tracked state is changed and replayed under this lock, senders track concurrently */
+        mutable decaf::util::concurrent::Mutex trackMutex;
+
+        /** Registrations are copied for the standby while they are tracked under this lock,
+         *  the copies are written after it is released and counted until they are out. */
+        mutable decaf::util::concurrent::Mutex standbyMutex;
+        Pointer<transport::Transport> standby;
+        int mirrorsInFlight;
+
+        /** A standby whose copy of the tracked state is still being written, and the
+         *  registrations tracked since that copy was taken. */
+        Pointer<transport::Transport> pendingStandby;
+        std::vector< Pointer<Command> > pendingMirrors;
+
         StateTrackerImpl(ConnectionStateTracker * parent) : parent(parent),
                                                             TRACKED_RESPONSE_MARKER(new Tracked()),
                                                             connectionStates(),
-                                                            messageCache(parent),
-                                                            messagePullCache(parent) {
+                                                            messageCache(),
+                                                            messagePullCache(parent),
+                                                            trackMutex(),
+                                                            standbyMutex(),
+                                                            standby(),
+                                                            mirrorsInFlight(0),
+                                                            pendingStandby(),
+                                                            pendingMirrors() {
         }
 
+        void mirror(const Pointer<transport::Transport> target, const Pointer<Command> copy);
+
+        void mirrorPending(const Pointer<transport::Transport> target, const std::vector< Pointer<Command> >& copies);
+
+        bool isMirroredRemoval(const RemoveInfo& info);
+
         ~StateTrackerImpl() {
             try {
                 connectionStates.clear();
@@ -151,17 +155,167 @@ namespace state {
         virtual ~RemoveTransactionAction() {}
 
         virtual void run() {
-            Pointer<ConnectionId> connectionId = info->getConnectionId();
-            Pointer<ConnectionState> cs = stateTracker->impl->connectionStates.get(connectionId);
-            Pointer<TransactionState> txState = cs->removeTransactionState(info->getTransactionId());
-            if (txState != NULL) {
-                txState->clear();
+            synchronized(&stateTracker->impl->trackMutex) {
+                Pointer<ConnectionId> connectionId = info->getConnectionId();
+                Pointer<ConnectionState> cs = stateTracker->impl->connectionStates.get(connectionId);
+                Pointer<TransactionState> txState = cs->removeTransactionState(info->getTransactionId());
+                if (txState != NULL) {
+                    txState->clear();
+                }
             }
         }
     };
 
 }}
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * A durable subscriber or exclusive consumer registered on the standby would be
+     * active on two brokers at once, these are only registered when it is promoted.
+     */
+    bool isMirroredConsumer(const ConsumerInfo& info) {
+        return info.getSubscriptionName().empty() && !info.isExclusive();
+    }
+
+    bool isMirrored(const Command& command) {
+        if (command.isConsumerInfo()) {
+            return isMirroredConsumer(dynamic_cast<const ConsumerInfo&>(command));
+        }
+
+        return command.isConnectionInfo() || command.isSessionInfo() || command.isProducerInfo() ||
+               command.isDestinationInfo() || command.isRemoveInfo();
+    }
+
+    /**
+     * Copies a registration for the standby, the copy never asks for a response and
+     * a consumer is registered with a prefetch of zero so nothing is dispatched to it.
+     */
+    Pointer<Command> createMirrorCommand(const Pointer<Command> command) {
+
+        Pointer<Command> copy(dynamic_cast<Command*>(command->cloneDataStructure()));
+        copy->setResponseRequired(false);
+
+        if (copy->isConsumerInfo()) {
+            copy.dynamicCast<ConsumerInfo>()->setPrefetchSize(0);
+        }
+
+        return copy;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool StateTrackerImpl::isMirroredRemoval(const RemoveInfo& info) {
+
+    const ConsumerId* id = dynamic_cast<const ConsumerId*>(info.getObjectId().get());
+    if (id == NULL || id->getParentId() == NULL) {
+        return true;
+    }
+
+    Pointer<ConnectionState> cs = connectionStates.get(id->getParentId()->getParentId());
+    if (cs != NULL) {
+        Pointer<SessionState> ss = cs->getSessionState(id->getParentId());
+        if (ss != NULL) {
+            Pointer<ConsumerState> consumer = ss->getConsumerState(Pointer<ConsumerId>(id->cloneDataStructure()));
+            if (consumer != NULL) {
+                return isMirroredConsumer(*consumer->getInfo());
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StateTrackerImpl::mirror(const Pointer<transport::Transport> target, const Pointer<Command> copy) {
+
+    bool failed = false;
+
+    try {
+        target->oneway(copy);
+    } catch (Exception&) {
+        failed = true;
+    }
+
+    synchronized(&standbyMutex) {
+
+        // The standby has missed a registration and can't be promoted any more.
+        if (failed && standby == target) {
+            standby.reset(NULL);
+        }
+
+        if (--mirrorsInFlight == 0) {
+            standbyMutex.notifyAll();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StateTrackerImpl::mirrorPending(const Pointer<transport::Transport> target, const std::vector< Pointer<Command> >& copies) {
+
+    try {
+        std::vector< Pointer<Command> >::const_iterator copy = copies.begin();
+        for (; copy != copies.end(); ++copy) {
+            target->oneway(*copy);
+        }
+    } catch (Exception&) {
+        synchronized(&standbyMutex) {
+            if (pendingStandby == target) {
+                pendingStandby.reset(NULL);
+                pendingMirrors.clear();
+            }
+        }
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * Batches the writes made to a transport while it is in scope, if the transport
+     * is not built on an IOTransport this does nothing.
+     */
+    class RestoreBatch {
+    private:
+
+        transport::IOTransport* transport;
+
+    private:
+
+        RestoreBatch(const RestoreBatch&);
+        RestoreBatch& operator=(const RestoreBatch&);
+
+    public:
+
+        RestoreBatch(transport::Transport* target) : transport(NULL) {
+            if (target != NULL) {
+                transport = dynamic_cast<transport::IOTransport*>(target->narrow(typeid(transport::IOTransport)));
+            }
+
+            if (transport != NULL) {
+                transport->beginBatch();
+            }
+        }
+
+        ~RestoreBatch() {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        void flush() {
+            if (transport != NULL) {
+                transport::IOTransport* target = transport;
+                transport = NULL;
+                target->endBatch();
+            }
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ConnectionStateTracker::ConnectionStateTracker() : impl(new StateTrackerImpl(this)),
                                                    trackTransactions(false),
@@ -172,7 +326,9 @@ ConnectionStateTracker::ConnectionStateTracker() : impl(new StateTrackerImpl(thi
                                                    trackMessages(true),
                                                    trackTransactionProducers(true),
                                                    maxMessageCacheSize(128 * 1024),
-                                                   maxMessagePullCacheSize(10) {
+                                                   maxMessagePullCacheSize(10),
+                                                   pipelineRestore(false),
+                                                   lastRestoreDuration(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -188,7 +344,42 @@ Pointer<Tracked> ConnectionStateTracker::track(Pointer<Command> command) {
 
     try{
 
-        Pointer<Command> result = command->visit(this);
+        Pointer<Command> result;
+
+        if (isMirrored(*command)) {
+
+            Pointer<transport::Transport> standby;
+            Pointer<Command> copy;
+
+            synchronized(&this->impl->standbyMutex) {
+                bool mirrored = true;
+                synchronized(&this->impl->trackMutex) {
+                    if (command->isRemoveInfo()) {
+                        mirrored = this->impl->isMirroredRemoval(dynamic_cast<const RemoveInfo&>(*command));
+                    }
+                    result = command->visit(this);
+                }
+
+                if (mirrored && this->impl->standby != NULL) {
+                    copy = createMirrorCommand(command);
+                    standby = this->impl->standby;
+                    this->impl->mirrorsInFlight++;
+                } else if (mirrored && this->impl->pendingStandby != NULL) {
+                    // Written by setStandby once the copy of the state is out.
+                    this->impl->pendingMirrors.push_back(createMirrorCommand(command));
+                }
+            }
+
+            // A standby that stalls only holds up the thread whose registration it is.
+            if (standby != NULL) {
+                this->impl->mirror(standby, copy);
+            }
+        } else {
+            synchronized(&this->impl->trackMutex) {
+                result = command->visit(this);
+            }
+        }
+
         if (result == NULL) {
             return Pointer<Tracked>();
         } else {
@@ -208,7 +399,7 @@ void ConnectionStateTracker::trackBack(Pointer<Command> command) {
             if (trackMessages && command->isMessage()) {
                 Pointer<Message> message = command.dynamicCast<Message>();
                 if (message->getTransactionId() == NULL) {
-                    this->impl->messageCache.currentCacheSize += message->getSize();
+                    this->impl->messageCache.sent(message->getCommandId());
                 }
             }
         }
@@ -218,36 +409,201 @@ void ConnectionStateTracker::trackBack(Pointer<Command> command) {
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::messageAcknowledged(int commandId) {
+
+    try {
+        if (trackMessages) {
+            this->impl->messageCache.acknowledge(commandId);
+        }
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ConnectionStateTracker::getMessageCacheCount() const {
+    return this->impl->messageCache.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ConnectionStateTracker::getMessageCacheSize() const {
+    return this->impl->messageCache.getCurrentSize();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionStateTracker::restore(Pointer<transport::Transport> transport) {
 
+    long long startTime = System::currentTimeMillis();
+
     try {
 
-        Pointer<Iterator<Pointer<ConnectionState> > > iterator(
-            this->impl->connectionStates.values().iterator());
+        // Nothing that is replayed waits for a response, so the restore can be written
+        // out back to back and flushed once at the end.
+        RestoreBatch batch(pipelineRestore ? transport.get() : NULL);
 
-        while (iterator->hasNext()) {
-            Pointer<ConnectionState> state = iterator->next();
+        synchronized(&this->impl->trackMutex) {
+
+            Pointer<Iterator<Pointer<ConnectionState> > > iterator(
+                this->impl->connectionStates.values().iterator());
 
-            Pointer<ConnectionInfo> info = state->getInfo();
-            info->setFailoverReconnect(true);
-            transport->oneway(info);
+            while (iterator->hasNext()) {
+                Pointer<ConnectionState> state = iterator->next();
 
-            doRestoreTempDestinations(transport, state);
+                Pointer<ConnectionInfo> info = state->getInfo();
+                info->setFailoverReconnect(true);
+                transport->oneway(info);
 
-            if (restoreSessions) {
-                doRestoreSessions(transport, state);
+                doRestoreTempDestinations(transport, state);
+
+                if (restoreSessions) {
+                    doRestoreSessions(transport, state);
+                }
+
+                if (restoreTransaction) {
+                    doRestoreTransactions(transport, state);
+                }
+            }
+
+            // Now we flush messages
+            doRestoreMessages(transport);
+        }
+
+        batch.flush();
+
+        this->lastRestoreDuration = System::currentTimeMillis() - startTime;
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::setStandby(Pointer<transport::Transport> transport) {
+
+    try {
+
+        std::vector<Pointer<Command> > copies;
+
+        synchronized(&this->impl->standbyMutex) {
+
+            this->impl->standby.reset(NULL);
+            this->impl->pendingStandby = transport;
+            this->impl->pendingMirrors.clear();
+
+            if (transport == NULL) {
+                return;
+            }
+
+            // Everything tracked after this copy is recorded for the pending standby.
+            synchronized(&this->impl->trackMutex) {
+                doMirrorState(copies);
+            }
+        }
+
+        // The writes are made without the tracker's locks so senders aren't held up
+        // by the new standby, until they are all out it doesn't get the live copies.
+        while (true) {
+
+            this->impl->mirrorPending(transport, copies);
+            copies.clear();
+
+            synchronized(&this->impl->standbyMutex) {
+
+                // Replaced by a later call while the state was being written.
+                if (this->impl->pendingStandby != transport) {
+                    return;
+                }
+
+                if (this->impl->pendingMirrors.empty()) {
+                    this->impl->pendingStandby.reset(NULL);
+                    this->impl->standby = transport;
+                    return;
+                }
+
+                copies.swap(this->impl->pendingMirrors);
             }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<transport::Transport> ConnectionStateTracker::getStandby() const {
 
-            if (restoreTransaction) {
-                doRestoreTransactions(transport, state);
+    synchronized(&this->impl->standbyMutex) {
+        return this->impl->standby;
+    }
+
+    return Pointer<transport::Transport>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::promoteStandby(Pointer<transport::Transport> transport) {
+
+    long long startTime = System::currentTimeMillis();
+
+    try {
+
+        synchronized(&this->impl->standbyMutex) {
+            if (this->impl->standby == transport) {
+                this->impl->standby.reset(NULL);
+            }
+
+            if (this->impl->pendingStandby == transport) {
+                this->impl->pendingStandby.reset(NULL);
+                this->impl->pendingMirrors.clear();
+            }
+
+            // A registration still being mirrored must reach the broker before the
+            // consumers it holds are given their prefetch back.
+            while (this->impl->mirrorsInFlight > 0) {
+                this->impl->standbyMutex.wait();
             }
         }
 
-        // Now we flush messages
-        Pointer<Iterator<Pointer<Command> > > messages(this->impl->messageCache.values().iterator());
-        while (messages->hasNext()) {
-            transport->oneway(messages->next());
+        RestoreBatch batch(pipelineRestore ? transport.get() : NULL);
+
+        synchronized(&this->impl->trackMutex) {
+
+            Pointer<Iterator<Pointer<ConnectionState> > > iterator(
+                this->impl->connectionStates.values().iterator());
+
+            while (iterator->hasNext()) {
+                Pointer<ConnectionState> state = iterator->next();
+
+                doPromoteConsumers(transport, state);
+
+                if (restoreTransaction) {
+                    doRestoreTransactions(transport, state);
+                }
+            }
+
+            doRestoreMessages(transport);
+        }
+
+        batch.flush();
+
+        this->lastRestoreDuration = System::currentTimeMillis() - startTime;
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::doRestoreMessages(Pointer<transport::Transport> transport) {
+
+    try {
+
+        std::vector<Pointer<Command> > messages;
+        this->impl->messageCache.getMessages(messages);
+        std::vector<Pointer<Command> >::const_iterator message = messages.begin();
+        for (; message != messages.end(); ++message) {
+            transport->oneway(*message);
         }
 
         Pointer<Iterator<Pointer<Command> > > messagePullIter(this->impl->messagePullCache.values().iterator());
@@ -260,6 +616,106 @@ void ConnectionStateTracker::restore(Pointer<transport::Transport> transport) {
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::doMirrorState(std::vector<Pointer<Command> >& commands) {
+
+    try {
+
+        Pointer<Iterator<Pointer<ConnectionState> > > iterator(
+            this->impl->connectionStates.values().iterator());
+
+        while (iterator->hasNext()) {
+            Pointer<ConnectionState> state = iterator->next();
+
+            commands.push_back(createMirrorCommand(state->getInfo()));
+
+            std::auto_ptr<Iterator<Pointer<DestinationInfo> > > tempDestinations(
+                state->getTempDesinations().iterator());
+            while (tempDestinations->hasNext()) {
+                commands.push_back(createMirrorCommand(tempDestinations->next()));
+            }
+
+            Pointer<Iterator<Pointer<SessionState> > > sessions(state->getSessionStates().iterator());
+            while (sessions->hasNext()) {
+                Pointer<SessionState> session = sessions->next();
+                commands.push_back(createMirrorCommand(session->getInfo()));
+
+                Pointer<Iterator<Pointer<ProducerState> > > producers(session->getProducerStates().iterator());
+                while (producers->hasNext()) {
+                    commands.push_back(createMirrorCommand(producers->next()->getInfo()));
+                }
+
+                Pointer<Iterator<Pointer<ConsumerState> > > consumers(session->getConsumerStates().iterator());
+                while (consumers->hasNext()) {
+                    Pointer<ConsumerInfo> info = consumers->next()->getInfo();
+                    if (isMirroredConsumer(*info)) {
+                        commands.push_back(createMirrorCommand(info));
+                    }
+                }
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::doPromoteConsumers(Pointer<transport::Transport> transport, Pointer<ConnectionState> connectionState) {
+
+    try {
+
+        // Until interruption processing completes the consumers are left at the zero
+        // prefetch they were mirrored with, as a restore would have left them.
+        bool connectionInterruptionProcessingComplete = connectionState->isConnectionInterruptProcessingComplete();
+
+        Pointer<Iterator<Pointer<SessionState> > > sessions(connectionState->getSessionStates().iterator());
+        while (sessions->hasNext()) {
+
+            Pointer<Iterator<Pointer<ConsumerState> > > consumers(sessions->next()->getConsumerStates().iterator());
+            while (consumers->hasNext()) {
+
+                Pointer<ConsumerInfo> info = consumers->next()->getInfo();
+
+                if (!isMirroredConsumer(*info)) {
+
+                    // Never registered on the standby, so it is restored as it would
+                    // be onto a newly connected transport.
+                    Pointer<ConsumerInfo> infoToSend = info;
+                    Pointer<wireformat::WireFormat> wireFormat = transport->getWireFormat();
+                    if (!connectionInterruptionProcessingComplete && info->getPrefetchSize() > 0 &&
+                        wireFormat != NULL && wireFormat->getVersion() > 5) {
+
+                        infoToSend.reset(info->cloneDataStructure());
+                        connectionState->getRecoveringPullConsumers().put(info->getConsumerId(), info);
+                        infoToSend->setPrefetchSize(0);
+                    }
+
+                    transport->oneway(infoToSend);
+                    continue;
+                }
+
+                if (info->getPrefetchSize() <= 0) {
+                    continue;
+                }
+
+                if (!connectionInterruptionProcessingComplete) {
+                    connectionState->getRecoveringPullConsumers().put(info->getConsumerId(), info);
+                } else {
+                    Pointer<ConsumerControl> control(new ConsumerControl());
+                    control->setConsumerId(info->getConsumerId());
+                    control->setPrefetch(info->getPrefetchSize());
+                    control->setDestination(info->getDestination());
+                    transport->oneway(control);
+                }
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionStateTracker::doRestoreTransactions(Pointer<transport::Transport> transport, Pointer<ConnectionState> connectionState) {
 
@@ -649,8 +1105,8 @@ Pointer<Command> ConnectionStateTracker::processMessage(Message* message) {
                 }
                 return this->impl->TRACKED_RESPONSE_MARKER;
             } else if (trackMessages) {
-                this->impl->messageCache.put(
-                    message->getMessageId(), Pointer<Message>(message->cloneDataStructure()));
+                this->impl->messageCache.add(
+                    Pointer<Command>(message->cloneDataStructure()), message->getSize(), maxMessageCacheSize);
             }
         }
 
@@ -848,7 +1304,10 @@ void ConnectionStateTracker::connectionInterruptProcessingComplete(transport::Tr
 
         connectionState->setConnectionInterruptProcessingComplete(true);
 
-        StlMap<Pointer<ConsumerId>, Pointer<ConsumerInfo>, ConsumerId::COMPARATOR> stalledConsumers = connectionState->getRecoveringPullConsumers();
+        StlMap<Pointer<ConsumerId>, Pointer<ConsumerInfo>, ConsumerId::COMPARATOR> stalledConsumers;
+        synchronized(&this->impl->trackMutex) {
+            stalledConsumers.copy(connectionState->getRecoveringPullConsumers());
+        }
 
         Pointer<Iterator<Pointer<ConsumerId> > > key(stalledConsumers.keySet().iterator());
         while (key->hasNext()) {
@@ -32,6 +32,8 @@
 
 #include <decaf/lang/Pointer.h>
 
+#include <vector>
+
 namespace activemq {
 namespace state {
 
@@ -52,6 +54,8 @@ namespace state {
         bool trackTransactionProducers;
         int maxMessageCacheSize;
         int maxMessagePullCacheSize;
+        bool pipelineRestore;
+        long long lastRestoreDuration;
 
         friend class RemoveTransactionAction;
 
@@ -67,6 +71,66 @@ namespace state {
 
         void restore(decaf::lang::Pointer<transport::Transport> transport);
 
+        /**
+         * Makes the given Transport a warm standby.  The connections, sessions, producers,
+         * consumers and temporary destinations tracked so far are registered on it right
+         * away and from then on every registration or removal that is tracked is copied
+         * to it as well.  Consumers are registered on the standby with a prefetch of zero
+         * so the broker it is connected to dispatches nothing until it is promoted.  Durable
+         * subscribers and exclusive consumers are not mirrored, on a broker they would be
+         * competing with the live ones, and are only registered when it is promoted.
+         *
+         * The copies sent to the standby never require a response and are written by the
+         * tracking thread once the tracker's locks are released, so a stalled standby does
+         * not hold up other senders.  The tracked state is likewise copied under the locks
+         * and written after they are released, registrations tracked in the meantime are
+         * written after it and only then is the transport made the standby.  If a write
+         * to the standby fails it is dropped and getStandby returns NULL.
+         *
+         * @param transport
+         *      The Transport to mirror registrations to, or NULL to stop mirroring.
+         *
+         * @throws IOException if the tracked state could not be registered on the standby.
+         */
+        void setStandby(decaf::lang::Pointer<transport::Transport> transport);
+
+        /**
+         * @return the Transport that registrations are mirrored to, or NULL if there is none.
+         */
+        decaf::lang::Pointer<transport::Transport> getStandby() const;
+
+        /**
+         * Restores state onto the Transport that was the standby.  As nearly everything is
+         * already registered there only the consumers' prefetch has to be raised, which is
+         * done once interruption processing completes just as after a normal restore, the
+         * consumers that were not mirrored are registered, and the transactions and cached
+         * messages are replayed.
+         *
+         * @param transport
+         *      The standby Transport that is taking over the connection.
+         */
+        void promoteStandby(decaf::lang::Pointer<transport::Transport> transport);
+
+        /**
+         * Called when the broker responds to a message that was sent, the message and
+         * any sent ahead of it are no longer needed for replay and are released from
+         * the message cache.
+         *
+         * @param commandId
+         *      The command id of the message that the response was for.
+         */
+        void messageAcknowledged(int commandId);
+
+        /**
+         * @return the number of messages held in the message cache for replay.
+         */
+        int getMessageCacheCount() const;
+
+        /**
+         * @return the total size in bytes of the messages held in the message cache.
+         */
+        long long getMessageCacheSize() const;
+
         void connectionInterruptProcessingComplete(
             transport::Transport* transport, decaf::lang::Pointer<ConnectionId> connectionId);
 
@@ -180,6 +244,30 @@ namespace state {
             this->trackTransactionProducers = trackTransactionProducers;
         }
 
+        bool isPipelineRestore() const {
+            return this->pipelineRestore;
+        }
+
+        /**
+         * When enabled the commands replayed by restore are written without flushing
+         * the transport after each one, so the whole replay goes out in as few large
+         * writes as the transport's output buffer allows.  Only transports built on an
+         * IOTransport can batch their writes, others are restored as before.
+         *
+         * @param pipelineRestore
+         *      True to coalesce the writes made while restoring state.
+         */
+        void setPipelineRestore(bool pipelineRestore) {
+            this->pipelineRestore = pipelineRestore;
+        }
+
+        /**
+         * @return the time in milliseconds that the last call to restore took.
+         */
+        long long getLastRestoreDuration() const {
+            return this->lastRestoreDuration;
+        }
+
     private:
 
         void doRestoreTransactions(decaf::lang::Pointer<transport::Transport> transport,
@@ -197,6 +285,13 @@ namespace state {
         void doRestoreTempDestinations(decaf::lang::Pointer<transport::Transport> transport,
                                        decaf::lang::Pointer<ConnectionState> connectionState);
 
+        void doRestoreMessages(decaf::lang::Pointer<transport::Transport> transport);
+
+        void doMirrorState(std::vector< decaf::lang::Pointer<commands::Command> >& commands);
+
+        void doPromoteConsumers(decaf::lang::Pointer<transport::Transport> transport,
+                                decaf::lang::Pointer<ConnectionState> connectionState);
+
     };
 
 }}
@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageCache.h"
+
+using namespace activemq;
+using namespace activemq::state;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Must be a power of two so that positions in the ring can be masked.
+    const std::size_t INITIAL_CAPACITY = 64;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageCache::MessageCache() : mutex(), ring(INITIAL_CAPACITY), head(0), count(0), nextSequence(1), currentSize(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageCache::~MessageCache() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MessageCache::add(const Pointer<Command> message, int size, long long maxSize) {
+
+    synchronized(&mutex) {
+
+        while (count > 0 && currentSize > maxSize) {
+            removeFirst();
+        }
+
+        if (count == ring.size()) {
+            grow();
+        }
+
+        Entry& entry = at(count++);
+        entry.message = message;
+        entry.sequence = nextSequence++;
+        entry.sentSequence = 0;
+        entry.commandId = message->getCommandId();
+        entry.size = size;
+
+        currentSize += size;
+
+        return entry.sequence;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCache::sent(int commandId) {
+
+    synchronized(&mutex) {
+
+        // Messages are sent right after they are added so the search is short.
+        for (std::size_t i = count; i > 0; --i) {
+            Entry& entry = at(i - 1);
+            if (entry.commandId == commandId && entry.sentSequence == 0) {
+                entry.sentSequence = nextSequence++;
+                return;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageCache::acknowledge(int commandId) {
+
+    synchronized(&mutex) {
+
+        long long acknowledged = 0;
+        for (std::size_t i = count; i > 0; --i) {
+            const Entry& entry = at(i - 1);
+            if (entry.commandId == commandId) {
+                acknowledged = entry.sequence;
+                break;
+            }
+        }
+
+        if (acknowledged == 0) {
+            return 0;
+        }
+
+        // Anything whose send completed before the acknowledged message was added was
+        // on the wire ahead of it, stop at the first message that might not have been.
+        long long releaseTo = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const Entry& entry = at(i);
+            if (entry.sequence == acknowledged) {
+                releaseTo = acknowledged;
+                break;
+            } else if (entry.sentSequence == 0 || entry.sentSequence > acknowledged) {
+                break;
+            }
+
+            releaseTo = entry.sequence;
+        }
+
+        return releaseUpTo(releaseTo);
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageCache::releaseUpTo(long long sequence) {
+
+    int released = 0;
+
+    synchronized(&mutex) {
+        while (count > 0 && at(0).sequence <= sequence) {
+            removeFirst();
+            released++;
+        }
+    }
+
+    return released;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCache::getMessages(std::vector< Pointer<Command> >& messages) const {
+
+    synchronized(&mutex) {
+        messages.reserve(messages.size() + count);
+        for (std::size_t i = 0; i < count; ++i) {
+            messages.push_back(at(i).message);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageCache::size() const {
+
+    synchronized(&mutex) {
+        return (int) count;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MessageCache::getCurrentSize() const {
+
+    synchronized(&mutex) {
+        return currentSize;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageCache::getCapacity() const {
+
+    synchronized(&mutex) {
+        return (int) ring.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCache::clear() {
+
+    synchronized(&mutex) {
+        while (count > 0) {
+            removeFirst();
+        }
+
+        head = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCache::removeFirst() {
+
+    Entry& entry = at(0);
+    currentSize -= entry.size;
+    entry.message.reset(NULL);
+
+    head = (head + 1) & (ring.size() - 1);
+    count--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCache::grow() {
+
+    std::vector<Entry> larger(ring.size() * 2);
+    for (std::size_t i = 0; i < count; ++i) {
+        larger[i] = at(i);
+    }
+
+    ring.swap(larger);
+    head = 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_STATE_MESSAGECACHE_H_
+#define _ACTIVEMQ_STATE_MESSAGECACHE_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Command.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+namespace activemq {
+namespace state {
+
+    /**
+     * Holds the messages sent since the last failover in the order they were sent so
+     * that they can be replayed to a new broker.  The messages are kept in a ring
+     * buffer, adding a message and evicting the oldest are constant time and the only
+     * allocation made is when the ring has to grow.  The cache is bounded by the total
+     * size of the messages it holds.
+     *
+     * Every message added is given a sequence number, once the broker is known to have
+     * processed a message it and those sent before it can be released in one step.
+     *
+     * This class is thread safe.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API MessageCache {
+    private:
+
+        struct Entry {
+            decaf::lang::Pointer<commands::Command> message;
+            long long sequence;
+            long long sentSequence;
+            int commandId;
+            int size;
+
+            Entry() : message(), sequence(0), sentSequence(0), commandId(0), size(0) {}
+        };
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        std::vector<Entry> ring;
+        std::size_t head;
+        std::size_t count;
+
+        long long nextSequence;
+        long long currentSize;
+
+    private:
+
+        MessageCache(const MessageCache&);
+        MessageCache& operator=(const MessageCache&);
+
+    public:
+
+        MessageCache();
+
+        virtual ~MessageCache();
+
+        /**
+         * Adds a message to the end of the cache.  While the cache holds more than the
+         * given number of bytes the oldest messages are evicted before it is added.
+         *
+         * @param message
+         *      The message to cache.
+         * @param size
+         *      The size of the message in bytes.
+         * @param maxSize
+         *      The number of bytes the cache may hold before messages are evicted.
+         *
+         * @return the sequence number given to the message.
+         */
+        long long add(const decaf::lang::Pointer<commands::Command> message, int size, long long maxSize);
+
+        /**
+         * Records that the most recently added message with the given command id has
+         * been written to the transport.
+         *
+         * @param commandId
+         *      The command id of the message that was sent.
+         */
+        void sent(int commandId);
+
+        /**
+         * Called when the broker has responded to the message with the given command id.
+         * The broker handles the commands of a connection in order, so every message whose
+         * send completed before that message was added has been processed as well and
+         * is released along with it.
+         *
+         * @param commandId
+         *      The command id of the message the response was for.
+         *
+         * @return the number of messages released.
+         */
+        int acknowledge(int commandId);
+
+        /**
+         * Releases all messages at the front of the cache with a sequence number less than
+         * or equal to the one given.
+         *
+         * @param sequence
+         *      The sequence number of the last message to release.
+         *
+         * @return the number of messages released.
+         */
+        int releaseUpTo(long long sequence);
+
+        /**
+         * Copies the cached messages into the given vector in the order they were sent.
+         *
+         * @param messages
+         *      The vector that receives the messages.
+         */
+        void getMessages(std::vector< decaf::lang::Pointer<commands::Command> >& messages) const;
+
+        /**
+         * @return the number of messages in the cache.
+         */
+        int size() const;
+
+        /**
+         * @return the total size in bytes of the messages in the cache.
+         */
+        long long getCurrentSize() const;
+
+        /**
+         * @return the number of messages the cache can hold before its ring has to grow.
+         */
+        int getCapacity() const;
+
+        /**
+         * Removes all messages from the cache.
+         */
+        void clear();
+
+    private:
+
+        Entry& at(std::size_t index) {
+            return ring[(head + index) & (ring.size() - 1)];
+        }
+
+        const Entry& at(std::size_t index) const {
+            return ring[(head + index) & (ring.size() - 1)];
+        }
+
+        void removeFirst();
+
+        void grow();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_STATE_MESSAGECACHE_H_ */
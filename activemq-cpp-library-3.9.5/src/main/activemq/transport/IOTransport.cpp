@@ -19,6 +19,8 @@
 
 #include <decaf/util/concurrent/Concurrent.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/lang/System.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/exceptions/ActiveMQException.h>
@@ -58,12 +60,44 @@ namespace transport {
         Pointer<decaf::lang::Thread> thread;
         AtomicBoolean closed;
         AtomicBoolean started;
-
-        IOTransportImpl() : wireFormat(), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false) {
+        AtomicBoolean readerStarted;
+        AtomicBoolean batching;
+        long long readSpinTime;
+        // Written by the reader thread, read by whoever collects the statistics.
+        AtomicInteger readSpinCount;
+        AtomicInteger readParkCount;
+
+        IOTransportImpl() : wireFormat(), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false),
+                            batching(false), readSpinTime(0), readSpinCount(0), readParkCount(0) {
         }
 
         IOTransportImpl(const Pointer<WireFormat> wireFormat) :
-            wireFormat(wireFormat), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false) {
+            wireFormat(wireFormat), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false),
+            batching(false), readSpinTime(0), readSpinCount(0), readParkCount(0) {
+        }
+
+        /**
+         * Busy waits for data to become available on the input stream for up to the
+         * configured spin time.  The stream's available method never blocks so the
+         * reader thread stays on CPU instead of sleeping in the kernel, if no data
+         * shows up in time the caller falls back to a normal blocking read.
+         */
+        void spinForInput() {
+
+            long long deadline = System::nanoTime() + readSpinTime * 1000;
+
+            while (started.get() && !closed.get()) {
+
+                if (inputStream->available() > 0) {
+                    readSpinCount.incrementAndGet();
+                    return;
+                }
+
+                if (System::nanoTime() >= deadline) {
+                    readParkCount.incrementAndGet();
+                    return;
+                }
+            }
         }
     };
 
@@ -126,8 +160,8 @@ void IOTransport::oneway(const Pointer<Command> command) {
             throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - transport is closed!");
         }
 
-        // Make sure the thread has been started.
-        if (impl->thread == NULL) {
+        // Make sure the reader has been started.
+        if (!impl->readerStarted.get()) {
             throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - transport is not started");
         }
 
@@ -144,7 +178,31 @@ void IOTransport::oneway(const Pointer<Command> command) {
         synchronized(impl->outputStream) {
             // Write the command to the output stream.
             this->impl->wireFormat->marshal(command, this, this->impl->outputStream);
-            this->impl->outputStream->flush();
+
+            if (!this->impl->batching.get()) {
+                this->impl->outputStream->flush();
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::beginBatch() {
+    this->impl->batching.set(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::endBatch() {
+
+    try {
+
+        if (impl->batching.compareAndSet(true, false) && impl->outputStream != NULL && !impl->closed.get()) {
+            synchronized(impl->outputStream) {
+                this->impl->outputStream->flush();
+            }
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -152,6 +210,11 @@ void IOTransport::oneway(const Pointer<Command> command) {
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::isBatching() const {
+    return this->impl->batching.get();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransport::start() {
 
@@ -169,9 +232,8 @@ void IOTransport::start() {
                         "IO streams and wireFormat instances must be set before calling start");
             }
 
-            // Start the polling thread.
-            impl->thread.reset(new Thread(this, "IOTransport reader Thread"));
-            impl->thread->start();
+            impl->readerStarted.set(true);
+            startReader();
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -179,6 +241,14 @@ void IOTransport::start() {
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::startReader() {
+
+    // Start the polling thread.
+    impl->thread.reset(new Thread(this, "IOTransport reader Thread"));
+    impl->thread->start();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransport::stop() {
 
@@ -267,6 +337,10 @@ void IOTransport::run() {
 
         while (this->impl->started.get() && !this->impl->closed.get()) {
 
+            if (impl->readSpinTime > 0) {
+                impl->spinForInput();
+            }
+
             // Read the next command from the input stream.
             Pointer<Command> command(impl->wireFormat->unmarshal(this, this->impl->inputStream));
 
@@ -336,6 +410,26 @@ TransportListener* IOTransport::getTransportListener() const {
     return this->impl->listener;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setReadSpinTime(long long readSpinTime) {
+    this->impl->readSpinTime = readSpinTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getReadSpinTime() const {
+    return this->impl->readSpinTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getReadSpinCount() const {
+    return this->impl->readSpinCount.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getReadParkCount() const {
+    return this->impl->readParkCount.get();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool IOTransport::isConnected() const {
     return !this->impl->closed.get();
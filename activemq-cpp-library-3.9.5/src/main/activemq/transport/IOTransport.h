@@ -69,7 +69,7 @@ namespace transport {
         IOTransport(const IOTransport&);
         IOTransport& operator=(const IOTransport&);
 
-    private:
+    protected:
 
         /**
          * Notify the exception listener
@@ -87,6 +87,14 @@ namespace transport {
          */
         void fire(const Pointer<Command> command);
 
+        /**
+         * Starts reading commands from the input stream, called once from start after
+         * the streams and WireFormat have been validated.  The default implementation
+         * starts a dedicated thread that runs this object's run method, subclasses can
+         * override this to have commands delivered by some other means.
+         */
+        virtual void startReader();
+
     public:
 
         /**
@@ -121,6 +129,51 @@ namespace transport {
          */
         virtual void setOutputStream(decaf::io::DataOutputStream* os);
 
+        /**
+         * Sets the time the reader thread spends busy waiting for new data before it
+         * blocks in a read, trading CPU for lower wake up latency.  A value of zero, the
+         * default, disables spinning.
+         *
+         * @param readSpinTime
+         *      The time to spin in microseconds.
+         */
+        void setReadSpinTime(long long readSpinTime);
+
+        /**
+         * @return the time in microseconds the reader thread spins before blocking.
+         */
+        long long getReadSpinTime() const;
+
+        /**
+         * @return the number of reads where data arrived while the reader thread was spinning.
+         */
+        long long getReadSpinCount() const;
+
+        /**
+         * @return the number of reads where the spin time ran out and the reader thread blocked.
+         */
+        long long getReadParkCount() const;
+
+        /**
+         * Stops oneway from flushing the output stream after each command so that a run
+         * of commands is coalesced into as few socket writes as the output buffer allows.
+         * Commands may sit in the buffer until endBatch is called.
+         */
+        void beginBatch();
+
+        /**
+         * Resumes flushing after every command and flushes anything written since the
+         * call to beginBatch.
+         *
+         * @throws IOException if an error occurs while flushing the output stream.
+         */
+        void endBatch();
+
+        /**
+         * @return true if writes are currently being batched.
+         */
+        bool isBatching() const;
+
     public:  // Transport methods
 
         virtual void oneway(const Pointer<Command> command);
@@ -52,6 +52,9 @@ namespace failover {
         // Is this Transport one of the priority backups.
         bool priority;
 
+        // Are registrations being mirrored to this Transport.
+        bool standby;
+
     private:
 
         BackupTransport(const BackupTransport&);
@@ -145,6 +148,23 @@ namespace failover {
         void setPriority(bool value) {
             this->priority = value;
         }
+
+        /**
+         * @return true if this transport is the warm standby that registrations are mirrored to.
+         */
+        bool isStandby() const {
+            return this->standby;
+        }
+
+        /**
+         * Set if this transport is the warm standby or not.
+         *
+         * @param value
+         *      True if registrations are mirrored to this transport.
+         */
+        void setStandby(bool value) {
+            this->standby = value;
+        }
     };
 
 }}}
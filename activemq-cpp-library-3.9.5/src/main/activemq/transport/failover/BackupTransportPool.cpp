@@ -24,6 +24,7 @@
 #include <activemq/transport/TransportRegistry.h>
 #include <activemq/transport/failover/FailoverTransport.h>
 
+#include <decaf/lang/System.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IllegalStateException.h>
 
@@ -102,7 +103,8 @@ BackupTransportPool::BackupTransportPool(FailoverTransport* parent,
                                                                                    updates(updates),
                                                                                    priorityUriPool(priorityUriPool),
                                                                                    backupPoolSize(1),
-                                                                                   enabled(false) {
+                                                                                   enabled(false),
+                                                                                   hotStandby(false) {
 
     if (parent == NULL) {
         throw NullPointerException(__FILE__, __LINE__, "Parent transport passed is NULL");
@@ -146,7 +148,8 @@ BackupTransportPool::BackupTransportPool(FailoverTransport* parent,
                                                                                    updates(updates),
                                                                                    priorityUriPool(priorityUriPool),
                                                                                    backupPoolSize(backupPoolSize),
-                                                                                   enabled(false) {
+                                                                                   enabled(false),
+                                                                                   hotStandby(false) {
 
     if (parent == NULL) {
         throw NullPointerException(__FILE__, __LINE__, "Parent transport passed is NULL");
@@ -196,6 +199,7 @@ void BackupTransportPool::close() {
         this->enabled = false;
         this->impl->closed = true;
         this->impl->backups.clear();
+        this->parent->stateTracker.setStandby(Pointer<Transport>());
     }
 }
 
@@ -213,6 +217,7 @@ void BackupTransportPool::setEnabled(bool value) {
     } else {
         synchronized(&this->impl->backups) {
             this->impl->backups.clear();
+            this->parent->stateTracker.setStandby(Pointer<Transport>());
         }
     }
 }
@@ -228,7 +233,19 @@ Pointer<BackupTransport> BackupTransportPool::getBackup() {
 
     synchronized(&this->impl->backups) {
         if (!this->impl->backups.isEmpty()) {
-            result = this->impl->backups.removeAt(0);
+            int index = 0;
+
+            // The standby has everything registered already so it is the cheapest to use.
+            if (this->hotStandby) {
+                for (int i = 0; i < this->impl->backups.size(); ++i) {
+                    if (this->impl->backups.get(i)->isStandby()) {
+                        index = i;
+                        break;
+                    }
+                }
+            }
+
+            result = this->impl->backups.removeAt(index);
         }
     }
 
@@ -282,13 +299,20 @@ bool BackupTransportPool::iterate() {
             Pointer<BackupTransport> backup(new BackupTransport(this));
             backup->setUri(connectTo);
 
+            Pointer<URIHealth> health = uriPool->getHealth();
+
             try {
+                long long connectStarted = System::currentTimeMillis();
                 Pointer<Transport> transport = createTransport(connectTo);
 
                 transport->setTransportListener(backup.get());
                 transport->start();
                 backup->setTransport(transport);
 
+                if (health != NULL) {
+                    health->connected(connectTo, System::currentTimeMillis() - connectStarted);
+                }
+
                 if (priorityUriPool->contains(connectTo) || (priorityUriPool->isEmpty() && uriPool->isPriority(connectTo))) {
                     backup->setPriority(true);
 
@@ -309,6 +333,9 @@ bool BackupTransportPool::iterate() {
             } catch (...) {
                 // Store it in the list of URIs that didn't work, once done we
                 // return those to the pool.
+                if (health != NULL) {
+                    health->failed(connectTo);
+                }
                 failures.add(connectTo);
             }
 
@@ -320,6 +347,10 @@ bool BackupTransportPool::iterate() {
             }
         }
 
+        if (this->hotStandby) {
+            electStandby();
+        }
+
         // return all failures to the URI Pool, we can try again later.
         uriPool->addURIs(failures);
 
@@ -334,22 +365,101 @@ void BackupTransportPool::onBackupTransportFailure(BackupTransport* failedTransp
 
     synchronized(&this->impl->backups) {
 
-        std::auto_ptr<Iterator<Pointer<BackupTransport> > > iter(this->impl->backups.iterator());
+        Pointer<BackupTransport> failed;
 
+        std::auto_ptr<Iterator<Pointer<BackupTransport> > > iter(this->impl->backups.iterator());
         while (iter->hasNext()) {
-            if (iter->next() == failedTransport) {
-                iter->remove();
+            Pointer<BackupTransport> backup = iter->next();
+            if (backup == failedTransport) {
+                failed = backup;
+                break;
             }
+        }
 
-            if (failedTransport->isPriority() && this->impl->priorityBackups > 0) {
-                this->impl->priorityBackups--;
-            }
+        // Already handed out or retired.
+        if (failed == NULL) {
+            return;
+        }
+
+        Pointer<URIHealth> health = this->uriPool->getHealth();
+        if (health != NULL) {
+            health->failed(failed->getUri());
+        }
+
+        // Build a new standby now rather than waiting for the next backup to be taken.
+        if (failed->isStandby()) {
+            this->impl->pending = true;
+        }
+
+        retire(failed);
+        this->taskRunner->wakeup();
+    }
+}
 
-            this->uriPool->addURI(failedTransport->getUri());
-            this->closeTask->add(failedTransport->getTransport());
-            this->taskRunner->wakeup();
+////////////////////////////////////////////////////////////////////////////////
+void BackupTransportPool::electStandby() {
+
+    Pointer<BackupTransport> current;
+
+    std::auto_ptr<Iterator<Pointer<BackupTransport> > > iter(this->impl->backups.iterator());
+    while (iter->hasNext()) {
+        Pointer<BackupTransport> backup = iter->next();
+        if (backup->isStandby()) {
+            current = backup;
+            break;
+        }
+    }
+
+    if (current != NULL) {
+
+        // A standby that missed a registration can't be used, and one that isn't a
+        // priority backup gives way as soon as a priority backup is connected.
+        bool broken = this->parent->stateTracker.getStandby() != current->getTransport();
+        bool outranked = !current->isPriority() && this->impl->priorityBackups > 0;
+
+        if (!broken && !outranked) {
+            return;
+        }
+
+        retire(current);
+        this->impl->pending = true;
+    }
+
+    // Priority backups are kept at the front of the list.
+    while (!this->impl->backups.isEmpty()) {
+
+        Pointer<BackupTransport> candidate = this->impl->backups.getFirst();
+
+        try {
+            this->parent->stateTracker.setStandby(candidate->getTransport());
+            candidate->setStandby(true);
+            return;
+        } catch (Exception&) {
+            retire(candidate);
+            this->impl->pending = true;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BackupTransportPool::retire(const Pointer<BackupTransport> backup) {
+
+    this->impl->backups.remove(backup);
+
+    if (backup->isPriority() && this->impl->priorityBackups > 0) {
+        this->impl->priorityBackups--;
+    }
+
+    if (backup->isStandby()) {
+        backup->setStandby(false);
+        if (this->parent->stateTracker.getStandby() == backup->getTransport()) {
+            this->parent->stateTracker.setStandby(Pointer<Transport>());
         }
     }
+
+    backup->setClosed(true);
+    this->uriPool->addURI(backup->getUri());
+    this->closeTask->add(backup->getTransport());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +56,7 @@ namespace failover {
         volatile int backupPoolSize;
         volatile bool enabled;
         volatile int maxReconnectDelay;
+        volatile bool hotStandby;
 
     public:
 
@@ -142,6 +143,23 @@ namespace failover {
          */
         bool isPriorityBackupAvailable() const;
 
+        bool isHotStandby() const {
+            return this->hotStandby;
+        }
+
+        /**
+         * Sets whether one of the backups, a priority backup when there is one, is kept as
+         * a warm standby that every connection, session, producer and consumer is also
+         * registered on.  Failing over to the standby then only has to start its consumers
+         * and replay what was in flight.  The standby is handed out first by getBackup.
+         *
+         * @param value
+         *      True to keep a warm standby.
+         */
+        void setHotStandby(bool value) {
+            this->hotStandby = value;
+        }
+
     private:
 
         // The backups report their failure to the pool, the pool removes them
@@ -151,6 +169,12 @@ namespace failover {
 
         Pointer<Transport> createTransport(const decaf::net::URI& location) const;
 
+        // Picks the backup that registrations are mirrored to, called with the backups locked.
+        void electStandby();
+
+        // Takes a backup out of the pool and closes it, called with the backups locked.
+        void retire(const Pointer<BackupTransport> backup);
+
     };
 
 }}}
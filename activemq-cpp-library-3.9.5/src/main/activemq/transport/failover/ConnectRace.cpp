@@ -0,0 +1,448 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConnectRace.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/transport/TransportFactory.h>
+#include <activemq/transport/TransportRegistry.h>
+#include <activemq/wireformat/openwire/OpenWireFormatNegotiator.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::failover;
+using namespace activemq::wireformat::openwire;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::net;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace failover {
+
+    class ConnectRaceState;
+
+    /**
+     * Listens to one candidate Transport, everything it reports is held until the
+     * race has been decided and then replayed to the listener it is handed to.
+     */
+    class RaceListener : public TransportListener {
+    private:
+
+        ConnectRaceState* state;
+        int index;
+
+        Mutex mutex;
+        LinkedList< Pointer<Command> > commands;
+        Pointer<Exception> error;
+        TransportListener* forward;
+
+    private:
+
+        RaceListener(const RaceListener&);
+        RaceListener& operator=(const RaceListener&);
+
+    public:
+
+        RaceListener(ConnectRaceState* state, int index) :
+            TransportListener(), state(state), index(index), mutex(), commands(), error(), forward(NULL) {
+        }
+
+        virtual ~RaceListener() {}
+
+        void handover(TransportListener* listener) {
+            synchronized(&mutex) {
+                while (!commands.isEmpty()) {
+                    listener->onCommand(commands.pop());
+                }
+
+                if (error != NULL) {
+                    listener->onException(*error);
+                    error.reset(NULL);
+                }
+
+                forward = listener;
+            }
+        }
+
+        virtual void onCommand(const Pointer<Command> command);
+
+        virtual void onException(const decaf::lang::Exception& ex);
+
+        virtual void transportInterrupted() {
+            TransportListener* listener = NULL;
+            synchronized(&mutex) {
+                listener = forward;
+            }
+
+            if (listener != NULL) {
+                listener->transportInterrupted();
+            }
+        }
+
+        virtual void transportResumed() {
+            TransportListener* listener = NULL;
+            synchronized(&mutex) {
+                listener = forward;
+            }
+
+            if (listener != NULL) {
+                listener->transportResumed();
+            }
+        }
+    };
+
+    class RaceCandidate {
+    private:
+
+        RaceCandidate(const RaceCandidate&);
+        RaceCandidate& operator=(const RaceCandidate&);
+
+    public:
+
+        URI uri;
+        Pointer<Transport> transport;
+        Pointer<RaceListener> listener;
+        bool started;
+        bool handshaken;
+        bool failed;
+
+        RaceCandidate(const URI& uri, RaceListener* listener) :
+            uri(uri), transport(), listener(listener), started(false), handshaken(false), failed(false) {
+        }
+    };
+
+    class ConnectRaceState {
+    private:
+
+        ConnectRaceState(const ConnectRaceState&);
+        ConnectRaceState& operator=(const ConnectRaceState&);
+
+    public:
+
+        Mutex mutex;
+        std::vector< Pointer<RaceCandidate> > candidates;
+        Pointer<CloseTransportsTask> closeTask;
+        Pointer<TransportListener> disposedListener;
+        Pointer<Exception> failure;
+        int winner;
+        int failures;
+        bool decided;
+
+        ConnectRaceState(const Pointer<CloseTransportsTask> closeTask, const Pointer<TransportListener> disposedListener) :
+            mutex(), candidates(), closeTask(closeTask), disposedListener(disposedListener),
+            failure(), winner(-1), failures(0), decided(false) {
+        }
+
+        bool isResolved() const {
+            return winner >= 0 || failures == (int) candidates.size();
+        }
+
+        /**
+         * Records a Transport that has started, returns false if the race was already
+         * decided in which case the caller is responsible for closing it.
+         */
+        bool transportStarted(int index, const Pointer<Transport> transport) {
+            synchronized(&mutex) {
+                if (decided) {
+                    return false;
+                }
+
+                RaceCandidate& candidate = *candidates[index];
+                candidate.transport = transport;
+                candidate.started = true;
+
+                // Without a negotiator there is no handshake to wait for.
+                if (transport->narrow(typeid(OpenWireFormatNegotiator)) == NULL) {
+                    candidate.handshaken = true;
+                }
+
+                if (candidate.handshaken && !candidate.failed && winner < 0) {
+                    winner = index;
+                }
+
+                mutex.notifyAll();
+            }
+
+            return true;
+        }
+
+        void handshakeCompleted(int index) {
+            synchronized(&mutex) {
+                RaceCandidate& candidate = *candidates[index];
+                candidate.handshaken = true;
+
+                if (candidate.started && !candidate.failed && winner < 0 && !decided) {
+                    winner = index;
+                }
+
+                mutex.notifyAll();
+            }
+        }
+
+        void attemptFailed(int index, const Exception& error) {
+            synchronized(&mutex) {
+                RaceCandidate& candidate = *candidates[index];
+
+                // An error on the winner is passed on when it is handed over.
+                if (candidate.failed || winner == index) {
+                    return;
+                }
+
+                candidate.failed = true;
+                failures++;
+                failure.reset(error.clone());
+
+                mutex.notifyAll();
+            }
+        }
+    };
+
+    /**
+     * Creates and starts the Transport for one candidate.
+     */
+    class ConnectAttempt : public Runnable {
+    private:
+
+        Pointer<ConnectRaceState> state;
+        int index;
+
+    private:
+
+        ConnectAttempt(const ConnectAttempt&);
+        ConnectAttempt& operator=(const ConnectAttempt&);
+
+    public:
+
+        ConnectAttempt(const Pointer<ConnectRaceState> state, int index) : Runnable(), state(state), index(index) {
+        }
+
+        virtual ~ConnectAttempt() {}
+
+        virtual void run() {
+
+            Pointer<RaceCandidate> candidate = state->candidates[index];
+            Pointer<Transport> transport;
+
+            try {
+
+                TransportFactory* factory =
+                    TransportRegistry::getInstance().findFactory(candidate->uri.getScheme());
+
+                if (factory == NULL) {
+                    throw IOException(__FILE__, __LINE__, "Invalid URI specified, no valid Factory Found.");
+                }
+
+                transport = factory->createComposite(candidate->uri);
+                transport->setTransportListener(candidate->listener.get());
+                transport->start();
+
+            } catch (Exception& ex) {
+                ex.setMark(__FILE__, __LINE__);
+                dispose(transport);
+                state->attemptFailed(index, ex);
+                return;
+            } catch (...) {
+                dispose(transport);
+                state->attemptFailed(index, ActiveMQException(
+                    __FILE__, __LINE__, "ConnectAttempt::run - caught unknown exception"));
+                return;
+            }
+
+            if (!state->transportStarted(index, transport)) {
+                dispose(transport);
+            }
+        }
+
+    private:
+
+        void dispose(Pointer<Transport> transport) {
+            if (transport != NULL) {
+                try {
+                    transport->setTransportListener(state->disposedListener.get());
+                    transport->close();
+                } catch (...) {
+                }
+            }
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    void RaceListener::onCommand(const Pointer<Command> command) {
+
+        TransportListener* listener = NULL;
+        synchronized(&mutex) {
+            listener = forward;
+            if (listener == NULL) {
+                commands.add(command);
+            }
+        }
+
+        if (listener != NULL) {
+            listener->onCommand(command);
+        } else if (command->isWireFormatInfo()) {
+            state->handshakeCompleted(index);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    void RaceListener::onException(const decaf::lang::Exception& ex) {
+
+        TransportListener* listener = NULL;
+        synchronized(&mutex) {
+            listener = forward;
+            if (listener == NULL && error == NULL) {
+                error.reset(ex.clone());
+            }
+        }
+
+        if (listener != NULL) {
+            listener->onException(ex);
+        } else {
+            state->attemptFailed(index, ex);
+        }
+    }
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+ConnectRace::ConnectRace(const List<URI>& candidates,
+                         const Pointer<CloseTransportsTask> closeTask,
+                         const Pointer<TransportListener> disposedListener) :
+    state(new ConnectRaceState(closeTask, disposedListener)) {
+
+    if (disposedListener == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Disposed TransportListener passed is NULL");
+    }
+
+    Pointer< Iterator<URI> > iter(candidates.iterator());
+    while (iter->hasNext()) {
+        int index = (int) this->state->candidates.size();
+        this->state->candidates.push_back(Pointer<RaceCandidate>(
+            new RaceCandidate(iter->next(), new RaceListener(this->state.get(), index))));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConnectRace::~ConnectRace() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectRace::start(ExecutorService& executor) {
+
+    for (int i = 0; i < (int) this->state->candidates.size(); ++i) {
+        try {
+            executor.execute(new ConnectAttempt(this->state, i));
+        } catch (Exception& ex) {
+            this->state->attemptFailed(i, ex);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ConnectRace::await(long long timeout) {
+
+    synchronized(&this->state->mutex) {
+        if (!this->state->isResolved() && timeout > 0) {
+            this->state->mutex.wait(timeout);
+        }
+
+        return this->state->isResolved();
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> ConnectRace::decide(bool abandon, URI& uri, LinkedList<URI>& failures, Pointer<Exception>& failure) {
+
+    Pointer<Transport> result;
+    std::vector< Pointer<Transport> > losers;
+
+    synchronized(&this->state->mutex) {
+
+        this->state->decided = true;
+
+        int winner = abandon ? -1 : this->state->winner;
+
+        // Nobody finished the handshake in time, use the first Transport that started
+        // as a sequential connect would have.
+        if (!abandon && winner < 0) {
+            for (int i = 0; i < (int) this->state->candidates.size(); ++i) {
+                if (this->state->candidates[i]->started && !this->state->candidates[i]->failed) {
+                    winner = i;
+                    break;
+                }
+            }
+        }
+
+        this->state->winner = winner;
+
+        for (int i = 0; i < (int) this->state->candidates.size(); ++i) {
+            RaceCandidate& candidate = *this->state->candidates[i];
+
+            if (i == winner) {
+                uri = candidate.uri;
+                result = candidate.transport;
+            } else {
+                failures.add(candidate.uri);
+                if (candidate.transport != NULL) {
+                    losers.push_back(candidate.transport);
+                    candidate.transport.reset(NULL);
+                }
+            }
+        }
+
+        if (this->state->failure != NULL) {
+            failure = this->state->failure;
+        }
+    }
+
+    std::vector< Pointer<Transport> >::iterator iter = losers.begin();
+    for (; iter != losers.end(); ++iter) {
+        (*iter)->setTransportListener(this->state->disposedListener.get());
+        this->state->closeTask->add(*iter);
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectRace::handover(TransportListener* listener) {
+
+    int winner = -1;
+    synchronized(&this->state->mutex) {
+        winner = this->state->winner;
+    }
+
+    if (winner >= 0) {
+        this->state->candidates[winner]->listener->handover(listener);
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_FAILOVER_CONNECTRACE_H_
+#define _ACTIVEMQ_TRANSPORT_FAILOVER_CONNECTRACE_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/Transport.h>
+#include <activemq/transport/TransportListener.h>
+#include <activemq/transport/failover/CloseTransportsTask.h>
+
+#include <decaf/net/URI.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Exception.h>
+#include <decaf/util/List.h>
+#include <decaf/util/LinkedList.h>
+#include <decaf/util/concurrent/ExecutorService.h>
+
+namespace activemq {
+namespace transport {
+namespace failover {
+
+    using decaf::lang::Pointer;
+
+    class ConnectRaceState;
+
+    /**
+     * Connects to several broker URIs at the same time and keeps the first Transport
+     * that completes its WireFormatInfo handshake, the others are closed.  Transports
+     * without a WireFormat negotiator win as soon as they have started.
+     *
+     * Each connect attempt runs on the given Executor so that a dead broker only costs
+     * its own connect timeout, attempts that are still running when the race has been
+     * decided close their Transport themselves once it has started.  Commands that the
+     * winning Transport receives before it is handed over are held and replayed to the
+     * listener passed to handover.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API ConnectRace {
+    private:
+
+        Pointer<ConnectRaceState> state;
+
+    private:
+
+        ConnectRace(const ConnectRace&);
+        ConnectRace& operator=(const ConnectRace&);
+
+    public:
+
+        /**
+         * Creates a new race between the given URIs.
+         *
+         * @param candidates
+         *      The URIs to connect to.
+         * @param closeTask
+         *      The task that losing Transports are handed to once the race is decided.
+         * @param disposedListener
+         *      The listener set on losing Transports before they are closed, it has to
+         *      outlive the close as the losers are closed after the race is gone.
+         *
+         * @throws NullPointerException if the disposed listener is NULL.
+         */
+        ConnectRace(const decaf::util::List<decaf::net::URI>& candidates,
+                    const Pointer<CloseTransportsTask> closeTask,
+                    const Pointer<TransportListener> disposedListener);
+
+        virtual ~ConnectRace();
+
+        /**
+         * Submits one connect attempt per candidate URI to the given Executor.
+         *
+         * @param executor
+         *      The Executor that runs the connect attempts.
+         */
+        void start(decaf::util::concurrent::ExecutorService& executor);
+
+        /**
+         * Waits for a Transport to win the race or for every attempt to fail.
+         *
+         * @param timeout
+         *      The maximum time to wait in milliseconds.
+         *
+         * @return true if the race can be decided.
+         */
+        bool await(long long timeout);
+
+        /**
+         * Decides the race.  If no Transport has completed its handshake then the first
+         * one that started is used, every other Transport is handed to the close task.
+         *
+         * @param abandon
+         *      If true there is no winner and every Transport is closed.
+         * @param uri
+         *      Set to the URI of the winning Transport.
+         * @param failures
+         *      Receives the URIs of every candidate other than the winner.
+         * @param failure
+         *      Set to the last error reported by a failed attempt.
+         *
+         * @return the winning Transport or NULL if there is none.
+         */
+        Pointer<Transport> decide(bool abandon, decaf::net::URI& uri,
+                                  decaf::util::LinkedList<decaf::net::URI>& failures,
+                                  Pointer<decaf::lang::Exception>& failure);
+
+        /**
+         * Replays everything the winning Transport has received so far to the given
+         * listener and forwards any later events to it until the Transport's listener
+         * is replaced.
+         *
+         * @param listener
+         *      The listener that receives the winning Transport's events.
+         */
+        void handover(TransportListener* listener);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_FAILOVER_CONNECTRACE_H_ */
@@ -21,21 +21,30 @@
 #include <activemq/commands/ShutdownInfo.h>
 #include <activemq/commands/RemoveInfo.h>
 #include <activemq/transport/TransportRegistry.h>
+#include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/threads/DedicatedTaskRunner.h>
 #include <activemq/threads/CompositeTaskRunner.h>
 #include <activemq/transport/failover/BackupTransportPool.h>
 #include <activemq/transport/failover/URIPool.h>
 #include <activemq/transport/failover/FailoverTransportListener.h>
 #include <activemq/transport/failover/CloseTransportsTask.h>
-#include <activemq/transport/failover/URIPool.h>
+#include <activemq/transport/failover/ConnectRace.h>
+#include <activemq/transport/failover/URIHealth.h>
+#include <activemq/util/URISupport.h>
+#include <activemq/wireformat/openwire/OpenWireFormatNegotiator.h>
 #include <decaf/util/Random.h>
 #include <decaf/util/StringTokenizer.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/StlMap.h>
 #include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/lang/System.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/Math.h>
 
 using namespace std;
 using namespace activemq;
@@ -45,14 +54,44 @@ using namespace activemq::exceptions;
 using namespace activemq::threads;
 using namespace activemq::transport;
 using namespace activemq::transport::failover;
+using namespace activemq::wireformat::openwire;
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::net;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CloseTransportRunnable : public Runnable {
+    private:
+
+        Pointer<Transport> transport;
+
+    private:
+
+        CloseTransportRunnable(const CloseTransportRunnable&);
+        CloseTransportRunnable& operator= (const CloseTransportRunnable&);
+
+    public:
+
+        CloseTransportRunnable(const Pointer<Transport> transport) : Runnable(), transport(transport) {}
+
+        virtual ~CloseTransportRunnable() {}
+
+        virtual void run() {
+            try {
+                transport->close();
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq {
 namespace transport {
@@ -68,6 +107,7 @@ namespace failover {
 
         static const int DEFAULT_INITIAL_RECONNECT_DELAY;
         static const int INFINITE_WAIT;
+        static const int RACE_POLL_INTERVAL;
 
     public:
 
@@ -89,6 +129,9 @@ namespace failover {
         bool trackTransactionProducers;
         int maxCacheSize;
         int maxPullCacheSize;
+        int raceConnectCount;
+        bool pipelineRestore;
+        long long healthFailureHalfLife;
         bool connectionInterruptProcessingComplete;
         bool firstConnection;
         bool updateURIsSupported;
@@ -104,6 +147,7 @@ namespace failover {
         mutable Mutex reconnectMutex;
         mutable Mutex sleepMutex;
         mutable Mutex listenerMutex;
+        mutable Mutex healthMutex;
 
         StlMap<int, Pointer<Command> > requestMap;
 
@@ -113,14 +157,38 @@ namespace failover {
         Pointer<URI> connectedTransportURI;
         Pointer<Transport> connectedTransport;
         Pointer<Exception> connectionFailure;
+        // Set on transports handed to the close task, declared first so it outlives them.
+        Pointer<TransportListener> disposedListener;
         Pointer<BackupTransportPool> backups;
         Pointer<CloseTransportsTask> closeTask;
         Pointer<CompositeTaskRunner> taskRunner;
-        Pointer<TransportListener> disposedListener;
         Pointer<TransportListener> myTransportListener;
 
         TransportListener* transportListener;
 
+        // Sends made while connected bypass the reconnectMutex.  The transport they use
+        // is only changed while the fast path is closed and no sender is still inside
+        // it, so senders can copy it without a lock.  Senders stuck in a write when
+        // the fast path is closed are failed out by closing the transport on its own
+        // executor, the closing thread may be the one the transport close would join.
+        AtomicBoolean fastPathOpen;
+        AtomicInteger fastPathSenders;
+        Pointer<Transport> fastPathTransport;
+        Mutex fastPathMutex;
+        Pointer<ExecutorService> fastPathCloser;
+
+        // Connect attempts made when racing several URIs, the last race is kept so the
+        // listener it handed the winning transport over with outlives any event that
+        // was being delivered when the transport's listener was replaced.
+        Pointer<ThreadPoolExecutor> connectExecutor;
+        Pointer<ConnectRace> lastRace;
+
+        // Scores kept per URI when brokers are selected by health, the connect whose
+        // WireFormatInfo has not arrived yet is remembered so its handshake can be timed.
+        Pointer<URIHealth> health;
+        Pointer<URI> handshakeURI;
+        long long handshakeStarted;
+
         FailoverTransportImpl(FailoverTransport* parent) :
             closed(false),
             connected(false),
@@ -139,6 +207,9 @@ namespace failover {
             trackTransactionProducers(true),
             maxCacheSize(128*1024),
             maxPullCacheSize(10),
+            raceConnectCount(1),
+            pipelineRestore(false),
+            healthFailureHalfLife(30000),
             connectionInterruptProcessingComplete(false),
             firstConnection(true),
             updateURIsSupported(true),
@@ -152,6 +223,7 @@ namespace failover {
             reconnectMutex(),
             sleepMutex(),
             listenerMutex(),
+            healthMutex(),
             requestMap(),
             uris(new URIPool()),
             priorityUris(new URIPool()),
@@ -159,12 +231,22 @@ namespace failover {
             connectedTransportURI(),
             connectedTransport(),
             connectionFailure(),
+            disposedListener(new DefaultTransportListener()),
             backups(),
             closeTask(new CloseTransportsTask()),
             taskRunner(new CompositeTaskRunner()),
-            disposedListener(),
             myTransportListener(new FailoverTransportListener(parent)),
-            transportListener(NULL) {
+            transportListener(NULL),
+            fastPathOpen(false),
+            fastPathSenders(0),
+            fastPathTransport(),
+            fastPathMutex(),
+            fastPathCloser(),
+            connectExecutor(),
+            lastRace(),
+            health(),
+            handshakeURI(),
+            handshakeStarted(0) {
 
             this->backups.reset(
                 new BackupTransportPool(parent, taskRunner, closeTask, uris, updated, priorityUris));
@@ -256,7 +338,60 @@ namespace failover {
             return connectedTransport != NULL && !doRebalance && !backups->isPriorityBackupAvailable();
         }
 
+        /**
+         * Publishes a newly connected transport for use by senders outside the lock,
+         * must be called with the reconnect mutex locked once its state is restored.
+         */
+        void openFastPath(const Pointer<Transport> transport) {
+            fastPathTransport = transport;
+            fastPathOpen.set(true);
+        }
+
+        /**
+         * Called by each sender as it leaves the fast path, the last one out wakes
+         * a thread waiting in closeFastPath.
+         */
+        void leaveFastPath() {
+            if (fastPathSenders.decrementAndGet() == 0 && !fastPathOpen.get()) {
+                synchronized(&fastPathMutex) {
+                    fastPathMutex.notifyAll();
+                }
+            }
+        }
+
+        /**
+         * Stops new sends from using the fast path and waits for those already in it
+         * to finish so the connection state is stable, must be called with the
+         * reconnect mutex locked before the connected transport is replaced.  If any
+         * sender is still writing its transport is closed first so that a write stuck
+         * on a stalled connection fails instead of holding up the reconnect.
+         */
+        void closeFastPath() {
+            if (fastPathOpen.compareAndSet(true, false)) {
+                synchronized(&fastPathMutex) {
+                    if (fastPathSenders.get() > 0) {
+                        if (fastPathCloser == NULL) {
+                            fastPathCloser.reset(new ThreadPoolExecutor(1, 1, 5, TimeUnit::SECONDS,
+                                                                        new LinkedBlockingQueue<Runnable*>()));
+                        }
+                        fastPathCloser->execute(new CloseTransportRunnable(fastPathTransport));
+                    }
+
+                    try {
+                        while (fastPathSenders.get() > 0) {
+                            fastPathMutex.wait();
+                        }
+                    } catch (InterruptedException& ex) {
+                        Thread::currentThread()->interrupt();
+                    }
+                }
+                fastPathTransport.reset(NULL);
+            }
+        }
+
         void disconnect() {
+            closeFastPath();
+
             Pointer<Transport> transport;
             transport.swap(this->connectedTransport);
 
@@ -280,13 +415,132 @@ namespace failover {
             }
         }
 
+        /**
+         * Notes that a connect to the given URI began at the given time so that the
+         * handshake can be timed when the broker's WireFormatInfo arrives.
+         */
+        void expectHandshake(const URI& uri, long long started) {
+            synchronized(&healthMutex) {
+                if (health != NULL) {
+                    handshakeURI.reset(new URI(uri));
+                    handshakeStarted = started;
+                }
+            }
+        }
+
+        void connectFailed(const URI& uri) {
+            synchronized(&healthMutex) {
+                if (health != NULL) {
+                    health->failed(uri);
+                    handshakeURI.reset(NULL);
+                }
+            }
+        }
+
         bool willReconnect() {
             return firstConnection || 0 != calculateReconnectAttemptLimit();
         }
+
+        /**
+         * Returns how long a race between the given URIs may take, the longest connect
+         * timeout set on any of them plus the time allowed for the WireFormatInfo
+         * handshake.  URIs without a connect timeout only count the handshake.
+         */
+        long long getRaceTimeout(const LinkedList<URI>& candidates) const {
+
+            long long connectTimeout = 0;
+
+            Pointer< Iterator<URI> > iter(candidates.iterator());
+            while (iter->hasNext()) {
+                try {
+                    Properties properties = activemq::util::URISupport::parseQuery(iter->next().getQuery());
+                    connectTimeout = Math::max(connectTimeout,
+                        (long long) Integer::parseInt(properties.getProperty("soConnectTimeout", "0")));
+                } catch (Exception& ex) {
+                    // The attempt reports the bad URI itself.
+                }
+            }
+
+            return connectTimeout + OpenWireFormatNegotiator::getNegotiationTimeout();
+        }
+
+        /**
+         * Returns the executor for race connect attempts with one thread per URI raced,
+         * resizing it if the race connect count has changed since it was created.
+         */
+        ThreadPoolExecutor& getConnectExecutor() {
+
+            if (connectExecutor == NULL) {
+                connectExecutor.reset(new ThreadPoolExecutor(raceConnectCount, raceConnectCount, 5, TimeUnit::SECONDS,
+                                                             new LinkedBlockingQueue<Runnable*>()));
+            } else if (connectExecutor->getMaximumPoolSize() < raceConnectCount) {
+                connectExecutor->setMaximumPoolSize(raceConnectCount);
+                connectExecutor->setCorePoolSize(raceConnectCount);
+            } else if (connectExecutor->getMaximumPoolSize() > raceConnectCount) {
+                connectExecutor->setCorePoolSize(raceConnectCount);
+                connectExecutor->setMaximumPoolSize(raceConnectCount);
+            }
+
+            return *connectExecutor;
+        }
+
+        /**
+         * Connects to up to raceConnectCount URIs from the given pool at once and returns
+         * the first transport to complete its handshake, already started and delivering
+         * to our own listener.  The URIs of every other candidate are added to failures,
+         * returns NULL if none of them could connect.  Must be called with the reconnect
+         * mutex locked, it is released while the attempts are running.
+         */
+        Pointer<Transport> raceConnect(const Pointer<URIPool> connectList, URI& uri,
+                                       LinkedList<URI>& failures, Pointer<Exception>& failure) {
+
+            LinkedList<URI> candidates;
+            while (candidates.size() < raceConnectCount && !connectList->isEmpty()) {
+                try {
+                    candidates.add(connectList->getURI());
+                } catch (NoSuchElementException& ex) {
+                    break;
+                }
+            }
+
+            lastRace.reset(new ConnectRace(candidates, closeTask, disposedListener));
+            lastRace->start(getConnectExecutor());
+
+            // Wait on the reconnect mutex so that senders and close are not held up
+            // for as long as the slowest candidate takes.
+            long long started = System::currentTimeMillis();
+            long long deadline = started + getRaceTimeout(candidates);
+            while (!lastRace->await(0) && !closed && System::currentTimeMillis() < deadline) {
+                try {
+                    reconnectMutex.wait(RACE_POLL_INTERVAL);
+                } catch (InterruptedException& ex) {
+                    Thread::currentThread()->interrupt();
+                    break;
+                }
+            }
+
+            Pointer<Transport> transport = lastRace->decide(closed, uri, failures, failure);
+            taskRunner->wakeup();
+
+            if (transport != NULL) {
+                synchronized(&healthMutex) {
+                    if (health != NULL) {
+                        health->connected(uri, System::currentTimeMillis() - started);
+                    }
+                }
+
+                expectHandshake(uri, started);
+                lastRace->handover(myTransportListener.get());
+                transport->setTransportListener(myTransportListener.get());
+            }
+
+            return transport;
+        }
     };
 
     const int FailoverTransportImpl::DEFAULT_INITIAL_RECONNECT_DELAY = 10;
     const int FailoverTransportImpl::INFINITE_WAIT = -1;
+    const int FailoverTransportImpl::RACE_POLL_INTERVAL = 10;
 
 }}}
 
@@ -396,11 +650,96 @@ std::string FailoverTransport::getRemoteAddress() const {
     return "";
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool FailoverTransport::onewayWhileConnected(const Pointer<Command> command) {
+
+    // Announce this sender before checking the gate so that a thread closing it
+    // either sees us and waits or we see it closed and take the slow path.
+    this->impl->fastPathSenders.incrementAndGet();
+
+    if (!this->impl->fastPathOpen.get() || this->impl->closed) {
+        this->impl->leaveFastPath();
+        return false;
+    }
+
+    Pointer<Transport> transport = this->impl->fastPathTransport;
+    Pointer<Tracked> tracked;
+
+    // If it was a request and it was not being tracked by the state
+    // tracker, then hold it in the requestMap so that we can replay
+    // it later.
+    try {
+        tracked = stateTracker.track(command);
+        synchronized(&this->impl->requestMap) {
+            if (tracked != NULL && tracked->isWaitingForResponse()) {
+                this->impl->requestMap.put(command->getCommandId(), tracked);
+            } else if (tracked == NULL && command->isResponseRequired()) {
+                this->impl->requestMap.put(command->getCommandId(), command);
+            }
+        }
+    } catch (Exception& ex) {
+        this->impl->leaveFastPath();
+        ex.setMark(__FILE__, __LINE__);
+        throw IOException(ex);
+    }
+
+    try {
+        transport->oneway(command);
+        stateTracker.trackBack(command);
+        if (command->isShutdownInfo()) {
+            this->impl->shutdown = true;
+        }
+
+    } catch (IOException& e) {
+
+        e.setMark(__FILE__, __LINE__);
+
+        // If the fast path was closed under us the thread that closed it is already
+        // replacing the transport, failing over again could dispose of its new one.
+        bool superseded = !this->impl->fastPathOpen.get();
+
+        // Leave the fast path before failing over, that has to wait for it to drain.
+        this->impl->leaveFastPath();
+
+        // If the command was not tracked.. it is retried on the slow path once
+        // reconnected, take it out of the request map so that it is not sent
+        // 2 times on recovery.
+        bool retry = tracked == NULL && this->impl->canReconnect();
+        if (retry && command->isResponseRequired()) {
+            synchronized(&this->impl->requestMap) {
+                this->impl->requestMap.remove(command->getCommandId());
+            }
+        }
+
+        if (!superseded) {
+            handleTransportFailure(e);
+        }
+
+        return !retry;
+
+    } catch (...) {
+        this->impl->leaveFastPath();
+        throw;
+    }
+
+    this->impl->leaveFastPath();
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void FailoverTransport::oneway(const Pointer<Command> command) {
 
     Pointer<Exception> error;
 
+    try {
+        if (command != NULL && onewayWhileConnected(command)) {
+            return;
+        }
+    } catch (InterruptedException& ex) {
+        Thread::currentThread()->interrupt();
+        throw InterruptedIOException(__FILE__, __LINE__, "FailoverTransport oneway() interrupted");
+    }
+
     try {
 
         synchronized(&this->impl->reconnectMutex) {
@@ -575,7 +914,7 @@ void FailoverTransport::start() {
 
             this->impl->started = true;
 
-            if (this->impl->backupsEnabled || this->impl->priorityBackup) {
+            if (this->impl->backupsEnabled || this->impl->priorityBackup || this->impl->backups->isHotStandby()) {
                 this->impl->backups->setEnabled(true);
             }
             this->impl->taskRunner->start();
@@ -584,6 +923,7 @@ void FailoverTransport::start() {
             stateTracker.setMaxMessagePullCacheSize(this->getMaxPullCacheSize());
             stateTracker.setTrackMessages(this->isTrackMessages());
             stateTracker.setTrackTransactionProducers(this->isTrackTransactionProducers());
+            stateTracker.setPipelineRestore(this->isPipelineRestore());
 
             if (this->impl->connectedTransport != NULL) {
                 stateTracker.restore(this->impl->connectedTransport);
@@ -630,6 +970,15 @@ void FailoverTransport::close() {
 
             this->impl->backups->setEnabled(false);
             this->impl->requestMap.clear();
+            this->impl->closeFastPath();
+
+            if (this->impl->connectExecutor != NULL) {
+                this->impl->connectExecutor->shutdown();
+            }
+
+            if (this->impl->fastPathCloser != NULL) {
+                this->impl->fastPathCloser->shutdown();
+            }
 
             if (this->impl->connectedTransport != NULL) {
                 transportToStop.swap(this->impl->connectedTransport);
@@ -688,7 +1037,12 @@ void FailoverTransport::restoreTransport(const Pointer<Transport> transport) {
         cc->setFaultTolerant(true);
         transport->oneway(cc);
 
-        stateTracker.restore(transport);
+        // A standby already has everything registered on it.
+        if (stateTracker.getStandby() == transport) {
+            stateTracker.promoteStandby(transport);
+        } else {
+            stateTracker.restore(transport);
+        }
 
         decaf::util::StlMap<int, Pointer<Command> > commands;
         synchronized(&this->impl->requestMap) {
@@ -720,6 +1074,8 @@ void FailoverTransport::handleTransportFailure(const decaf::lang::Exception& err
             return;
         }
 
+        this->impl->closeFastPath();
+
         Pointer<Transport> transport;
         this->impl->connectedTransport.swap(transport);
 
@@ -736,6 +1092,7 @@ void FailoverTransport::handleTransportFailure(const decaf::lang::Exception& err
             URI failedUri = *this->impl->connectedTransportURI;
 
             this->impl->initialized = false;
+            this->impl->connectFailed(failedUri);
             this->impl->uris->addURI(failedUri);
             this->impl->connectedTransportURI.reset(NULL);
             this->impl->connected = false;
@@ -944,26 +1301,51 @@ bool FailoverTransport::iterate() {
                 while ((transport != NULL || !connectList->isEmpty()) && this->impl->connectedTransport == NULL && !this->impl->closed) {
                     try {
                         // We could be starting the loop with a backup already.
-                        if (transport == NULL) {
-                            try {
-                                uri = connectList->getURI();
-                            } catch (NoSuchElementException& ex) {
-                                break;
+                        if (transport == NULL && this->impl->raceConnectCount > 1) {
+                            transport = this->impl->raceConnect(connectList, uri, failures, failure);
+                            if (transport == NULL) {
+                                continue;
+                            }
+                        } else {
+                            long long connectStarted = 0;
+
+                            if (transport == NULL) {
+                                try {
+                                    uri = connectList->getURI();
+                                } catch (NoSuchElementException& ex) {
+                                    break;
+                                }
+
+                                connectStarted = System::currentTimeMillis();
+                                this->impl->expectHandshake(uri, connectStarted);
+                                transport = createTransport(uri);
                             }
 
-                            transport = createTransport(uri);
-                        }
+                            transport->setTransportListener(this->impl->myTransportListener.get());
+                            transport->start();
 
-                        transport->setTransportListener(this->impl->myTransportListener.get());
-                        transport->start();
+                            if (connectStarted != 0) {
+                                synchronized(&this->impl->healthMutex) {
+                                    if (this->impl->health != NULL) {
+                                        this->impl->health->connected(uri, System::currentTimeMillis() - connectStarted);
+                                    }
+                                }
+                            }
+                        }
 
                         if (this->impl->started && !this->impl->firstConnection) {
                             restoreTransport(transport);
                         }
 
+                        // Stop mirroring to a standby that was connected to without a restore.
+                        if (stateTracker.getStandby() == transport) {
+                            stateTracker.setStandby(Pointer<Transport>());
+                        }
+
                         this->impl->reconnectDelay = this->impl->initialReconnectDelay;
                         this->impl->connectedTransportURI.reset(new URI(uri));
                         this->impl->connectedTransport = transport;
+                        this->impl->openFastPath(transport);
                         this->impl->reconnectMutex.notifyAll();
                         this->impl->connectFailures = 0;
                         this->impl->connected = true;
@@ -1021,6 +1403,7 @@ bool FailoverTransport::iterate() {
                             transport.reset(NULL);
                         }
 
+                        this->impl->connectFailed(uri);
                         failures.add(uri);
                         failure.reset(e.clone());
                     }
@@ -1131,7 +1514,12 @@ void FailoverTransport::processResponse(const Pointer<Response> response) {
         }
     }
 
-    if (object != NULL) {
+    if (object != NULL && object->isMessage()) {
+        try {
+            stateTracker.messageAcknowledged(object->getCommandId());
+        }
+        AMQ_CATCHALL_NOTHROW()
+    } else if (object != NULL) {
         try {
             Pointer<Tracked> tracked = object.dynamicCast<Tracked>();
             tracked->onResponse();
@@ -1263,6 +1651,115 @@ void FailoverTransport::setBackupPoolSize(int value) {
     this->impl->backups->setBackupPoolSize(value);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool FailoverTransport::isHotStandby() const {
+    return this->impl->backups->isHotStandby();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setHotStandby(bool value) {
+    this->impl->backups->setHotStandby(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FailoverTransport::getRaceConnectCount() const {
+    return this->impl->raceConnectCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setRaceConnectCount(int value) {
+    this->impl->raceConnectCount = value < 1 ? 1 : value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FailoverTransport::isPipelineRestore() const {
+    return this->impl->pipelineRestore;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setPipelineRestore(bool value) {
+    this->impl->pipelineRestore = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getLastRestoreDuration() const {
+    return this->stateTracker.getLastRestoreDuration();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FailoverTransport::getMessageCacheCount() const {
+    return this->stateTracker.getMessageCacheCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getMessageCacheSize() const {
+    return this->stateTracker.getMessageCacheSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FailoverTransport::isHealthSelection() const {
+    synchronized(&this->impl->healthMutex) {
+        return this->impl->health != NULL;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setHealthSelection(bool value) {
+
+    synchronized(&this->impl->healthMutex) {
+
+        if (value && this->impl->health == NULL) {
+            this->impl->health.reset(new URIHealth());
+            this->impl->health->setFailureHalfLife(this->impl->healthFailureHalfLife);
+        } else if (!value) {
+            this->impl->health.reset(NULL);
+            this->impl->handshakeURI.reset(NULL);
+        }
+
+        this->impl->uris->setHealth(this->impl->health);
+        this->impl->updated->setHealth(this->impl->health);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getHealthFailureHalfLife() const {
+    return this->impl->healthFailureHalfLife;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setHealthFailureHalfLife(long long value) {
+
+    synchronized(&this->impl->healthMutex) {
+        this->impl->healthFailureHalfLife = value;
+        if (this->impl->health != NULL) {
+            this->impl->health->setFailureHalfLife(value);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<URIHealth> FailoverTransport::getURIHealth() const {
+    synchronized(&this->impl->healthMutex) {
+        return this->impl->health;
+    }
+
+    return Pointer<URIHealth>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::handshakeCompleted() {
+
+    synchronized(&this->impl->healthMutex) {
+        if (this->impl->health != NULL && this->impl->handshakeURI != NULL) {
+            this->impl->health->handshakeCompleted(
+                *this->impl->handshakeURI, System::currentTimeMillis() - this->impl->handshakeStarted);
+            this->impl->handshakeURI.reset(NULL);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool FailoverTransport::isTrackMessages() const {
     return this->impl->trackMessages;
@@ -26,6 +26,7 @@
 #include <activemq/threads/CompositeTaskRunner.h>
 #include <activemq/state/ConnectionStateTracker.h>
 #include <activemq/transport/CompositeTransport.h>
+#include <activemq/transport/failover/URIHealth.h>
 #include <activemq/wireformat/WireFormat.h>
 
 #include <decaf/util/List.h>
@@ -200,6 +201,96 @@ namespace failover {
 
         void setBackupPoolSize(int value);
 
+        bool isHotStandby() const;
+
+        /**
+         * Sets whether a backup transport is kept as a warm standby.  Every connection,
+         * session, producer and consumer is registered on the standby as it is created,
+         * consumers with a prefetch of zero, so that failing over to it only needs the
+         * consumers' prefetch to be raised and the in-flight messages and transactions to
+         * be replayed.  Enabling this also enables backups.
+         *
+         * @param value
+         *      True to keep a warm standby.
+         */
+        void setHotStandby(bool value);
+
+        /**
+         * @return the number of URIs that are connected to at once when reconnecting.
+         */
+        int getRaceConnectCount() const;
+
+        /**
+         * Sets the number of URIs that are connected to at the same time when there is
+         * no backup transport to fall back on.  The first to complete the WireFormatInfo
+         * handshake is kept and the others are closed, so a reconnect takes as long as
+         * the fastest live broker instead of the sum of the connect timeouts of the dead
+         * ones in front of it.  The default of 1 tries each URI in turn.  A race is
+         * given the longest soConnectTimeout of the URIs raced plus the WireFormatInfo
+         * negotiation timeout, after that the first Transport to have started is used.
+         *
+         * @param value
+         *      The number of URIs to race, values less than 1 are treated as 1.
+         */
+        void setRaceConnectCount(int value);
+
+        bool isPipelineRestore() const;
+
+        /**
+         * Sets whether the connection state replayed after a reconnect is written as one
+         * coalesced batch instead of flushing the new transport after every command.
+         *
+         * @param value
+         *      True to pipeline the restore of the connection state.
+         */
+        void setPipelineRestore(bool value);
+
+        /**
+         * @return the time in milliseconds it took to replay the connection state the
+         *         last time it was restored.
+         */
+        long long getLastRestoreDuration() const;
+
+        /**
+         * @return the number of sent messages held for replay after a failover.
+         */
+        int getMessageCacheCount() const;
+
+        /**
+         * @return the total size in bytes of the sent messages held for replay.
+         */
+        long long getMessageCacheSize() const;
+
+        bool isHealthSelection() const;
+
+        /**
+         * Sets whether URIs are chosen by their health instead of in order or at random.
+         * The time taken to connect and to complete the handshake and recent failures
+         * are scored for each URI, the lowest scoring URI that has not failed repeatedly
+         * is connected to first and backups are made to the best scoring brokers.
+         *
+         * @param value
+         *      True to select brokers by their health scores.
+         */
+        void setHealthSelection(bool value);
+
+        long long getHealthFailureHalfLife() const;
+
+        /**
+         * Sets the time in milliseconds for the weight of a failed connection to halve
+         * when brokers are selected by health.
+         *
+         * @param value
+         *      The half life of a failure in milliseconds.
+         */
+        void setHealthFailureHalfLife(long long value);
+
+        /**
+         * @return the health scores kept for each URI, or NULL if brokers are not selected
+         *         by health.
+         */
+        Pointer<URIHealth> getURIHealth() const;
+
         bool isTrackMessages() const;
 
         void setTrackMessages(bool value);
@@ -242,6 +333,12 @@ namespace failover {
 
     protected:
 
+        /**
+         * Called when the broker's WireFormatInfo arrives on a new connection so that
+         * the handshake time can be added to the broker's health score.
+         */
+        void handshakeCompleted();
+
         /**
          * Given a Transport restore the state of the Client's connection to the Broker
          * using the data accumulated in the State Tracker.
@@ -286,6 +383,14 @@ namespace failover {
 
         void processResponse(const Pointer<Response> response);
 
+        /**
+         * Sends the command on the connected transport without taking the reconnect
+         * mutex, this is the path taken by all sends while the connection is healthy.
+         *
+         * @return false if not connected or the send should be retried on the slow path.
+         */
+        bool onewayWhileConnected(const Pointer<Command> command);
+
     };
 
 }}}
@@ -95,6 +95,16 @@ Pointer<Transport> FailoverTransportFactory::doCreateComposite(const decaf::net:
             Boolean::parseBoolean(topLvlProperties.getProperty("backup", "false")));
         transport->setBackupPoolSize(
             Integer::parseInt(topLvlProperties.getProperty("backupPoolSize", "1")));
+        transport->setHotStandby(
+            Boolean::parseBoolean(topLvlProperties.getProperty("hotStandby", "false")));
+        transport->setRaceConnectCount(
+            Integer::parseInt(topLvlProperties.getProperty("raceConnectCount", "1")));
+        transport->setPipelineRestore(
+            Boolean::parseBoolean(topLvlProperties.getProperty("pipelineRestore", "false")));
+        transport->setHealthFailureHalfLife(
+            Long::parseLong(topLvlProperties.getProperty("healthFailureHalfLife", "30000")));
+        transport->setHealthSelection(
+            Boolean::parseBoolean(topLvlProperties.getProperty("healthSelection", "false")));
         transport->setTimeout(
             Long::parseLong(topLvlProperties.getProperty("timeout", "-1")));
         transport->setTrackMessages(
@@ -63,6 +63,10 @@ void FailoverTransportListener::onCommand(const Pointer<Command> command) {
         parent->handleConnectionControl(command);
     }
 
+    if (command->isWireFormatInfo()) {
+        parent->handshakeCompleted();
+    }
+
     if (parent->getTransportListener() != NULL) {
         parent->getTransportListener()->onCommand(command);
     }
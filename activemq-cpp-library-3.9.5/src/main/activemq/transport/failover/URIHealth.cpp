@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "URIHealth.h"
+
+#include <decaf/lang/System.h>
+
+#include <memory>
+#include <math.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::failover;
+using namespace decaf;
+using namespace decaf::net;
+using namespace decaf::util;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Weight given to the newest sample in the moving averages.
+    const double SAMPLE_WEIGHT = 0.3;
+
+    double average(double current, long long sample, bool measured) {
+        if (!measured) {
+            return (double) sample;
+        }
+
+        return current + SAMPLE_WEIGHT * ((double) sample - current);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+URIHealth::URIHealth() : mutex(), scores(), failureHalfLife(30000), quarantineThreshold(3.0), failurePenalty(1000) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+URIHealth::~URIHealth() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealth::connected(const URI& uri, long long connectTime) {
+
+    synchronized(&mutex) {
+        Score& score = scores[uri.toString()];
+        score.connectTime = average(score.connectTime, connectTime, score.measured);
+
+        // The round trip time starts out as the connect time until the first
+        // handshake is measured.
+        if (!score.measured) {
+            score.roundTripTime = (double) connectTime;
+        }
+
+        score.measured = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealth::handshakeCompleted(const URI& uri, long long roundTripTime) {
+
+    synchronized(&mutex) {
+        Score& score = scores[uri.toString()];
+        score.roundTripTime = average(score.roundTripTime, roundTripTime, score.measured);
+        score.measured = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealth::failed(const URI& uri) {
+
+    long long now = System::currentTimeMillis();
+
+    synchronized(&mutex) {
+        Score& score = scores[uri.toString()];
+        score.failures = decayedFailures(score, now) + 1.0;
+        score.lastFailure = now;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double URIHealth::getScore(const URI& uri) const {
+
+    long long now = System::currentTimeMillis();
+
+    synchronized(&mutex) {
+        std::map<std::string, Score>::const_iterator iter = scores.find(uri.toString());
+        if (iter != scores.end()) {
+            return scoreOf(iter->second, now);
+        }
+    }
+
+    return 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URIHealth::isQuarantined(const URI& uri) const {
+
+    long long now = System::currentTimeMillis();
+
+    synchronized(&mutex) {
+        std::map<std::string, Score>::const_iterator iter = scores.find(uri.toString());
+        if (iter != scores.end()) {
+            return decayedFailures(iter->second, now) >= quarantineThreshold;
+        }
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int URIHealth::select(const List<URI>& uris) const {
+
+    long long now = System::currentTimeMillis();
+
+    int best = -1;
+    double bestScore = 0;
+    int leastFailed = -1;
+    double leastFailures = 0;
+
+    synchronized(&mutex) {
+
+        std::auto_ptr<Iterator<URI> > iter(uris.iterator());
+        for (int index = 0; iter->hasNext(); ++index) {
+
+            std::map<std::string, Score>::const_iterator entry = scores.find(iter->next().toString());
+
+            Score unknown;
+            const Score& score = entry != scores.end() ? entry->second : unknown;
+
+            double failures = decayedFailures(score, now);
+            if (leastFailed < 0 || failures < leastFailures) {
+                leastFailed = index;
+                leastFailures = failures;
+            }
+
+            if (failures >= quarantineThreshold) {
+                continue;
+            }
+
+            double value = scoreOf(score, now);
+            if (best < 0 || value < bestScore) {
+                best = index;
+                bestScore = value;
+            }
+        }
+    }
+
+    return best >= 0 ? best : leastFailed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealth::setFailureHalfLife(long long failureHalfLife) {
+    synchronized(&mutex) {
+        this->failureHalfLife = failureHalfLife;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long URIHealth::getFailureHalfLife() const {
+    synchronized(&mutex) {
+        return this->failureHalfLife;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealth::setQuarantineThreshold(double quarantineThreshold) {
+    synchronized(&mutex) {
+        this->quarantineThreshold = quarantineThreshold;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double URIHealth::getQuarantineThreshold() const {
+    synchronized(&mutex) {
+        return this->quarantineThreshold;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealth::setFailurePenalty(long long failurePenalty) {
+    synchronized(&mutex) {
+        this->failurePenalty = failurePenalty;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long URIHealth::getFailurePenalty() const {
+    synchronized(&mutex) {
+        return this->failurePenalty;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double URIHealth::decayedFailures(const Score& score, long long now) const {
+
+    if (score.failures <= 0) {
+        return 0;
+    }
+
+    if (failureHalfLife <= 0) {
+        return score.failures;
+    }
+
+    long long elapsed = now - score.lastFailure;
+    if (elapsed <= 0) {
+        return score.failures;
+    }
+
+    return score.failures * ::pow(0.5, (double) elapsed / (double) failureHalfLife);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double URIHealth::scoreOf(const Score& score, long long now) const {
+    return score.connectTime + score.roundTripTime + decayedFailures(score, now) * (double) failurePenalty;
+}
@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_FAILOVER_URIHEALTH_H_
+#define _ACTIVEMQ_TRANSPORT_FAILOVER_URIHEALTH_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/net/URI.h>
+#include <decaf/util/List.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+#include <string>
+
+namespace activemq {
+namespace transport {
+namespace failover {
+
+    /**
+     * Keeps a health score for each broker URI so that a URIPool can hand out the
+     * broker that is most likely to connect quickly.  The score is a moving average
+     * of the time it took to connect and to complete the WireFormatInfo handshake,
+     * plus a penalty for recent failures.  Failures decay with a configurable half
+     * life and a URI whose decayed failure count reaches the quarantine threshold is
+     * only used when no healthy URI is left.
+     *
+     * URIs that have never been scored are preferred so that every broker is tried
+     * at least once.  This class is thread safe.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API URIHealth {
+    private:
+
+        struct Score {
+            double connectTime;
+            double roundTripTime;
+            double failures;
+            long long lastFailure;
+            bool measured;
+
+            Score() : connectTime(0), roundTripTime(0), failures(0), lastFailure(0), measured(false) {}
+        };
+
+        mutable decaf::util::concurrent::Mutex mutex;
+        std::map<std::string, Score> scores;
+
+        long long failureHalfLife;
+        double quarantineThreshold;
+        long long failurePenalty;
+
+    private:
+
+        URIHealth(const URIHealth&);
+        URIHealth& operator=(const URIHealth&);
+
+    public:
+
+        URIHealth();
+
+        virtual ~URIHealth();
+
+        /**
+         * Records the time it took to establish a connection to the given URI.
+         *
+         * @param uri
+         *      The URI that was connected to.
+         * @param connectTime
+         *      The time taken to connect in milliseconds.
+         */
+        void connected(const decaf::net::URI& uri, long long connectTime);
+
+        /**
+         * Records the time it took the broker at the given URI to complete the
+         * WireFormatInfo handshake.
+         *
+         * @param uri
+         *      The URI that was connected to.
+         * @param roundTripTime
+         *      The time taken for the handshake in milliseconds.
+         */
+        void handshakeCompleted(const decaf::net::URI& uri, long long roundTripTime);
+
+        /**
+         * Records a failed connect attempt or the loss of a connection to the given URI.
+         *
+         * @param uri
+         *      The URI that failed.
+         */
+        void failed(const decaf::net::URI& uri);
+
+        /**
+         * @return the current score of the URI, lower is better.
+         */
+        double getScore(const decaf::net::URI& uri) const;
+
+        /**
+         * @return true if the URI has failed often enough recently to be avoided.
+         */
+        bool isQuarantined(const decaf::net::URI& uri) const;
+
+        /**
+         * Picks the URI from the list that should be connected to next, that is the one
+         * with the lowest score that is not quarantined.  If every URI is quarantined the
+         * one with the fewest recent failures is picked.  Ties go to the earliest URI in
+         * the list.
+         *
+         * @param uris
+         *      The candidate URIs.
+         *
+         * @return the index of the chosen URI or -1 if the list is empty.
+         */
+        int select(const decaf::util::List<decaf::net::URI>& uris) const;
+
+        /**
+         * Sets the time it takes for the weight of a failure to halve.
+         *
+         * @param failureHalfLife
+         *      The half life in milliseconds.
+         */
+        void setFailureHalfLife(long long failureHalfLife);
+
+        long long getFailureHalfLife() const;
+
+        /**
+         * Sets the decayed number of failures at which a URI is quarantined.
+         *
+         * @param quarantineThreshold
+         *      The failure count at which a URI is avoided.
+         */
+        void setQuarantineThreshold(double quarantineThreshold);
+
+        double getQuarantineThreshold() const;
+
+        /**
+         * Sets how many milliseconds each recent failure adds to a URI's score.
+         *
+         * @param failurePenalty
+         *      The penalty in milliseconds.
+         */
+        void setFailurePenalty(long long failurePenalty);
+
+        long long getFailurePenalty() const;
+
+    private:
+
+        double decayedFailures(const Score& score, long long now) const;
+
+        double scoreOf(const Score& score, long long now) const;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_FAILOVER_URIHEALTH_H_ */
@@ -31,11 +31,11 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
-URIPool::URIPool() : uriPool(), priorityURI(), randomize(false) {
+URIPool::URIPool() : uriPool(), priorityURI(), randomize(false), health() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-URIPool::URIPool(const decaf::util::List<URI>& uris) : uriPool(), priorityURI(), randomize(false) {
+URIPool::URIPool(const decaf::util::List<URI>& uris) : uriPool(), priorityURI(), randomize(false), health() {
     this->uriPool.copy(uris);
 
     if (!this->uriPool.isEmpty()) {
@@ -44,7 +44,7 @@ URIPool::URIPool(const decaf::util::List<URI>& uris) : uriPool(), priorityURI(),
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-URIPool::URIPool(const URIPool& uris) : uriPool(), priorityURI(), randomize(false) {
+URIPool::URIPool(const URIPool& uris) : uriPool(), priorityURI(), randomize(false), health(uris.health) {
     synchronized(&uris.uriPool) {
         this->uriPool.copy(uris.uriPool);
     }
@@ -79,7 +79,18 @@ URI URIPool::getURI() {
 
             int index = 0; // Take the first one in the list unless random is on.
 
-            if (isRandomize()) {
+            if (this->health != NULL) {
+                if (isRandomize()) {
+                    // Rotate the list to a random start so that ties go to a random URI.
+                    Random rand;
+                    rand.setSeed(decaf::lang::System::currentTimeMillis());
+                    for (int i = rand.nextInt((int) uriPool.size()); i > 0; --i) {
+                        uriPool.add(uriPool.removeAt(0));
+                    }
+                }
+
+                index = this->health->select(uriPool);
+            } else if (isRandomize()) {
                 Random rand;
                 rand.setSeed(decaf::lang::System::currentTimeMillis());
                 index = rand.nextInt((int) uriPool.size());
@@ -19,7 +19,9 @@
 #define _ACTIVEMQ_TRANSPORT_FAILOVER_URIPOOL_H_
 
 #include <activemq/util/Config.h>
+#include <activemq/transport/failover/URIHealth.h>
 
+#include <decaf/lang/Pointer.h>
 #include <decaf/net/URI.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/NoSuchElementException.h>
@@ -34,6 +36,7 @@ namespace failover {
         mutable decaf::util::LinkedList<decaf::net::URI> uriPool;
         decaf::net::URI priorityURI;
         bool randomize;
+        decaf::lang::Pointer<URIHealth> health;
 
     public:
 
@@ -162,6 +165,25 @@ namespace failover {
             this->randomize = value;
         }
 
+        /**
+         * @return the health scores used to pick URIs, or NULL if none are used.
+         */
+        decaf::lang::Pointer<URIHealth> getHealth() const {
+            return this->health;
+        }
+
+        /**
+         * Sets the health scores used to choose which URI getURI returns.  When set the
+         * URI with the best score is handed out and the randomize setting only breaks
+         * ties between URIs that have never been scored.
+         *
+         * @param health
+         *      The health scores to use, or NULL to pick URIs in order or at random.
+         */
+        void setHealth(const decaf::lang::Pointer<URIHealth> health) {
+            this->health = health;
+        }
+
         /**
          * Returns true if the given URI is contained in this set of URIs.
          *
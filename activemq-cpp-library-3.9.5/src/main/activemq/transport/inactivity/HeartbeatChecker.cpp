@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HeartbeatChecker.h"
+
+#include <activemq/transport/inactivity/InactivityMonitor.h>
+
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::inactivity;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+HeartbeatChecker::HeartbeatChecker(InactivityMonitor* parent) : TimerTask(), parent(parent) {
+
+    if (this->parent == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "HeartbeatChecker created with NULL parent.");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HeartbeatChecker::~HeartbeatChecker() {}
+
+////////////////////////////////////////////////////////////////////////////////
+void HeartbeatChecker::run() {
+    this->parent->heartbeatCheck();
+}
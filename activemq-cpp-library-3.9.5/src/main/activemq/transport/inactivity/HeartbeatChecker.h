@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_INACTIVITY_HEARTBEATCHECKER_H_
+#define _ACTIVEMQ_TRANSPORT_INACTIVITY_HEARTBEATCHECKER_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/util/TimerTask.h>
+
+namespace activemq {
+namespace transport {
+namespace inactivity {
+
+    class InactivityMonitor;
+
+    /**
+     * Runnable class that is used by the {@see InactivityMonitor} class to send
+     * heartbeats to the peer and count the ones that go unanswered.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API HeartbeatChecker : public decaf::util::TimerTask {
+    private:
+
+        HeartbeatChecker(const HeartbeatChecker&);
+        HeartbeatChecker operator=(const HeartbeatChecker&);
+
+    private:
+
+        // The Inactivity Monitor that created this Heartbeat Checker.
+        InactivityMonitor* parent;
+
+    public:
+
+        HeartbeatChecker(InactivityMonitor* parent);
+        virtual ~HeartbeatChecker();
+
+        virtual void run();
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_INACTIVITY_HEARTBEATCHECKER_H_ */
@@ -19,6 +19,8 @@
 
 #include "ReadChecker.h"
 #include "WriteChecker.h"
+#include "HeartbeatChecker.h"
+#include "RoundTripHistogram.h"
 
 #include <activemq/threads/CompositeTask.h>
 #include <activemq/threads/CompositeTaskRunner.h>
@@ -32,6 +34,9 @@
 #include <decaf/lang/Thread.h>
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/Boolean.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/System.h>
 
 using namespace std;
 using namespace activemq;
@@ -71,9 +76,11 @@ namespace inactivity {
 
         Pointer<ReadChecker> readCheckerTask;
         Pointer<WriteChecker> writeCheckerTask;
+        Pointer<HeartbeatChecker> heartbeatCheckerTask;
 
         Timer readCheckTimer;
         Timer writeCheckTimer;
+        Timer heartbeatTimer;
 
         Pointer<CompositeTaskRunner> asyncTasks;
 
@@ -98,14 +105,28 @@ namespace inactivity {
 
         bool keepAliveResponseRequired;
 
+        // Heartbeats, only one is outstanding at a time and it is matched to its
+        // reply by command id.
+        long long heartbeatInterval;
+        int heartbeatMaxMissed;
+        AtomicInteger missedHeartbeats;
+        AtomicBoolean heartbeatReceived;
+        Mutex heartbeatMutex;
+        bool heartbeatOutstanding;
+        int heartbeatId;
+        long long heartbeatSent;
+        RoundTripHistogram roundTripTimes;
+
         InactivityMonitorData(const Pointer<WireFormat> wireFormat) :
             wireFormat(wireFormat),
             localWireFormatInfo(),
             remoteWireFormatInfo(),
             readCheckerTask(),
             writeCheckerTask(),
+            heartbeatCheckerTask(),
             readCheckTimer("InactivityMonitor Read Check Timer"),
             writeCheckTimer("InactivityMonitor Write Check Timer"),
+            heartbeatTimer("InactivityMonitor Heartbeat Timer"),
             asyncTasks(),
             asyncReadTask(),
             asyncWriteTask(),
@@ -120,7 +141,16 @@ namespace inactivity {
             readCheckTime(0),
             writeCheckTime(0),
             initialDelayTime(0),
-            keepAliveResponseRequired(false) {
+            keepAliveResponseRequired(false),
+            heartbeatInterval(0),
+            heartbeatMaxMissed(3),
+            missedHeartbeats(),
+            heartbeatReceived(),
+            heartbeatMutex(),
+            heartbeatOutstanding(false),
+            heartbeatId(0),
+            heartbeatSent(0),
+            roundTripTimes() {
         }
     };
 
@@ -131,6 +161,7 @@ namespace inactivity {
         InactivityMonitor* parent;
         std::string remote;
         AtomicBoolean failed;
+        AtomicBoolean heartbeatsMissed;
 
     private:
 
@@ -140,13 +171,18 @@ namespace inactivity {
     public:
 
         AsyncSignalReadErrorkTask(InactivityMonitor* parent, const std::string& remote) :
-            parent(parent), remote(remote), failed() {
+            parent(parent), remote(remote), failed(), heartbeatsMissed() {
         }
 
         void setFailed(bool failed) {
             this->failed.set(failed);
         }
 
+        void setHeartbeatsMissed() {
+            this->heartbeatsMissed.set(true);
+            this->failed.set(true);
+        }
+
         virtual bool isPending() const {
             return this->failed.get();
         }
@@ -154,8 +190,9 @@ namespace inactivity {
         virtual bool iterate() {
 
             if (this->failed.compareAndSet(true, false)) {
-                IOException ex(__FILE__, __LINE__,
-                    (std::string("Channel was inactive for too long: ") + remote).c_str());
+                std::string reason = this->heartbeatsMissed.get() ?
+                    "Channel missed too many heartbeats: " : "Channel was inactive for too long: ";
+                IOException ex(__FILE__, __LINE__, (reason + remote).c_str());
                 this->parent->onException(ex);
             }
 
@@ -169,6 +206,7 @@ namespace inactivity {
 
         InactivityMonitor* parent;
         AtomicBoolean write;
+        AtomicBoolean heartbeat;
 
     private:
 
@@ -177,14 +215,18 @@ namespace inactivity {
 
     public:
 
-        AsyncWriteTask(InactivityMonitor* parent) : parent(parent), write() {}
+        AsyncWriteTask(InactivityMonitor* parent) : parent(parent), write(), heartbeat() {}
 
         void setWrite( bool write ) {
             this->write.set( write );
         }
 
+        void setHeartbeat(bool heartbeat) {
+            this->heartbeat.set(heartbeat);
+        }
+
         virtual bool isPending() const {
-            return this->write.get();
+            return this->write.get() || this->heartbeat.get();
         }
 
         virtual bool iterate() {
@@ -199,7 +241,15 @@ namespace inactivity {
                 }
             }
 
-            return this->write.get();
+            if (this->heartbeat.compareAndSet(true, false) && this->parent->members->monitorStarted.get()) {
+                try {
+                    this->parent->sendHeartbeat();
+                } catch (IOException& e) {
+                    this->parent->onException(e);
+                }
+            }
+
+            return isPending();
         }
     };
 
@@ -215,6 +265,8 @@ InactivityMonitor::InactivityMonitor(const Pointer<Transport> next, const decaf:
     TransportFilter(next), members(new InactivityMonitorData(wireFormat)) {
 
     this->members->keepAliveResponseRequired = Boolean::parseBoolean(properties.getProperty("keepAliveResponseRequired", "false"));
+    this->members->heartbeatInterval = Long::parseLong(properties.getProperty("heartbeatInterval", "0"));
+    this->members->heartbeatMaxMissed = Integer::parseInt(properties.getProperty("heartbeatMaxMissed", "3"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -270,6 +322,36 @@ void InactivityMonitor::setKeepAliveResponseRequired(bool value) {
     this->members->keepAliveResponseRequired = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long InactivityMonitor::getHeartbeatInterval() const {
+    return this->members->heartbeatInterval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitor::setHeartbeatInterval(long long value) {
+    this->members->heartbeatInterval = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int InactivityMonitor::getHeartbeatMaxMissed() const {
+    return this->members->heartbeatMaxMissed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitor::setHeartbeatMaxMissed(int value) {
+    this->members->heartbeatMaxMissed = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int InactivityMonitor::getMissedHeartbeats() const {
+    return this->members->missedHeartbeats.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const RoundTripHistogram& InactivityMonitor::getRoundTripHistogram() const {
+    return this->members->roundTripTimes;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void InactivityMonitor::afterNextIsStarted() {
     try {
@@ -313,10 +395,17 @@ void InactivityMonitor::onException(const decaf::lang::Exception& ex) {
 void InactivityMonitor::onCommand(const Pointer<Command> command) {
 
     this->members->commandReceived.set(true);
+    this->members->heartbeatReceived.set(true);
     this->members->inRead.set(true);
 
     try {
 
+        // Replies to our own heartbeats are not passed on.
+        if (command->isKeepAliveInfo() && heartbeatAnswered(command)) {
+            this->members->inRead.set(false);
+            return;
+        }
+
         if (command->isWireFormatInfo()) {
             synchronized(&this->members->monitor) {
 
@@ -419,6 +508,74 @@ void InactivityMonitor::writeCheck() {
     this->members->commandSent.set(false);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitor::heartbeatCheck() {
+
+    bool outstanding = false;
+    synchronized(&this->members->heartbeatMutex) {
+        outstanding = this->members->heartbeatOutstanding;
+    }
+
+    // Anything received since the last check shows the peer is alive even if the
+    // heartbeat reply is queued behind it.
+    bool received = this->members->heartbeatReceived.getAndSet(false);
+
+    if (outstanding) {
+
+        if (!received && !this->members->inRead.get() && !this->members->wireFormat->inReceive() &&
+            this->members->missedHeartbeats.incrementAndGet() >= this->members->heartbeatMaxMissed) {
+
+            this->members->asyncReadTask->setHeartbeatsMissed();
+            this->members->asyncTasks->wakeup();
+        }
+
+        return;
+    }
+
+    this->members->asyncWriteTask->setHeartbeat(true);
+    this->members->asyncTasks->wakeup();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitor::sendHeartbeat() {
+
+    Pointer<KeepAliveInfo> info(new KeepAliveInfo());
+    info->setResponseRequired(true);
+
+    synchronized(&this->members->heartbeatMutex) {
+        info->setCommandId(++this->members->heartbeatId);
+        this->members->heartbeatOutstanding = true;
+        this->members->heartbeatSent = System::nanoTime();
+    }
+
+    this->oneway(info);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool InactivityMonitor::heartbeatAnswered(const Pointer<Command> command) {
+
+    if (command->isResponseRequired()) {
+        return false;
+    }
+
+    long long roundTrip = 0;
+
+    synchronized(&this->members->heartbeatMutex) {
+
+        if (!this->members->heartbeatOutstanding || command->getCommandId() != this->members->heartbeatId) {
+            return false;
+        }
+
+        this->members->heartbeatOutstanding = false;
+        roundTrip = (System::nanoTime() - this->members->heartbeatSent) / 1000;
+    }
+
+    this->members->missedHeartbeats.set(0);
+    this->members->roundTripTimes.record(roundTrip);
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void InactivityMonitor::startMonitorThreads() {
 
@@ -460,6 +617,15 @@ void InactivityMonitor::startMonitorThreads() {
             this->members->writeCheckTimer.scheduleAtFixedRate(this->members->writeCheckerTask, this->members->initialDelayTime, this->members->writeCheckTime);
             this->members->readCheckTimer.scheduleAtFixedRate(this->members->readCheckerTask, this->members->initialDelayTime, this->members->readCheckTime);
         }
+
+        if (this->members->heartbeatInterval > 0) {
+
+            this->members->monitorStarted.set(true);
+            this->members->heartbeatCheckerTask.reset(new HeartbeatChecker(this));
+
+            this->members->heartbeatTimer.scheduleAtFixedRate(this->members->heartbeatCheckerTask,
+                this->members->heartbeatInterval, this->members->heartbeatInterval);
+        }
     }
 }
 
@@ -470,13 +636,21 @@ void InactivityMonitor::stopMonitorThreads() {
 
         synchronized(&this->members->monitor) {
 
-            this->members->readCheckerTask->cancel();
-            this->members->writeCheckerTask->cancel();
+            if (this->members->readCheckerTask != NULL) {
+                this->members->readCheckerTask->cancel();
+                this->members->writeCheckerTask->cancel();
+            }
+
+            if (this->members->heartbeatCheckerTask != NULL) {
+                this->members->heartbeatCheckerTask->cancel();
+            }
 
             this->members->readCheckTimer.purge();
             this->members->readCheckTimer.cancel();
             this->members->writeCheckTimer.purge();
             this->members->writeCheckTimer.cancel();
+            this->members->heartbeatTimer.purge();
+            this->members->heartbeatTimer.cancel();
 
             this->members->asyncTasks->shutdown();
         }
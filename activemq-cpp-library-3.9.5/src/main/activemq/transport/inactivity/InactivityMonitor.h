@@ -35,6 +35,8 @@ namespace inactivity {
 
     class ReadChecker;
     class WriteChecker;
+    class HeartbeatChecker;
+    class RoundTripHistogram;
     class AsyncSignalReadErrorkTask;
     class AsyncWriteTask;
     class InactivityMonitorData;
@@ -48,6 +50,7 @@ namespace inactivity {
         friend class ReadChecker;
         friend class AsyncSignalReadErrorkTask;
         friend class WriteChecker;
+        friend class HeartbeatChecker;
         friend class AsyncWriteTask;
 
     private:
@@ -92,6 +95,41 @@ namespace inactivity {
 
         void setInitialDelayTime(long long value) const;
 
+        long long getHeartbeatInterval() const;
+
+        /**
+         * Sets the interval in milliseconds at which a KeepAliveInfo that requires a
+         * reply is sent to the peer once the WireFormatInfo exchange is done.  A value
+         * of zero, the default, disables heartbeats and leaves only the read and write
+         * checks based on the negotiated maximum inactivity duration.
+         *
+         * @param value
+         *      The heartbeat interval in milliseconds.
+         */
+        void setHeartbeatInterval(long long value);
+
+        int getHeartbeatMaxMissed() const;
+
+        /**
+         * Sets the number of heartbeat intervals in a row that may pass without the
+         * peer answering the outstanding heartbeat or sending anything else before
+         * the connection is failed.
+         *
+         * @param value
+         *      The number of heartbeats that may be missed.
+         */
+        void setHeartbeatMaxMissed(int value);
+
+        /**
+         * @return the number of heartbeat intervals missed since the last heartbeat reply.
+         */
+        int getMissedHeartbeats() const;
+
+        /**
+         * @return the round trip times of the heartbeats that have been answered.
+         */
+        const RoundTripHistogram& getRoundTripHistogram() const;
+
     protected:
 
         virtual void afterNextIsStarted();
@@ -111,6 +149,15 @@ namespace inactivity {
         // Perform a Write Check on the current connection, called from a separate Thread.
         void writeCheck();
 
+        // Counts a missed heartbeat if needed and sends the next, called from a separate Thread.
+        void heartbeatCheck();
+
+        // Sends a heartbeat that the peer must answer.
+        void sendHeartbeat();
+
+        // Records the reply to the outstanding heartbeat, returns false if it wasn't one.
+        bool heartbeatAnswered(const Pointer<Command> command);
+
         // Stops all the monitoring Threads, cannot restart once called.
         void stopMonitorThreads();
 
@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RoundTripHistogram.h"
+
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::inactivity;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+RoundTripHistogram::RoundTripHistogram() : mutex(), buckets(), count(0), total(0), minimum(0), maximum(0), last(0) {
+    reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RoundTripHistogram::~RoundTripHistogram() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RoundTripHistogram::record(long long micros) {
+
+    if (micros < 0) {
+        micros = 0;
+    }
+
+    int index = 0;
+    while (index < BUCKET_COUNT - 1 && micros >= getBucketUpperBound(index)) {
+        index++;
+    }
+
+    synchronized(&mutex) {
+        buckets[index]++;
+        total += micros;
+        minimum = count == 0 || micros < minimum ? micros : minimum;
+        maximum = micros > maximum ? micros : maximum;
+        last = micros;
+        count++;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getCount() const {
+    synchronized(&mutex) {
+        return count;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getBucket(int index) const {
+
+    if (index < 0 || index >= BUCKET_COUNT) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "Invalid histogram bucket: %d", index);
+    }
+
+    synchronized(&mutex) {
+        return buckets[index];
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getBucketUpperBound(int index) {
+
+    if (index < 0 || index >= BUCKET_COUNT) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "Invalid histogram bucket: %d", index);
+    }
+
+    return 2LL << index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getMinimum() const {
+    synchronized(&mutex) {
+        return minimum;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getMaximum() const {
+    synchronized(&mutex) {
+        return maximum;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getMean() const {
+    synchronized(&mutex) {
+        return count == 0 ? 0 : total / count;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getLast() const {
+    synchronized(&mutex) {
+        return last;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RoundTripHistogram::getPercentile(double percentile) const {
+
+    synchronized(&mutex) {
+
+        if (count == 0) {
+            return 0;
+        }
+
+        long long wanted = (long long) ((double) count * percentile / 100.0 + 0.5);
+        if (wanted < 1) {
+            wanted = 1;
+        } else if (wanted > count) {
+            wanted = count;
+        }
+
+        long long seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets[i];
+            if (seen >= wanted) {
+                long long bound = getBucketUpperBound(i);
+                return bound < maximum ? bound : maximum;
+            }
+        }
+
+        return maximum;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RoundTripHistogram::reset() {
+    synchronized(&mutex) {
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] = 0;
+        }
+
+        count = 0;
+        total = 0;
+        minimum = 0;
+        maximum = 0;
+        last = 0;
+    }
+}
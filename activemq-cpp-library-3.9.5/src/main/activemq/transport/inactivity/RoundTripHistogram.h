@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_INACTIVITY_ROUNDTRIPHISTOGRAM_H_
+#define _ACTIVEMQ_TRANSPORT_INACTIVITY_ROUNDTRIPHISTOGRAM_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/util/concurrent/Mutex.h>
+
+namespace activemq {
+namespace transport {
+namespace inactivity {
+
+    /**
+     * Records round trip times in buckets whose bounds double from one bucket to the
+     * next, bucket zero holds samples under two microseconds and bucket N holds the
+     * samples from 2^N up to 2^(N+1) microseconds.  The last bucket also holds every
+     * sample too large for the others.
+     *
+     * This class is thread safe.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API RoundTripHistogram {
+    public:
+
+        static const int BUCKET_COUNT = 32;
+
+    private:
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        long long buckets[BUCKET_COUNT];
+        long long count;
+        long long total;
+        long long minimum;
+        long long maximum;
+        long long last;
+
+    private:
+
+        RoundTripHistogram(const RoundTripHistogram&);
+        RoundTripHistogram& operator=(const RoundTripHistogram&);
+
+    public:
+
+        RoundTripHistogram();
+
+        virtual ~RoundTripHistogram();
+
+        /**
+         * Adds a sample to the histogram.
+         *
+         * @param micros
+         *      The round trip time in microseconds.
+         */
+        void record(long long micros);
+
+        /**
+         * @return the number of samples recorded.
+         */
+        long long getCount() const;
+
+        /**
+         * @return the number of samples in the given bucket.
+         *
+         * @throws IndexOutOfBoundsException if the index is not a valid bucket.
+         */
+        long long getBucket(int index) const;
+
+        /**
+         * @return the exclusive upper bound in microseconds of the given bucket.
+         *
+         * @throws IndexOutOfBoundsException if the index is not a valid bucket.
+         */
+        static long long getBucketUpperBound(int index);
+
+        /**
+         * @return the smallest sample in microseconds, or zero if there are none.
+         */
+        long long getMinimum() const;
+
+        /**
+         * @return the largest sample in microseconds, or zero if there are none.
+         */
+        long long getMaximum() const;
+
+        /**
+         * @return the mean of the samples in microseconds, or zero if there are none.
+         */
+        long long getMean() const;
+
+        /**
+         * @return the most recent sample in microseconds, or zero if there are none.
+         */
+        long long getLast() const;
+
+        /**
+         * Estimates a percentile from the buckets, the result is the upper bound of the
+         * bucket that holds the requested sample capped at the largest sample seen.
+         *
+         * @param percentile
+         *      The percentile wanted, from 0 to 100.
+         *
+         * @return the estimated round trip time in microseconds, or zero if there are no samples.
+         */
+        long long getPercentile(double percentile) const;
+
+        /**
+         * Discards all recorded samples.
+         */
+        void reset();
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_INACTIVITY_ROUNDTRIPHISTOGRAM_H_ */
@@ -0,0 +1,436 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SharedTransport.h"
+
+#include <activemq/transport/shared/SharedTransportChannel.h>
+#include <activemq/transport/TransportFactory.h>
+#include <activemq/transport/TransportRegistry.h>
+#include <activemq/commands/ConnectionError.h>
+#include <activemq/commands/ConsumerControl.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageDispatchNotification.h>
+#include <activemq/commands/ProducerAck.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::shared;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::net;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class SharedTransportRegistry {
+    private:
+
+        SharedTransportRegistry(const SharedTransportRegistry&);
+        SharedTransportRegistry& operator=(const SharedTransportRegistry&);
+
+    public:
+
+        Mutex mutex;
+        std::map<std::string, Pointer<SharedTransport> > transports;
+
+        SharedTransportRegistry() : mutex(), transports() {}
+
+        void remove(const SharedTransport* transport, const std::string& key) {
+            std::map<std::string, Pointer<SharedTransport> >::iterator iter = transports.find(key);
+            if (iter != transports.end() && iter->second.get() == transport) {
+                transports.erase(iter);
+            }
+        }
+    };
+
+    SharedTransportRegistry* theOnlyInstance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SharedTransport::SharedTransport(const std::string& key, const Pointer<Transport> next) :
+    TransportListener(), mutex(), key(key), next(next), endpoints(), connections(),
+    wireFormatInfo(), brokerInfo(), started(false), failed(false) {
+
+    if (next == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Transport passed is NULL");
+    }
+
+    next->setTransportListener(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SharedTransport::~SharedTransport() {
+    try {
+        next->setTransportListener(NULL);
+        next->close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> SharedTransport::createChannel(const URI& location) {
+
+    try {
+
+        Pointer<SharedTransport> shared;
+
+        synchronized(&theOnlyInstance->mutex) {
+
+            std::string key = location.toString();
+
+            std::map<std::string, Pointer<SharedTransport> >::iterator iter = theOnlyInstance->transports.find(key);
+            if (iter != theOnlyInstance->transports.end()) {
+                shared = iter->second;
+            } else {
+                TransportFactory* factory = TransportRegistry::getInstance().findFactory(location.getScheme());
+
+                Pointer<Transport> transport(factory->create(location));
+                if (transport == NULL) {
+                    throw IOException(__FILE__, __LINE__, "Failed to create the shared Transport for: %s", key.c_str());
+                }
+
+                shared.reset(new SharedTransport(key, transport));
+                theOnlyInstance->transports[key] = shared;
+            }
+
+            return Pointer<Transport>(new SharedTransportChannel(shared));
+        }
+
+        return Pointer<Transport>();
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int SharedTransport::getSharedTransportCount() {
+
+    synchronized(&theOnlyInstance->mutex) {
+        return (int) theOnlyInstance->transports.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int SharedTransport::getChannelCount() const {
+
+    synchronized(&mutex) {
+        return (int) this->endpoints.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedTransport::isFailed() const {
+
+    synchronized(&mutex) {
+        return this->failed;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::attach(const Pointer<Endpoint> endpoint) {
+
+    synchronized(&mutex) {
+        this->endpoints.push_back(endpoint);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::start(const Pointer<Endpoint> endpoint) {
+
+    std::vector< Pointer<Command> > missed;
+
+    synchronized(&mutex) {
+
+        if (this->failed) {
+            throw IOException(__FILE__, __LINE__, "The shared Transport has failed.");
+        }
+
+        if (!this->started) {
+            this->next->start();
+            this->started = true;
+        }
+
+        // Anything read from here on is routed to the endpoint, what it missed while
+        // the physical Transport was already running is handed to it below.
+        if (this->wireFormatInfo != NULL) {
+            missed.push_back(this->wireFormatInfo);
+        }
+        if (this->brokerInfo != NULL) {
+            missed.push_back(this->brokerInfo);
+        }
+
+        synchronized(&endpoint->mutex) {
+            endpoint->started = true;
+        }
+    }
+
+    std::vector< Pointer<Command> >::const_iterator iter = missed.begin();
+    for (; iter != missed.end(); ++iter) {
+        dispatch(endpoint, *iter);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::stop(const Pointer<Endpoint> endpoint) {
+
+    synchronized(&endpoint->mutex) {
+        endpoint->started = false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::bind(const Pointer<Endpoint> endpoint, const std::string& connectionId) {
+
+    synchronized(&mutex) {
+        if (!endpoint->connectionId.empty()) {
+            this->connections.erase(endpoint->connectionId);
+        }
+
+        endpoint->connectionId = connectionId;
+        this->connections[connectionId] = endpoint;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::detach(const Pointer<Endpoint> endpoint) {
+
+    bool last = false;
+
+    synchronized(&endpoint->mutex) {
+        endpoint->started = false;
+        endpoint->listener = NULL;
+    }
+
+    synchronized(&theOnlyInstance->mutex) {
+        synchronized(&mutex) {
+
+            std::vector< Pointer<Endpoint> >::iterator iter = this->endpoints.begin();
+            for (; iter != this->endpoints.end(); ++iter) {
+                if (iter->get() == endpoint.get()) {
+                    this->endpoints.erase(iter);
+                    break;
+                }
+            }
+
+            if (!endpoint->connectionId.empty()) {
+                std::map<std::string, Pointer<Endpoint> >::iterator entry = this->connections.find(endpoint->connectionId);
+                if (entry != this->connections.end() && entry->second.get() == endpoint.get()) {
+                    this->connections.erase(entry);
+                }
+            }
+
+            if (this->endpoints.empty()) {
+                theOnlyInstance->remove(this, this->key);
+                last = true;
+            }
+        }
+    }
+
+    // Closing waits for the reader thread, which may be waiting on the mutex.
+    if (last) {
+        this->next->close();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::onCommand(const Pointer<Command> command) {
+
+    Pointer<Endpoint> target;
+    std::vector< Pointer<Endpoint> > targets;
+    bool addressed = false;
+
+    synchronized(&mutex) {
+
+        if (command->isWireFormatInfo()) {
+            this->wireFormatInfo = command;
+        } else if (command->isBrokerInfo()) {
+            this->brokerInfo = command;
+        }
+
+        addressed = route(command, target);
+        if (!addressed) {
+            snapshot(targets);
+        }
+    }
+
+    // A command for a connection that has since closed is dropped.
+    if (addressed) {
+        if (target != NULL) {
+            dispatch(target, command);
+        }
+        return;
+    }
+
+    std::vector< Pointer<Endpoint> >::const_iterator iter = targets.begin();
+    for (; iter != targets.end(); ++iter) {
+        dispatch(*iter, command);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::onException(const decaf::lang::Exception& ex) {
+
+    std::vector< Pointer<Endpoint> > targets;
+
+    // Drop the failed Transport so that new connections build a fresh one.
+    synchronized(&theOnlyInstance->mutex) {
+        synchronized(&mutex) {
+            this->failed = true;
+            theOnlyInstance->remove(this, this->key);
+            snapshot(targets);
+        }
+    }
+
+    std::vector< Pointer<Endpoint> >::const_iterator iter = targets.begin();
+    for (; iter != targets.end(); ++iter) {
+        synchronized(&(*iter)->mutex) {
+            if ((*iter)->started && (*iter)->listener != NULL) {
+                (*iter)->listener->onException(ex);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::transportInterrupted() {
+
+    std::vector< Pointer<Endpoint> > targets;
+    synchronized(&mutex) {
+        snapshot(targets);
+    }
+
+    std::vector< Pointer<Endpoint> >::const_iterator iter = targets.begin();
+    for (; iter != targets.end(); ++iter) {
+        synchronized(&(*iter)->mutex) {
+            if ((*iter)->started && (*iter)->listener != NULL) {
+                (*iter)->listener->transportInterrupted();
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::transportResumed() {
+
+    std::vector< Pointer<Endpoint> > targets;
+    synchronized(&mutex) {
+        snapshot(targets);
+    }
+
+    std::vector< Pointer<Endpoint> >::const_iterator iter = targets.begin();
+    for (; iter != targets.end(); ++iter) {
+        synchronized(&(*iter)->mutex) {
+            if ((*iter)->started && (*iter)->listener != NULL) {
+                (*iter)->listener->transportResumed();
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedTransport::route(const Pointer<Command> command, Pointer<Endpoint>& target) const {
+
+    const std::string* connectionId = NULL;
+
+    if (command->isMessageDispatch()) {
+        const Pointer<ConsumerId>& id = command.dynamicCast<MessageDispatch>()->getConsumerId();
+        if (id != NULL) {
+            connectionId = &id->getConnectionId();
+        }
+    } else if (command->isConsumerControl()) {
+        const Pointer<ConsumerId>& id = command.dynamicCast<ConsumerControl>()->getConsumerId();
+        if (id != NULL) {
+            connectionId = &id->getConnectionId();
+        }
+    } else if (command->isMessageDispatchNotification()) {
+        const Pointer<ConsumerId>& id = command.dynamicCast<MessageDispatchNotification>()->getConsumerId();
+        if (id != NULL) {
+            connectionId = &id->getConnectionId();
+        }
+    } else if (command->isProducerAck()) {
+        const Pointer<ProducerId>& id = command.dynamicCast<ProducerAck>()->getProducerId();
+        if (id != NULL) {
+            connectionId = &id->getConnectionId();
+        }
+    } else if (command->isConnectionError()) {
+        const Pointer<ConnectionId>& id = command.dynamicCast<ConnectionError>()->getConnectionId();
+        if (id != NULL) {
+            connectionId = &id->getValue();
+        }
+    }
+
+    if (connectionId == NULL) {
+        return false;
+    }
+
+    std::map<std::string, Pointer<Endpoint> >::const_iterator iter = this->connections.find(*connectionId);
+    if (iter != this->connections.end()) {
+        target = iter->second;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::snapshot(std::vector< Pointer<Endpoint> >& result) const {
+
+    result.reserve(this->endpoints.size());
+
+    std::vector< Pointer<Endpoint> >::const_iterator iter = this->endpoints.begin();
+    for (; iter != this->endpoints.end(); ++iter) {
+        result.push_back(*iter);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::dispatch(const Pointer<Endpoint> endpoint, const Pointer<Command> command) {
+
+    try {
+        synchronized(&endpoint->mutex) {
+            if (endpoint->started && endpoint->listener != NULL) {
+                endpoint->listener->onCommand(command);
+            }
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::initialize() {
+    theOnlyInstance = new SharedTransportRegistry();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransport::shutdown() {
+    delete theOnlyInstance;
+    theOnlyInstance = NULL;
+}
@@ -0,0 +1,222 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_SHARED_SHAREDTRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_SHARED_SHAREDTRANSPORT_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/Transport.h>
+#include <activemq/transport/TransportListener.h>
+#include <activemq/commands/Command.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/net/URI.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace transport {
+namespace shared {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::Command;
+
+    class SharedTransportChannel;
+
+    /**
+     * A single physical Transport that is shared by many logical connections in the
+     * same process.  Each ActiveMQConnection is handed a SharedTransportChannel, the
+     * channels all write to the one Transport chain so the socket, the reader thread,
+     * the wire format and the inactivity monitor exist only once per broker URI.
+     *
+     * The shared transport is the listener of the physical chain and routes what it
+     * reads to the channel that owns the ConnectionId the command is addressed to,
+     * commands that belong to no particular connection such as the BrokerInfo are
+     * passed to every channel.  A channel learns its ConnectionId when its connection
+     * sends its ConnectionInfo.  Responses never reach this layer, they are matched to
+     * their requests by the ResponseCorrelator in the shared chain which also keeps
+     * the command ids of all the channels unique.
+     *
+     * The physical Transport is started along with the first channel and closed when
+     * the last channel is closed.  If it fails every channel is told and it is dropped
+     * so that the next connection made to the same URI builds a new one.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API SharedTransport : public TransportListener {
+    public:
+
+        /**
+         * The part of a channel that the router dispatches to.  It is reference counted
+         * separately from the channel so that a command being routed on the reader thread
+         * is never handed to a channel that has just been destroyed.
+         */
+        class Endpoint {
+        private:
+
+            Endpoint(const Endpoint&);
+            Endpoint& operator=(const Endpoint&);
+
+        public:
+
+            decaf::util::concurrent::Mutex mutex;
+            TransportListener* listener;
+            std::string connectionId;
+            bool started;
+
+            Endpoint() : mutex(), listener(NULL), connectionId(), started(false) {}
+        };
+
+    private:
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        std::string key;
+        Pointer<Transport> next;
+
+        std::vector< Pointer<Endpoint> > endpoints;
+        std::map<std::string, Pointer<Endpoint> > connections;
+
+        Pointer<Command> wireFormatInfo;
+        Pointer<Command> brokerInfo;
+
+        bool started;
+        bool failed;
+
+    private:
+
+        SharedTransport(const SharedTransport&);
+        SharedTransport& operator=(const SharedTransport&);
+
+    public:
+
+        /**
+         * Creates a new SharedTransport that routes the commands read from the given
+         * Transport chain.
+         *
+         * @param key
+         *      The key this transport is registered under, normally the broker URI.
+         * @param next
+         *      The physical Transport chain, it should contain a ResponseCorrelator.
+         *
+         * @throws NullPointerException if next is NULL.
+         */
+        SharedTransport(const std::string& key, const Pointer<Transport> next);
+
+        virtual ~SharedTransport();
+
+        /**
+         * Creates a new channel on the shared Transport for the given broker URI, the
+         * physical Transport is created if there is none for that URI yet.
+         *
+         * @param location
+         *      The URI of the broker to connect to.
+         *
+         * @return a new channel for one logical connection.
+         *
+         * @throws IOException if the physical Transport could not be created.
+         */
+        static Pointer<Transport> createChannel(const decaf::net::URI& location);
+
+        /**
+         * @return the number of shared Transports that are currently open.
+         */
+        static int getSharedTransportCount();
+
+        /**
+         * @return the physical Transport chain this object routes for.
+         */
+        Pointer<Transport> getTransport() const {
+            return this->next;
+        }
+
+        /**
+         * @return the number of channels that are open on this transport.
+         */
+        int getChannelCount() const;
+
+        /**
+         * @return true if the physical Transport has failed.
+         */
+        bool isFailed() const;
+
+    public:  // Used by SharedTransportChannel
+
+        /**
+         * Adds a channel endpoint, called when a channel is created.
+         */
+        void attach(const Pointer<Endpoint> endpoint);
+
+        /**
+         * Starts routing to the given endpoint, the physical Transport is started if this
+         * is the first endpoint to start.  The BrokerInfo and WireFormatInfo that were read
+         * before the endpoint started are passed to it.
+         */
+        void start(const Pointer<Endpoint> endpoint);
+
+        /**
+         * Stops routing commands to the given endpoint.
+         */
+        void stop(const Pointer<Endpoint> endpoint);
+
+        /**
+         * Routes commands for the given ConnectionId to the endpoint.
+         */
+        void bind(const Pointer<Endpoint> endpoint, const std::string& connectionId);
+
+        /**
+         * Removes a channel endpoint, the physical Transport is closed when the last
+         * endpoint is removed.
+         */
+        void detach(const Pointer<Endpoint> endpoint);
+
+    public:  // TransportListener methods
+
+        virtual void onCommand(const Pointer<Command> command);
+
+        virtual void onException(const decaf::lang::Exception& ex);
+
+        virtual void transportInterrupted();
+
+        virtual void transportResumed();
+
+    private:
+
+        bool route(const Pointer<Command> command, Pointer<Endpoint>& target) const;
+
+        void snapshot(std::vector< Pointer<Endpoint> >& result) const;
+
+        static void dispatch(const Pointer<Endpoint> endpoint, const Pointer<Command> command);
+
+    private:
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_SHARED_SHAREDTRANSPORT_H_ */
@@ -0,0 +1,270 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SharedTransportChannel.h"
+
+#include <activemq/commands/ConnectionInfo.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/wireformat/WireFormat.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+#include <typeinfo>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::shared;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+SharedTransportChannel::SharedTransportChannel(const Pointer<SharedTransport> shared) :
+    Transport(), shared(shared), endpoint(new SharedTransport::Endpoint()), started(false), closed(false) {
+
+    if (shared == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "SharedTransport passed is NULL");
+    }
+
+    shared->attach(this->endpoint);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SharedTransportChannel::~SharedTransportChannel() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::start() {
+
+    if (this->closed.get()) {
+        return;
+    }
+
+    if (getTransportListener() == NULL) {
+        throw IOException(__FILE__, __LINE__, "exceptionListener is invalid");
+    }
+
+    try {
+        if (this->started.compareAndSet(false, true)) {
+            this->shared->start(this->endpoint);
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::stop() {
+
+    if (this->closed.get()) {
+        return;
+    }
+
+    if (this->started.compareAndSet(true, false)) {
+        this->shared->stop(this->endpoint);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::close() {
+
+    if (this->closed.compareAndSet(false, true)) {
+        this->started.set(false);
+
+        try {
+            this->shared->detach(this->endpoint);
+        }
+        AMQ_CATCH_RETHROW(IOException)
+        AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+        AMQ_CATCHALL_THROW(IOException)
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::oneway(const Pointer<Command> command) {
+
+    checkClosed();
+
+    // The broker answers a ShutdownInfo by closing the socket, which the other
+    // channels are still using.
+    if (command->isShutdownInfo()) {
+        return;
+    }
+
+    try {
+        beforeSend(command);
+        this->shared->getTransport()->oneway(command);
+    }
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FutureResponse> SharedTransportChannel::asyncRequest(const Pointer<Command> command,
+                                                             const Pointer<ResponseCallback> responseCallback) {
+    checkClosed();
+
+    try {
+        beforeSend(command);
+        return this->shared->getTransport()->asyncRequest(command, responseCallback);
+    }
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> SharedTransportChannel::request(const Pointer<Command> command) {
+
+    checkClosed();
+
+    try {
+        beforeSend(command);
+        return this->shared->getTransport()->request(command);
+    }
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> SharedTransportChannel::request(const Pointer<Command> command, unsigned int timeout) {
+
+    checkClosed();
+
+    try {
+        beforeSend(command);
+        return this->shared->getTransport()->request(command, timeout);
+    }
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<wireformat::WireFormat> SharedTransportChannel::getWireFormat() const {
+    checkClosed();
+    return this->shared->getTransport()->getWireFormat();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::setTransportListener(TransportListener* listener) {
+    synchronized(&this->endpoint->mutex) {
+        this->endpoint->listener = listener;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TransportListener* SharedTransportChannel::getTransportListener() const {
+    synchronized(&this->endpoint->mutex) {
+        return this->endpoint->listener;
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Transport* SharedTransportChannel::narrow(const std::type_info& typeId) {
+    if (typeid(*this) == typeId) {
+        return this;
+    }
+
+    return this->shared->getTransport()->narrow(typeId);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedTransportChannel::isFaultTolerant() const {
+    return this->shared->getTransport()->isFaultTolerant();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedTransportChannel::isConnected() const {
+    return !this->closed.get() && this->shared->getTransport()->isConnected();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedTransportChannel::isReconnectSupported() const {
+    return this->shared->getTransport()->isReconnectSupported();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedTransportChannel::isUpdateURIsSupported() const {
+    return this->shared->getTransport()->isUpdateURIsSupported();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string SharedTransportChannel::getRemoteAddress() const {
+    return this->shared->getTransport()->getRemoteAddress();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::reconnect(const decaf::net::URI& uri) {
+
+    checkClosed();
+
+    try {
+        this->shared->getTransport()->reconnect(uri);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::updateURIs(bool rebalance, const decaf::util::List<decaf::net::URI>& uris) {
+
+    checkClosed();
+
+    try {
+        this->shared->getTransport()->updateURIs(rebalance, uris);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::checkClosed() const {
+    if (this->closed.get()) {
+        throw IOException(__FILE__, __LINE__, "Transport is closed");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportChannel::beforeSend(const Pointer<Command> command) {
+
+    if (command->isConnectionInfo()) {
+        const Pointer<ConnectionId>& id = command.dynamicCast<ConnectionInfo>()->getConnectionId();
+        if (id != NULL) {
+            this->shared->bind(this->endpoint, id->getValue());
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_SHARED_SHAREDTRANSPORTCHANNEL_H_
+#define _ACTIVEMQ_TRANSPORT_SHARED_SHAREDTRANSPORTCHANNEL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/Transport.h>
+#include <activemq/transport/shared/SharedTransport.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+namespace activemq {
+namespace transport {
+namespace shared {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::Command;
+    using activemq::commands::Response;
+
+    /**
+     * The Transport handed to one logical connection that shares its physical
+     * Transport with others.  Commands are written straight to the shared chain, the
+     * commands read from it arrive here once the SharedTransport has routed them.
+     *
+     * Stopping or closing a channel never affects the other channels, the ShutdownInfo
+     * a connection sends when it closes is dropped since the broker would close the
+     * socket every connection is using.  The connection's RemoveInfo still tells the
+     * broker that the logical connection is gone.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API SharedTransportChannel : public Transport {
+    private:
+
+        Pointer<SharedTransport> shared;
+        Pointer<SharedTransport::Endpoint> endpoint;
+
+        decaf::util::concurrent::atomic::AtomicBoolean started;
+        decaf::util::concurrent::atomic::AtomicBoolean closed;
+
+    private:
+
+        SharedTransportChannel(const SharedTransportChannel&);
+        SharedTransportChannel& operator=(const SharedTransportChannel&);
+
+    public:
+
+        /**
+         * Creates a new channel on the given SharedTransport.
+         *
+         * @param shared
+         *      The SharedTransport that owns the physical Transport.
+         *
+         * @throws NullPointerException if shared is NULL.
+         */
+        SharedTransportChannel(const Pointer<SharedTransport> shared);
+
+        virtual ~SharedTransportChannel();
+
+        /**
+         * @return the SharedTransport this channel belongs to.
+         */
+        Pointer<SharedTransport> getSharedTransport() const {
+            return this->shared;
+        }
+
+    public:  // Transport methods
+
+        virtual void start();
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual void oneway(const Pointer<Command> command);
+
+        virtual Pointer<FutureResponse> asyncRequest(const Pointer<Command> command,
+                                                     const Pointer<ResponseCallback> responseCallback);
+
+        virtual Pointer<Response> request(const Pointer<Command> command);
+
+        virtual Pointer<Response> request(const Pointer<Command> command, unsigned int timeout);
+
+        virtual Pointer<wireformat::WireFormat> getWireFormat() const;
+
+        /**
+         * The wire format belongs to the shared Transport, it is not changed by a channel.
+         */
+        virtual void setWireFormat(const Pointer<wireformat::WireFormat> wireFormat AMQCPP_UNUSED) {}
+
+        virtual void setTransportListener(TransportListener* listener);
+
+        virtual TransportListener* getTransportListener() const;
+
+        virtual Transport* narrow(const std::type_info& typeId);
+
+        virtual bool isFaultTolerant() const;
+
+        virtual bool isConnected() const;
+
+        virtual bool isClosed() const {
+            return this->closed.get();
+        }
+
+        virtual bool isReconnectSupported() const;
+
+        virtual bool isUpdateURIsSupported() const;
+
+        virtual std::string getRemoteAddress() const;
+
+        virtual void reconnect(const decaf::net::URI& uri);
+
+        virtual void updateURIs(bool rebalance, const decaf::util::List<decaf::net::URI>& uris);
+
+    private:
+
+        void checkClosed() const;
+
+        void beforeSend(const Pointer<Command> command);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_SHARED_SHAREDTRANSPORTCHANNEL_H_ */
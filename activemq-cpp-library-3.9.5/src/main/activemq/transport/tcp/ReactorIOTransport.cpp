@@ -0,0 +1,228 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ReactorIOTransport.h"
+
+#include <activemq/transport/tcp/TcpReactor.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/OpenWireFrameDecoder.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/internal/net/tcp/TcpSocketInputStream.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+#include <string.h>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::net;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const std::size_t READ_BUFFER_SIZE = 8192;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace tcp {
+
+    class ReactorIOTransportImpl {
+    private:
+
+        ReactorIOTransportImpl(const ReactorIOTransportImpl&);
+        ReactorIOTransportImpl& operator=(const ReactorIOTransportImpl&);
+
+    public:
+
+        decaf::net::Socket* socket;
+        TcpSocketInputStream* input;
+        AtomicBoolean registered;
+
+        // Bytes are read into this buffer and pushed to the decoder, which keeps any
+        // partial frame until the rest of it arrives.
+        std::vector<unsigned char> buffer;
+        Pointer<OpenWireFrameDecoder> decoder;
+        std::vector< Pointer<Command> > commands;
+
+        ReactorIOTransportImpl() : socket(NULL), input(NULL), registered(false), buffer(READ_BUFFER_SIZE), decoder(), commands() {
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+ReactorIOTransport::ReactorIOTransport(const Pointer<WireFormat> wireFormat) :
+    IOTransport(wireFormat), TcpReactorChannel(), impl(new ReactorIOTransportImpl()) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ReactorIOTransport::~ReactorIOTransport() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransport::setSocket(decaf::net::Socket* socket) {
+    this->impl->socket = socket;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ReactorIOTransport::isReactorDriven() const {
+    return this->impl->registered.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransport::startReader() {
+
+    OpenWireFormat* openWireFormat = dynamic_cast<OpenWireFormat*>(getWireFormat().get());
+
+    // Frames can only be found in the byte stream when each one carries its size,
+    // and the reactor thread can only serve sockets it can read without blocking.
+    if (impl->socket != NULL) {
+        impl->input = dynamic_cast<TcpSocketInputStream*>(impl->socket->getInputStream());
+    }
+
+    if (impl->input == NULL || openWireFormat == NULL || openWireFormat->isSizePrefixDisabled() ||
+        (openWireFormat->getPreferedWireFormatInfo() != NULL &&
+         openWireFormat->getPreferedWireFormatInfo()->isSizePrefixDisabled())) {
+
+        IOTransport::startReader();
+        return;
+    }
+
+    try {
+        impl->decoder.reset(new OpenWireFrameDecoder(getWireFormat().dynamicCast<OpenWireFormat>()));
+        impl->registered.set(true);
+        TcpReactor::getInstance().registerChannel(impl->socket->getFileDescriptor(), this);
+    } catch (decaf::io::IOException&) {
+        impl->registered.set(false);
+        IOTransport::startReader();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransport::unregister() {
+    if (impl->registered.compareAndSet(true, false)) {
+        TcpReactor::getInstance().unregisterChannel(this);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransport::stop() {
+
+    try {
+        // The owning TcpTransport closes the socket once this transport is stopped,
+        // the socket has to leave the reactor before that happens.
+        unregister();
+        IOTransport::stop();
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransport::close() {
+
+    try {
+        unregister();
+        IOTransport::close();
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ReactorIOTransport::onReadable() {
+
+    try {
+
+        if (isClosed()) {
+            return false;
+        }
+
+        // Never waits, a wakeup with nothing to read leaves the channel registered
+        // until data or end of stream arrives.
+        int bytesRead = impl->input->readAvailable(
+            &impl->buffer[0], (int) impl->buffer.size(), 0, (int) impl->buffer.size());
+
+        if (bytesRead == 0) {
+            return true;
+        }
+
+        if (bytesRead == -1) {
+            throw IOException(__FILE__, __LINE__, "ReactorIOTransport::onReadable - Connection closed by peer");
+        }
+
+        // The commands decoded before a bad frame are still delivered, ahead of the error.
+        impl->commands.clear();
+        try {
+            impl->decoder->decode(&impl->buffer[0], bytesRead, impl->commands);
+        } catch (...) {
+            fireAll(impl->commands);
+            throw;
+        }
+
+        fireAll(impl->commands);
+
+        return true;
+
+    } catch (exceptions::ActiveMQException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        fire(ex);
+    } catch (decaf::lang::Exception& ex) {
+        exceptions::ActiveMQException exl(ex);
+        exl.setMark(__FILE__, __LINE__);
+        fire(exl);
+    } catch (...) {
+        exceptions::ActiveMQException ex(__FILE__, __LINE__, "ReactorIOTransport::onReadable - caught unknown exception");
+        fire(ex);
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransport::fireAll(std::vector< Pointer<Command> >& commands) {
+
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        fire(commands[i]);
+    }
+
+    commands.clear();
+}
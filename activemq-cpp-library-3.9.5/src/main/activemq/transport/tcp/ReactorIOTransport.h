@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_TCP_REACTORIOTRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_TCP_REACTORIOTRANSPORT_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/transport/tcp/TcpReactorChannel.h>
+#include <decaf/net/Socket.h>
+
+#include <vector>
+
+namespace activemq {
+namespace transport {
+namespace tcp {
+
+    class ReactorIOTransportImpl;
+
+    /**
+     * An IOTransport whose inbound commands are read by the shared TcpReactor rather
+     * than by a dedicated reader thread.  Bytes are taken from the socket as they
+     * arrive and pushed to an OpenWireFrameDecoder, which only hands a frame to the
+     * WireFormat once all of it has been received, so a partial frame never blocks a
+     * reactor thread.  Writes are performed on the caller's thread exactly as in IOTransport.
+     *
+     * The reactor is only used when a Socket has been set and the WireFormat is an
+     * OpenWireFormat with size prefixes enabled, in all other cases this transport
+     * falls back to the reader thread of its parent.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API ReactorIOTransport : public IOTransport,
+                                          public TcpReactorChannel {
+    private:
+
+        ReactorIOTransportImpl* impl;
+
+    private:
+
+        ReactorIOTransport(const ReactorIOTransport&);
+        ReactorIOTransport& operator=(const ReactorIOTransport&);
+
+    public:
+
+        /**
+         * Create an instance of this Transport and assign its WireFormat instance
+         * at creation time.
+         *
+         * @param wireFormat
+         *        Data encoder / decoder to use when reading and writing.
+         */
+        ReactorIOTransport(const Pointer<wireformat::WireFormat> wireFormat);
+
+        virtual ~ReactorIOTransport();
+
+        /**
+         * Sets the connected Socket that the reactor watches and reads from, the socket
+         * is not owned by this transport.  Must be called before start.
+         *
+         * @param socket
+         *      The connected Socket this transport reads from.
+         */
+        void setSocket(decaf::net::Socket* socket);
+
+        /**
+         * @return true if commands are being delivered by the TcpReactor, false if
+         *         the transport fell back to a dedicated reader thread.
+         */
+        bool isReactorDriven() const;
+
+    public:  // Transport methods
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual Transport* narrow(const std::type_info& typeId) {
+            if (typeid(*this) == typeId || typeid(IOTransport) == typeId) {
+                return this;
+            }
+
+            return NULL;
+        }
+
+    public:  // TcpReactorChannel methods
+
+        virtual bool onReadable();
+
+    protected:
+
+        virtual void startReader();
+
+    private:
+
+        void unregister();
+
+        void fireAll(std::vector< Pointer<Command> >& commands);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_TCP_REACTORIOTRANSPORT_H_ */
@@ -0,0 +1,394 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TcpReactor.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/internal/net/SocketPoller.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::net;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    TcpReactor* theOnlyInstance;
+
+    const int MAX_DEFAULT_THREADS = 4;
+
+    // Delays used while the poller keeps failing, so a broken poll set is retried
+    // without spinning the reactor thread.
+    const long long MIN_POLL_RETRY_DELAY = 10;
+    const long long MAX_POLL_RETRY_DELAY = 1000;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace tcp {
+
+    class TcpReactorImpl;
+
+    /**
+     * One reactor thread along with the poller it waits on and the channels that
+     * have been assigned to it.  Channels are called back without the dispatch lock
+     * held, the channel being called is recorded under it instead so that removing
+     * a channel from another thread waits out a call in progress.
+     */
+    class TcpReactorThread : public Runnable {
+    private:
+
+        TcpReactorThread(const TcpReactorThread&);
+        TcpReactorThread& operator=(const TcpReactorThread&);
+
+    public:
+
+        TcpReactorImpl* reactor;
+        SocketPoller poller;
+        Mutex dispatchLock;
+        std::map<TcpReactorChannel*, const FileDescriptor*> channels;
+        TcpReactorChannel* dispatching;
+        AtomicBoolean running;
+        std::auto_ptr<Thread> thread;
+        int load;
+
+        TcpReactorThread(TcpReactorImpl* reactor, int id) :
+            reactor(reactor), poller(64), dispatchLock(), channels(), dispatching(NULL),
+            running(true), thread(), load(0) {
+            thread.reset(new Thread(this, std::string("ActiveMQ TcpReactor Thread-") + Integer::toString(id)));
+            thread->start();
+        }
+
+        virtual ~TcpReactorThread() {
+            try {
+                running.set(false);
+                poller.wakeup();
+                thread->join();
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+
+        void add(const FileDescriptor* fd, TcpReactorChannel* channel) {
+            synchronized(&dispatchLock) {
+                channels[channel] = fd;
+                try {
+                    poller.add(fd, channel);
+                } catch (...) {
+                    channels.erase(channel);
+                    throw;
+                }
+            }
+        }
+
+        void remove(TcpReactorChannel* channel) {
+            synchronized(&dispatchLock) {
+                std::map<TcpReactorChannel*, const FileDescriptor*>::iterator iter = channels.find(channel);
+                if (iter == channels.end()) {
+                    break;
+                }
+
+                try {
+                    poller.remove(iter->second);
+                }
+                AMQ_CATCHALL_NOTHROW()
+
+                channels.erase(iter);
+
+                // A channel may remove itself from its own callback, anyone else
+                // has to wait for that callback to return.
+                try {
+                    while (dispatching == channel && Thread::currentThread() != thread.get()) {
+                        dispatchLock.wait();
+                    }
+                } catch (InterruptedException&) {
+                    Thread::currentThread()->interrupt();
+                }
+            }
+        }
+
+        virtual void run();
+    };
+
+    class TcpReactorImpl {
+    private:
+
+        TcpReactorImpl(const TcpReactorImpl&);
+        TcpReactorImpl& operator=(const TcpReactorImpl&);
+
+    public:
+
+        Mutex lock;
+        int threadCount;
+        std::vector<TcpReactorThread*> threads;
+        std::map<TcpReactorChannel*, TcpReactorThread*> owners;
+
+        TcpReactorImpl() : lock(), threadCount(1), threads(), owners() {
+            threadCount = System::availableProcessors();
+            if (threadCount > MAX_DEFAULT_THREADS) {
+                threadCount = MAX_DEFAULT_THREADS;
+            } else if (threadCount < 1) {
+                threadCount = 1;
+            }
+        }
+
+        ~TcpReactorImpl() {
+            std::vector<TcpReactorThread*>::iterator iter = threads.begin();
+            for (; iter != threads.end(); ++iter) {
+                delete *iter;
+            }
+        }
+
+        TcpReactorThread* selectThread() {
+
+            if ((int) threads.size() < threadCount) {
+                threads.push_back(new TcpReactorThread(this, (int) threads.size() + 1));
+                return threads.back();
+            }
+
+            TcpReactorThread* result = threads.front();
+            std::vector<TcpReactorThread*>::iterator iter = threads.begin();
+            for (; iter != threads.end(); ++iter) {
+                if ((*iter)->load < result->load) {
+                    result = *iter;
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * Drops a channel from its owner, the owner's load and the owner's poller,
+         * does nothing if the channel is not registered.
+         */
+        void removeChannel(TcpReactorChannel* channel) {
+
+            TcpReactorThread* thread = NULL;
+
+            synchronized(&lock) {
+
+                std::map<TcpReactorChannel*, TcpReactorThread*>::iterator iter = owners.find(channel);
+                if (iter == owners.end()) {
+                    break;
+                }
+
+                thread = iter->second;
+                thread->load--;
+                owners.erase(iter);
+            }
+
+            if (thread != NULL) {
+                thread->remove(channel);
+            }
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    void TcpReactorThread::run() {
+
+        std::vector<void*> ready;
+        long long retryDelay = 0;
+
+        while (running.get()) {
+
+            try {
+                poller.poll(-1, ready);
+                retryDelay = 0;
+            } catch (Exception&) {
+                retryDelay = retryDelay == 0 ? MIN_POLL_RETRY_DELAY : retryDelay * 2;
+                if (retryDelay > MAX_POLL_RETRY_DELAY) {
+                    retryDelay = MAX_POLL_RETRY_DELAY;
+                }
+
+                try {
+                    Thread::sleep(retryDelay);
+                } catch (InterruptedException&) {
+                }
+
+                continue;
+            }
+
+            std::vector<void*>::const_iterator iter = ready.begin();
+            for (; iter != ready.end() && running.get(); ++iter) {
+
+                TcpReactorChannel* channel = static_cast<TcpReactorChannel*>(*iter);
+
+                // A channel can be removed between the poll and now, or by an earlier
+                // callback in this batch, only call back those still registered.
+                synchronized(&dispatchLock) {
+                    if (channels.find(channel) == channels.end()) {
+                        channel = NULL;
+                    } else {
+                        dispatching = channel;
+                    }
+                }
+
+                if (channel == NULL) {
+                    continue;
+                }
+
+                bool keep = false;
+                try {
+                    keep = channel->onReadable();
+                }
+                AMQ_CATCHALL_NOTHROW()
+
+                synchronized(&dispatchLock) {
+                    dispatching = NULL;
+                    dispatchLock.notifyAll();
+                }
+
+                if (!keep) {
+                    reactor->removeChannel(channel);
+                }
+            }
+        }
+    }
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpReactor::TcpReactor() : impl(new TcpReactorImpl()) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpReactor::~TcpReactor() {
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpReactor::registerChannel(const FileDescriptor* fd, TcpReactorChannel* channel) {
+
+    if (channel == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "TcpReactorChannel cannot be NULL");
+    }
+
+    TcpReactorThread* thread = NULL;
+
+    synchronized(&impl->lock) {
+
+        if (impl->owners.find(channel) != impl->owners.end()) {
+            throw IOException(__FILE__, __LINE__, "TcpReactor::registerChannel - Channel is already registered");
+        }
+
+        thread = impl->selectThread();
+        thread->load++;
+        impl->owners[channel] = thread;
+    }
+
+    // The reactor lock is never held while waiting on a dispatch lock, a channel
+    // callback may need to unregister itself or another channel.
+    try {
+        thread->add(fd, channel);
+    } catch (...) {
+        synchronized(&impl->lock) {
+            thread->load--;
+            impl->owners.erase(channel);
+        }
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpReactor::unregisterChannel(TcpReactorChannel* channel) {
+    impl->removeChannel(channel);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpReactor::setThreadCount(int threadCount) {
+
+    if (threadCount < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Thread count must be greater than zero");
+    }
+
+    synchronized(&impl->lock) {
+        impl->threadCount = threadCount;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpReactor::getThreadCount() const {
+
+    int result = 0;
+    synchronized(&impl->lock) {
+        result = impl->threadCount;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpReactor::getActiveThreadCount() const {
+
+    int result = 0;
+    synchronized(&impl->lock) {
+        result = (int) impl->threads.size();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpReactor::getChannelCount() const {
+
+    int result = 0;
+    synchronized(&impl->lock) {
+        result = (int) impl->owners.size();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpReactor& TcpReactor::getInstance() {
+    return *theOnlyInstance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpReactor::initialize() {
+    theOnlyInstance = new TcpReactor();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpReactor::shutdown() {
+    delete theOnlyInstance;
+    theOnlyInstance = NULL;
+}
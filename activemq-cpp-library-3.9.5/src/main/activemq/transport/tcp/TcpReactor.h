@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_TCP_TCPREACTOR_H_
+#define _ACTIVEMQ_TRANSPORT_TCP_TCPREACTOR_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/tcp/TcpReactorChannel.h>
+#include <decaf/io/FileDescriptor.h>
+#include <decaf/io/IOException.h>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace transport {
+namespace tcp {
+
+    class TcpReactorImpl;
+
+    /**
+     * Services the sockets of many TCP transports from a small pool of threads.  Each
+     * thread waits on a platform poller (epoll on Linux) and calls back the channels
+     * whose sockets have become readable, so the number of threads no longer grows
+     * with the number of open connections.
+     *
+     * Threads are created on demand as channels register, up to the configured
+     * thread count, and each new channel is assigned to the least loaded thread.
+     * Because a reactor thread is shared by many connections, the code that runs
+     * inside a channel callback must not block for long periods.  Callbacks are made
+     * without any reactor lock held, so one may close its connection or unregister
+     * channels served by other threads, but the other channels of its own thread
+     * wait until it returns.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API TcpReactor {
+    private:
+
+        TcpReactorImpl* impl;
+
+    private:
+
+        TcpReactor();
+        TcpReactor(const TcpReactor&);
+        TcpReactor& operator=(const TcpReactor&);
+
+    public:
+
+        virtual ~TcpReactor();
+
+        /**
+         * Registers a channel for read notifications on the given socket.
+         *
+         * @param fd
+         *      The FileDescriptor of the channel's connected socket.
+         * @param channel
+         *      The channel to call back when the socket is readable.
+         *
+         * @throws IOException if the socket could not be added to a poller.
+         */
+        void registerChannel(const decaf::io::FileDescriptor* fd, TcpReactorChannel* channel);
+
+        /**
+         * Removes a channel from the reactor, once this method returns the channel will
+         * not be called again.  If the channel is currently being serviced by another
+         * thread this method waits for that call to complete, it is safe to call this
+         * method from within the channel's own callback.
+         *
+         * @param channel
+         *      The channel to remove, unknown channels are ignored.
+         */
+        void unregisterChannel(TcpReactorChannel* channel);
+
+        /**
+         * Sets the maximum number of reactor threads, threads that are already running
+         * are not stopped when the value is lowered.
+         *
+         * @param threadCount
+         *      The maximum number of threads, must be greater than zero.
+         *
+         * @throws IllegalArgumentException if the value is less than one.
+         */
+        void setThreadCount(int threadCount);
+
+        /**
+         * @return the maximum number of reactor threads.
+         */
+        int getThreadCount() const;
+
+        /**
+         * @return the number of reactor threads that have been started.
+         */
+        int getActiveThreadCount() const;
+
+        /**
+         * @return the number of channels currently registered.
+         */
+        int getChannelCount() const;
+
+    public:
+
+        /**
+         * Gets the single instance of the TcpReactor
+         * @return reference to the single instance of the reactor
+         */
+        static TcpReactor& getInstance();
+
+    private:
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_TCP_TCPREACTOR_H_ */
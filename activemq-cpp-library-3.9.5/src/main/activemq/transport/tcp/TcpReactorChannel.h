@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_TCP_TCPREACTORCHANNEL_H_
+#define _ACTIVEMQ_TRANSPORT_TCP_TCPREACTORCHANNEL_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace transport {
+namespace tcp {
+
+    /**
+     * A socket endpoint that is serviced by the TcpReactor, the reactor calls back
+     * into the channel each time its socket has data to read.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API TcpReactorChannel {
+    public:
+
+        virtual ~TcpReactorChannel() {}
+
+        /**
+         * Called from a reactor thread when the channel's socket is readable, the
+         * channel must consume what it can without blocking and return.  The reactor
+         * never calls a channel from more than one thread at a time.
+         *
+         * @return true to keep the channel registered, false if the channel has
+         *         failed or reached end of stream and should be removed.
+         */
+        virtual bool onReadable() = 0;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_TCP_TCPREACTORCHANNEL_H_ */
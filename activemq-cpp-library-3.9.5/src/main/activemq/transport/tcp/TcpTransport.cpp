@@ -18,11 +18,15 @@
 #include "TcpTransport.h"
 
 #include <activemq/transport/IOTransport.h>
+#include <activemq/transport/tcp/ReactorIOTransport.h>
 #include <activemq/transport/TransportFactory.h>
+#include <activemq/io/GatheringOutputStream.h>
 
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/net/SocketFactory.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Math.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 
 #include <memory>
@@ -42,6 +46,12 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+namespace {
+
+    // Upper bound for socket buffers sized from the bandwidth-delay product.
+    const long long MAX_AUTO_TUNE_BUFFER = 16 * 1024 * 1024;
+}
+
 namespace activemq {
 namespace transport {
 namespace tcp {
@@ -64,6 +74,7 @@ namespace tcp {
 
         int outputBufferSize;
         int inputBufferSize;
+        int outputGatherThreshold;
 
         bool trace;
 
@@ -72,6 +83,16 @@ namespace tcp {
         int soReceiveBufferSize;
         int soSendBufferSize;
         bool tcpNoDelay;
+        int soBusyPoll;
+        bool tcpQuickAck;
+        int tcpNotSentLowWatermark;
+        bool soBufferAutoTune;
+        int soBufferAutoTuneBandwidth;
+        int soBufferAutoTuneRoundTripTime;
+
+        int effectiveReceiveBufferSize;
+        int effectiveSendBufferSize;
+        int measuredRoundTripTime;
 
         TcpTransportImpl(const decaf::net::URI& location) :
             connectTimeout(0),
@@ -81,12 +102,87 @@ namespace tcp {
             location(location),
             outputBufferSize(8192),
             inputBufferSize(8192),
+            outputGatherThreshold(16384),
             trace(false),
             soLinger(-1),
             soKeepAlive(false),
             soReceiveBufferSize(-1),
             soSendBufferSize(-1),
-            tcpNoDelay(true) {
+            tcpNoDelay(true),
+            soBusyPoll(-1),
+            tcpQuickAck(false),
+            tcpNotSentLowWatermark(-1),
+            soBufferAutoTune(false),
+            soBufferAutoTuneBandwidth(1000),
+            soBufferAutoTuneRoundTripTime(-1),
+            effectiveReceiveBufferSize(-1),
+            effectiveSendBufferSize(-1),
+            measuredRoundTripTime(-1) {
+        }
+
+        /**
+         * Sizes the socket buffers from the bandwidth-delay product before connecting,
+         * setting them afterwards would turn off the platform's own buffer tuning for a
+         * connection that has already started with it.  The round trip time is the
+         * configured one, or else the one measured by an earlier connect, without
+         * either the platform is left to tune the buffers itself.
+         */
+        void autoTuneSocketBuffers(decaf::net::Socket* socket) {
+
+            if (!soBufferAutoTune || soBufferAutoTuneBandwidth <= 0) {
+                return;
+            }
+
+            int roundTripTime = soBufferAutoTuneRoundTripTime > 0 ? soBufferAutoTuneRoundTripTime : measuredRoundTripTime;
+            if (roundTripTime <= 0) {
+                return;
+            }
+
+            // Megabits per second times microseconds gives bits, divide by eight
+            // for the number of bytes that can be in flight on the link.
+            long long product = (long long) soBufferAutoTuneBandwidth * roundTripTime / 8;
+            int bufferSize = (int) Math::min(product, MAX_AUTO_TUNE_BUFFER);
+
+            // A buffer the platform already makes large enough is left alone so that it
+            // can still grow it, one it caps below what was asked is reported back
+            // through the effective sizes rather than treated as a failure.
+            try {
+                if (soReceiveBufferSize <= 0 && bufferSize > socket->getReceiveBufferSize()) {
+                    socket->setReceiveBufferSize(bufferSize);
+                }
+                if (soSendBufferSize <= 0 && bufferSize > socket->getSendBufferSize()) {
+                    socket->setSendBufferSize(bufferSize);
+                }
+            } catch (SocketException& ex) {
+            }
+        }
+
+        /**
+         * Applies the options that only make sense on a connected socket and records the
+         * values the platform actually used so they can be reported.
+         */
+        void configureConnectedSocket(decaf::net::Socket* socket, long long connectTime) {
+
+            // Prefer the platform's smoothed RTT, the time taken to connect is close
+            // to one round trip and stands in where the platform doesn't expose it
+            // or fails to report it.
+            int roundTripTime = -1;
+            try {
+                roundTripTime = socket->getRoundTripTime();
+            } catch (Exception& ex) {
+            }
+
+            if (roundTripTime <= 0) {
+                roundTripTime = (int) Math::max(connectTime, 1LL);
+            }
+
+            if (tcpQuickAck) {
+                socket->setTcpQuickAck(true);
+            }
+
+            effectiveReceiveBufferSize = socket->getReceiveBufferSize();
+            effectiveSendBufferSize = socket->getSendBufferSize();
+            measuredRoundTripTime = roundTripTime;
         }
     };
 }}}
@@ -154,6 +250,7 @@ void TcpTransport::connect() {
 
         // Set all Socket Options from the URI options.
         this->configureSocket(impl->socket.get());
+        impl->autoTuneSocketBuffers(impl->socket.get());
 
         URI uri = this->impl->location;
 
@@ -167,7 +264,9 @@ void TcpTransport::connect() {
         string host = uri.getHost();
         int port = uri.getPort();
 
+        long long connectStart = System::nanoTime();
         impl->socket->connect(host, port, impl->connectTimeout);
+        impl->configureConnectedSocket(impl->socket.get(), (System::nanoTime() - connectStart) / 1000);
 
         // Cast it to an IO transport so we can wire up the socket
         // input and output streams.
@@ -200,9 +299,11 @@ void TcpTransport::connect() {
             inputStream.reset(new BufferedInputStream(inputStream.release(), inputBufferSize, true));
             outputStream.reset(new BufferedOutputStream(outputStream.release(), outputBufferSize, true));
         } else {
-            // Wrap with the Buffered streams, we don't own the source streams
+            // Wrap with the Buffered streams, we don't own the source streams.  Large
+            // writes such as message bodies are gathered with the buffered header
+            // instead of being copied through the output buffer.
             inputStream.reset(new BufferedInputStream(socketIStream, inputBufferSize));
-            outputStream.reset(new BufferedOutputStream(sokcetOStream, outputBufferSize));
+            outputStream.reset(new GatheringOutputStream(sokcetOStream, outputBufferSize, this->impl->outputGatherThreshold));
         }
 
         // Now wrap the Buffered Streams with DataInput based streams.  We own
@@ -214,6 +315,13 @@ void TcpTransport::connect() {
         // Give the IOTransport the streams.
         ioTransport->setInputStream(impl->dataInputStream.get());
         ioTransport->setOutputStream(impl->dataOutputStream.get());
+
+        // A reactor driven transport reads straight from the socket, when tracing
+        // is on it is left without one so that reads go through the logging stream.
+        ReactorIOTransport* reactorTransport = dynamic_cast<ReactorIOTransport*>(ioTransport);
+        if (reactorTransport != NULL && !this->impl->trace) {
+            reactorTransport->setSocket(impl->socket.get());
+        }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
@@ -256,6 +364,19 @@ void TcpTransport::configureSocket(Socket* socket) {
         if (soSendBufferSize > 0) {
             socket->setSendBufferSize(soSendBufferSize);
         }
+
+        if (this->impl->soBusyPoll > 0) {
+            // Busy polling is only a latency hint, raising it above the system default
+            // can require elevated privileges so a failure here is not fatal.
+            try {
+                socket->setBusyPoll(this->impl->soBusyPoll);
+            } catch (SocketException& ex) {
+            }
+        }
+
+        if (this->impl->tcpNotSentLowWatermark >= 0) {
+            socket->setTcpNotSentLowWatermark(this->impl->tcpNotSentLowWatermark);
+        }
     }
     DECAF_CATCH_RETHROW(NullPointerException)
     DECAF_CATCH_RETHROW(IllegalArgumentException)
@@ -293,6 +414,16 @@ int TcpTransport::getOutputBufferSize() const {
     return this->impl->outputBufferSize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setOutputGatherThreshold(int outputGatherThreshold) {
+    this->impl->outputGatherThreshold = outputGatherThreshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getOutputGatherThreshold() const {
+    return this->impl->outputGatherThreshold;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpTransport::setInputBufferSize(int inputBufferSize) {
     this->impl->inputBufferSize = inputBufferSize;
@@ -363,6 +494,81 @@ bool TcpTransport::isTcpNoDelay() const {
     return this->impl->tcpNoDelay;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setBusyPoll(int soBusyPoll) {
+    this->impl->soBusyPoll = soBusyPoll;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getBusyPoll() const {
+    return this->impl->soBusyPoll;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setTcpQuickAck(bool tcpQuickAck) {
+    this->impl->tcpQuickAck = tcpQuickAck;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpTransport::isTcpQuickAck() const {
+    return this->impl->tcpQuickAck;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setTcpNotSentLowWatermark(int tcpNotSentLowWatermark) {
+    this->impl->tcpNotSentLowWatermark = tcpNotSentLowWatermark;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getTcpNotSentLowWatermark() const {
+    return this->impl->tcpNotSentLowWatermark;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setBufferAutoTune(bool soBufferAutoTune) {
+    this->impl->soBufferAutoTune = soBufferAutoTune;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpTransport::isBufferAutoTune() const {
+    return this->impl->soBufferAutoTune;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setBufferAutoTuneBandwidth(int soBufferAutoTuneBandwidth) {
+    this->impl->soBufferAutoTuneBandwidth = soBufferAutoTuneBandwidth;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getBufferAutoTuneBandwidth() const {
+    return this->impl->soBufferAutoTuneBandwidth;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getEffectiveReceiveBufferSize() const {
+    return this->impl->effectiveReceiveBufferSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getEffectiveSendBufferSize() const {
+    return this->impl->effectiveSendBufferSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setBufferAutoTuneRoundTripTime(int soBufferAutoTuneRoundTripTime) {
+    this->impl->soBufferAutoTuneRoundTripTime = soBufferAutoTuneRoundTripTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getBufferAutoTuneRoundTripTime() const {
+    return this->impl->soBufferAutoTuneRoundTripTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getMeasuredRoundTripTime() const {
+    return this->impl->measuredRoundTripTime;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 decaf::net::URI TcpTransport::getLocation() const {
     return this->impl->location;
@@ -76,6 +76,17 @@ namespace tcp {
         void setOutputBufferSize(int outputBufferSize);
         int getOutputBufferSize() const;
 
+        /**
+         * Sets the size at or above which a single write, such as a large message body,
+         * is sent to the socket together with the buffered bytes in one gathering write
+         * rather than being copied through the output buffer.  Zero or less disables it.
+         *
+         * @param outputGatherThreshold
+         *      The write size in bytes that bypasses the output buffer.
+         */
+        void setOutputGatherThreshold(int outputGatherThreshold);
+        int getOutputGatherThreshold() const;
+
         void setInputBufferSize(int inputBufferSize);
         int getInputBufferSize() const;
 
@@ -97,6 +108,68 @@ namespace tcp {
         void setTcpNoDelay(bool tcpNoDelay);
         bool isTcpNoDelay() const;
 
+        void setBusyPoll(int soBusyPoll);
+        int getBusyPoll() const;
+
+        void setTcpQuickAck(bool tcpQuickAck);
+        bool isTcpQuickAck() const;
+
+        void setTcpNotSentLowWatermark(int tcpNotSentLowWatermark);
+        int getTcpNotSentLowWatermark() const;
+
+        /**
+         * When enabled the kernel send and receive buffers are sized before connecting
+         * from the bandwidth-delay product of the link to the broker, using the
+         * configured link bandwidth and round trip time.  Without a configured round
+         * trip time the one measured by an earlier connect of this transport is used,
+         * and with neither the buffers are left for the platform to tune.  A buffer is
+         * only enlarged, never shrunk below the platform default, and buffer sizes set
+         * explicitly with soReceiveBufferSize or soSendBufferSize are left as configured.
+         *
+         * @param soBufferAutoTune
+         *      True to size the socket buffers from the bandwidth-delay product.
+         */
+        void setBufferAutoTune(bool soBufferAutoTune);
+        bool isBufferAutoTune() const;
+
+        /**
+         * Sets the bandwidth of the link to the broker used when sizing the socket
+         * buffers from the bandwidth-delay product.
+         *
+         * @param soBufferAutoTuneBandwidth
+         *      The link bandwidth in megabits per second.
+         */
+        void setBufferAutoTuneBandwidth(int soBufferAutoTuneBandwidth);
+        int getBufferAutoTuneBandwidth() const;
+
+        /**
+         * Sets the round trip time to the broker used when sizing the socket buffers
+         * from the bandwidth-delay product.
+         *
+         * @param soBufferAutoTuneRoundTripTime
+         *      The round trip time in microseconds, or -1 to use a measured one.
+         */
+        void setBufferAutoTuneRoundTripTime(int soBufferAutoTuneRoundTripTime);
+        int getBufferAutoTuneRoundTripTime() const;
+
+        /**
+         * @return the receive buffer size the platform reported for the socket once it
+         *         was connected and configured, or -1 if not connected yet.
+         */
+        int getEffectiveReceiveBufferSize() const;
+
+        /**
+         * @return the send buffer size the platform reported for the socket once it
+         *         was connected and configured, or -1 if not connected yet.
+         */
+        int getEffectiveSendBufferSize() const;
+
+        /**
+         * @return the round trip time to the broker in microseconds measured when the
+         *         socket was connected, or -1 if not connected yet.
+         */
+        int getMeasuredRoundTripTime() const;
+
     public: // Transport Methods
 
         virtual bool isFaultTolerant() const {
@@ -19,6 +19,7 @@
 
 #include <activemq/transport/IOTransport.h>
 #include <activemq/transport/tcp/TcpTransport.h>
+#include <activemq/transport/tcp/ReactorIOTransport.h>
 #include <activemq/transport/correlator/ResponseCorrelator.h>
 #include <activemq/transport/logging/LoggingTransport.h>
 #include <activemq/transport/inactivity/InactivityMonitor.h>
@@ -26,6 +27,7 @@
 #include <activemq/wireformat/WireFormat.h>
 #include <decaf/util/Properties.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
 #include <decaf/lang/Boolean.h>
 
 using namespace activemq;
@@ -87,7 +89,13 @@ Pointer<Transport> TcpTransportFactory::doCreateComposite(const decaf::net::URI&
 
     try {
 
-        Pointer<Transport> transport(new IOTransport(wireFormat));
+        Pointer<Transport> transport;
+
+        if (properties.getProperty("transport.useReactor", "false") == "true") {
+            transport.reset(new ReactorIOTransport(wireFormat));
+        } else {
+            transport.reset(new IOTransport(wireFormat));
+        }
 
         transport.reset(new TcpTransport(transport, location));
 
@@ -130,6 +138,7 @@ void TcpTransportFactory::doConfigureTransport(Pointer<Transport> transport,
 
         tcp->setInputBufferSize(Integer::parseInt(properties.getProperty("inputBufferSize", "8192")));
         tcp->setOutputBufferSize(Integer::parseInt(properties.getProperty("outputBufferSize", "8192")));
+        tcp->setOutputGatherThreshold(Integer::parseInt(properties.getProperty("outputGatherThreshold", "16384")));
         tcp->setTrace(Boolean::parseBoolean(properties.getProperty("transport.tcpTracingEnabled", "false")));
         tcp->setLinger(Integer::parseInt(properties.getProperty("soLinger", "-1")));
         tcp->setKeepAlive(Boolean::parseBoolean(properties.getProperty("soKeepAlive", "false")));
@@ -137,6 +146,17 @@ void TcpTransportFactory::doConfigureTransport(Pointer<Transport> transport,
         tcp->setSendBufferSize(Integer::parseInt(properties.getProperty("soSendBufferSize", "-1")));
         tcp->setTcpNoDelay(Boolean::parseBoolean(properties.getProperty("tcpNoDelay", "true")));
         tcp->setConnectTimeout(Integer::parseInt(properties.getProperty("soConnectTimeout", "0")));
+        tcp->setBusyPoll(Integer::parseInt(properties.getProperty("soBusyPoll", "-1")));
+        tcp->setTcpQuickAck(Boolean::parseBoolean(properties.getProperty("tcpQuickAck", "false")));
+        tcp->setTcpNotSentLowWatermark(Integer::parseInt(properties.getProperty("tcpNotSentLowWatermark", "-1")));
+        tcp->setBufferAutoTune(Boolean::parseBoolean(properties.getProperty("soBufferAutoTune", "false")));
+        tcp->setBufferAutoTuneBandwidth(Integer::parseInt(properties.getProperty("soBufferAutoTuneBandwidth", "1000")));
+        tcp->setBufferAutoTuneRoundTripTime(Integer::parseInt(properties.getProperty("soBufferAutoTuneRoundTripTime", "-1")));
+
+        IOTransport* io = dynamic_cast<IOTransport*>(transport->narrow(typeid(IOTransport)));
+        if (io != NULL) {
+            io->setReadSpinTime(Long::parseLong(properties.getProperty("transport.readSpinTime", "0")));
+        }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
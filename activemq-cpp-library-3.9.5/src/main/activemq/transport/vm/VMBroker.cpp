@@ -0,0 +1,459 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VMBroker.h"
+
+#include <activemq/transport/vm/VMTransport.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <activemq/commands/BrokerId.h>
+#include <activemq/commands/BrokerInfo.h>
+#include <activemq/commands/ConnectionId.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/RemoveInfo.h>
+#include <activemq/commands/SessionId.h>
+#include <activemq/commands/TransactionId.h>
+#include <activemq/commands/TransactionInfo.h>
+#include <decaf/lang/Integer.h>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::core;
+using namespace activemq::transport;
+using namespace activemq::transport::vm;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class VMBrokerRegistry {
+    private:
+
+        VMBrokerRegistry(const VMBrokerRegistry&);
+        VMBrokerRegistry& operator=(const VMBrokerRegistry&);
+
+    public:
+
+        Mutex mutex;
+        std::map<std::string, Pointer<VMBroker> > brokers;
+
+        VMBrokerRegistry() : mutex(), brokers() {}
+    };
+
+    VMBrokerRegistry* theOnlyInstance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+VMBroker::VMBroker(const std::string& name) :
+    mutex(), name(name), transports(), destinations(), consumers(), transactions() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+VMBroker::~VMBroker() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int VMBroker::getBrokerCount() {
+
+    synchronized(&theOnlyInstance->mutex) {
+        return (int) theOnlyInstance->brokers.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<VMBroker> VMBroker::connect(const std::string& name, VMTransport* transport) {
+
+    Pointer<VMBroker> broker;
+
+    // The registry stays locked so that the last transport of a router can't
+    // disconnect it while another one is joining.
+    synchronized(&theOnlyInstance->mutex) {
+
+        std::map<std::string, Pointer<VMBroker> >::iterator iter = theOnlyInstance->brokers.find(name);
+        if (iter != theOnlyInstance->brokers.end()) {
+            broker = iter->second;
+        } else {
+            broker.reset(new VMBroker(name));
+            theOnlyInstance->brokers[name] = broker;
+        }
+
+        Pointer<BrokerId> brokerId(new BrokerId());
+        brokerId->setValue("ID:vm-" + name);
+
+        Pointer<BrokerInfo> info(new BrokerInfo());
+        info->setBrokerId(brokerId);
+        info->setBrokerName(name);
+        info->setBrokerURL("vm://" + name);
+
+        synchronized(&broker->mutex) {
+            broker->transports.push_back(transport);
+            transport->deliver(info);
+        }
+    }
+
+    return broker;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::disconnect(VMTransport* transport) {
+
+    synchronized(&theOnlyInstance->mutex) {
+        synchronized(&mutex) {
+
+            std::vector<VMTransport*>::iterator iter = this->transports.begin();
+            for (; iter != this->transports.end(); ++iter) {
+                if (*iter == transport) {
+                    this->transports.erase(iter);
+                    break;
+                }
+            }
+
+            remove(transport, Pointer<DataStructure>());
+
+            if (this->transports.empty()) {
+                std::map<std::string, Pointer<VMBroker> >::iterator entry = theOnlyInstance->brokers.find(this->name);
+                if (entry != theOnlyInstance->brokers.end() && entry->second.get() == this) {
+                    theOnlyInstance->brokers.erase(entry);
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> VMBroker::process(VMTransport* transport, const Pointer<Command> command) {
+
+    synchronized(&mutex) {
+
+        if (command->isMessage()) {
+
+            Pointer<Message> message = command.dynamicCast<Message>();
+
+            if (message->getTransactionId() != NULL) {
+                this->transactions[message->getTransactionId()->toString()].push_back(message);
+            } else {
+                route(message);
+            }
+
+        } else if (command->isConsumerInfo()) {
+
+            Pointer<ConsumerInfo> info = command.dynamicCast<ConsumerInfo>();
+
+            if (info->isBrowser()) {
+                browse(transport, info);
+            } else {
+                addConsumer(transport, info);
+            }
+
+        } else if (command->isRemoveInfo()) {
+
+            Pointer<RemoveInfo> info = command.dynamicCast<RemoveInfo>();
+            if (info->getObjectId() != NULL) {
+                remove(transport, info->getObjectId());
+            }
+
+        } else if (command->isTransactionInfo()) {
+
+            Pointer<TransactionInfo> info = command.dynamicCast<TransactionInfo>();
+            if (info->getTransactionId() != NULL) {
+
+                std::string key = info->getTransactionId()->toString();
+
+                switch (info->getType()) {
+                    case ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE:
+                    case ActiveMQConstants::TRANSACTION_STATE_COMMITTWOPHASE: {
+                        std::vector< Pointer<Message> > messages;
+                        messages.swap(this->transactions[key]);
+                        this->transactions.erase(key);
+
+                        std::vector< Pointer<Message> >::const_iterator iter = messages.begin();
+                        for (; iter != messages.end(); ++iter) {
+                            route(*iter);
+                        }
+                        break;
+                    }
+                    case ActiveMQConstants::TRANSACTION_STATE_ROLLBACK:
+                    case ActiveMQConstants::TRANSACTION_STATE_FORGET:
+                        this->transactions.erase(key);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+
+    if (command->isResponseRequired()) {
+        Pointer<Response> response(new Response());
+        response->setCorrelationId(command->getCommandId());
+        return response;
+    }
+
+    return Pointer<Response>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int VMBroker::getTransportCount() const {
+
+    synchronized(&mutex) {
+        return (int) this->transports.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int VMBroker::getConsumerCount() const {
+
+    synchronized(&mutex) {
+        return (int) this->consumers.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int VMBroker::getPendingCount() const {
+
+    int count = 0;
+
+    synchronized(&mutex) {
+        std::map<std::string, Destination>::const_iterator iter = this->destinations.begin();
+        for (; iter != this->destinations.end(); ++iter) {
+            count += (int) iter->second.pending.size();
+        }
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::addConsumer(VMTransport* transport, const Pointer<ConsumerInfo> info) {
+
+    if (info->getConsumerId() == NULL || info->getDestination() == NULL) {
+        return;
+    }
+
+    std::string key = keyOf(info->getDestination().get());
+    std::string consumerId = info->getConsumerId()->toString();
+
+    // A consumer registered again after a reconnect replaces the old registration.
+    removeConsumer(consumerId);
+
+    Pointer<Subscription> subscription(new Subscription(info, transport));
+
+    Destination& destination = this->destinations[key];
+    destination.subscriptions.push_back(subscription);
+    this->consumers[consumerId] = key;
+
+    // Hand the new consumer what was sent to the Queue before anyone was listening.
+    while (!destination.pending.empty()) {
+        dispatch(*subscription, destination.pending.front());
+        destination.pending.pop_front();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::browse(VMTransport* transport, const Pointer<ConsumerInfo> info) {
+
+    if (info->getConsumerId() == NULL || info->getDestination() == NULL) {
+        return;
+    }
+
+    Subscription browser(info, transport);
+
+    std::map<std::string, Destination>::const_iterator iter = this->destinations.find(keyOf(info->getDestination().get()));
+    if (iter != this->destinations.end()) {
+        std::deque< Pointer<Message> >::const_iterator message = iter->second.pending.begin();
+        for (; message != iter->second.pending.end(); ++message) {
+            dispatch(browser, Pointer<Message>((*message)->cloneDataStructure()));
+        }
+    }
+
+    // A dispatch without a message marks the end of the browse.
+    dispatch(browser, Pointer<Message>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::remove(VMTransport* transport, const Pointer<DataStructure> id) {
+
+    if (id != NULL && id->getDataStructureType() == ConsumerId::ID_CONSUMERID) {
+        removeConsumer(id.dynamicCast<ConsumerId>()->toString());
+        return;
+    }
+
+    // A NULL id removes every consumer of the transport.
+    const ConnectionId* connectionId = NULL;
+    const SessionId* sessionId = NULL;
+
+    if (id != NULL && id->getDataStructureType() == ConnectionId::ID_CONNECTIONID) {
+        connectionId = dynamic_cast<const ConnectionId*>(id.get());
+    } else if (id != NULL && id->getDataStructureType() == SessionId::ID_SESSIONID) {
+        sessionId = dynamic_cast<const SessionId*>(id.get());
+    } else if (id != NULL) {
+        return;
+    }
+
+    std::vector<std::string> removed;
+
+    std::map<std::string, Destination>::const_iterator iter = this->destinations.begin();
+    for (; iter != this->destinations.end(); ++iter) {
+
+        std::vector< Pointer<Subscription> >::const_iterator sub = iter->second.subscriptions.begin();
+        for (; sub != iter->second.subscriptions.end(); ++sub) {
+
+            if ((*sub)->transport != transport) {
+                continue;
+            }
+
+            const ConsumerId& consumerId = *(*sub)->info->getConsumerId();
+
+            if (connectionId != NULL && consumerId.getConnectionId() != connectionId->getValue()) {
+                continue;
+            }
+
+            if (sessionId != NULL && (consumerId.getConnectionId() != sessionId->getConnectionId() ||
+                                      consumerId.getSessionId() != sessionId->getValue())) {
+                continue;
+            }
+
+            removed.push_back(consumerId.toString());
+        }
+    }
+
+    std::vector<std::string>::const_iterator consumer = removed.begin();
+    for (; consumer != removed.end(); ++consumer) {
+        removeConsumer(*consumer);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::removeConsumer(const std::string& consumerId) {
+
+    std::map<std::string, std::string>::iterator entry = this->consumers.find(consumerId);
+    if (entry == this->consumers.end()) {
+        return;
+    }
+
+    std::map<std::string, Destination>::iterator iter = this->destinations.find(entry->second);
+    this->consumers.erase(entry);
+
+    if (iter == this->destinations.end()) {
+        return;
+    }
+
+    Destination& destination = iter->second;
+
+    std::vector< Pointer<Subscription> >::iterator sub = destination.subscriptions.begin();
+    for (; sub != destination.subscriptions.end(); ++sub) {
+        if ((*sub)->info->getConsumerId()->toString() == consumerId) {
+            destination.subscriptions.erase(sub);
+            break;
+        }
+    }
+
+    if (destination.subscriptions.empty() && destination.pending.empty()) {
+        this->destinations.erase(iter);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::route(const Pointer<Message> message) {
+
+    const ActiveMQDestination* target = message->getDestination().get();
+    if (target == NULL) {
+        return;
+    }
+
+    std::string key = keyOf(target);
+
+    if (target->isTopic()) {
+
+        std::map<std::string, Destination>::const_iterator iter = this->destinations.find(key);
+        if (iter == this->destinations.end()) {
+            return;
+        }
+
+        const std::vector< Pointer<Subscription> >& subscriptions = iter->second.subscriptions;
+        if (subscriptions.empty()) {
+            return;
+        }
+
+        // Each consumer marks the message it is given, so only one can be handed the
+        // instance that was sent.  Every copy is taken before that, once it has been
+        // dispatched its consumer may already be changing it on another thread.
+        std::vector< Pointer<Message> > copies;
+        copies.reserve(subscriptions.size() - 1);
+        for (std::size_t i = 1; i < subscriptions.size(); ++i) {
+            copies.push_back(Pointer<Message>(message->cloneDataStructure()));
+        }
+
+        for (std::size_t i = 1; i < subscriptions.size(); ++i) {
+            dispatch(*subscriptions[i], copies[i - 1]);
+        }
+
+        dispatch(*subscriptions[0], message);
+
+    } else {
+
+        Destination& destination = this->destinations[key];
+
+        if (destination.subscriptions.empty()) {
+            destination.pending.push_back(message);
+            return;
+        }
+
+        if (destination.next >= destination.subscriptions.size()) {
+            destination.next = 0;
+        }
+
+        dispatch(*destination.subscriptions[destination.next++], message);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::dispatch(const Subscription& subscription, const Pointer<Message> message) {
+
+    Pointer<MessageDispatch> dispatch(new MessageDispatch());
+    dispatch->setConsumerId(subscription.info->getConsumerId());
+    dispatch->setDestination(subscription.info->getDestination());
+    dispatch->setMessage(message);
+    dispatch->setRedeliveryCounter(0);
+
+    subscription.transport->deliver(dispatch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string VMBroker::keyOf(const ActiveMQDestination* destination) {
+    return Integer::toString((int) destination->getDestinationType()) + ":" + destination->getPhysicalName();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::initialize() {
+    theOnlyInstance = new VMBrokerRegistry();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMBroker::shutdown() {
+    delete theOnlyInstance;
+    theOnlyInstance = NULL;
+}
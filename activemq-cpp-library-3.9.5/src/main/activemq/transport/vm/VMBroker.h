@@ -0,0 +1,213 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_VM_VMBROKER_H_
+#define _ACTIVEMQ_TRANSPORT_VM_VMBROKER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <activemq/commands/Command.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/Response.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace transport {
+namespace vm {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::Command;
+    using activemq::commands::Response;
+
+    class VMTransport;
+
+    /**
+     * A minimal message router that lives inside the process and is reached through
+     * the vm:// transport.  The Message objects a producer sends are handed to the
+     * consumers as they are, nothing is marshaled on the way.
+     *
+     * A message sent to a Topic goes to every consumer on that Topic, each consumer
+     * after the first gets its own copy.  A message sent to a Queue goes to one of the
+     * Queue's consumers in turn, or is held until a consumer arrives if there is none.
+     * Messages sent in a transaction are held until it commits and dropped if it rolls
+     * back.  Every command that asks for one is given a Response.
+     *
+     * The router keeps nothing beyond what is needed to route: selectors, message
+     * expiration, redelivery and persistence are not supported and acknowledgements
+     * are accepted and discarded.  A router is created when the first transport with
+     * its name connects and goes away, along with any messages it holds, when the last
+     * one disconnects.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API VMBroker {
+    private:
+
+        class Subscription {
+        private:
+
+            Subscription(const Subscription&);
+            Subscription& operator=(const Subscription&);
+
+        public:
+
+            Pointer<commands::ConsumerInfo> info;
+            VMTransport* transport;
+
+            Subscription(const Pointer<commands::ConsumerInfo> info, VMTransport* transport) :
+                info(info), transport(transport) {
+            }
+        };
+
+        class Destination {
+        public:
+
+            std::vector< Pointer<Subscription> > subscriptions;
+            std::deque< Pointer<commands::Message> > pending;
+            std::size_t next;
+
+            Destination() : subscriptions(), pending(), next(0) {}
+        };
+
+    private:
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        std::string name;
+
+        std::vector<VMTransport*> transports;
+        std::map<std::string, Destination> destinations;
+        std::map<std::string, std::string> consumers;
+        std::map<std::string, std::vector< Pointer<commands::Message> > > transactions;
+
+    private:
+
+        VMBroker(const VMBroker&);
+        VMBroker& operator=(const VMBroker&);
+
+    public:
+
+        /**
+         * Creates a new router with the given name.
+         *
+         * @param name
+         *      The name of the router, the host part of the vm:// URI.
+         */
+        VMBroker(const std::string& name);
+
+        virtual ~VMBroker();
+
+        /**
+         * Connects a transport to the router with the given name, the router is created
+         * if it does not exist.  The transport is sent the router's BrokerInfo.
+         *
+         * @param name
+         *      The name of the router.
+         * @param transport
+         *      The transport that is connecting.
+         *
+         * @return the router the transport is now connected to.
+         */
+        static Pointer<VMBroker> connect(const std::string& name, VMTransport* transport);
+
+        /**
+         * @return the number of routers that currently exist.
+         */
+        static int getBrokerCount();
+
+        /**
+         * @return the name of this router.
+         */
+        std::string getName() const {
+            return this->name;
+        }
+
+        /**
+         * Removes a transport and all of its consumers from the router, the router is
+         * dropped when its last transport disconnects.
+         *
+         * @param transport
+         *      The transport that disconnected.
+         */
+        void disconnect(VMTransport* transport);
+
+        /**
+         * Handles a command that was sent by the given transport.
+         *
+         * @param transport
+         *      The transport the command was sent on.
+         * @param command
+         *      The command that was sent.
+         *
+         * @return the Response to the command, or NULL if it did not ask for one.
+         */
+        Pointer<Response> process(VMTransport* transport, const Pointer<Command> command);
+
+        /**
+         * @return the number of transports connected to this router.
+         */
+        int getTransportCount() const;
+
+        /**
+         * @return the number of consumers registered with this router.
+         */
+        int getConsumerCount() const;
+
+        /**
+         * @return the number of Queue messages that are waiting for a consumer.
+         */
+        int getPendingCount() const;
+
+    private:
+
+        void addConsumer(VMTransport* transport, const Pointer<commands::ConsumerInfo> info);
+
+        void browse(VMTransport* transport, const Pointer<commands::ConsumerInfo> info);
+
+        void remove(VMTransport* transport, const Pointer<commands::DataStructure> id);
+
+        void removeConsumer(const std::string& consumerId);
+
+        void route(const Pointer<commands::Message> message);
+
+        static void dispatch(const Subscription& subscription, const Pointer<commands::Message> message);
+
+        static std::string keyOf(const commands::ActiveMQDestination* destination);
+
+    private:
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_VM_VMBROKER_H_ */
@@ -0,0 +1,199 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VMTransport.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::vm;
+using namespace activemq::wireformat;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+VMTransport::VMTransport(const std::string& name, const Pointer<WireFormat> wireFormat) :
+    Transport(), Runnable(), name(name), wireFormat(wireFormat), listener(NULL), broker(), thread(),
+    inboundQueue(), started(false), closed(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+VMTransport::~VMTransport() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransport::start() {
+
+    try {
+
+        if (this->closed.get()) {
+            throw IOException(__FILE__, __LINE__, "VMTransport::start() - transport is already closed - cannot restart");
+        }
+
+        if (this->listener == NULL) {
+            throw IOException(__FILE__, __LINE__, "VMTransport::start() - transportListener is invalid");
+        }
+
+        if (this->started.compareAndSet(false, true)) {
+            this->broker = VMBroker::connect(this->name, this);
+
+            this->thread.reset(new Thread(this, "VMTransport dispatch Thread: " + this->name));
+            this->thread->start();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransport::stop() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransport::close() {
+
+    try {
+
+        if (!this->closed.compareAndSet(false, true)) {
+            return;
+        }
+
+        if (this->broker != NULL) {
+            this->broker->disconnect(this);
+        }
+
+        synchronized(&this->inboundQueue) {
+            this->inboundQueue.clear();
+            this->inboundQueue.notifyAll();
+        }
+
+        // The listener may close the transport from within a dispatch.
+        if (this->thread != NULL && Thread::currentThread() != this->thread.get()) {
+            this->thread->join();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransport::deliver(const Pointer<Command> command) {
+
+    synchronized(&this->inboundQueue) {
+        if (!this->closed.get()) {
+            this->inboundQueue.add(command);
+            this->inboundQueue.notifyAll();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransport::oneway(const Pointer<Command> command) {
+
+    try {
+
+        if (this->closed.get()) {
+            throw IOException(__FILE__, __LINE__, "VMTransport::oneway() - transport is closed!");
+        }
+
+        if (this->broker == NULL) {
+            throw IOException(__FILE__, __LINE__, "VMTransport::oneway() - transport is not started!");
+        }
+
+        Pointer<Response> response = this->broker->process(this, command);
+
+        // Nothing else waits on a Response, so it is handed over without queuing.
+        if (response != NULL) {
+            fire(response);
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FutureResponse> VMTransport::asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
+                                                  const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "VMTransport::asyncRequest() - unsupported operation");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> VMTransport::request(const Pointer<Command> command AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "VMTransport::request() - unsupported operation");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> VMTransport::request(const Pointer<Command> command AMQCPP_UNUSED, unsigned int timeout AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "VMTransport::request() - unsupported operation");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransport::run() {
+
+    try {
+
+        while (!this->closed.get()) {
+
+            Pointer<Command> command;
+
+            synchronized(&this->inboundQueue) {
+                while (this->inboundQueue.isEmpty() && !this->closed.get()) {
+                    this->inboundQueue.wait();
+                }
+
+                if (this->closed.get()) {
+                    break;
+                }
+
+                command = this->inboundQueue.pop();
+            }
+
+            fire(command);
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransport::fire(const Pointer<Command> command) {
+
+    try {
+
+        if (this->listener == NULL || this->closed.get()) {
+            return;
+        }
+
+        this->listener->onCommand(command);
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_VM_VMTRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_VM_VMTRANSPORT_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/Transport.h>
+#include <activemq/transport/TransportListener.h>
+#include <activemq/transport/vm/VMBroker.h>
+#include <activemq/commands/Command.h>
+#include <activemq/commands/Response.h>
+#include <activemq/wireformat/WireFormat.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/LinkedList.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/io/IOException.h>
+
+namespace activemq {
+namespace transport {
+namespace vm {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::Command;
+    using activemq::commands::Response;
+
+    /**
+     * A Transport that connects to a VMBroker in the same process instead of a broker
+     * over the network.  Commands are passed to the router as objects, nothing is
+     * marshaled in either direction.
+     *
+     * A Response is handed to the listener on the thread that sent the command, so a
+     * request completes without a thread hand off.  The commands the router sends on
+     * its own, such as message dispatches, are queued and delivered from this
+     * transport's own thread in the same way a socket transport delivers what it reads.
+     *
+     * Like the IOTransport this transport only supports oneway sends, it is wrapped in
+     * a ResponseCorrelator to support requests.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API VMTransport : public Transport, public decaf::lang::Runnable {
+    private:
+
+        std::string name;
+        Pointer<wireformat::WireFormat> wireFormat;
+        TransportListener* listener;
+
+        Pointer<VMBroker> broker;
+        Pointer<decaf::lang::Thread> thread;
+        decaf::util::LinkedList< Pointer<Command> > inboundQueue;
+
+        decaf::util::concurrent::atomic::AtomicBoolean started;
+        decaf::util::concurrent::atomic::AtomicBoolean closed;
+
+    private:
+
+        VMTransport(const VMTransport&);
+        VMTransport& operator=(const VMTransport&);
+
+    public:
+
+        /**
+         * Creates a new VMTransport for the router with the given name.
+         *
+         * @param name
+         *      The name of the router to connect to.
+         * @param wireFormat
+         *      The WireFormat reported to the layers above, it is never used to marshal.
+         */
+        VMTransport(const std::string& name, const Pointer<wireformat::WireFormat> wireFormat);
+
+        virtual ~VMTransport();
+
+        /**
+         * Queues a command from the router for delivery to this transport's listener.
+         *
+         * @param command
+         *      The command the router is sending.
+         */
+        void deliver(const Pointer<Command> command);
+
+        /**
+         * @return the router this transport is connected to, NULL until it is started.
+         */
+        Pointer<VMBroker> getBroker() const {
+            return this->broker;
+        }
+
+        /**
+         * @return the name of the router this transport connects to.
+         */
+        std::string getName() const {
+            return this->name;
+        }
+
+    public:  // Transport methods
+
+        virtual void start();
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual void oneway(const Pointer<Command> command);
+
+        virtual Pointer<FutureResponse> asyncRequest(const Pointer<Command> command,
+                                                     const Pointer<ResponseCallback> responseCallback);
+
+        virtual Pointer<Response> request(const Pointer<Command> command);
+
+        virtual Pointer<Response> request(const Pointer<Command> command, unsigned int timeout);
+
+        virtual Pointer<wireformat::WireFormat> getWireFormat() const {
+            return this->wireFormat;
+        }
+
+        virtual void setWireFormat(const Pointer<wireformat::WireFormat> wireFormat) {
+            this->wireFormat = wireFormat;
+        }
+
+        virtual void setTransportListener(TransportListener* listener) {
+            this->listener = listener;
+        }
+
+        virtual TransportListener* getTransportListener() const {
+            return this->listener;
+        }
+
+        virtual Transport* narrow(const std::type_info& typeId) {
+            if (typeid(*this) == typeId) {
+                return this;
+            }
+
+            return NULL;
+        }
+
+        virtual bool isFaultTolerant() const {
+            return false;
+        }
+
+        virtual bool isConnected() const {
+            return this->started.get() && !this->closed.get();
+        }
+
+        virtual bool isClosed() const {
+            return this->closed.get();
+        }
+
+        virtual std::string getRemoteAddress() const {
+            return "vm://" + this->name;
+        }
+
+        virtual bool isReconnectSupported() const {
+            return false;
+        }
+
+        virtual bool isUpdateURIsSupported() const {
+            return false;
+        }
+
+        virtual void updateURIs(bool rebalance AMQCPP_UNUSED, const decaf::util::List<decaf::net::URI>& uris AMQCPP_UNUSED) {
+            throw decaf::io::IOException();
+        }
+
+        virtual void reconnect(const decaf::net::URI& uri AMQCPP_UNUSED) {}
+
+    public:  // Runnable methods.
+
+        virtual void run();
+
+    private:
+
+        void fire(const Pointer<Command> command);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_VM_VMTRANSPORT_H_ */
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VMTransportFactory.h"
+
+#include <activemq/transport/vm/VMTransport.h>
+#include <activemq/transport/correlator/ResponseCorrelator.h>
+#include <activemq/transport/logging/LoggingTransport.h>
+#include <activemq/util/URISupport.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::wireformat;
+using namespace activemq::transport;
+using namespace activemq::transport::vm;
+using namespace activemq::transport::correlator;
+using namespace activemq::transport::logging;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> VMTransportFactory::create(const decaf::net::URI& location) {
+
+    try {
+
+        Properties properties = activemq::util::URISupport::parseQuery(location.getQuery());
+
+        Pointer<WireFormat> wireFormat = this->createWireFormat(properties);
+
+        // Create the initial Transport, then wrap it in the normal Filters
+        Pointer<Transport> transport(doCreateComposite(location, wireFormat, properties));
+
+        // Create the Transport for response correlator
+        transport.reset(new ResponseCorrelator(transport));
+
+        // If command tracing was enabled, wrap the transport with a logging transport.
+        if (properties.getProperty("transport.commandTracingEnabled", "false") == "true") {
+            transport.reset(new LoggingTransport(transport));
+        }
+
+        return transport;
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> VMTransportFactory::createComposite(const decaf::net::URI& location) {
+
+    try {
+
+        Properties properties = activemq::util::URISupport::parseQuery(location.getQuery());
+
+        Pointer<WireFormat> wireFormat = this->createWireFormat(properties);
+
+        return doCreateComposite(location, wireFormat, properties);
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> VMTransportFactory::doCreateComposite(const decaf::net::URI& location,
+                                                         const Pointer<wireformat::WireFormat> wireFormat,
+                                                         const decaf::util::Properties& properties AMQCPP_UNUSED) {
+
+    try {
+
+        std::string name = location.getHost();
+        if (name.empty()) {
+            name = "localhost";
+        }
+
+        return Pointer<Transport>(new VMTransport(name, wireFormat));
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
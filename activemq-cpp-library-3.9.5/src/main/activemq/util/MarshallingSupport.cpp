@@ -21,6 +21,11 @@
 #include <activemq/exceptions/ExceptionDefines.h>
 #include <decaf/lang/Short.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/io/ByteArrayInputStream.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 using namespace activemq;
 using namespace activemq::util;
@@ -29,6 +34,69 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace std;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Names up to this length are read without a heap allocated buffer.
+    const std::size_t NAME_BUFFER_SIZE = 128;
+
+    // Property names set by the broker and this client along with the WireFormatInfo
+    // options, the names that turn up in nearly every properties block.
+    const std::string INTERNED_NAMES[] = {
+        "JMSXDeliveryCount",
+        "JMSXGroupID",
+        "JMSXGroupSeq",
+        "JMSXGroupFirstForConsumer",
+        "JMSXUserID",
+        "JMSXProducerTXID",
+        "JMSXConsumerTXID",
+        "JMSXRcvTimestamp",
+        "JMSXAppID",
+        "JMSXState",
+        "AMQ_SCHEDULED_DELAY",
+        "AMQ_SCHEDULED_PERIOD",
+        "AMQ_SCHEDULED_REPEAT",
+        "AMQ_SCHEDULED_CRON",
+        "AMQ_SCHEDULED_ID",
+        "CacheEnabled",
+        "CacheSize",
+        "MaxFrameSize",
+        "MaxInactivityDuration",
+        "MaxInactivityDurationInitalDelay",
+        "PlatformDetails",
+        "ProviderName",
+        "ProviderVersion",
+        "SizePrefixDisabled",
+        "StackTraceEnabled",
+        "TcpNoDelayEnabled",
+        "TightEncodingEnabled"
+    };
+
+    const std::size_t INTERNED_NAME_COUNT = sizeof(INTERNED_NAMES) / sizeof(INTERNED_NAMES[0]);
+
+    // True when the bytes need no modified UTF-8 encoding, NUL is encoded as two bytes.
+    bool isPlainAscii(const unsigned char* bytes, std::size_t length) {
+        for (std::size_t i = 0; i < length; ++i) {
+            if (bytes[i] == 0 || bytes[i] > 0x7F) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    const std::string* findInternedName(const unsigned char* bytes, std::size_t length) {
+        for (std::size_t i = 0; i < INTERNED_NAME_COUNT; ++i) {
+            const std::string& name = INTERNED_NAMES[i];
+            if (name.length() == length && std::memcmp(name.data(), bytes, length) == 0) {
+                return &name;
+            }
+        }
+
+        return NULL;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 MarshallingSupport::MarshallingSupport() {
 }
@@ -101,14 +169,13 @@ void MarshallingSupport::writeString32(decaf::io::DataOutputStream& dataOut, con
 std::string MarshallingSupport::readString16(decaf::io::DataInputStream& dataIn) {
 
     try {
+        std::string result;
         int utfLength = dataIn.readShort();
         if (utfLength > 0) {
-
-            std::vector<unsigned char> buffer(utfLength);
-            dataIn.readFully(&buffer[0], utfLength);
-            return std::string((char*) (&buffer[0]), utfLength);
+            result.resize(utfLength);
+            dataIn.readFully((unsigned char*) &result[0], utfLength);
         }
-        return "";
+        return result;
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
@@ -119,15 +186,83 @@ std::string MarshallingSupport::readString16(decaf::io::DataInputStream& dataIn)
 std::string MarshallingSupport::readString32(decaf::io::DataInputStream& dataIn) {
 
     try {
+        std::string result;
         int utfLength = dataIn.readInt();
         if (utfLength > 0) {
+            result.resize(utfLength);
+            dataIn.readFully((unsigned char*) &result[0], utfLength);
+        }
+        return result;
+    }
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
+}
 
-            std::vector<unsigned char> buffer(utfLength);
-            dataIn.readFully(&buffer[0], utfLength);
-            return std::string((char*) (&buffer[0]), utfLength);
+////////////////////////////////////////////////////////////////////////////////
+void MarshallingSupport::writePropertyName(decaf::io::DataOutputStream& dataOut, const std::string& name) {
+
+    try {
+
+        std::size_t length = name.length();
+
+        if (length <= 65535 && isPlainAscii((const unsigned char*) name.data(), length)) {
+            dataOut.writeUnsignedShort((unsigned short) length);
+            if (length > 0) {
+                dataOut.write((const unsigned char*) name.data(), (int) length, 0, (int) length);
+            }
+        } else {
+            dataOut.writeUTF(name);
         }
-        return "";
     }
+    AMQ_CATCH_RETHROW(decaf::io::UTFDataFormatException)
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string MarshallingSupport::readPropertyName(decaf::io::DataInputStream& dataIn) {
+
+    try {
+
+        unsigned short utfLength = dataIn.readUnsignedShort();
+        if (utfLength == 0) {
+            return "";
+        }
+
+        unsigned char local[NAME_BUFFER_SIZE];
+        std::vector<unsigned char> overflow;
+        unsigned char* bytes = local;
+
+        if (utfLength > NAME_BUFFER_SIZE) {
+            overflow.resize(utfLength);
+            bytes = &overflow[0];
+        }
+
+        dataIn.readFully(bytes, utfLength);
+
+        if (isPlainAscii(bytes, utfLength)) {
+
+            const std::string* interned = findInternedName(bytes, utfLength);
+            if (interned != NULL) {
+                return *interned;
+            }
+
+            return std::string((const char*) bytes, utfLength);
+        }
+
+        // Multi byte characters are rare in names, decode them the way readUTF does.
+        std::vector<unsigned char> encoded(utfLength + 2);
+        encoded[0] = (unsigned char) (utfLength >> 8);
+        encoded[1] = (unsigned char) (utfLength & 0xFF);
+        std::copy(bytes, bytes + utfLength, encoded.begin() + 2);
+
+        ByteArrayInputStream bytesIn(encoded);
+        DataInputStream encodedIn(&bytesIn);
+        return encodedIn.readUTF();
+    }
+    AMQ_CATCH_RETHROW(decaf::io::UTFDataFormatException)
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
     AMQ_CATCHALL_THROW(decaf::io::IOException)
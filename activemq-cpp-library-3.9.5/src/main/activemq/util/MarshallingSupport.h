@@ -117,6 +117,37 @@ namespace util {
          */
         static std::string readString32(decaf::io::DataInputStream& dataIn);
 
+        /**
+         * Writes a property name in the modified UTF-8 form that DataOutputStream::writeUTF
+         * produces.  Names made up of plain ASCII characters, which is nearly all of them,
+         * are written as they are without first building an encoded copy.
+         *
+         * @param dataOut
+         *      The DataOutputStream to write the name to.
+         * @param name
+         *      The property name to write.
+         *
+         * @throws IOException if an I/O error occurs while writing the name.
+         * @throws UTFDataFormatException if the encoded name is longer than 65535 bytes.
+         */
+        static void writePropertyName(decaf::io::DataOutputStream& dataOut, const std::string& name);
+
+        /**
+         * Reads a property name written by writePropertyName or DataOutputStream::writeUTF.
+         * The names the broker and the client set on their own, such as JMSXGroupID or
+         * the WireFormatInfo options, are interned and returned as a copy of one shared
+         * instance instead of being decoded again for each message.
+         *
+         * @param dataIn
+         *      The DataInputStream to read the name from.
+         *
+         * @return the property name.
+         *
+         * @throws IOException if an I/O error occurs while reading the name.
+         * @throws UTFDataFormatException if the name is not valid modified UTF-8.
+         */
+        static std::string readPropertyName(decaf::io::DataInputStream& dataIn);
+
     public:
         // Static Utility Methods.
 
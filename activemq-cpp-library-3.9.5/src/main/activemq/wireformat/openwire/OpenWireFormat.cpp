@@ -25,11 +25,15 @@
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <activemq/wireformat/openwire/OpenWireFormatNegotiator.h>
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <activemq/wireformat/openwire/utils/FrameInputStream.h>
 #include <activemq/wireformat/MarshalAware.h>
 #include <activemq/commands/WireFormatInfo.h>
 #include <activemq/commands/DataStructure.h>
+#include <activemq/commands/Message.h>
 #include <activemq/wireformat/openwire/marshal/DataStreamMarshaller.h>
 #include <activemq/wireformat/openwire/marshal/generated/MarshallerFactory.h>
+#include <activemq/wireformat/openwire/marshal/PreparedMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/VersionedMarshallerFactory.h>
 #include <activemq/exceptions/ActiveMQException.h>
 
 using namespace std;
@@ -47,22 +51,77 @@ using namespace decaf::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * Holds the memory that one size prefixed frame is read into.  Frames up to the
+     * pool's retained size use a pooled buffer, larger ones get a buffer of their own
+     * that is freed once the frame is decoded.  Keeping those in the pool would pin
+     * memory as large as the biggest message ever received, so instead they are at
+     * least not zero filled before the frame is read over them.
+     */
+    class FrameBuffer {
+    private:
+
+        FrameBufferPool* pool;
+        std::vector<unsigned char>* pooled;
+        unsigned char* unpooled;
+
+    private:
+
+        FrameBuffer(const FrameBuffer&);
+        FrameBuffer& operator=(const FrameBuffer&);
+
+    public:
+
+        FrameBuffer(FrameBufferPool* pool, int size) : pool(pool), pooled(NULL), unpooled(NULL) {
+            if (size > pool->getMaxRetainedSize()) {
+                unpooled = new unsigned char[size];
+            } else if (size > 0) {
+                pooled = pool->acquire(size);
+            }
+        }
+
+        ~FrameBuffer() {
+            pool->release(pooled);
+            delete [] unpooled;
+        }
+
+        unsigned char* get() const {
+            if (pooled != NULL) {
+                return &(*pooled)[0];
+            }
+            return unpooled;
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 const unsigned char OpenWireFormat::NULL_TYPE = 0;
 const int OpenWireFormat::DEFAULT_VERSION = 1;
 const int OpenWireFormat::MAX_SUPPORTED_VERSION = 11;
+const long long OpenWireFormat::DEFAULT_MAX_FRAME_SIZE = Long::MAX_VALUE;
 
 ////////////////////////////////////////////////////////////////////////////////
 OpenWireFormat::OpenWireFormat(const decaf::util::Properties& properties) :
-    properties(properties), preferedWireFormatInfo(), dataMarshallers(256),
-    id(UUID::randomUUID().toString()), receiving(), version(0), stackTraceEnabled(true),
+    properties(properties), preferedWireFormatInfo(), dataMarshallers(256), genericMarshallers(256),
+    versionedMarshallers(MAX_SUPPORTED_VERSION + 1),
+    id(UUID::randomUUID().toString()), receiving(), framePool(2, 64 * 1024), version(0), stackTraceEnabled(true),
     tcpNoDelayEnabled(true), cacheEnabled(true), cacheSize(1024), tightEncodingEnabled(false),
-    sizePrefixDisabled(false), maxInactivityDuration(30000), maxInactivityDurationInitialDelay(10000) {
+    sizePrefixDisabled(false), maxInactivityDuration(30000), maxInactivityDurationInitialDelay(10000),
+    maxFrameSize(DEFAULT_MAX_FRAME_SIZE) {
 
     // initialize the universal marshalers, don't need to reset them again
     // after this so its safe to do this here.
     generated::MarshallerFactory().configure(this);
 
+    // Created up front so that a renegotiation never frees a Marshaler that another
+    // thread could still be using.
+    for (int i = 0; i <= MAX_SUPPORTED_VERSION; ++i) {
+        VersionedMarshallerFactory::create(i, this->versionedMarshallers[i]);
+    }
+
     // Set to Default as lowest common denominator, then we will try
     // and move up to the preferred when the wireformat is negotiated.
     this->setVersion(DEFAULT_VERSION);
@@ -90,10 +149,18 @@ Pointer<Transport> OpenWireFormat::createNegotiator(const Pointer<Transport> tra
 void OpenWireFormat::destroyMarshalers() {
 
     try {
-        for (size_t i = 0; i < dataMarshallers.size(); ++i) {
-            delete dataMarshallers[i];
+        for (size_t i = 0; i < genericMarshallers.size(); ++i) {
+            delete genericMarshallers[i];
+            genericMarshallers[i] = NULL;
             dataMarshallers[i] = NULL;
         }
+
+        for (size_t i = 0; i < versionedMarshallers.size(); ++i) {
+            for (size_t j = 0; j < versionedMarshallers[i].size(); ++j) {
+                delete versionedMarshallers[i][j];
+            }
+            versionedMarshallers[i].clear();
+        }
     }
     AMQ_CATCH_NOTHROW(ActiveMQException)
     AMQ_CATCHALL_NOTHROW()
@@ -113,16 +180,34 @@ void OpenWireFormat::setVersion(int version) {
                     "Given Version: %d , is not yet supported", version);
         }
 
-        // Clear old marshalers in preparation for the new set.
         this->version = version;
+        this->selectMarshallers();
     }
     AMQ_CATCH_RETHROW(IllegalArgumentException)
     AMQ_CATCHALL_THROW(IllegalArgumentException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::selectMarshallers() {
+
+    for (size_t i = 0; i < dataMarshallers.size(); ++i) {
+        dataMarshallers[i] = genericMarshallers[i];
+    }
+
+    if (this->version < 0 || this->version >= (int) this->versionedMarshallers.size()) {
+        return;
+    }
+
+    const std::vector<DataStreamMarshaller*>& versioned = this->versionedMarshallers[this->version];
+    for (size_t i = 0; i < versioned.size(); ++i) {
+        dataMarshallers[versioned[i]->getDataStructureType() & 0xFF] = versioned[i];
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void OpenWireFormat::addMarshaller(DataStreamMarshaller* marshaller) {
     unsigned char type = marshaller->getDataStructureType();
+    genericMarshallers[type & 0xFF] = marshaller;
     dataMarshallers[type & 0xFF] = marshaller;
 }
 
@@ -173,6 +258,16 @@ void OpenWireFormat::marshal(const Pointer<commands::Command> command, const act
 
             } else {
 
+                // A Message sent from a prepared Message has most of its fields
+                // written from runs marshaled once when it was prepared.
+                if (command->isMessage()) {
+                    const Message* message = static_cast<const Message*>(command.get());
+                    const Pointer<PreparedMessageMarshaller>& prepared = message->getPreparedMarshaller();
+                    if (prepared != NULL && prepared->isPreparedFor(message)) {
+                        dsm = prepared.get();
+                    }
+                }
+
                 if (sizePrefixDisabled) {
                     dataOut->writeByte(type);
                     dsm->looseMarshal(this, dataStructure, dataOut);
@@ -213,6 +308,20 @@ void OpenWireFormat::marshal(const Pointer<commands::Command> command, const act
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::checkFrameSize(int size) const {
+
+    if (size < 0) {
+        throw IOException(__FILE__, __LINE__, "OpenWireFormat::checkFrameSize - Invalid frame size: %d", size);
+    }
+
+    if ((long long) size > this->maxFrameSize) {
+        throw IOException(__FILE__, __LINE__,
+            "OpenWireFormat::checkFrameSize - Frame size of %d bytes larger than max allowed %lld bytes",
+            size, this->maxFrameSize);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<commands::Command> OpenWireFormat::unmarshal(const activemq::transport::Transport* transport AMQCPP_UNUSED, decaf::io::DataInputStream* dis) {
 
@@ -222,12 +331,33 @@ Pointer<commands::Command> OpenWireFormat::unmarshal(const activemq::transport::
             throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
         }
 
+        Pointer<DataStructure> data;
+
         if (!sizePrefixDisabled) {
-            dis->readInt();
-        }
 
-        // Get the unmarshalled DataStructure
-        Pointer<DataStructure> data(doUnmarshal(dis));
+            int size = dis->readInt();
+            checkFrameSize(size);
+
+            if (dynamic_cast<FrameInputStream*>(dis) != NULL) {
+                // The caller already holds the whole frame in memory.
+                data.reset(doUnmarshal(dis));
+            } else {
+
+                FrameBuffer frame(&this->framePool, size);
+
+                // Read the whole frame with one call and decode it from memory, the
+                // fields no longer each pass through the buffered socket streams.
+                if (size > 0) {
+                    dis->readFully(frame.get(), size);
+                }
+
+                FrameInputStream frameIn(frame.get(), size);
+                data.reset(doUnmarshal(&frameIn));
+            }
+
+        } else {
+            data.reset(doUnmarshal(dis));
+        }
 
         if (data == NULL) {
             throw IOException(__FILE__, __LINE__, "OpenWireFormat::doUnmarshal - "
@@ -23,6 +23,7 @@
 #include <activemq/commands/DataStructure.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <activemq/wireformat/openwire/utils/FrameBufferPool.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/util/Properties.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
@@ -52,6 +53,9 @@ namespace marshal {
         // Defines the maximum supported openwire version
         static const int MAX_SUPPORTED_VERSION;
 
+        // The largest frame accepted unless a smaller limit is configured.
+        static const long long DEFAULT_MAX_FRAME_SIZE;
+
     private:
 
         // Configuration parameters
@@ -60,15 +64,25 @@ namespace marshal {
         // Preferred WireFormatInfo
         Pointer<commands::WireFormatInfo> preferedWireFormatInfo;
 
-        // Marshalers
+        // Marshalers in use for the current version, indexed by data structure type
         std::vector< marshal::DataStreamMarshaller* > dataMarshallers;
 
+        // The generated Marshalers that handle every version, owned by this object
+        std::vector< marshal::DataStreamMarshaller* > genericMarshallers;
+
+        // Marshalers compiled for a single version, indexed by version and owned by this object
+        std::vector< std::vector< marshal::DataStreamMarshaller* > > versionedMarshallers;
+
         // Uniquely Generated ID, initialize in the Ctor
         std::string id;
 
         // Indicates when we are in the doUnmarshal call
         decaf::util::concurrent::atomic::AtomicBoolean receiving;
 
+        // Reusable buffers that whole size prefixed frames are read into, frames over
+        // its retained size are read into memory of their own and freed after decoding.
+        utils::FrameBufferPool framePool;
+
         // WireFormat Data
         int version;
         bool stackTraceEnabled;
@@ -79,6 +93,7 @@ namespace marshal {
         bool sizePrefixDisabled;
         long long maxInactivityDuration;
         long long maxInactivityDurationInitialDelay;
+        long long maxFrameSize;
 
     public:
 
@@ -243,7 +258,8 @@ namespace marshal {
         }
 
         /**
-         * Set the current Wireformat Version
+         * Set the current Wireformat Version, the Marshalers that were compiled for
+         * the version replace the generic ones for the types they cover.
          *
          * @param version
          *      An int that identifies the version
@@ -357,6 +373,36 @@ namespace marshal {
             this->maxInactivityDurationInitialDelay = value;
         }
 
+        /**
+         * Gets the largest frame size that will be read from the wire, a frame whose
+         * size prefix is larger is rejected before any memory is allocated for it.
+         *
+         * @return the maximum frame size in bytes.
+         */
+        long long getMaxFrameSize() const {
+            return this->maxFrameSize;
+        }
+
+        /**
+         * Sets the largest frame size that will be read from the wire.
+         *
+         * @param value
+         *      The maximum frame size in bytes.
+         */
+        void setMaxFrameSize(long long value) {
+            this->maxFrameSize = value;
+        }
+
+        /**
+         * Checks a frame size read from a size prefix against the configured limit.
+         *
+         * @param size
+         *      The size of the frame that follows the prefix.
+         *
+         * @throws IOException if the size is negative or larger than the maximum frame size.
+         */
+        void checkFrameSize(int size) const;
+
     protected:
 
         /**
@@ -381,6 +427,10 @@ namespace marshal {
          */
         void destroyMarshalers();
 
+    private:
+
+        void selectMarshallers();
+
     };
 
 }}}
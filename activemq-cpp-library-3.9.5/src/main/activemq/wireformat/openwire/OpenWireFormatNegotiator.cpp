@@ -37,6 +37,11 @@ using namespace decaf::lang::exceptions;
 ////////////////////////////////////////////////////////////////////////////////
 const int OpenWireFormatNegotiator::negotiationTimeout = 15000;
 
+////////////////////////////////////////////////////////////////////////////////
+int OpenWireFormatNegotiator::getNegotiationTimeout() {
+    return negotiationTimeout;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 OpenWireFormatNegotiator::OpenWireFormatNegotiator(OpenWireFormat* wireFormat, const Pointer<Transport> next ) :
     WireFormatNegotiator( next ),
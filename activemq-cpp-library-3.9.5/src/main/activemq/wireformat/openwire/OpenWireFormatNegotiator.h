@@ -80,6 +80,12 @@ namespace openwire{
 
         virtual Pointer<commands::Response> request(const Pointer<commands::Command> command, unsigned int timeout);
 
+        /**
+         * @return the time in milliseconds to wait for the peer's WireFormatInfo before
+         *         the negotiation is declared to have timed out.
+         */
+        static int getNegotiationTimeout();
+
     public:
 
         virtual void onCommand(const Pointer<commands::Command> command);
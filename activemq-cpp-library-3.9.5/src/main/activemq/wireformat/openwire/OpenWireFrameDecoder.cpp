@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenWireFrameDecoder.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const std::size_t FRAME_SIZE_PREFIX = 4;
+
+    // A buffer grown past this to hold a large frame is released once it is decoded.
+    const std::size_t RETAINED_BUFFER_SIZE = 8192;
+
+    int readFrameSize(const OpenWireFormat* wireFormat, const unsigned char* prefix) {
+
+        int size = (int) (((unsigned int) prefix[0] << 24) | ((unsigned int) prefix[1] << 16) |
+                          ((unsigned int) prefix[2] << 8) | (unsigned int) prefix[3]);
+
+        // Checked before any of the frame is buffered.
+        wireFormat->checkFrameSize(size);
+
+        return size;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenWireFrameDecoder::OpenWireFrameDecoder(const Pointer<OpenWireFormat> wireFormat) :
+    wireFormat(wireFormat), buffer(), count(0), frameIn() {
+
+    if (wireFormat == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "OpenWireFrameDecoder - WireFormat passed is NULL");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenWireFrameDecoder::~OpenWireFrameDecoder() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OpenWireFrameDecoder::decode(const unsigned char* data, int length, std::vector< Pointer<Command> >& commands) {
+
+    try {
+
+        if (length < 0 || (data == NULL && length > 0)) {
+            throw IllegalArgumentException(__FILE__, __LINE__,
+                "OpenWireFrameDecoder::decode - Invalid chunk of %d bytes", length);
+        }
+
+        if (this->wireFormat->isSizePrefixDisabled()) {
+            throw IOException(__FILE__, __LINE__,
+                "OpenWireFrameDecoder::decode - Frames can't be found without a size prefix");
+        }
+
+        std::size_t available = (std::size_t) length;
+        std::size_t offset = 0;
+        int decoded = 0;
+
+        // First complete the frame left over from the previous chunk.
+        if (this->count > 0) {
+
+            if (this->count < FRAME_SIZE_PREFIX) {
+                std::size_t take = std::min(FRAME_SIZE_PREFIX - this->count, available);
+                append(data, take);
+                offset += take;
+
+                if (this->count < FRAME_SIZE_PREFIX) {
+                    return 0;
+                }
+            }
+
+            std::size_t frameLength = FRAME_SIZE_PREFIX + (std::size_t) readFrameSize(this->wireFormat.get(), &this->buffer[0]);
+            std::size_t take = std::min(frameLength - this->count, available - offset);
+            append(data + offset, take);
+            offset += take;
+
+            if (this->count < frameLength) {
+                return 0;
+            }
+
+            // Cleared first so a frame that fails to decode isn't decoded again.
+            this->count = 0;
+            commands.push_back(decodeFrame(&this->buffer[0], frameLength));
+            decoded++;
+
+            if (this->buffer.size() > RETAINED_BUFFER_SIZE) {
+                std::vector<unsigned char>().swap(this->buffer);
+            }
+        }
+
+        // Frames wholly inside the chunk are decoded without copying them.
+        while (available - offset >= FRAME_SIZE_PREFIX) {
+
+            std::size_t frameLength = FRAME_SIZE_PREFIX + (std::size_t) readFrameSize(this->wireFormat.get(), data + offset);
+            if (available - offset < frameLength) {
+                break;
+            }
+
+            const unsigned char* frame = data + offset;
+            offset += frameLength;
+
+            commands.push_back(decodeFrame(frame, frameLength));
+            decoded++;
+        }
+
+        // Whatever is left starts a frame that a later chunk completes.
+        append(data + offset, available - offset);
+
+        return decoded;
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_RETHROW(IllegalArgumentException)
+    AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoder::reset() {
+    this->count = 0;
+    std::vector<unsigned char>().swap(this->buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Command> OpenWireFrameDecoder::decodeFrame(const unsigned char* frame, std::size_t length) {
+
+    // The OpenWireFormat reads the size prefix itself and decodes the rest of the
+    // frame in place.
+    this->frameIn.setFrame(frame, (int) length);
+    return this->wireFormat->unmarshal(NULL, &this->frameIn);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoder::append(const unsigned char* data, std::size_t length) {
+
+    if (length == 0) {
+        return;
+    }
+
+    std::size_t required = this->count + length;
+    if (this->buffer.size() < required) {
+        std::size_t newSize = this->buffer.size() * 2;
+        this->buffer.resize(newSize < required ? required : newSize);
+    }
+
+    ::memcpy(&this->buffer[this->count], data, length);
+    this->count += length;
+}
@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFRAMEDECODER_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFRAMEDECODER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Command.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/utils/FrameInputStream.h>
+#include <decaf/lang/Pointer.h>
+
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+
+    using decaf::lang::Pointer;
+
+    /**
+     * Decodes OpenWire commands from bytes that are pushed to it in chunks of any
+     * size, rather than pulled from a blocking stream.  Each call to decode returns
+     * the commands whose frames were completed by the given bytes, a frame that is
+     * only partly received is kept until a later call supplies the rest.  This lets
+     * a non-blocking or event driven transport, or a tool reading captured traffic
+     * from a file, decode frames without a thread blocked on each source.
+     *
+     * Frames that lie entirely within a chunk are decoded in place from the caller's
+     * memory, only the bytes of a frame split across chunks are copied.
+     *
+     * Frames are found by their size prefix, so the OpenWireFormat must not have
+     * size prefixes disabled.  After decode throws the byte stream can't be followed
+     * any further, the decoder has to be reset before it is given a new stream.
+     *
+     * The decoder is not thread safe, a single thread at a time must feed it.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API OpenWireFrameDecoder {
+    private:
+
+        Pointer<OpenWireFormat> wireFormat;
+
+        // The start of a frame that hasn't been completely received yet.
+        std::vector<unsigned char> buffer;
+        std::size_t count;
+
+        utils::FrameInputStream frameIn;
+
+    private:
+
+        OpenWireFrameDecoder(const OpenWireFrameDecoder&);
+        OpenWireFrameDecoder& operator=(const OpenWireFrameDecoder&);
+
+    public:
+
+        /**
+         * Creates a new decoder that unmarshals frames with the given OpenWireFormat.
+         *
+         * @param wireFormat
+         *      The OpenWireFormat used to unmarshal each complete frame.
+         *
+         * @throws NullPointerException if the wireFormat is NULL.
+         */
+        OpenWireFrameDecoder(const Pointer<OpenWireFormat> wireFormat);
+
+        virtual ~OpenWireFrameDecoder();
+
+        /**
+         * Consumes the next chunk of the byte stream and appends every command that
+         * it completes to the given vector, in the order they were received.  All of
+         * the bytes are consumed, any that belong to an incomplete frame are kept for
+         * the next call.  If a frame fails to decode the commands that preceded it
+         * have already been appended when the exception is thrown.
+         *
+         * @param data
+         *      Pointer to the bytes to consume, may be NULL if length is zero.
+         * @param length
+         *      The number of bytes to consume.
+         * @param commands
+         *      The vector that the decoded commands are appended to.
+         *
+         * @return the number of commands that were appended.
+         *
+         * @throws IOException if a frame is invalid or can't be unmarshaled, or if the
+         *         OpenWireFormat has size prefixes disabled.
+         * @throws IllegalArgumentException if length is negative or data is NULL with a
+         *         non zero length.
+         */
+        int decode(const unsigned char* data, int length, std::vector< Pointer<commands::Command> >& commands);
+
+        /**
+         * @return the number of bytes held from a frame that is not yet complete.
+         */
+        std::size_t getBufferedBytes() const {
+            return this->count;
+        }
+
+        /**
+         * Discards any partly received frame so the decoder can start on a new stream.
+         */
+        void reset();
+
+    private:
+
+        Pointer<commands::Command> decodeFrame(const unsigned char* frame, std::size_t length);
+
+        void append(const unsigned char* data, std::size_t length);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFRAMEDECODER_H_ */
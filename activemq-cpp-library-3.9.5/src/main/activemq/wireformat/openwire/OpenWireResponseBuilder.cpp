@@ -61,6 +61,14 @@ Pointer<Response> OpenWireResponseBuilder::buildResponse(const Pointer<Command>
 ////////////////////////////////////////////////////////////////////////////////
 void OpenWireResponseBuilder::buildIncomingCommands(const Pointer<Command> command, decaf::util::LinkedList<Pointer<Command> >& queue) {
 
+    // A broker answers a KeepAliveInfo by sending it back.
+    if (command->isKeepAliveInfo() && command->isResponseRequired()) {
+        Pointer<Command> reply(dynamic_cast<Command*>(command->cloneDataStructure()));
+        reply->setResponseRequired(false);
+        queue.push(reply);
+        return;
+    }
+
     // Delegate this to buildResponse
     if (command->isResponseRequired()) {
         queue.push(buildResponse(command));
@@ -45,6 +45,17 @@ using namespace decaf::lang;
 ////////////////////////////////////////////////////////////////////////////////
 utils::HexTable BaseDataStreamMarshaller::hexTable;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The pair of booleans that tells how many bytes a tightly marshaled long
+    // takes, read and written as a single two bit run.
+    const unsigned int LONG_ZERO = 0x00;
+    const unsigned int LONG_INT = 0x01;
+    const unsigned int LONG_SHORT = 0x02;
+    const unsigned int LONG_LONG = 0x03;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 commands::DataStructure* BaseDataStreamMarshaller::tightUnmarshalCachedObject(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn,utils::BooleanStream* bs) {
     try {
@@ -171,8 +182,8 @@ std::string BaseDataStreamMarshaller::tightUnmarshalString(decaf::io::DataInputS
 int BaseDataStreamMarshaller::tightMarshalString1(const std::string& value, utils::BooleanStream* bs) {
     try {
 
-        bs->writeBoolean(value != "");
-        if (value != "") {
+        bs->writeBoolean(!value.empty());
+        if (!value.empty()) {
             size_t strlen = value.length();
 
             int utflen = 0;
@@ -200,6 +211,11 @@ int BaseDataStreamMarshaller::tightMarshalString1(const std::string& value, util
 
             bs->writeBoolean(isOnlyAscii);
 
+            // The second pass encodes using this length instead of measuring again.
+            if (!isOnlyAscii) {
+                bs->writeLength(utflen);
+            }
+
             return utflen + 2;
         } else {
             return 0;
@@ -221,7 +237,7 @@ void BaseDataStreamMarshaller::tightMarshalString2(const std::string& value, dec
                 dataOut->writeShort((short) value.length());
                 dataOut->writeBytes(value);
             } else {
-                dataOut->writeUTF(value);
+                writeUTF(value, bs->readLength(), dataOut);
             }
         }
     }
@@ -264,26 +280,23 @@ int BaseDataStreamMarshaller::tightMarshalLong1(OpenWireFormat* wireFormat AMQCP
 
     try {
 
+        // The two booleans are written as one run, the first one in the low bit.
         if (value == 0L) {
 
-            bs->writeBoolean(false);
-            bs->writeBoolean(false);
+            bs->writeBits(LONG_ZERO, 2);
             return 0;
 
         } else {
 
             unsigned long long ul = (unsigned long long) value;
             if ((ul & 0xFFFFFFFFFFFF0000ULL) == 0ULL) {
-                bs->writeBoolean(false);
-                bs->writeBoolean(true);
+                bs->writeBits(LONG_SHORT, 2);
                 return 2;
             } else if ((ul & 0xFFFFFFFF00000000ULL) == 0ULL) {
-                bs->writeBoolean(true);
-                bs->writeBoolean(false);
+                bs->writeBits(LONG_INT, 2);
                 return 4;
             } else {
-                bs->writeBoolean(true);
-                bs->writeBoolean(true);
+                bs->writeBits(LONG_LONG, 2);
                 return 8;
             }
         }
@@ -298,19 +311,18 @@ void BaseDataStreamMarshaller::tightMarshalLong2(OpenWireFormat* wireFormat AMQC
         utils::BooleanStream* bs) {
     try {
 
-        if (bs->readBoolean()) {
-
-            if (bs->readBoolean()) {
+        switch (bs->readBits(2)) {
+            case LONG_LONG:
                 dataOut->writeLong(value);
-            } else {
+                break;
+            case LONG_INT:
                 dataOut->writeInt((int) value);
-            }
-
-        } else {
-
-            if (bs->readBoolean()) {
+                break;
+            case LONG_SHORT:
                 dataOut->writeShort((short) value);
-            }
+                break;
+            default:
+                break;
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -322,21 +334,15 @@ void BaseDataStreamMarshaller::tightMarshalLong2(OpenWireFormat* wireFormat AMQC
 long long BaseDataStreamMarshaller::tightUnmarshalLong(OpenWireFormat* wireFormat AMQCPP_UNUSED, decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs) {
 
     try {
-        if (bs->readBoolean()) {
-
-            if (bs->readBoolean()) {
+        switch (bs->readBits(2)) {
+            case LONG_LONG:
                 return dataIn->readLong();
-            } else {
+            case LONG_INT:
                 return (unsigned int) dataIn->readInt();
-            }
-
-        } else {
-
-            if (bs->readBoolean()) {
+            case LONG_SHORT:
                 return dataIn->readUnsignedShort();
-            } else {
+            default:
                 return 0;
-            }
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -572,9 +578,17 @@ void BaseDataStreamMarshaller::looseMarshalBrokerError(OpenWireFormat* wireForma
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<unsigned char> BaseDataStreamMarshaller::tightUnmarshalByteArray(decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs) {
 
+    std::vector<unsigned char> data;
+    tightUnmarshalByteArray(dataIn, bs, data);
+    return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshaller::tightUnmarshalByteArray(decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs, std::vector<unsigned char>& data) {
+
     try {
 
-        std::vector<unsigned char> data;
+        data.clear();
         if (bs->readBoolean()) {
             int size = dataIn->readInt();
             if (size > 0) {
@@ -582,8 +596,6 @@ std::vector<unsigned char> BaseDataStreamMarshaller::tightUnmarshalByteArray(dec
                 dataIn->readFully(&data[0], (int) data.size());
             }
         }
-
-        return data;
     }
     AMQ_CATCH_RETHROW(IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
@@ -593,19 +605,24 @@ std::vector<unsigned char> BaseDataStreamMarshaller::tightUnmarshalByteArray(dec
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<unsigned char> BaseDataStreamMarshaller::looseUnmarshalByteArray(decaf::io::DataInputStream* dataIn) {
 
+    std::vector<unsigned char> data;
+    looseUnmarshalByteArray(dataIn, data);
+    return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshaller::looseUnmarshalByteArray(decaf::io::DataInputStream* dataIn, std::vector<unsigned char>& data) {
+
     try {
 
+        data.clear();
         if (dataIn->readBoolean()) {
             int size = dataIn->readInt();
-            std::vector<unsigned char> data;
             if (size > 0) {
                 data.resize(size);
                 dataIn->readFully(&data[0], (int) data.size());
             }
-            return data;
         }
-
-        return std::vector<unsigned char>();
     }
     AMQ_CATCH_RETHROW(IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
@@ -687,6 +704,31 @@ std::string BaseDataStreamMarshaller::toHexFromBytes(const std::vector<unsigned
     return buffer;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshaller::writeUTF(const std::string& value, int utflen, decaf::io::DataOutputStream* dataOut) {
+
+    std::vector<unsigned char> utfBytes((std::size_t) utflen);
+    std::size_t length = value.length();
+    std::size_t utfIndex = 0;
+
+    // Same modified UTF-8 as DataOutputStream::writeUTF, the length was measured
+    // by tightMarshalString1 so it is not counted again here.
+    for (std::size_t i = 0; i < length; ++i) {
+
+        unsigned int charValue = (unsigned char) value[i];
+
+        if (charValue > 0 && charValue <= 127) {
+            utfBytes[utfIndex++] = (unsigned char) charValue;
+        } else {
+            utfBytes[utfIndex++] = (unsigned char) (0xc0 | (0x1f & (charValue >> 6)));
+            utfBytes[utfIndex++] = (unsigned char) (0x80 | (0x3f & charValue));
+        }
+    }
+
+    dataOut->writeUnsignedShort((unsigned short) utflen);
+    dataOut->write(&utfBytes[0], (int) utfIndex, 0, (int) utfIndex);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string BaseDataStreamMarshaller::readAsciiString(decaf::io::DataInputStream* dataIn) {
 
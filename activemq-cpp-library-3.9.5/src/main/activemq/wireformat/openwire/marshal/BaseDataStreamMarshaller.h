@@ -350,6 +350,26 @@ namespace marshal{
          */
         virtual std::vector<unsigned char> looseUnmarshalByteArray(decaf::io::DataInputStream* dataIn);
 
+        /**
+         * Tight Unmarshal an array of char directly into the given vector, the
+         * vector is resized to fit and left empty if the array was null.  Reading
+         * straight into a command's own storage avoids copying large bodies.
+         * @param dataIn - the DataInputStream to Un-Marshal from
+         * @param bs - boolean stream to unmarshal from.
+         * @param data - the vector that receives the unmarshaled chars.
+         * @throws IOException if an error occurs.
+         */
+        virtual void tightUnmarshalByteArray(decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs, std::vector<unsigned char>& data);
+
+        /**
+         * Loose Unmarshal an array of char directly into the given vector, the
+         * vector is resized to fit and left empty if the array was null.
+         * @param dataIn - the DataInputStream to Un-Marshal from
+         * @param data - the vector that receives the unmarshaled chars.
+         * @throws IOException if an error occurs.
+         */
+        virtual void looseUnmarshalByteArray(decaf::io::DataInputStream* dataIn, std::vector<unsigned char>& data);
+
         /**
          * Tight Unmarshal a fixed size array from that data input stream
          * and return an stl vector of char as the resultant.
@@ -518,6 +538,15 @@ namespace marshal{
          */
         virtual std::string readAsciiString(decaf::io::DataInputStream* dataIn);
 
+        /**
+         * Writes a string as modified UTF-8 whose encoded length is already known,
+         * the bytes written are the same as DataOutputStream::writeUTF.
+         * @param value - the string to write.
+         * @param utflen - the encoded length of the string.
+         * @param dataOut - DataOutputStream to write to.
+         */
+        void writeUTF(const std::string& value, int utflen, decaf::io::DataOutputStream* dataOut);
+
     };
 
 }}}}
@@ -0,0 +1,242 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PreparedMessageMarshaller.h"
+
+#include <activemq/commands/MessageId.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessageMarshaller::PreparedMessageMarshaller(const Pointer<Message> prototype) :
+    BaseDataStreamMarshaller(), prototype(prototype), mutex(), version(-1), segments() {
+
+    if (prototype == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Prototype Message passed is NULL");
+    }
+
+    if (prototype->getProducerId() == NULL || prototype->getDestination() == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Prototype Message has no ProducerId or Destination");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessageMarshaller::~PreparedMessageMarshaller() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char PreparedMessageMarshaller::getDataStructureType() const {
+    return this->prototype->getDataStructureType();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructure* PreparedMessageMarshaller::createObject() const {
+    return this->prototype->cloneDataStructure();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshaller::apply(Message* message) const {
+
+    const Message* source = this->prototype.get();
+
+    message->setOriginalDestination(source->getOriginalDestination());
+    message->setOriginalTransactionId(source->getOriginalTransactionId());
+    message->setGroupID(source->getGroupID());
+    message->setGroupSequence(source->getGroupSequence());
+    message->setCorrelationId(source->getCorrelationId());
+    message->setPersistent(source->isPersistent());
+    message->setPriority(source->getPriority());
+    message->setReplyTo(source->getReplyTo());
+    message->setType(source->getType());
+    message->setDataStructure(source->getDataStructure());
+    message->setTargetConsumerId(source->getTargetConsumerId());
+    message->setRedeliveryCounter(source->getRedeliveryCounter());
+    message->setBrokerPath(source->getBrokerPath());
+    message->setArrival(source->getArrival());
+    message->setUserID(source->getUserID());
+    message->setRecievedByDFBridge(source->isRecievedByDFBridge());
+    message->setDroppable(source->isDroppable());
+    message->setCluster(source->getCluster());
+    message->setBrokerInTime(source->getBrokerInTime());
+    message->setBrokerOutTime(source->getBrokerOutTime());
+    message->setJMSXGroupFirstForConsumer(source->isJMSXGroupFirstForConsumer());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool PreparedMessageMarshaller::isPreparedFor(const Message* message) const {
+
+    if (message->getDataStructureType() != this->prototype->getDataStructureType() ||
+        message->getProducerId().get() != this->prototype->getProducerId().get() ||
+        message->getDestination().get() != this->prototype->getDestination().get()) {
+
+        return false;
+    }
+
+    const MessageId* id = message->getMessageId().get();
+
+    return id != NULL && id->getProducerId().get() == this->prototype->getProducerId().get() &&
+           id->getBrokerSequenceId() == 0 && id->getTextView().empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataOutputStream* dataOut) {
+
+    try {
+
+        // Only called for a Message that passed isPreparedFor.
+        Message* info = static_cast<Message*>(dataStructure);
+
+        synchronized(&this->mutex) {
+
+            if (this->version != wireFormat->getVersion()) {
+                layout(wireFormat);
+            }
+
+            info->beforeMarshal(wireFormat);
+
+            dataOut->writeInt(info->getCommandId());
+            dataOut->writeBoolean(info->isResponseRequired());
+            writeSegment(this->segments[PRODUCER_AND_DESTINATION], dataOut);
+            looseMarshalCachedObject(wireFormat, info->getTransactionId().get(), dataOut);
+            writeSegment(this->segments[MESSAGE_ID], dataOut);
+            looseMarshalLong(wireFormat, info->getMessageId()->getProducerSequenceId(), dataOut);
+            writeSegment(this->segments[HEADERS], dataOut);
+            looseMarshalLong(wireFormat, info->getExpiration(), dataOut);
+            writeSegment(this->segments[PRIORITY_AND_REPLY_TO], dataOut);
+            looseMarshalLong(wireFormat, info->getTimestamp(), dataOut);
+            writeSegment(this->segments[TYPE], dataOut);
+            dataOut->writeBoolean(!info->getContent().empty());
+            if (!info->getContent().empty()) {
+                dataOut->writeInt((int) info->getContent().size());
+                dataOut->write(&info->getContent()[0], (int) info->getContent().size(), 0, (int) info->getContent().size());
+            }
+            dataOut->writeBoolean(!info->getMarshalledProperties().empty());
+            if (!info->getMarshalledProperties().empty()) {
+                dataOut->writeInt((int) info->getMarshalledProperties().size());
+                dataOut->write(&info->getMarshalledProperties()[0], (int) info->getMarshalledProperties().size(), 0, (int) info->getMarshalledProperties().size());
+            }
+            writeSegment(this->segments[DATA_STRUCTURE], dataOut);
+            dataOut->writeBoolean(info->isCompressed());
+            writeSegment(this->segments[TRAILER], dataOut);
+
+            info->afterMarshal(wireFormat);
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshaller::layout(OpenWireFormat* wireFormat) {
+
+    // Each run holds the fields of MessageMarshaller::looseMarshal that lie between
+    // two fields that change from send to send, in the same order.
+    Message* info = this->prototype.get();
+    int wireVersion = wireFormat->getVersion();
+
+    for (int segment = 0; segment < SEGMENT_COUNT; ++segment) {
+
+        ByteArrayOutputStream bytesOut;
+        DataOutputStream dataOut(&bytesOut);
+
+        switch (segment) {
+            case PRODUCER_AND_DESTINATION:
+                looseMarshalCachedObject(wireFormat, info->getProducerId().get(), &dataOut);
+                looseMarshalCachedObject(wireFormat, info->getDestination().get(), &dataOut);
+                break;
+            case MESSAGE_ID:
+                looseMarshalCachedObject(wireFormat, info->getOriginalDestination().get(), &dataOut);
+                // The start of the nested MessageId, up to its producer sequence id.
+                dataOut.writeBoolean(true);
+                dataOut.writeByte(MessageId::ID_MESSAGEID);
+                if (wireVersion >= 10) {
+                    looseMarshalString("", &dataOut);
+                }
+                looseMarshalCachedObject(wireFormat, info->getProducerId().get(), &dataOut);
+                break;
+            case HEADERS:
+                // The rest of the MessageId, the broker sequence id is always zero.
+                looseMarshalLong(wireFormat, 0, &dataOut);
+                looseMarshalCachedObject(wireFormat, info->getOriginalTransactionId().get(), &dataOut);
+                looseMarshalString(info->getGroupID(), &dataOut);
+                dataOut.writeInt(info->getGroupSequence());
+                looseMarshalString(info->getCorrelationId(), &dataOut);
+                dataOut.writeBoolean(info->isPersistent());
+                break;
+            case PRIORITY_AND_REPLY_TO:
+                dataOut.write(info->getPriority());
+                looseMarshalNestedObject(wireFormat, info->getReplyTo().get(), &dataOut);
+                break;
+            case TYPE:
+                looseMarshalString(info->getType(), &dataOut);
+                break;
+            case DATA_STRUCTURE:
+                looseMarshalNestedObject(wireFormat, info->getDataStructure().get(), &dataOut);
+                looseMarshalCachedObject(wireFormat, info->getTargetConsumerId().get(), &dataOut);
+                break;
+            case TRAILER:
+                dataOut.writeInt(info->getRedeliveryCounter());
+                looseMarshalObjectArray(wireFormat, info->getBrokerPath(), &dataOut);
+                looseMarshalLong(wireFormat, info->getArrival(), &dataOut);
+                looseMarshalString(info->getUserID(), &dataOut);
+                dataOut.writeBoolean(info->isRecievedByDFBridge());
+                if (wireVersion >= 2) {
+                    dataOut.writeBoolean(info->isDroppable());
+                }
+                if (wireVersion >= 3) {
+                    looseMarshalObjectArray(wireFormat, info->getCluster(), &dataOut);
+                    looseMarshalLong(wireFormat, info->getBrokerInTime(), &dataOut);
+                    looseMarshalLong(wireFormat, info->getBrokerOutTime(), &dataOut);
+                }
+                if (wireVersion >= 10) {
+                    dataOut.writeBoolean(info->isJMSXGroupFirstForConsumer());
+                }
+                break;
+        }
+
+        dataOut.close();
+
+        std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+        this->segments[segment].assign(array.first, array.first + array.second);
+        delete [] array.first;
+    }
+
+    this->version = wireVersion;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshaller::writeSegment(const std::vector<unsigned char>& segment, DataOutputStream* dataOut) {
+    dataOut->write(&segment[0], (int) segment.size(), 0, (int) segment.size());
+}
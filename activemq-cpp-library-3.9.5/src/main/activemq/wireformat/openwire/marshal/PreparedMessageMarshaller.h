@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_PREPAREDMESSAGEMARSHALLER_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_PREPAREDMESSAGEMARSHALLER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Message.h>
+#include <activemq/wireformat/openwire/marshal/BaseDataStreamMarshaller.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace marshal {
+
+    using decaf::lang::Pointer;
+
+    /**
+     * Marshals the Messages sent from one prepared prototype in the loose encoding.
+     * The parts of the prototype that stay the same from send to send, its producer,
+     * destination and headers, are marshaled once per wire format version and kept
+     * as runs of bytes.  Each send writes those runs as they are and only marshals
+     * the fields in between that change: the command id, transaction, sequence id,
+     * timestamp, expiration, body and properties.
+     *
+     * A Message is laid out this way only when it was sent with the prototype's
+     * ProducerId and destination objects and apply() has copied the prototype's
+     * headers onto it, the bytes written are identical to the generated marshaller's.
+     * The tight encoding interleaves each field's encoding with the boolean stream
+     * written ahead of the body, so it always uses the generated marshallers.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API PreparedMessageMarshaller : public BaseDataStreamMarshaller {
+    private:
+
+        enum Segment {
+            PRODUCER_AND_DESTINATION,
+            MESSAGE_ID,
+            HEADERS,
+            PRIORITY_AND_REPLY_TO,
+            TYPE,
+            DATA_STRUCTURE,
+            TRAILER,
+            SEGMENT_COUNT
+        };
+
+        Pointer<commands::Message> prototype;
+
+        decaf::util::concurrent::Mutex mutex;
+
+        // The wire format version the segments were laid out for, or -1.
+        int version;
+
+        std::vector<unsigned char> segments[SEGMENT_COUNT];
+
+    private:
+
+        PreparedMessageMarshaller(const PreparedMessageMarshaller&);
+        PreparedMessageMarshaller& operator=(const PreparedMessageMarshaller&);
+
+    public:
+
+        /**
+         * Creates a new marshaller for the Messages sent from the given prototype.
+         *
+         * @param prototype
+         *      The Message whose producer, destination and headers every send shares.
+         *
+         * @throws NullPointerException if the prototype, its ProducerId or its
+         *         destination is NULL.
+         */
+        PreparedMessageMarshaller(const Pointer<commands::Message> prototype);
+
+        virtual ~PreparedMessageMarshaller();
+
+        /**
+         * @return the prototype the Messages are sent from.
+         */
+        const Pointer<commands::Message>& getPrototype() const {
+            return this->prototype;
+        }
+
+        /**
+         * Copies the headers of the prototype that the marshaled runs hold onto the
+         * given Message, replacing any the Message had.
+         *
+         * @param message
+         *      The Message about to be sent from the prototype.
+         */
+        void apply(commands::Message* message) const;
+
+        /**
+         * Checks whether the given Message can be written from the prepared runs, its
+         * type, ProducerId and destination must be the prototype's and its MessageId
+         * must have been assigned by the prototype's producer.
+         *
+         * @param message
+         *      The Message that is about to be marshaled.
+         *
+         * @return true if looseMarshal can write the Message.
+         */
+        bool isPreparedFor(const commands::Message* message) const;
+
+        virtual unsigned char getDataStructureType() const;
+
+        virtual commands::DataStructure* createObject() const;
+
+        virtual void looseMarshal(OpenWireFormat* wireFormat,
+                                  commands::DataStructure* dataStructure,
+                                  decaf::io::DataOutputStream* dataOut);
+
+    private:
+
+        void layout(OpenWireFormat* wireFormat);
+
+        static void writeSegment(const std::vector<unsigned char>& segment, decaf::io::DataOutputStream* dataOut);
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_PREPAREDMESSAGEMARSHALLER_H_ */
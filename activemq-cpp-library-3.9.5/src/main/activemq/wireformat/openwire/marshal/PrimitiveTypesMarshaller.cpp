@@ -18,10 +18,12 @@
 #include "PrimitiveTypesMarshaller.h"
 
 #include <decaf/io/ByteArrayInputStream.h>
-#include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/ThreadLocal.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/io/ByteVectorOutputStream.h>
+#include <activemq/util/MarshallingSupport.h>
 #include <decaf/lang/Short.h>
 
 #include <memory>
@@ -38,12 +40,69 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::util;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Scratch buffers that maps and lists are encoded into before being copied
+    // into the caller's vector, one per thread so encoding needs no locking.
+    decaf::lang::ThreadLocal< std::vector<unsigned char> >* marshalBuffers = NULL;
+
+    // A scratch buffer that grew past this is released once it has been used
+    // so that one very large map doesn't pin its memory to the thread.
+    const std::size_t MAX_RETAINED_BUFFER_SIZE = 64 * 1024;
+
+    class ScratchBuffer {
+    private:
+
+        std::vector<unsigned char> local;
+        std::vector<unsigned char>* buffer;
+
+    private:
+
+        ScratchBuffer(const ScratchBuffer&);
+        ScratchBuffer& operator=(const ScratchBuffer&);
+
+    public:
+
+        ScratchBuffer() : local(), buffer(&local) {
+            if (marshalBuffers != NULL) {
+                buffer = &marshalBuffers->get();
+            }
+            buffer->clear();
+        }
+
+        ~ScratchBuffer() {
+            if (buffer->capacity() > MAX_RETAINED_BUFFER_SIZE) {
+                std::vector<unsigned char>().swap(*buffer);
+            } else {
+                buffer->clear();
+            }
+        }
+
+        std::vector<unsigned char>& get() {
+            return *buffer;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrimitiveTypesMarshaller::initialize() {
+    marshalBuffers = new decaf::lang::ThreadLocal< std::vector<unsigned char> >();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrimitiveTypesMarshaller::shutdown() {
+    delete marshalBuffers;
+    marshalBuffers = NULL;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PrimitiveTypesMarshaller::marshal(const PrimitiveMap* map, std::vector<unsigned char>& buffer) {
 
     try {
 
-        ByteArrayOutputStream bytesOut;
+        ScratchBuffer scratch;
+        activemq::io::ByteVectorOutputStream bytesOut(scratch.get());
         DataOutputStream dataOut(&bytesOut);
 
         if (map == NULL) {
@@ -52,11 +111,7 @@ void PrimitiveTypesMarshaller::marshal(const PrimitiveMap* map, std::vector<unsi
             PrimitiveTypesMarshaller::marshalPrimitiveMap(dataOut, *map);
         }
 
-        if (bytesOut.size() > 0) {
-            std::pair<unsigned char*, int> array = bytesOut.toByteArray();
-            buffer.insert(buffer.begin(), array.first, array.first + array.second);
-            delete[] array.first;
-        }
+        buffer.insert(buffer.begin(), scratch.get().begin(), scratch.get().end());
     }
     AMQ_CATCH_RETHROW(decaf::lang::Exception)
     AMQ_CATCHALL_THROW(decaf::lang::Exception)
@@ -87,7 +142,8 @@ void PrimitiveTypesMarshaller::marshal(const PrimitiveList* list, std::vector<un
 
     try {
 
-        ByteArrayOutputStream bytesOut;
+        ScratchBuffer scratch;
+        activemq::io::ByteVectorOutputStream bytesOut(scratch.get());
         DataOutputStream dataOut(&bytesOut);
 
         if (list == NULL) {
@@ -96,11 +152,7 @@ void PrimitiveTypesMarshaller::marshal(const PrimitiveList* list, std::vector<un
             PrimitiveTypesMarshaller::marshalPrimitiveList(dataOut, *list);
         }
 
-        if (bytesOut.size() > 0) {
-            std::pair<unsigned char*, int> array = bytesOut.toByteArray();
-            buffer.insert(buffer.begin(), array.first, array.first + array.second);
-            delete[] array.first;
-        }
+        buffer.insert(buffer.begin(), scratch.get().begin(), scratch.get().end());
     }
     AMQ_CATCH_RETHROW(decaf::lang::Exception)
     AMQ_CATCHALL_THROW(decaf::lang::Exception)
@@ -192,14 +244,13 @@ void PrimitiveTypesMarshaller::marshalPrimitiveMap(decaf::io::DataOutputStream&
         Pointer<Iterator<std::string> > keys(map.keySet().iterator());
         while (keys->hasNext()) {
             std::string key = keys->next();
-            dataOut.writeUTF(key);
-            PrimitiveValueNode value = map.get(key);
-            marshalPrimitive(dataOut, value);
+            MarshallingSupport::writePropertyName(dataOut, key);
+            marshalPrimitive(dataOut, map.get(key));
         }
     }
-    AMQ_CATCH_RETHROW(io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
-    AMQ_CATCHALL_THROW(io::IOException)
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -213,13 +264,13 @@ void PrimitiveTypesMarshaller::marshalPrimitiveList(decaf::io::DataOutputStream&
             marshalPrimitive(dataOut, list.get(ix));
         }
     }
-    AMQ_CATCH_RETHROW(io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
-    AMQ_CATCHALL_THROW(io::IOException)
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void PrimitiveTypesMarshaller::marshalPrimitive(io::DataOutputStream& dataOut, const activemq::util::PrimitiveValueNode& value) {
+void PrimitiveTypesMarshaller::marshalPrimitive(decaf::io::DataOutputStream& dataOut, const activemq::util::PrimitiveValueNode& value) {
 
     try {
 
@@ -269,7 +320,7 @@ void PrimitiveTypesMarshaller::marshalPrimitive(io::DataOutputStream& dataOut, c
 
             dataOut.writeByte(PrimitiveValueNode::BYTE_ARRAY_TYPE);
 
-            std::vector<unsigned char> data = value.getByteArray();
+            const std::vector<unsigned char>& data = *value.getValue().byteArrayValue;
 
             dataOut.writeInt((int) data.size());
             if (!data.empty()) {
@@ -278,7 +329,7 @@ void PrimitiveTypesMarshaller::marshalPrimitive(io::DataOutputStream& dataOut, c
 
         } else if (value.getType() == PrimitiveValueNode::STRING_TYPE) {
 
-            std::string data = value.getString();
+            const std::string& data = *value.getValue().stringValue;
             int size = (int) data.size();
 
             // is the string big??
@@ -311,9 +362,9 @@ void PrimitiveTypesMarshaller::marshalPrimitive(io::DataOutputStream& dataOut, c
             __LINE__, "Object is not a primitive: ");
         }
     }
-    AMQ_CATCH_RETHROW(io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
-    AMQ_CATCHALL_THROW(io::IOException)
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -325,14 +376,14 @@ void PrimitiveTypesMarshaller::unmarshalPrimitiveMap(decaf::io::DataInputStream&
 
         if (size > 0) {
             for (int i = 0; i < size; i++) {
-                std::string key = dataIn.readUTF();
+                std::string key = MarshallingSupport::readPropertyName(dataIn);
                 map.put(key, unmarshalPrimitive(dataIn));
             }
         }
     }
-    AMQ_CATCH_RETHROW(io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
-    AMQ_CATCHALL_THROW(io::IOException)
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -345,13 +396,13 @@ void PrimitiveTypesMarshaller::unmarshalPrimitiveList(decaf::io::DataInputStream
             list.add(unmarshalPrimitive(dataIn));
         }
     }
-    AMQ_CATCH_RETHROW(io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
-    AMQ_CATCHALL_THROW(io::IOException)
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-PrimitiveValueNode PrimitiveTypesMarshaller::unmarshalPrimitive(io::DataInputStream& dataIn) {
+PrimitiveValueNode PrimitiveTypesMarshaller::unmarshalPrimitive(decaf::io::DataInputStream& dataIn) {
 
     try {
 
@@ -400,22 +451,16 @@ PrimitiveValueNode PrimitiveTypesMarshaller::unmarshalPrimitive(io::DataInputStr
                 break;
             }
             case PrimitiveValueNode::STRING_TYPE: {
-                int utfLength = dataIn.readShort();
-                if (utfLength > 0) {
-
-                    std::vector<unsigned char> buffer(utfLength);
-                    dataIn.readFully(&buffer[0], utfLength);
-                    value.setString(std::string((char*) (&buffer[0]), utfLength));
+                std::string data = MarshallingSupport::readString16(dataIn);
+                if (!data.empty()) {
+                    value.setString(data);
                 }
                 break;
             }
             case PrimitiveValueNode::BIG_STRING_TYPE: {
-                int utfLength = dataIn.readInt();
-                if (utfLength > 0) {
-
-                    std::vector<unsigned char> buffer(utfLength);
-                    dataIn.readFully(&buffer[0], utfLength);
-                    value.setString(std::string((char*) (&buffer[0]), utfLength));
+                std::string data = MarshallingSupport::readString32(dataIn);
+                if (!data.empty()) {
+                    value.setString(data);
                 }
                 break;
             }
@@ -440,7 +485,7 @@ PrimitiveValueNode PrimitiveTypesMarshaller::unmarshalPrimitive(io::DataInputStr
 
         return value;
     }
-    AMQ_CATCH_RETHROW(io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
-    AMQ_CATCHALL_THROW(io::IOException)
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
 }
@@ -29,6 +29,9 @@
 #include <string>
 
 namespace activemq{
+namespace library{
+    class ActiveMQCPP;
+}
 namespace wireformat{
 namespace openwire{
 namespace marshal{
@@ -37,6 +40,10 @@ namespace marshal{
      * This class wraps the functionality needed to marshal a primitive
      * map to the Openwire Format's expectation of what the map looks like
      * on the wire.
+     *
+     * Maps and lists marshaled into a vector are first encoded into a buffer
+     * kept for each thread and then copied into the vector in one piece, so
+     * the vector is sized once and no intermediate streams are allocated.
      */
     class AMQCPP_API PrimitiveTypesMarshaller {
     public:
@@ -212,6 +219,13 @@ namespace marshal{
          */
         static util::PrimitiveValueNode unmarshalPrimitive( decaf::io::DataInputStream& dataIn );
 
+    private:
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
     };
 
 }}}}
@@ -0,0 +1,784 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VersionedMarshallerFactory.h"
+
+#include <activemq/wireformat/openwire/marshal/BaseDataStreamMarshaller.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <activemq/commands/ActiveMQTempTopic.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/BrokerError.h>
+#include <activemq/commands/BrokerId.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/LocalTransactionId.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/XATransactionId.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Pointer.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::exceptions;
+using namespace activemq::commands;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+const int VersionedMarshallerFactory::MIN_VERSION = 9;
+const int VersionedMarshallerFactory::MAX_VERSION = 11;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The object read for a field is created from the type byte in the stream, it
+    // is checked against what the field holds before it is cast.
+    void checkType(DataStructure* object, bool matches) {
+        if (object != NULL && !matches) {
+            unsigned char type = object->getDataStructureType();
+            delete object;
+            throw IOException(__FILE__, __LINE__, "Unexpected data type %d in marshaled field", (int) type);
+        }
+    }
+
+    template<typename T>
+    Pointer<T> narrow(DataStructure* object, unsigned char type) {
+        checkType(object, object != NULL && object->getDataStructureType() == type);
+        return Pointer<T>(static_cast<T*>(object));
+    }
+
+    Pointer<ActiveMQDestination> narrowDestination(DataStructure* object) {
+        if (object != NULL) {
+            unsigned char type = object->getDataStructureType();
+            checkType(object, type == ActiveMQQueue::ID_ACTIVEMQQUEUE || type == ActiveMQTopic::ID_ACTIVEMQTOPIC ||
+                              type == ActiveMQTempQueue::ID_ACTIVEMQTEMPQUEUE || type == ActiveMQTempTopic::ID_ACTIVEMQTEMPTOPIC);
+        }
+        return Pointer<ActiveMQDestination>(static_cast<ActiveMQDestination*>(object));
+    }
+
+    Pointer<TransactionId> narrowTransactionId(DataStructure* object) {
+        if (object != NULL) {
+            unsigned char type = object->getDataStructureType();
+            checkType(object, type == LocalTransactionId::ID_LOCALTRANSACTIONID || type == XATransactionId::ID_XATRANSACTIONID);
+        }
+        return Pointer<TransactionId>(static_cast<TransactionId*>(object));
+    
+    }
+
+    /**
+     * Shared by the specialized marshallers, encodes the fields every command starts
+     * with and the Message fields.  The helpers of the base class are called by their
+     * qualified names so that none of them is dispatched through the vtable.
+     */
+    template<int WIRE_VERSION>
+    class VersionedMarshaller : public BaseDataStreamMarshaller {
+    private:
+
+        // Fails to compile for a version the fields below don't cover.
+        typedef char versionIsSupported[WIRE_VERSION >= 9 ? 1 : -1];
+
+    public:
+
+        virtual ~VersionedMarshaller() {}
+
+    protected:
+
+        void tightUnmarshalCommand(BaseCommand* info, DataInputStream* dataIn, BooleanStream* bs) {
+            info->setCommandId(dataIn->readInt());
+            info->setResponseRequired(bs->readBoolean());
+        }
+
+        int tightMarshalCommand1(BaseCommand* info, BooleanStream* bs) {
+            bs->writeBoolean(info->isResponseRequired());
+            return 4;
+        }
+
+        void tightMarshalCommand2(BaseCommand* info, DataOutputStream* dataOut, BooleanStream* bs) {
+            dataOut->writeInt(info->getCommandId());
+            bs->readBoolean();
+        }
+
+        void looseUnmarshalCommand(BaseCommand* info, DataInputStream* dataIn) {
+            info->setCommandId(dataIn->readInt());
+            info->setResponseRequired(dataIn->readBoolean());
+        }
+
+        void looseMarshalCommand(BaseCommand* info, DataOutputStream* dataOut) {
+            dataOut->writeInt(info->getCommandId());
+            dataOut->writeBoolean(info->isResponseRequired());
+        }
+
+        void tightUnmarshalMessage(OpenWireFormat* wireFormat, Message* info, DataInputStream* dataIn, BooleanStream* bs) {
+
+            tightUnmarshalCommand(info, dataIn, bs);
+
+            info->setProducerId(narrow<ProducerId>(
+                BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs), ProducerId::ID_PRODUCERID));
+            info->setDestination(narrowDestination(
+                BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs)));
+            info->setTransactionId(narrowTransactionId(
+                BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs)));
+            info->setOriginalDestination(narrowDestination(
+                BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs)));
+            info->setMessageId(narrow<MessageId>(
+                BaseDataStreamMarshaller::tightUnmarshalNestedObject(wireFormat, dataIn, bs), MessageId::ID_MESSAGEID));
+            info->setOriginalTransactionId(narrowTransactionId(
+                BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs)));
+            info->setGroupID(BaseDataStreamMarshaller::tightUnmarshalString(dataIn, bs));
+            info->setGroupSequence(dataIn->readInt());
+            info->setCorrelationId(BaseDataStreamMarshaller::tightUnmarshalString(dataIn, bs));
+            info->setPersistent(bs->readBoolean());
+            info->setExpiration(BaseDataStreamMarshaller::tightUnmarshalLong(wireFormat, dataIn, bs));
+            info->setPriority(dataIn->readByte());
+            info->setReplyTo(narrowDestination(
+                BaseDataStreamMarshaller::tightUnmarshalNestedObject(wireFormat, dataIn, bs)));
+            info->setTimestamp(BaseDataStreamMarshaller::tightUnmarshalLong(wireFormat, dataIn, bs));
+            info->setType(BaseDataStreamMarshaller::tightUnmarshalString(dataIn, bs));
+            BaseDataStreamMarshaller::tightUnmarshalByteArray(dataIn, bs, info->getContent());
+            BaseDataStreamMarshaller::tightUnmarshalByteArray(dataIn, bs, info->getMarshalledProperties());
+            info->setDataStructure(Pointer<DataStructure>(
+                BaseDataStreamMarshaller::tightUnmarshalNestedObject(wireFormat, dataIn, bs)));
+            info->setTargetConsumerId(narrow<ConsumerId>(
+                BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs), ConsumerId::ID_CONSUMERID));
+            info->setCompressed(bs->readBoolean());
+            info->setRedeliveryCounter(dataIn->readInt());
+            tightUnmarshalBrokerIds(wireFormat, info->getBrokerPath(), dataIn, bs);
+            info->setArrival(BaseDataStreamMarshaller::tightUnmarshalLong(wireFormat, dataIn, bs));
+            info->setUserID(BaseDataStreamMarshaller::tightUnmarshalString(dataIn, bs));
+            info->setRecievedByDFBridge(bs->readBoolean());
+            info->setDroppable(bs->readBoolean());
+            tightUnmarshalBrokerIds(wireFormat, info->getCluster(), dataIn, bs);
+            info->setBrokerInTime(BaseDataStreamMarshaller::tightUnmarshalLong(wireFormat, dataIn, bs));
+            info->setBrokerOutTime(BaseDataStreamMarshaller::tightUnmarshalLong(wireFormat, dataIn, bs));
+            if (WIRE_VERSION >= 10) {
+                info->setJMSXGroupFirstForConsumer(bs->readBoolean());
+            }
+        }
+
+        int tightMarshalMessage1(OpenWireFormat* wireFormat, Message* info, BooleanStream* bs) {
+
+            int rc = tightMarshalCommand1(info, bs);
+
+            rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getProducerId().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getDestination().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getTransactionId().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getOriginalDestination().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalNestedObject1(wireFormat, info->getMessageId().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getOriginalTransactionId().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalString1(info->getGroupID(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalString1(info->getCorrelationId(), bs);
+            bs->writeBoolean(info->isPersistent());
+            rc += BaseDataStreamMarshaller::tightMarshalLong1(wireFormat, info->getExpiration(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalNestedObject1(wireFormat, info->getReplyTo().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalLong1(wireFormat, info->getTimestamp(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalString1(info->getType(), bs);
+            bs->writeBoolean(info->getContent().size() != 0);
+            rc += info->getContent().size() == 0 ? 0 : (int) info->getContent().size() + 4;
+            bs->writeBoolean(info->getMarshalledProperties().size() != 0);
+            rc += info->getMarshalledProperties().size() == 0 ? 0 : (int) info->getMarshalledProperties().size() + 4;
+            rc += BaseDataStreamMarshaller::tightMarshalNestedObject1(wireFormat, info->getDataStructure().get(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getTargetConsumerId().get(), bs);
+            bs->writeBoolean(info->isCompressed());
+            rc += tightMarshalBrokerIds1(wireFormat, info->getBrokerPath(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalLong1(wireFormat, info->getArrival(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalString1(info->getUserID(), bs);
+            bs->writeBoolean(info->isRecievedByDFBridge());
+            bs->writeBoolean(info->isDroppable());
+            rc += tightMarshalBrokerIds1(wireFormat, info->getCluster(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalLong1(wireFormat, info->getBrokerInTime(), bs);
+            rc += BaseDataStreamMarshaller::tightMarshalLong1(wireFormat, info->getBrokerOutTime(), bs);
+            if (WIRE_VERSION >= 10) {
+                bs->writeBoolean(info->isJMSXGroupFirstForConsumer());
+            }
+
+            return rc + 9;
+        }
+
+        void tightMarshalMessage2(OpenWireFormat* wireFormat, Message* info, DataOutputStream* dataOut, BooleanStream* bs) {
+
+            tightMarshalCommand2(info, dataOut, bs);
+
+            BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getProducerId().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getTransactionId().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getOriginalDestination().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalNestedObject2(wireFormat, info->getMessageId().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getOriginalTransactionId().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalString2(info->getGroupID(), dataOut, bs);
+            dataOut->writeInt(info->getGroupSequence());
+            BaseDataStreamMarshaller::tightMarshalString2(info->getCorrelationId(), dataOut, bs);
+            bs->readBoolean();
+            BaseDataStreamMarshaller::tightMarshalLong2(wireFormat, info->getExpiration(), dataOut, bs);
+            dataOut->write(info->getPriority());
+            BaseDataStreamMarshaller::tightMarshalNestedObject2(wireFormat, info->getReplyTo().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalLong2(wireFormat, info->getTimestamp(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalString2(info->getType(), dataOut, bs);
+            if (bs->readBoolean()) {
+                writeByteArray(info->getContent(), dataOut);
+            }
+            if (bs->readBoolean()) {
+                writeByteArray(info->getMarshalledProperties(), dataOut);
+            }
+            BaseDataStreamMarshaller::tightMarshalNestedObject2(wireFormat, info->getDataStructure().get(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getTargetConsumerId().get(), dataOut, bs);
+            bs->readBoolean();
+            dataOut->writeInt(info->getRedeliveryCounter());
+            tightMarshalBrokerIds2(wireFormat, info->getBrokerPath(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalLong2(wireFormat, info->getArrival(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalString2(info->getUserID(), dataOut, bs);
+            bs->readBoolean();
+            bs->readBoolean();
+            tightMarshalBrokerIds2(wireFormat, info->getCluster(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalLong2(wireFormat, info->getBrokerInTime(), dataOut, bs);
+            BaseDataStreamMarshaller::tightMarshalLong2(wireFormat, info->getBrokerOutTime(), dataOut, bs);
+            if (WIRE_VERSION >= 10) {
+                bs->readBoolean();
+            }
+        }
+
+        void looseUnmarshalMessage(OpenWireFormat* wireFormat, Message* info, DataInputStream* dataIn) {
+
+            looseUnmarshalCommand(info, dataIn);
+
+            info->setProducerId(narrow<ProducerId>(
+                BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn), ProducerId::ID_PRODUCERID));
+            info->setDestination(narrowDestination(
+                BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn)));
+            info->setTransactionId(narrowTransactionId(
+                BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn)));
+            info->setOriginalDestination(narrowDestination(
+                BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn)));
+            info->setMessageId(narrow<MessageId>(
+                BaseDataStreamMarshaller::looseUnmarshalNestedObject(wireFormat, dataIn), MessageId::ID_MESSAGEID));
+            info->setOriginalTransactionId(narrowTransactionId(
+                BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn)));
+            info->setGroupID(BaseDataStreamMarshaller::looseUnmarshalString(dataIn));
+            info->setGroupSequence(dataIn->readInt());
+            info->setCorrelationId(BaseDataStreamMarshaller::looseUnmarshalString(dataIn));
+            info->setPersistent(dataIn->readBoolean());
+            info->setExpiration(BaseDataStreamMarshaller::looseUnmarshalLong(wireFormat, dataIn));
+            info->setPriority(dataIn->readByte());
+            info->setReplyTo(narrowDestination(
+                BaseDataStreamMarshaller::looseUnmarshalNestedObject(wireFormat, dataIn)));
+            info->setTimestamp(BaseDataStreamMarshaller::looseUnmarshalLong(wireFormat, dataIn));
+            info->setType(BaseDataStreamMarshaller::looseUnmarshalString(dataIn));
+            BaseDataStreamMarshaller::looseUnmarshalByteArray(dataIn, info->getContent());
+            BaseDataStreamMarshaller::looseUnmarshalByteArray(dataIn, info->getMarshalledProperties());
+            info->setDataStructure(Pointer<DataStructure>(
+                BaseDataStreamMarshaller::looseUnmarshalNestedObject(wireFormat, dataIn)));
+            info->setTargetConsumerId(narrow<ConsumerId>(
+                BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn), ConsumerId::ID_CONSUMERID));
+            info->setCompressed(dataIn->readBoolean());
+            info->setRedeliveryCounter(dataIn->readInt());
+            looseUnmarshalBrokerIds(wireFormat, info->getBrokerPath(), dataIn);
+            info->setArrival(BaseDataStreamMarshaller::looseUnmarshalLong(wireFormat, dataIn));
+            info->setUserID(BaseDataStreamMarshaller::looseUnmarshalString(dataIn));
+            info->setRecievedByDFBridge(dataIn->readBoolean());
+            info->setDroppable(dataIn->readBoolean());
+            looseUnmarshalBrokerIds(wireFormat, info->getCluster(), dataIn);
+            info->setBrokerInTime(BaseDataStreamMarshaller::looseUnmarshalLong(wireFormat, dataIn));
+            info->setBrokerOutTime(BaseDataStreamMarshaller::looseUnmarshalLong(wireFormat, dataIn));
+            if (WIRE_VERSION >= 10) {
+                info->setJMSXGroupFirstForConsumer(dataIn->readBoolean());
+            }
+        }
+
+        void looseMarshalMessage(OpenWireFormat* wireFormat, Message* info, DataOutputStream* dataOut) {
+
+            looseMarshalCommand(info, dataOut);
+
+            BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getProducerId().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getDestination().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getTransactionId().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getOriginalDestination().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalNestedObject(wireFormat, info->getMessageId().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getOriginalTransactionId().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalString(info->getGroupID(), dataOut);
+            dataOut->writeInt(info->getGroupSequence());
+            BaseDataStreamMarshaller::looseMarshalString(info->getCorrelationId(), dataOut);
+            dataOut->writeBoolean(info->isPersistent());
+            BaseDataStreamMarshaller::looseMarshalLong(wireFormat, info->getExpiration(), dataOut);
+            dataOut->write(info->getPriority());
+            BaseDataStreamMarshaller::looseMarshalNestedObject(wireFormat, info->getReplyTo().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalLong(wireFormat, info->getTimestamp(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalString(info->getType(), dataOut);
+            dataOut->write(info->getContent().size() != 0);
+            if (info->getContent().size() != 0) {
+                writeByteArray(info->getContent(), dataOut);
+            }
+            dataOut->write(info->getMarshalledProperties().size() != 0);
+            if (info->getMarshalledProperties().size() != 0) {
+                writeByteArray(info->getMarshalledProperties(), dataOut);
+            }
+            BaseDataStreamMarshaller::looseMarshalNestedObject(wireFormat, info->getDataStructure().get(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getTargetConsumerId().get(), dataOut);
+            dataOut->writeBoolean(info->isCompressed());
+            dataOut->writeInt(info->getRedeliveryCounter());
+            looseMarshalBrokerIds(wireFormat, info->getBrokerPath(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalLong(wireFormat, info->getArrival(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalString(info->getUserID(), dataOut);
+            dataOut->writeBoolean(info->isRecievedByDFBridge());
+            dataOut->writeBoolean(info->isDroppable());
+            looseMarshalBrokerIds(wireFormat, info->getCluster(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalLong(wireFormat, info->getBrokerInTime(), dataOut);
+            BaseDataStreamMarshaller::looseMarshalLong(wireFormat, info->getBrokerOutTime(), dataOut);
+            if (WIRE_VERSION >= 10) {
+                dataOut->writeBoolean(info->isJMSXGroupFirstForConsumer());
+            }
+        }
+
+    private:
+
+        static void writeByteArray(const std::vector<unsigned char>& value, DataOutputStream* dataOut) {
+            dataOut->writeInt((int) value.size());
+            dataOut->write(&value[0], (int) value.size(), 0, (int) value.size());
+        }
+
+        // The broker path and cluster arrays are almost always empty, unlike the
+        // generic helpers these don't copy the vector to find that out.
+
+        void tightUnmarshalBrokerIds(OpenWireFormat* wireFormat, std::vector< Pointer<BrokerId> >& ids,
+                                     DataInputStream* dataIn, BooleanStream* bs) {
+            ids.clear();
+            if (bs->readBoolean()) {
+                short size = dataIn->readShort();
+                ids.reserve(size);
+                for (int i = 0; i < size; i++) {
+                    ids.push_back(narrow<BrokerId>(
+                        BaseDataStreamMarshaller::tightUnmarshalNestedObject(wireFormat, dataIn, bs), BrokerId::ID_BROKERID));
+                }
+            }
+        }
+
+        int tightMarshalBrokerIds1(OpenWireFormat* wireFormat, const std::vector< Pointer<BrokerId> >& ids, BooleanStream* bs) {
+            bs->writeBoolean(!ids.empty());
+            if (ids.empty()) {
+                return 0;
+            }
+
+            int rc = 2;
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                rc += BaseDataStreamMarshaller::tightMarshalNestedObject1(wireFormat, ids[i].get(), bs);
+            }
+            return rc;
+        }
+
+        void tightMarshalBrokerIds2(OpenWireFormat* wireFormat, const std::vector< Pointer<BrokerId> >& ids,
+                                    DataOutputStream* dataOut, BooleanStream* bs) {
+            if (bs->readBoolean()) {
+                dataOut->writeShort((short) ids.size());
+                for (std::size_t i = 0; i < ids.size(); ++i) {
+                    BaseDataStreamMarshaller::tightMarshalNestedObject2(wireFormat, ids[i].get(), dataOut, bs);
+                }
+            }
+        }
+
+        void looseUnmarshalBrokerIds(OpenWireFormat* wireFormat, std::vector< Pointer<BrokerId> >& ids, DataInputStream* dataIn) {
+            ids.clear();
+            if (dataIn->readBoolean()) {
+                short size = dataIn->readShort();
+                ids.reserve(size);
+                for (int i = 0; i < size; i++) {
+                    ids.push_back(narrow<BrokerId>(
+                        BaseDataStreamMarshaller::looseUnmarshalNestedObject(wireFormat, dataIn), BrokerId::ID_BROKERID));
+                }
+            }
+        }
+
+        void looseMarshalBrokerIds(OpenWireFormat* wireFormat, const std::vector< Pointer<BrokerId> >& ids, DataOutputStream* dataOut) {
+            dataOut->writeBoolean(!ids.empty());
+            if (!ids.empty()) {
+                dataOut->writeShort((short) ids.size());
+                for (std::size_t i = 0; i < ids.size(); ++i) {
+                    BaseDataStreamMarshaller::looseMarshalNestedObject(wireFormat, ids[i].get(), dataOut);
+                }
+            }
+        }
+    };
+
+    /**
+     * Used for the Message types that add no fields of their own, T is the concrete
+     * Message class.
+     */
+    template<int WIRE_VERSION, typename T>
+    class VersionedMessageMarshaller : public VersionedMarshaller<WIRE_VERSION> {
+    private:
+
+        unsigned char type;
+
+    public:
+
+        VersionedMessageMarshaller(unsigned char type) : VersionedMarshaller<WIRE_VERSION>(), type(type) {}
+
+        virtual ~VersionedMessageMarshaller() {}
+
+        virtual DataStructure* createObject() const {
+            return new T();
+        }
+
+        virtual unsigned char getDataStructureType() const {
+            return this->type;
+        }
+
+        virtual void tightUnmarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataInputStream* dataIn, BooleanStream* bs) {
+
+            try {
+
+                T* info = static_cast<T*>(dataStructure);
+                this->tightUnmarshalMessage(wireFormat, info, dataIn, bs);
+                info->beforeUnmarshal(wireFormat);
+                info->afterUnmarshal(wireFormat);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual int tightMarshal1(OpenWireFormat* wireFormat, DataStructure* dataStructure, BooleanStream* bs) {
+
+            try {
+
+                T* info = static_cast<T*>(dataStructure);
+                info->beforeMarshal(wireFormat);
+                return this->tightMarshalMessage1(wireFormat, info, bs);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void tightMarshal2(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataOutputStream* dataOut, BooleanStream* bs) {
+
+            try {
+
+                T* info = static_cast<T*>(dataStructure);
+                this->tightMarshalMessage2(wireFormat, info, dataOut, bs);
+                info->afterMarshal(wireFormat);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void looseUnmarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataInputStream* dataIn) {
+
+            try {
+
+                T* info = static_cast<T*>(dataStructure);
+                this->looseUnmarshalMessage(wireFormat, info, dataIn);
+                info->beforeUnmarshal(wireFormat);
+                info->afterUnmarshal(wireFormat);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void looseMarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataOutputStream* dataOut) {
+
+            try {
+
+                T* info = static_cast<T*>(dataStructure);
+                info->beforeMarshal(wireFormat);
+                this->looseMarshalMessage(wireFormat, info, dataOut);
+                info->afterMarshal(wireFormat);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+    };
+
+    template<int WIRE_VERSION>
+    class VersionedMessageDispatchMarshaller : public VersionedMarshaller<WIRE_VERSION> {
+    public:
+
+        virtual ~VersionedMessageDispatchMarshaller() {}
+
+        virtual DataStructure* createObject() const {
+            return new MessageDispatch();
+        }
+
+        virtual unsigned char getDataStructureType() const {
+            return MessageDispatch::ID_MESSAGEDISPATCH;
+        }
+
+        virtual void tightUnmarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataInputStream* dataIn, BooleanStream* bs) {
+
+            try {
+
+                MessageDispatch* info = static_cast<MessageDispatch*>(dataStructure);
+                this->tightUnmarshalCommand(info, dataIn, bs);
+                info->setConsumerId(narrow<ConsumerId>(
+                    BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs), ConsumerId::ID_CONSUMERID));
+                info->setDestination(narrowDestination(
+                    BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs)));
+                info->setMessage(narrowMessage(
+                    BaseDataStreamMarshaller::tightUnmarshalNestedObject(wireFormat, dataIn, bs)));
+                info->setRedeliveryCounter(dataIn->readInt());
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual int tightMarshal1(OpenWireFormat* wireFormat, DataStructure* dataStructure, BooleanStream* bs) {
+
+            try {
+
+                MessageDispatch* info = static_cast<MessageDispatch*>(dataStructure);
+                int rc = this->tightMarshalCommand1(info, bs);
+                rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getConsumerId().get(), bs);
+                rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getDestination().get(), bs);
+                rc += BaseDataStreamMarshaller::tightMarshalNestedObject1(wireFormat, info->getMessage().get(), bs);
+
+                return rc + 4;
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void tightMarshal2(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataOutputStream* dataOut, BooleanStream* bs) {
+
+            try {
+
+                MessageDispatch* info = static_cast<MessageDispatch*>(dataStructure);
+                this->tightMarshalCommand2(info, dataOut, bs);
+                BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getConsumerId().get(), dataOut, bs);
+                BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
+                BaseDataStreamMarshaller::tightMarshalNestedObject2(wireFormat, info->getMessage().get(), dataOut, bs);
+                dataOut->writeInt(info->getRedeliveryCounter());
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void looseUnmarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataInputStream* dataIn) {
+
+            try {
+
+                MessageDispatch* info = static_cast<MessageDispatch*>(dataStructure);
+                this->looseUnmarshalCommand(info, dataIn);
+                info->setConsumerId(narrow<ConsumerId>(
+                    BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn), ConsumerId::ID_CONSUMERID));
+                info->setDestination(narrowDestination(
+                    BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn)));
+                info->setMessage(narrowMessage(
+                    BaseDataStreamMarshaller::looseUnmarshalNestedObject(wireFormat, dataIn)));
+                info->setRedeliveryCounter(dataIn->readInt());
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void looseMarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataOutputStream* dataOut) {
+
+            try {
+
+                MessageDispatch* info = static_cast<MessageDispatch*>(dataStructure);
+                this->looseMarshalCommand(info, dataOut);
+                BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getConsumerId().get(), dataOut);
+                BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getDestination().get(), dataOut);
+                BaseDataStreamMarshaller::looseMarshalNestedObject(wireFormat, info->getMessage().get(), dataOut);
+                dataOut->writeInt(info->getRedeliveryCounter());
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+    private:
+
+        // Every Message type derives from commands::Message but there are too many of
+        // them to list, the one dynamic_cast that is left is on the dispatched message.
+        static Pointer<Message> narrowMessage(DataStructure* object) {
+            Message* message = dynamic_cast<Message*>(object);
+            checkType(object, message != NULL);
+            return Pointer<Message>(message);
+        }
+    };
+
+    template<int WIRE_VERSION>
+    class VersionedMessageAckMarshaller : public VersionedMarshaller<WIRE_VERSION> {
+    public:
+
+        virtual ~VersionedMessageAckMarshaller() {}
+
+        virtual DataStructure* createObject() const {
+            return new MessageAck();
+        }
+
+        virtual unsigned char getDataStructureType() const {
+            return MessageAck::ID_MESSAGEACK;
+        }
+
+        virtual void tightUnmarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataInputStream* dataIn, BooleanStream* bs) {
+
+            try {
+
+                MessageAck* info = static_cast<MessageAck*>(dataStructure);
+                this->tightUnmarshalCommand(info, dataIn, bs);
+                info->setDestination(narrowDestination(
+                    BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs)));
+                info->setTransactionId(narrowTransactionId(
+                    BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs)));
+                info->setConsumerId(narrow<ConsumerId>(
+                    BaseDataStreamMarshaller::tightUnmarshalCachedObject(wireFormat, dataIn, bs), ConsumerId::ID_CONSUMERID));
+                info->setAckType(dataIn->readByte());
+                info->setFirstMessageId(narrow<MessageId>(
+                    BaseDataStreamMarshaller::tightUnmarshalNestedObject(wireFormat, dataIn, bs), MessageId::ID_MESSAGEID));
+                info->setLastMessageId(narrow<MessageId>(
+                    BaseDataStreamMarshaller::tightUnmarshalNestedObject(wireFormat, dataIn, bs), MessageId::ID_MESSAGEID));
+                info->setMessageCount(dataIn->readInt());
+                info->setPoisonCause(Pointer<BrokerError>(static_cast<BrokerError*>(
+                    BaseDataStreamMarshaller::tightUnmarshalBrokerError(wireFormat, dataIn, bs))));
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual int tightMarshal1(OpenWireFormat* wireFormat, DataStructure* dataStructure, BooleanStream* bs) {
+
+            try {
+
+                MessageAck* info = static_cast<MessageAck*>(dataStructure);
+                int rc = this->tightMarshalCommand1(info, bs);
+                rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getDestination().get(), bs);
+                rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getTransactionId().get(), bs);
+                rc += BaseDataStreamMarshaller::tightMarshalCachedObject1(wireFormat, info->getConsumerId().get(), bs);
+                rc += BaseDataStreamMarshaller::tightMarshalNestedObject1(wireFormat, info->getFirstMessageId().get(), bs);
+                rc += BaseDataStreamMarshaller::tightMarshalNestedObject1(wireFormat, info->getLastMessageId().get(), bs);
+                rc += BaseDataStreamMarshaller::tightMarshalBrokerError1(wireFormat, info->getPoisonCause().get(), bs);
+
+                return rc + 5;
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void tightMarshal2(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataOutputStream* dataOut, BooleanStream* bs) {
+
+            try {
+
+                MessageAck* info = static_cast<MessageAck*>(dataStructure);
+                this->tightMarshalCommand2(info, dataOut, bs);
+                BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
+                BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getTransactionId().get(), dataOut, bs);
+                BaseDataStreamMarshaller::tightMarshalCachedObject2(wireFormat, info->getConsumerId().get(), dataOut, bs);
+                dataOut->write(info->getAckType());
+                BaseDataStreamMarshaller::tightMarshalNestedObject2(wireFormat, info->getFirstMessageId().get(), dataOut, bs);
+                BaseDataStreamMarshaller::tightMarshalNestedObject2(wireFormat, info->getLastMessageId().get(), dataOut, bs);
+                dataOut->writeInt(info->getMessageCount());
+                BaseDataStreamMarshaller::tightMarshalBrokerError2(wireFormat, info->getPoisonCause().get(), dataOut, bs);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void looseUnmarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataInputStream* dataIn) {
+
+            try {
+
+                MessageAck* info = static_cast<MessageAck*>(dataStructure);
+                this->looseUnmarshalCommand(info, dataIn);
+                info->setDestination(narrowDestination(
+                    BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn)));
+                info->setTransactionId(narrowTransactionId(
+                    BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn)));
+                info->setConsumerId(narrow<ConsumerId>(
+                    BaseDataStreamMarshaller::looseUnmarshalCachedObject(wireFormat, dataIn), ConsumerId::ID_CONSUMERID));
+                info->setAckType(dataIn->readByte());
+                info->setFirstMessageId(narrow<MessageId>(
+                    BaseDataStreamMarshaller::looseUnmarshalNestedObject(wireFormat, dataIn), MessageId::ID_MESSAGEID));
+                info->setLastMessageId(narrow<MessageId>(
+                    BaseDataStreamMarshaller::looseUnmarshalNestedObject(wireFormat, dataIn), MessageId::ID_MESSAGEID));
+                info->setMessageCount(dataIn->readInt());
+                info->setPoisonCause(Pointer<BrokerError>(static_cast<BrokerError*>(
+                    BaseDataStreamMarshaller::looseUnmarshalBrokerError(wireFormat, dataIn))));
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void looseMarshal(OpenWireFormat* wireFormat, DataStructure* dataStructure, DataOutputStream* dataOut) {
+
+            try {
+
+                MessageAck* info = static_cast<MessageAck*>(dataStructure);
+                this->looseMarshalCommand(info, dataOut);
+                BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getDestination().get(), dataOut);
+                BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getTransactionId().get(), dataOut);
+                BaseDataStreamMarshaller::looseMarshalCachedObject(wireFormat, info->getConsumerId().get(), dataOut);
+                dataOut->write(info->getAckType());
+                BaseDataStreamMarshaller::looseMarshalNestedObject(wireFormat, info->getFirstMessageId().get(), dataOut);
+                BaseDataStreamMarshaller::looseMarshalNestedObject(wireFormat, info->getLastMessageId().get(), dataOut);
+                dataOut->writeInt(info->getMessageCount());
+                BaseDataStreamMarshaller::looseMarshalBrokerError(wireFormat, info->getPoisonCause().get(), dataOut);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+    };
+
+    template<int WIRE_VERSION>
+    void createVersion(std::vector<DataStreamMarshaller*>& marshallers) {
+        marshallers.push_back(new VersionedMessageDispatchMarshaller<WIRE_VERSION>());
+        marshallers.push_back(new VersionedMessageAckMarshaller<WIRE_VERSION>());
+        marshallers.push_back(new VersionedMessageMarshaller<WIRE_VERSION, ActiveMQBytesMessage>(
+            ActiveMQBytesMessage::ID_ACTIVEMQBYTESMESSAGE));
+        marshallers.push_back(new VersionedMessageMarshaller<WIRE_VERSION, ActiveMQTextMessage>(
+            ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VersionedMarshallerFactory::create(int version, std::vector<DataStreamMarshaller*>& marshallers) {
+
+    switch (version) {
+        case 9:
+            createVersion<9>(marshallers);
+            break;
+        case 10:
+            createVersion<10>(marshallers);
+            break;
+        case 11:
+            createVersion<11>(marshallers);
+            break;
+        default:
+            break;
+    }
+}
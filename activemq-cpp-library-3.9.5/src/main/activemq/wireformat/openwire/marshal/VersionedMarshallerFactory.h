@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_VERSIONEDMARSHALLERFACTORY_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_VERSIONEDMARSHALLERFACTORY_H_
+
+#include <activemq/util/Config.h>
+
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace marshal {
+
+    class DataStreamMarshaller;
+
+    /**
+     * Creates marshallers for the commands that dominate a busy connection that are
+     * compiled for one OpenWire version.  The generated marshallers look up the wire
+     * format version for every versioned field and dynamic_cast each object they are
+     * handed, these know the version at compile time and cast statically, the fields
+     * of the base command and message are encoded inline.
+     *
+     * Covers MessageDispatch, MessageAck, ActiveMQBytesMessage and ActiveMQTextMessage
+     * for versions MIN_VERSION through MAX_VERSION.  The OpenWireFormat installs them
+     * in place of the generated marshallers once a version has been negotiated, the
+     * bytes on the wire are identical.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API VersionedMarshallerFactory {
+    public:
+
+        /**
+         * The lowest OpenWire version there are specialized marshallers for.
+         */
+        static const int MIN_VERSION;
+
+        /**
+         * The highest OpenWire version there are specialized marshallers for.
+         */
+        static const int MAX_VERSION;
+
+    private:
+
+        VersionedMarshallerFactory();
+
+    public:
+
+        /**
+         * Creates the specialized marshallers for the given version, nothing is
+         * created for a version outside MIN_VERSION and MAX_VERSION.
+         *
+         * @param version
+         *      The OpenWire version the marshallers encode.
+         * @param marshallers
+         *      The vector the new marshallers are appended to, the caller owns them.
+         */
+        static void create(int version, std::vector<DataStreamMarshaller*>& marshallers);
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_VERSIONEDMARSHALLERFACTORY_H_ */
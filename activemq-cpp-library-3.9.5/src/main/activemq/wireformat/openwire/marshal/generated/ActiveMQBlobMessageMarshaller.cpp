@@ -125,7 +125,7 @@ void ActiveMQBlobMessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Da
             tightMarshalString2(info->getMimeType(), dataOut, bs);
         }
         if (wireVersion >= 3) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -85,7 +85,7 @@ void BaseCommandMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStruct
         BaseCommand* info =
             dynamic_cast<BaseCommand*>(dataStructure);
         dataOut->writeInt(info->getCommandId());
-        bs->readBoolean();
+        bs->skipBits(1);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT( exceptions::ActiveMQException, decaf::io::IOException)
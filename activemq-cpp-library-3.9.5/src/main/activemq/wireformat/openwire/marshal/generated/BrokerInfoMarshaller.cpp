@@ -77,9 +77,10 @@ void BrokerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruct
             info->getPeerBrokerInfos().clear();
         }
         info->setBrokerName(tightUnmarshalString(dataIn, bs));
-        info->setSlaveBroker(bs->readBoolean());
-        info->setMasterBroker(bs->readBoolean());
-        info->setFaultTolerantConfiguration(bs->readBoolean());
+        unsigned int flags = bs->readBits(3);
+        info->setSlaveBroker((flags & 0x01) != 0);
+        info->setMasterBroker((flags & 0x02) != 0);
+        info->setFaultTolerantConfiguration((flags & 0x04) != 0);
         if (wireVersion >= 2) {
             info->setDuplexConnection(bs->readBoolean());
         }
@@ -117,9 +118,9 @@ int BrokerInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructur
         rc += tightMarshalString1(info->getBrokerURL(), bs);
         rc += tightMarshalObjectArray1(wireFormat, info->getPeerBrokerInfos(), bs);
         rc += tightMarshalString1(info->getBrokerName(), bs);
-        bs->writeBoolean(info->isSlaveBroker());
-        bs->writeBoolean(info->isMasterBroker());
-        bs->writeBoolean(info->isFaultTolerantConfiguration());
+        bs->writeBits((info->isSlaveBroker() ? 0x01 : 0) |
+                      (info->isMasterBroker() ? 0x02 : 0) |
+                      (info->isFaultTolerantConfiguration() ? 0x04 : 0), 3);
         if (wireVersion >= 2) {
             bs->writeBoolean(info->isDuplexConnection());
         }
@@ -159,14 +160,12 @@ void BrokerInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructu
         tightMarshalString2(info->getBrokerURL(), dataOut, bs);
         tightMarshalObjectArray2(wireFormat, info->getPeerBrokerInfos(), dataOut, bs);
         tightMarshalString2(info->getBrokerName(), dataOut, bs);
-        bs->readBoolean();
-        bs->readBoolean();
-        bs->readBoolean();
+        bs->skipBits(3);
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 2) {
             tightMarshalLong2(wireFormat, info->getConnectionId(), dataOut, bs);
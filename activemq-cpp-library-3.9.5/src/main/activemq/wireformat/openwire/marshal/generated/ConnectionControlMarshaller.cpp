@@ -62,11 +62,12 @@ void ConnectionControlMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, Dat
 
         int wireVersion = wireFormat->getVersion();
 
-        info->setClose(bs->readBoolean());
-        info->setExit(bs->readBoolean());
-        info->setFaultTolerant(bs->readBoolean());
-        info->setResume(bs->readBoolean());
-        info->setSuspend(bs->readBoolean());
+        unsigned int flags = bs->readBits(5);
+        info->setClose((flags & 0x01) != 0);
+        info->setExit((flags & 0x02) != 0);
+        info->setFaultTolerant((flags & 0x04) != 0);
+        info->setResume((flags & 0x08) != 0);
+        info->setSuspend((flags & 0x10) != 0);
         if (wireVersion >= 6) {
             info->setConnectedBrokers(tightUnmarshalString(dataIn, bs));
         }
@@ -77,7 +78,7 @@ void ConnectionControlMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, Dat
             info->setRebalanceConnection(bs->readBoolean());
         }
         if (wireVersion >= 8) {
-            info->setToken(tightUnmarshalByteArray(dataIn, bs));
+            tightUnmarshalByteArray(dataIn, bs, info->getToken());
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -97,11 +98,11 @@ int ConnectionControlMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataS
 
         int wireVersion = wireFormat->getVersion();
 
-        bs->writeBoolean(info->isClose());
-        bs->writeBoolean(info->isExit());
-        bs->writeBoolean(info->isFaultTolerant());
-        bs->writeBoolean(info->isResume());
-        bs->writeBoolean(info->isSuspend());
+        bs->writeBits((info->isClose() ? 0x01 : 0) |
+                      (info->isExit() ? 0x02 : 0) |
+                      (info->isFaultTolerant() ? 0x04 : 0) |
+                      (info->isResume() ? 0x08 : 0) |
+                      (info->isSuspend() ? 0x10 : 0), 5);
         if (wireVersion >= 6) {
             rc += tightMarshalString1(info->getConnectedBrokers(), bs);
         }
@@ -135,11 +136,7 @@ void ConnectionControlMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Data
 
         int wireVersion = wireFormat->getVersion();
 
-        bs->readBoolean();
-        bs->readBoolean();
-        bs->readBoolean();
-        bs->readBoolean();
-        bs->readBoolean();
+        bs->skipBits(5);
         if (wireVersion >= 6) {
             tightMarshalString2(info->getConnectedBrokers(), dataOut, bs);
         }
@@ -147,7 +144,7 @@ void ConnectionControlMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Data
             tightMarshalString2(info->getReconnectTo(), dataOut, bs);
         }
         if (wireVersion >= 6) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 8) {
             if (bs->readBoolean()) {
@@ -187,7 +184,7 @@ void ConnectionControlMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, Dat
             info->setRebalanceConnection(dataIn->readBoolean());
         }
         if (wireVersion >= 8) {
-            info->setToken(looseUnmarshalByteArray(dataIn));
+            looseUnmarshalByteArray(dataIn, info->getToken());
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -78,8 +78,9 @@ void ConnectionInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataSt
         } else {
             info->getBrokerPath().clear();
         }
-        info->setBrokerMasterConnector(bs->readBoolean());
-        info->setManageable(bs->readBoolean());
+        unsigned int flags = bs->readBits(2);
+        info->setBrokerMasterConnector((flags & 0x01) != 0);
+        info->setManageable((flags & 0x02) != 0);
         if (wireVersion >= 2) {
             info->setClientMaster(bs->readBoolean());
         }
@@ -115,8 +116,8 @@ int ConnectionInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStru
         rc += tightMarshalString1(info->getPassword(), bs);
         rc += tightMarshalString1(info->getUserName(), bs);
         rc += tightMarshalObjectArray1(wireFormat, info->getBrokerPath(), bs);
-        bs->writeBoolean(info->isBrokerMasterConnector());
-        bs->writeBoolean(info->isManageable());
+        bs->writeBits((info->isBrokerMasterConnector() ? 0x01 : 0) |
+                      (info->isManageable() ? 0x02 : 0), 2);
         if (wireVersion >= 2) {
             bs->writeBoolean(info->isClientMaster());
         }
@@ -154,16 +155,15 @@ void ConnectionInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStr
         tightMarshalString2(info->getPassword(), dataOut, bs);
         tightMarshalString2(info->getUserName(), dataOut, bs);
         tightMarshalObjectArray2(wireFormat, info->getBrokerPath(), dataOut, bs);
-        bs->readBoolean();
-        bs->readBoolean();
+        bs->skipBits(2);
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 6) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 6) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 8) {
             tightMarshalString2(info->getClientIp(), dataOut, bs);
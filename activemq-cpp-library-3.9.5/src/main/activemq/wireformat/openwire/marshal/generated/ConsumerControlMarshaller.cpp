@@ -134,17 +134,17 @@ void ConsumerControlMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataSt
         if (wireVersion >= 6) {
             tightMarshalNestedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
         }
-        bs->readBoolean();
+        bs->skipBits(1);
         tightMarshalNestedObject2(wireFormat, info->getConsumerId().get(), dataOut, bs);
         dataOut->writeInt(info->getPrefetch());
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -75,9 +75,10 @@ void ConsumerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStru
             info->setClientId(tightUnmarshalString(dataIn, bs));
         }
         info->setSubscriptionName(tightUnmarshalString(dataIn, bs));
-        info->setNoLocal(bs->readBoolean());
-        info->setExclusive(bs->readBoolean());
-        info->setRetroactive(bs->readBoolean());
+        unsigned int flags = bs->readBits(3);
+        info->setNoLocal((flags & 0x01) != 0);
+        info->setExclusive((flags & 0x02) != 0);
+        info->setRetroactive((flags & 0x04) != 0);
         info->setPriority(dataIn->readByte());
 
         if (bs->readBoolean()) {
@@ -92,9 +93,10 @@ void ConsumerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStru
         }
         info->setAdditionalPredicate(Pointer<BooleanExpression>(dynamic_cast<BooleanExpression* >(
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
-        info->setNetworkSubscription(bs->readBoolean());
-        info->setOptimizedAcknowledge(bs->readBoolean());
-        info->setNoRangeAcks(bs->readBoolean());
+        flags = bs->readBits(3);
+        info->setNetworkSubscription((flags & 0x01) != 0);
+        info->setOptimizedAcknowledge((flags & 0x02) != 0);
+        info->setNoRangeAcks((flags & 0x04) != 0);
         if (wireVersion >= 4) {
 
             if (bs->readBoolean()) {
@@ -135,14 +137,14 @@ int ConsumerInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStruct
             rc += tightMarshalString1(info->getClientId(), bs);
         }
         rc += tightMarshalString1(info->getSubscriptionName(), bs);
-        bs->writeBoolean(info->isNoLocal());
-        bs->writeBoolean(info->isExclusive());
-        bs->writeBoolean(info->isRetroactive());
+        bs->writeBits((info->isNoLocal() ? 0x01 : 0) |
+                      (info->isExclusive() ? 0x02 : 0) |
+                      (info->isRetroactive() ? 0x04 : 0), 3);
         rc += tightMarshalObjectArray1(wireFormat, info->getBrokerPath(), bs);
         rc += tightMarshalNestedObject1(wireFormat, info->getAdditionalPredicate().get(), bs);
-        bs->writeBoolean(info->isNetworkSubscription());
-        bs->writeBoolean(info->isOptimizedAcknowledge());
-        bs->writeBoolean(info->isNoRangeAcks());
+        bs->writeBits((info->isNetworkSubscription() ? 0x01 : 0) |
+                      (info->isOptimizedAcknowledge() ? 0x02 : 0) |
+                      (info->isNoRangeAcks() ? 0x04 : 0), 3);
         if (wireVersion >= 4) {
             rc += tightMarshalObjectArray1(wireFormat, info->getNetworkConsumerPath(), bs);
         }
@@ -167,25 +169,21 @@ void ConsumerInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStruc
         int wireVersion = wireFormat->getVersion();
 
         tightMarshalCachedObject2(wireFormat, info->getConsumerId().get(), dataOut, bs);
-        bs->readBoolean();
+        bs->skipBits(1);
         tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
         dataOut->writeInt(info->getPrefetchSize());
         dataOut->writeInt(info->getMaximumPendingMessageLimit());
-        bs->readBoolean();
+        bs->skipBits(1);
         tightMarshalString2(info->getSelector(), dataOut, bs);
         if (wireVersion >= 10) {
             tightMarshalString2(info->getClientId(), dataOut, bs);
         }
         tightMarshalString2(info->getSubscriptionName(), dataOut, bs);
-        bs->readBoolean();
-        bs->readBoolean();
-        bs->readBoolean();
+        bs->skipBits(3);
         dataOut->write(info->getPriority());
         tightMarshalObjectArray2(wireFormat, info->getBrokerPath(), dataOut, bs);
         tightMarshalNestedObject2(wireFormat, info->getAdditionalPredicate().get(), dataOut, bs);
-        bs->readBoolean();
-        bs->readBoolean();
-        bs->readBoolean();
+        bs->skipBits(3);
         if (wireVersion >= 4) {
             tightMarshalObjectArray2(wireFormat, info->getNetworkConsumerPath(), dataOut, bs);
         }
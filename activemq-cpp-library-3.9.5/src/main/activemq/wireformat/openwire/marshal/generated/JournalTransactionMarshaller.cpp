@@ -99,7 +99,7 @@ void JournalTransactionMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Dat
             dynamic_cast<JournalTransaction*>(dataStructure);
         tightMarshalNestedObject2(wireFormat, info->getTransactionId().get(), dataOut, bs);
         dataOut->write(info->getType());
-        bs->readBoolean();
+        bs->skipBits(1);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT( exceptions::ActiveMQException, decaf::io::IOException)
@@ -74,8 +74,8 @@ void MessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructure
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
         info->setTimestamp(tightUnmarshalLong(wireFormat, dataIn, bs));
         info->setType(tightUnmarshalString(dataIn, bs));
-        info->setContent(tightUnmarshalByteArray(dataIn, bs));
-        info->setMarshalledProperties(tightUnmarshalByteArray(dataIn, bs));
+        tightUnmarshalByteArray(dataIn, bs, info->getContent());
+        tightUnmarshalByteArray(dataIn, bs, info->getMarshalledProperties());
         info->setDataStructure(Pointer<DataStructure>(dynamic_cast<DataStructure* >(
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
         info->setTargetConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId* >(
@@ -207,7 +207,7 @@ void MessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure*
         tightMarshalString2(info->getGroupID(), dataOut, bs);
         dataOut->writeInt(info->getGroupSequence());
         tightMarshalString2(info->getCorrelationId(), dataOut, bs);
-        bs->readBoolean();
+        bs->skipBits(1);
         tightMarshalLong2(wireFormat, info->getExpiration(), dataOut, bs);
         dataOut->write(info->getPriority());
         tightMarshalNestedObject2(wireFormat, info->getReplyTo().get(), dataOut, bs);
@@ -223,14 +223,14 @@ void MessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure*
         }
         tightMarshalNestedObject2(wireFormat, info->getDataStructure().get(), dataOut, bs);
         tightMarshalCachedObject2(wireFormat, info->getTargetConsumerId().get(), dataOut, bs);
-        bs->readBoolean();
+        bs->skipBits(1);
         dataOut->writeInt(info->getRedeliveryCounter());
         tightMarshalObjectArray2(wireFormat, info->getBrokerPath(), dataOut, bs);
         tightMarshalLong2(wireFormat, info->getArrival(), dataOut, bs);
         tightMarshalString2(info->getUserID(), dataOut, bs);
-        bs->readBoolean();
+        bs->skipBits(1);
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 3) {
             tightMarshalObjectArray2(wireFormat, info->getCluster(), dataOut, bs);
@@ -242,7 +242,7 @@ void MessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure*
             tightMarshalLong2(wireFormat, info->getBrokerOutTime(), dataOut, bs);
         }
         if (wireVersion >= 10) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -283,8 +283,8 @@ void MessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructure
             looseUnmarshalNestedObject(wireFormat, dataIn))));
         info->setTimestamp(looseUnmarshalLong(wireFormat, dataIn));
         info->setType(looseUnmarshalString(dataIn));
-        info->setContent(looseUnmarshalByteArray(dataIn));
-        info->setMarshalledProperties(looseUnmarshalByteArray(dataIn));
+        looseUnmarshalByteArray(dataIn, info->getContent());
+        looseUnmarshalByteArray(dataIn, info->getMarshalledProperties());
         info->setDataStructure(Pointer<DataStructure>(dynamic_cast<DataStructure*>(
             looseUnmarshalNestedObject(wireFormat, dataIn))));
         info->setTargetConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId*>(
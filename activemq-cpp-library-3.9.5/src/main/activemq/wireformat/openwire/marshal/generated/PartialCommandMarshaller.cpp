@@ -60,7 +60,7 @@ void PartialCommandMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataSt
         PartialCommand* info =
             dynamic_cast<PartialCommand*>(dataStructure);
         info->setCommandId(dataIn->readInt());
-        info->setData(tightUnmarshalByteArray(dataIn, bs));
+        tightUnmarshalByteArray(dataIn, bs, info->getData());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -115,7 +115,7 @@ void PartialCommandMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataSt
         PartialCommand* info =
             dynamic_cast<PartialCommand*>(dataStructure);
         info->setCommandId(dataIn->readInt());
-        info->setData(looseUnmarshalByteArray(dataIn));
+        looseUnmarshalByteArray(dataIn, info->getData());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
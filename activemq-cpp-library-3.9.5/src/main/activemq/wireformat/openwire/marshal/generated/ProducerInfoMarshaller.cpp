@@ -133,7 +133,7 @@ void ProducerInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStruc
         tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
         tightMarshalObjectArray2(wireFormat, info->getBrokerPath(), dataOut, bs);
         if (wireVersion >= 2) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
         if (wireVersion >= 3) {
             dataOut->writeInt(info->getWindowSize());
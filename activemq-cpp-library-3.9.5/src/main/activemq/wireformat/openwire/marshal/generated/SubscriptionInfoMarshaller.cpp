@@ -130,7 +130,7 @@ void SubscriptionInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataS
             tightMarshalNestedObject2(wireFormat, info->getSubscribedDestination().get(), dataOut, bs);
         }
         if (wireVersion >= 11) {
-            bs->readBoolean();
+            bs->skipBits(1);
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -60,8 +60,8 @@ void XATransactionIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataS
         XATransactionId* info =
             dynamic_cast<XATransactionId*>(dataStructure);
         info->setFormatId(dataIn->readInt());
-        info->setGlobalTransactionId(tightUnmarshalByteArray(dataIn, bs));
-        info->setBranchQualifier(tightUnmarshalByteArray(dataIn, bs));
+        tightUnmarshalByteArray(dataIn, bs, info->getGlobalTransactionId());
+        tightUnmarshalByteArray(dataIn, bs, info->getBranchQualifier());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -122,8 +122,8 @@ void XATransactionIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataS
         XATransactionId* info =
             dynamic_cast<XATransactionId*>(dataStructure);
         info->setFormatId(dataIn->readInt());
-        info->setGlobalTransactionId(looseUnmarshalByteArray(dataIn));
-        info->setBranchQualifier(looseUnmarshalByteArray(dataIn));
+        looseUnmarshalByteArray(dataIn, info->getGlobalTransactionId());
+        looseUnmarshalByteArray(dataIn, info->getBranchQualifier());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
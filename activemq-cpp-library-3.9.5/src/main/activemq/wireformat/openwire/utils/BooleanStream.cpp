@@ -18,6 +18,9 @@
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
 
 #include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <algorithm>
 
 using namespace std;
 using namespace activemq;
@@ -30,7 +33,7 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ///////////////////////////////////////////////////////////////////////////////
-BooleanStream::BooleanStream() : data(), arrayLimit(0), arrayPos(0), bytePos(0) {
+BooleanStream::BooleanStream() : data(), arrayLimit(0), arrayPos(0), bytePos(0), lengths(), lengthPos(0) {
 
     // Reserve 1K
     this->data.resize( 1000, 0 );
@@ -90,6 +93,110 @@ void BooleanStream::writeBoolean( bool value ) {
     AMQ_CATCHALL_THROW( IOException )
 }
 
+///////////////////////////////////////////////////////////////////////////////
+unsigned int BooleanStream::readBits( int count ) {
+
+    try {
+
+        if( count < 0 || count > 32 ) {
+            throw IllegalArgumentException( __FILE__, __LINE__,
+                "BooleanStream::readBits - Can't read %d booleans at once", count );
+        }
+
+        // A run of up to 32 booleans spans at most 5 bytes, gather them into one
+        // word and shift the run down to the lowest bits.
+        int end = bytePos + count;
+        int bytes = ( end + 7 ) / 8;
+
+        if( arrayPos + bytes > arrayLimit ) {
+            throw IOException( __FILE__, __LINE__,
+                "BooleanStream::readBits - Not enough booleans remain in the stream" );
+        }
+
+        unsigned long long word = 0;
+        for( int i = 0; i < bytes; ++i ) {
+            word |= (unsigned long long)data[arrayPos + i] << ( 8 * i );
+        }
+
+        unsigned long long mask = ( 1ULL << count ) - 1;
+
+        arrayPos = (short)( arrayPos + end / 8 );
+        bytePos = (unsigned char)( end % 8 );
+
+        return (unsigned int)( ( word >> ( end - count ) ) & mask );
+    }
+    AMQ_CATCH_RETHROW( IOException )
+    AMQ_CATCH_EXCEPTION_CONVERT( Exception, IOException )
+    AMQ_CATCHALL_THROW( IOException )
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BooleanStream::writeBits( unsigned int bits, int count ) {
+
+    try {
+
+        if( count < 0 || count > 32 ) {
+            throw IllegalArgumentException( __FILE__, __LINE__,
+                "BooleanStream::writeBits - Can't write %d booleans at once", count );
+        }
+
+        int end = bytePos + count;
+        int bytes = ( end + 7 ) / 8;
+
+        // Keep the buffer larger than the limit just as writeBoolean does.
+        if( (size_t)( arrayPos + bytes ) >= data.size() ) {
+            data.resize( std::max( data.size() * 2, (size_t)( arrayPos + bytes + 1 ) ) );
+        }
+
+        if( arrayPos + bytes > arrayLimit ) {
+            arrayLimit = (short)( arrayPos + bytes );
+        }
+
+        unsigned long long mask = ( 1ULL << count ) - 1;
+        unsigned long long word = ( (unsigned long long)bits & mask ) << bytePos;
+
+        for( int i = 0; i < bytes; ++i ) {
+            data[arrayPos + i] |= (unsigned char)( word >> ( 8 * i ) );
+        }
+
+        arrayPos = (short)( arrayPos + end / 8 );
+        bytePos = (unsigned char)( end % 8 );
+    }
+    AMQ_CATCH_RETHROW( IOException )
+    AMQ_CATCH_EXCEPTION_CONVERT( Exception, IOException )
+    AMQ_CATCHALL_THROW( IOException )
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BooleanStream::skipBits( int count ) {
+
+    int end = arrayPos * 8 + bytePos + count;
+
+    if( count < 0 || end > arrayLimit * 8 ) {
+        throw IOException( __FILE__, __LINE__,
+            "BooleanStream::skipBits - Not enough booleans remain in the stream" );
+    }
+
+    arrayPos = (short)( end / 8 );
+    bytePos = (unsigned char)( end % 8 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BooleanStream::writeLength( int length ) {
+    this->lengths.push_back( length );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int BooleanStream::readLength() {
+
+    if( lengthPos >= lengths.size() ) {
+        throw IOException( __FILE__, __LINE__,
+            "BooleanStream::readLength - No recorded length remains to be read" );
+    }
+
+    return lengths[lengthPos++];
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void BooleanStream::marshal( DataOutputStream* dataOut ) {
 
@@ -131,7 +238,7 @@ void BooleanStream::marshal( std::vector< unsigned char >& dataOut ) {
         }
 
         // Insert all data from data into the passed buffer
-        dataOut.insert( dataOut.end(), &data[0], &data[arrayLimit-1] );
+        dataOut.insert( dataOut.end(), data.begin(), data.begin() + arrayLimit );
     }
     AMQ_CATCH_RETHROW( IOException )
     AMQ_CATCH_EXCEPTION_CONVERT( Exception, IOException )
@@ -169,6 +276,7 @@ void BooleanStream::clear() {
     // Reset the positions
     arrayPos = 0;
     bytePos = 0;
+    lengthPos = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
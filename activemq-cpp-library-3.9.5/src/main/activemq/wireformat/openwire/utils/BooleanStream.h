@@ -61,6 +61,12 @@ namespace utils{
         // Bit we are on in the byte we are on from the buffer
         unsigned char bytePos;
 
+        // Lengths recorded during the sizing pass, not part of the marshalled form
+        std::vector<int> lengths;
+
+        // Length we are on in the recorded lengths
+        std::size_t lengthPos;
+
     public:
 
         BooleanStream();
@@ -84,6 +90,60 @@ namespace utils{
          */
         void writeBoolean( bool value );
 
+        /**
+         * Reads a run of booleans from the internal data buffer in one call, the
+         * result is the same as calling readBoolean count times with the first value
+         * read returned in the lowest order bit.
+         *
+         * @param count - the number of booleans to read, from 0 to 32.
+         *
+         * @return the booleans read, one per bit starting at the lowest order bit.
+         *
+         * @throws IOException if fewer than count booleans remain in the stream.
+         */
+        unsigned int readBits( int count );
+
+        /**
+         * Writes a run of booleans to the internal data buffer in one call, the
+         * result is the same as calling writeBoolean for each of the count lowest
+         * order bits of the given value starting with the lowest.
+         *
+         * @param bits - the booleans to write, one per bit starting at the lowest order bit.
+         * @param count - the number of booleans to write, from 0 to 32.
+         *
+         * @throws IOException if an I/O error occurs during this operation.
+         */
+        void writeBits( unsigned int bits, int count );
+
+        /**
+         * Skips over a run of booleans that has already been consumed, as the second
+         * tight marshal pass does for the values written by the first.
+         *
+         * @param count - the number of booleans to skip.
+         *
+         * @throws IOException if fewer than count booleans remain in the stream.
+         */
+        void skipBits( int count );
+
+        /**
+         * Records a length computed while sizing a field in the first tight marshal
+         * pass so the second pass can write the field without computing it again.
+         * Recorded lengths are kept in memory only, they are never marshalled, and are
+         * read back in the order they were written just like the booleans.
+         *
+         * @param length - the length to record.
+         */
+        void writeLength( int length );
+
+        /**
+         * Reads the next length recorded by writeLength.
+         *
+         * @return the next recorded length.
+         *
+         * @throws IOException if there are no more recorded lengths.
+         */
+        int readLength();
+
         /**
          * Marshal the data to a DataOutputStream
          * @param dataOut - Stream to write the data to.
@@ -109,7 +169,7 @@ namespace utils{
         void unmarshal( decaf::io::DataInputStream* dataIn );
 
         /**
-         * Clears to old position markers, data starts at the beginning
+         * Clears to old position markers, data and recorded lengths start at the beginning
          */
         void clear();
 
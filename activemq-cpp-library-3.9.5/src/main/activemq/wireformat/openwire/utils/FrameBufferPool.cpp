@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameBufferPool.h"
+
+#include <decaf/util/concurrent/Concurrent.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+FrameBufferPool::FrameBufferPool(int maxPooled, int maxRetainedSize) :
+    pool(), maxPooled(maxPooled), maxRetainedSize(maxRetainedSize < 0 ? 0 : (std::size_t) maxRetainedSize),
+    allocations(0), mutex() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameBufferPool::~FrameBufferPool() {
+    try {
+        std::vector< std::vector<unsigned char>* >::iterator iter = pool.begin();
+        for (; iter != pool.end(); ++iter) {
+            delete *iter;
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char>* FrameBufferPool::acquire(int size) {
+
+    std::vector<unsigned char>* buffer = NULL;
+
+    synchronized(&mutex) {
+        if (!pool.empty()) {
+            buffer = pool.back();
+            pool.pop_back();
+        } else {
+            allocations++;
+        }
+    }
+
+    if (buffer == NULL) {
+        buffer = new std::vector<unsigned char>();
+    }
+
+    if (size > 0 && buffer->size() < (std::size_t) size) {
+        buffer->resize(size);
+    }
+
+    return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameBufferPool::release(std::vector<unsigned char>* buffer) {
+
+    if (buffer == NULL) {
+        return;
+    }
+
+    if (buffer->size() <= maxRetainedSize) {
+        synchronized(&mutex) {
+            if ((int) pool.size() < maxPooled) {
+                pool.push_back(buffer);
+                buffer = NULL;
+            }
+        }
+    }
+
+    delete buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FrameBufferPool::getPooledCount() const {
+
+    int result = 0;
+    synchronized(&mutex) {
+        result = (int) pool.size();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameBufferPool::getAllocationCount() const {
+
+    long long result = 0;
+    synchronized(&mutex) {
+        result = allocations;
+    }
+
+    return result;
+}
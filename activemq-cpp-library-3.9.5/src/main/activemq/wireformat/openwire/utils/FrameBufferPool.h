@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEBUFFERPOOL_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEBUFFERPOOL_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace utils {
+
+    /**
+     * Keeps a small number of receive buffers so that each inbound frame can be read
+     * into memory that is already allocated.  Buffers grow to fit the largest frame
+     * they have held, those that grow beyond the retained size limit are freed when
+     * they are returned rather than kept in the pool.  Callers that see frames larger
+     * than the retained size should not take them from the pool at all, since each
+     * such buffer would be allocated, zero filled and freed again on every use.
+     *
+     * This class is thread safe.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API FrameBufferPool {
+    private:
+
+        std::vector< std::vector<unsigned char>* > pool;
+        int maxPooled;
+        std::size_t maxRetainedSize;
+        long long allocations;
+        mutable decaf::util::concurrent::Mutex mutex;
+
+    private:
+
+        FrameBufferPool(const FrameBufferPool&);
+        FrameBufferPool& operator=(const FrameBufferPool&);
+
+    public:
+
+        /**
+         * Creates a new pool.
+         *
+         * @param maxPooled
+         *      The maximum number of idle buffers kept in the pool.
+         * @param maxRetainedSize
+         *      The largest buffer size in bytes that is returned to the pool.
+         */
+        FrameBufferPool(int maxPooled, int maxRetainedSize);
+
+        virtual ~FrameBufferPool();
+
+        /**
+         * Takes a buffer from the pool, or allocates one if the pool is empty, and
+         * sizes it to hold at least the requested number of bytes.
+         *
+         * @param size
+         *      The number of bytes the caller needs.
+         *
+         * @return a buffer that must be handed back with release.
+         */
+        std::vector<unsigned char>* acquire(int size);
+
+        /**
+         * Returns a buffer obtained from acquire.
+         *
+         * @param buffer
+         *      The buffer to return, NULL is ignored.
+         */
+        void release(std::vector<unsigned char>* buffer);
+
+        /**
+         * @return the largest buffer size in bytes that is returned to the pool.
+         */
+        int getMaxRetainedSize() const {
+            return (int) this->maxRetainedSize;
+        }
+
+        /**
+         * @return the number of idle buffers held in the pool.
+         */
+        int getPooledCount() const;
+
+        /**
+         * @return the number of buffers this pool has had to allocate.
+         */
+        long long getAllocationCount() const;
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEBUFFERPOOL_H_ */
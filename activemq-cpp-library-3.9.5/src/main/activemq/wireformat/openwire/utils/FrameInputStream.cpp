@@ -0,0 +1,249 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameInputStream.h"
+
+#include <decaf/io/EOFException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+
+#include <string.h>
+
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+FrameInputStreamCursor::FrameInputStreamCursor() : InputStream(), data(NULL), length(0), position(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameInputStreamCursor::~FrameInputStreamCursor() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameInputStreamCursor::skip(long long num) {
+
+    if (num <= 0) {
+        return 0;
+    }
+
+    long long remaining = this->length - this->position;
+    long long skipped = num < remaining ? num : remaining;
+    this->position += (int) skipped;
+
+    return skipped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FrameInputStreamCursor::doReadByte() {
+
+    if (this->position >= this->length) {
+        return -1;
+    }
+
+    return this->data[this->position++];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FrameInputStreamCursor::doReadArrayBounded(unsigned char* buffer, int size, int offset, int length) {
+
+    if (length == 0) {
+        return 0;
+    }
+
+    if (buffer == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Buffer passed was NULL.");
+    }
+
+    if (size < 0 || offset < 0 || offset > size || length < 0 || length > size - offset) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "Given size{%d} offset{%d} or length{%d} is invalid.",
+                                        size, offset, length);
+    }
+
+    int remaining = this->length - this->position;
+    if (remaining <= 0) {
+        return -1;
+    }
+
+    int count = length < remaining ? length : remaining;
+    memcpy(buffer + offset, this->data + this->position, count);
+    this->position += count;
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameInputStream::FrameInputStream() : DataInputStream(&cursor), cursor() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameInputStream::FrameInputStream(const unsigned char* data, int length) : DataInputStream(&cursor), cursor() {
+    this->setFrame(data, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameInputStream::~FrameInputStream() {
+    try {
+        // Close now while the cursor is still alive, the base class would otherwise
+        // try to close it after it has been destroyed.
+        this->close();
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameInputStream::setFrame(const unsigned char* data, int length) {
+
+    if (length < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Frame length cannot be negative: %d", length);
+    }
+
+    if (data == NULL && length > 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Frame data cannot be NULL");
+    }
+
+    this->cursor.data = data;
+    this->cursor.length = length;
+    this->cursor.position = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* FrameInputStream::consume(int count) {
+
+    if (this->cursor.length - this->cursor.position < count) {
+        throw EOFException(__FILE__, __LINE__, "FrameInputStream - Read past the end of the frame");
+    }
+
+    const unsigned char* result = this->cursor.data + this->cursor.position;
+    this->cursor.position += count;
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FrameInputStream::readBoolean() {
+    return *consume(1) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+char FrameInputStream::readByte() {
+    return (char) *consume(1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char FrameInputStream::readUnsignedByte() {
+    return *consume(1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+char FrameInputStream::readChar() {
+    return (char) *consume(1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double FrameInputStream::readDouble() {
+    unsigned long long lvalue = this->readLong();
+    double value = 0.0;
+    memcpy(&value, &lvalue, sizeof(unsigned long long));
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+float FrameInputStream::readFloat() {
+    unsigned int lvalue = this->readInt();
+    float value = 0.0f;
+    memcpy(&value, &lvalue, sizeof(unsigned int));
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FrameInputStream::readInt() {
+    const unsigned char* bytes = consume(4);
+    return (int) (((unsigned int) bytes[0] << 24) | ((unsigned int) bytes[1] << 16) |
+                  ((unsigned int) bytes[2] << 8) | (unsigned int) bytes[3]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameInputStream::readLong() {
+    const unsigned char* bytes = consume(8);
+
+    unsigned long long value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | (unsigned long long) bytes[i];
+    }
+
+    return (long long) value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short FrameInputStream::readShort() {
+    const unsigned char* bytes = consume(2);
+    return (short) ((bytes[0] << 8) | bytes[1]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned short FrameInputStream::readUnsignedShort() {
+    const unsigned char* bytes = consume(2);
+    return (unsigned short) ((bytes[0] << 8) | bytes[1]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameInputStream::readFully(unsigned char* buffer, int size) {
+
+    if (size == 0) {
+        return;
+    }
+
+    this->readFully(buffer, size, 0, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameInputStream::readFully(unsigned char* buffer, int size, int offset, int length) {
+
+    if (length == 0) {
+        return;
+    }
+
+    if (buffer == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Buffer is null");
+    }
+
+    if (size < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "size parameter out of Bounds: %d.", size);
+    }
+
+    if (offset > size || offset < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "offset parameter out of Bounds: %d.", offset);
+    }
+
+    if (length < 0 || length > size - offset) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", length);
+    }
+
+    memcpy(buffer + offset, consume(length), length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameInputStream::skipBytes(long long num) {
+    return this->cursor.skip(num);
+}
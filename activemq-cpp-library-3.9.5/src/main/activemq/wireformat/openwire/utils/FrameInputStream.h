@@ -0,0 +1,164 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEINPUTSTREAM_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEINPUTSTREAM_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/InputStream.h>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace utils {
+
+    /**
+     * The memory region a FrameInputStream reads from, also serves as the
+     * InputStream underneath it so that every read shares a single position.
+     */
+    class AMQCPP_API FrameInputStreamCursor : public decaf::io::InputStream {
+    private:
+
+        FrameInputStreamCursor(const FrameInputStreamCursor&);
+        FrameInputStreamCursor& operator=(const FrameInputStreamCursor&);
+
+    public:
+
+        const unsigned char* data;
+        int length;
+        int position;
+
+        FrameInputStreamCursor();
+
+        virtual ~FrameInputStreamCursor();
+
+        virtual int available() const {
+            return this->length - this->position;
+        }
+
+        virtual long long skip(long long num);
+
+    protected:
+
+        virtual int doReadByte();
+
+        virtual int doReadArrayBounded(unsigned char* buffer, int size, int offset, int length);
+
+    };
+
+    /**
+     * A DataInputStream that decodes a complete OpenWire frame held in memory.  The
+     * primitive reads that the marshallers perform for every field are done with
+     * bounds checked pointer arithmetic on the frame instead of passing through the
+     * chain of buffered socket streams, and reading past the end of the frame throws
+     * an EOFException.
+     *
+     * The stream does not copy or own the frame, the memory must stay valid and
+     * unchanged until decoding is complete.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API FrameInputStream : public decaf::io::DataInputStream {
+    private:
+
+        FrameInputStreamCursor cursor;
+
+    private:
+
+        FrameInputStream(const FrameInputStream&);
+        FrameInputStream& operator=(const FrameInputStream&);
+
+    public:
+
+        FrameInputStream();
+
+        /**
+         * Creates a new stream that reads the given frame.
+         *
+         * @param data
+         *      Pointer to the first byte of the frame.
+         * @param length
+         *      The number of bytes in the frame.
+         */
+        FrameInputStream(const unsigned char* data, int length);
+
+        virtual ~FrameInputStream();
+
+        /**
+         * Points this stream at a new frame and rewinds it to the start.
+         *
+         * @param data
+         *      Pointer to the first byte of the frame.
+         * @param length
+         *      The number of bytes in the frame.
+         *
+         * @throws IllegalArgumentException if length is negative or data is NULL with a non zero length.
+         */
+        void setFrame(const unsigned char* data, int length);
+
+        /**
+         * @return the number of bytes of the frame that have been consumed.
+         */
+        int getPosition() const {
+            return this->cursor.position;
+        }
+
+        /**
+         * @return the number of bytes of the frame that remain to be read.
+         */
+        int getRemaining() const {
+            return this->cursor.length - this->cursor.position;
+        }
+
+    public:
+
+        virtual bool readBoolean();
+
+        virtual char readByte();
+
+        virtual unsigned char readUnsignedByte();
+
+        virtual char readChar();
+
+        virtual double readDouble();
+
+        virtual float readFloat();
+
+        virtual int readInt();
+
+        virtual long long readLong();
+
+        virtual short readShort();
+
+        virtual unsigned short readUnsignedShort();
+
+        virtual void readFully(unsigned char* buffer, int size);
+
+        virtual void readFully(unsigned char* buffer, int size, int offset, int length);
+
+        virtual long long skipBytes(long long num);
+
+    private:
+
+        const unsigned char* consume(int count);
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FRAMEINPUTSTREAM_H_ */
@@ -259,7 +259,7 @@ Pointer<Command> StompWireFormat::unmarshalMessage(const Pointer<StompFrame> fra
         Pointer<ActiveMQBytesMessage> message(new ActiveMQBytesMessage());
         frame->removeProperty(StompCommandConstants::HEADER_CONTENTLENGTH);
         helper->convertProperties(frame, message);
-        message->setContent(frame->getBody());
+        message->swapContent(frame->getBody());
         messageDispatch->setMessage(message);
         messageDispatch->setDestination(message->getDestination());
 
@@ -0,0 +1,237 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SocketPoller.h"
+
+#include <decaf/internal/AprPool.h>
+#include <decaf/internal/net/SocketFileDescriptor.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <map>
+#include <memory>
+
+#include <apr_portable.h>
+#include <apr_poll.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace net {
+
+    /**
+     * A socket that is in the watched set, the APR socket wrapper lives in its
+     * own pool so that it can be released when the socket is removed.
+     */
+    class SocketPollerEntry {
+    private:
+
+        SocketPollerEntry(const SocketPollerEntry&);
+        SocketPollerEntry& operator=(const SocketPollerEntry&);
+
+    public:
+
+        AprPool pool;
+        apr_pollfd_t descriptor;
+
+        SocketPollerEntry() : pool(), descriptor() {
+        }
+    };
+
+    class SocketPollerImpl {
+    private:
+
+        SocketPollerImpl(const SocketPollerImpl&);
+        SocketPollerImpl& operator=(const SocketPollerImpl&);
+
+    public:
+
+        AprPool pool;
+        apr_pollset_t* pollset;
+        Mutex mutex;
+        std::map<long, SocketPollerEntry*> entries;
+
+        SocketPollerImpl() : pool(), pollset(NULL), mutex(), entries() {
+        }
+
+        ~SocketPollerImpl() {
+            std::map<long, SocketPollerEntry*>::iterator iter = entries.begin();
+            for (; iter != entries.end(); ++iter) {
+                delete iter->second;
+            }
+
+            if (pollset != NULL) {
+                apr_pollset_destroy(pollset);
+            }
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    long getSocketValue(const FileDescriptor* fd) {
+
+        if (fd == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "FileDescriptor cannot be NULL");
+        }
+
+        const SocketFileDescriptor* socketFd = dynamic_cast<const SocketFileDescriptor*>(fd);
+        if (socketFd == NULL) {
+            throw IllegalArgumentException(__FILE__, __LINE__, "FileDescriptor is not a Socket descriptor");
+        }
+
+        return socketFd->getValue();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SocketPoller::SocketPoller(int capacity) : impl(new SocketPollerImpl()) {
+
+    if (capacity <= 0) {
+        capacity = 1;
+    }
+
+    apr_status_t result = apr_pollset_create(&impl->pollset, (apr_uint32_t) capacity, impl->pool.getAprPool(),
+                                             APR_POLLSET_THREADSAFE | APR_POLLSET_WAKEABLE);
+
+    if (result != APR_SUCCESS) {
+        impl->pollset = NULL;
+        delete impl;
+        throw IOException(__FILE__, __LINE__,
+            "SocketPoller - Platform does not support a thread safe pollset, error code %d", (int) result);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SocketPoller::~SocketPoller() {
+    try {
+        delete impl;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SocketPoller::add(const FileDescriptor* fd, void* attachment) {
+
+    if (attachment == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Attachment cannot be NULL");
+    }
+
+    long value = getSocketValue(fd);
+
+    synchronized(&impl->mutex) {
+
+        if (impl->entries.find(value) != impl->entries.end()) {
+            throw IOException(__FILE__, __LINE__, "SocketPoller::add - Socket is already registered");
+        }
+
+        std::auto_ptr<SocketPollerEntry> entry(new SocketPollerEntry());
+
+        apr_socket_t* socket = NULL;
+        apr_os_sock_t osSocket = (apr_os_sock_t) value;
+        apr_status_t result = apr_os_sock_put(&socket, &osSocket, entry->pool.getAprPool());
+        if (result != APR_SUCCESS) {
+            throw IOException(__FILE__, __LINE__, "SocketPoller::add - Could not wrap socket, error code %d", (int) result);
+        }
+
+        entry->descriptor.p = entry->pool.getAprPool();
+        entry->descriptor.desc_type = APR_POLL_SOCKET;
+        entry->descriptor.reqevents = APR_POLLIN;
+        entry->descriptor.desc.s = socket;
+        entry->descriptor.client_data = attachment;
+
+        result = apr_pollset_add(impl->pollset, &entry->descriptor);
+        if (result != APR_SUCCESS) {
+            throw IOException(__FILE__, __LINE__, "SocketPoller::add - Could not add socket, error code %d", (int) result);
+        }
+
+        impl->entries[value] = entry.release();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SocketPoller::remove(const FileDescriptor* fd) {
+
+    long value = getSocketValue(fd);
+
+    synchronized(&impl->mutex) {
+
+        std::map<long, SocketPollerEntry*>::iterator iter = impl->entries.find(value);
+        if (iter == impl->entries.end()) {
+            break;
+        }
+
+        // The socket may already be closed in which case the OS has dropped it from
+        // the set, the pollset still releases its own record so the result is ignored.
+        apr_pollset_remove(impl->pollset, &iter->second->descriptor);
+
+        delete iter->second;
+        impl->entries.erase(iter);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int SocketPoller::poll(long long timeout, std::vector<void*>& ready) {
+
+    ready.clear();
+
+    apr_interval_time_t interval = timeout < 0 ? -1 : (apr_interval_time_t) (timeout * 1000);
+    apr_int32_t count = 0;
+    const apr_pollfd_t* descriptors = NULL;
+
+    apr_status_t result = apr_pollset_poll(impl->pollset, interval, &count, &descriptors);
+
+    if (APR_STATUS_IS_TIMEUP(result) || APR_STATUS_IS_EINTR(result)) {
+        return 0;
+    } else if (result != APR_SUCCESS) {
+        throw IOException(__FILE__, __LINE__, "SocketPoller::poll - Poll failed, error code %d", (int) result);
+    }
+
+    for (apr_int32_t i = 0; i < count; ++i) {
+        ready.push_back(descriptors[i].client_data);
+    }
+
+    return (int) ready.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SocketPoller::wakeup() {
+    apr_pollset_wakeup(impl->pollset);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int SocketPoller::size() const {
+
+    int result = 0;
+    synchronized(&impl->mutex) {
+        result = (int) impl->entries.size();
+    }
+
+    return result;
+}
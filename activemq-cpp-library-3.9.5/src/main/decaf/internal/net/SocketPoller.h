@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_SOCKETPOLLER_H_
+#define _DECAF_INTERNAL_NET_SOCKETPOLLER_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/io/FileDescriptor.h>
+#include <decaf/io/IOException.h>
+
+#include <vector>
+
+namespace decaf {
+namespace internal {
+namespace net {
+
+    class SocketPollerImpl;
+
+    /**
+     * Waits for read readiness on a set of sockets at once, hiding the platform
+     * event notification mechanism (epoll on Linux, kqueue on the BSDs, poll or
+     * select elsewhere) behind a single interface.
+     *
+     * Sockets may be added and removed from any thread while another thread is
+     * blocked in poll.  A socket that has been removed may still be reported by a
+     * poll call that was already in progress, callers that need a strict guarantee
+     * must filter the returned attachments themselves.
+     *
+     * @since 3.9
+     */
+    class DECAF_API SocketPoller {
+    private:
+
+        SocketPollerImpl* impl;
+
+    private:
+
+        SocketPoller(const SocketPoller&);
+        SocketPoller& operator=(const SocketPoller&);
+
+    public:
+
+        /**
+         * Creates a new poller.
+         *
+         * @param capacity
+         *      The number of sockets the poller is expected to hold, used as a sizing hint.
+         *
+         * @throws IOException if the platform poller could not be created.
+         */
+        SocketPoller(int capacity);
+
+        virtual ~SocketPoller();
+
+        /**
+         * Adds the given socket to the set watched for read readiness, the attachment
+         * value is returned from poll each time the socket becomes readable.  A socket
+         * remains readable while it has unread data or has reached end of stream.
+         *
+         * @param fd
+         *      The FileDescriptor of a connected Socket.
+         * @param attachment
+         *      Opaque value returned from poll for this socket, cannot be NULL.
+         *
+         * @throws IOException if the socket could not be added.
+         * @throws IllegalArgumentException if the descriptor is not a socket descriptor.
+         */
+        void add(const decaf::io::FileDescriptor* fd, void* attachment);
+
+        /**
+         * Removes the given socket from the watched set.  Removing a socket that was
+         * never added is ignored.
+         *
+         * @param fd
+         *      The FileDescriptor that was passed to add.
+         */
+        void remove(const decaf::io::FileDescriptor* fd);
+
+        /**
+         * Waits until at least one socket is readable, the timeout expires or wakeup
+         * is called.
+         *
+         * @param timeout
+         *      The maximum time to wait in milliseconds, a negative value waits forever.
+         * @param ready
+         *      Cleared and then filled with the attachments of the readable sockets.
+         *
+         * @return the number of readable sockets, zero on timeout or wakeup.
+         *
+         * @throws IOException if the platform poll call fails.
+         */
+        int poll(long long timeout, std::vector<void*>& ready);
+
+        /**
+         * Causes a thread blocked in poll to return immediately.
+         */
+        void wakeup();
+
+        /**
+         * @return the number of sockets currently in the watched set.
+         */
+        int size() const;
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_NET_SOCKETPOLLER_H_ */
@@ -24,19 +24,26 @@
 #include <decaf/net/SocketError.h>
 #include <decaf/net/SocketOptions.h>
 #include <decaf/lang/Character.h>
+#include <decaf/lang/System.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <string>
 #include <stdio.h>
 #include <iostream>
+#include <vector>
 
 #include <apr_portable.h>
+#define APR_WANT_IOVEC
+#include <apr_want.h>
 #include <apr_network_io.h>
 
 #if !defined(HAVE_WINSOCK2_H)
     #include <sys/select.h>
     #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
 #else
     #include <Winsock2.h>
 #endif
@@ -62,6 +69,14 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util::concurrent::atomic;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Quick ACK mode tends to lapse across the pauses of a request and reply exchange,
+    // a gap longer than the minimum delayed ACK time of Linux counts as such a pause.
+    const long long QUICK_ACK_IDLE_TIME = 40 * 1000 * 1000;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 namespace decaf {
 namespace internal {
@@ -85,6 +100,10 @@ namespace tcp {
         int trafficClass;
         int soTimeout;
         int soLinger;
+        bool tcpQuickAck;
+
+        // Time of the last read that returned data, only used by the reading thread.
+        long long lastReadTime;
 
         TcpSocketImpl() : apr_pool(),
                           socketHandle(NULL),
@@ -99,7 +118,9 @@ namespace tcp {
                           connected(false),
                           trafficClass(0),
                           soTimeout(-1),
-                          soLinger(-1) {
+                          soLinger(-1),
+                          tcpQuickAck(false),
+                          lastReadTime(0) {
         }
     };
 
@@ -552,6 +573,14 @@ int TcpSocket::getOption(int option) const {
             }
 
             return this->impl->soLinger;
+        } else if (option == SocketOptions::SOCKET_OPTION_BUSY_POLL ||
+                   option == SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT) {
+            return getPlatformOption(option);
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_QUICKACK) {
+            // The platform resets this on its own, report what was asked for.
+            return this->impl->tcpQuickAck ? 1 : 0;
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_RTT) {
+            return getRoundTripTime();
         }
 
         if (option == SocketOptions::SOCKET_OPTION_REUSEADDR) {
@@ -602,6 +631,18 @@ void TcpSocket::setOption(int option, int value) {
             value = value <= 0 ? 0 : 1;
             checkResult(apr_socket_opt_set(impl->socketHandle, APR_SO_LINGER, (apr_int32_t) value));
             return;
+        } else if (option == SocketOptions::SOCKET_OPTION_BUSY_POLL ||
+                   option == SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT) {
+            setPlatformOption(option, value);
+            return;
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_QUICKACK) {
+            int level = 0;
+            int name = 0;
+            if (toPlatformOption(option, level, name)) {
+                setPlatformOption(option, value);
+                this->impl->tcpQuickAck = value != 0;
+            }
+            return;
         }
 
         if (option == SocketOptions::SOCKET_OPTION_REUSEADDR) {
@@ -624,6 +665,93 @@ void TcpSocket::setOption(int option, int value) {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocket::getPlatformOption(int option) const {
+
+    int level = 0;
+    int name = 0;
+
+    if (!toPlatformOption(option, level, name)) {
+        // Not supported on this platform, report it as disabled.
+        return 0;
+    }
+
+    apr_os_sock_t oss;
+    apr_os_sock_get(&oss, impl->socketHandle);
+
+    int value = 0;
+    socklen_t length = (socklen_t) sizeof(value);
+    if (::getsockopt(oss, level, name, (char*) &value, &length) != 0) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::setPlatformOption(int option, int value) {
+
+    int level = 0;
+    int name = 0;
+
+    if (!toPlatformOption(option, level, name)) {
+        // Not supported on this platform, the option is a hint so we ignore it.
+        return;
+    }
+
+    apr_os_sock_t oss;
+    apr_os_sock_get(&oss, impl->socketHandle);
+
+    if (::setsockopt(oss, level, name, (const char*) &value, (socklen_t) sizeof(value)) != 0) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocket::getRoundTripTime() const {
+
+#if defined(TCP_INFO) && defined(__linux__)
+    apr_os_sock_t oss;
+    apr_os_sock_get(&oss, impl->socketHandle);
+
+    struct tcp_info info;
+    socklen_t length = (socklen_t) sizeof(info);
+    if (::getsockopt(oss, IPPROTO_TCP, TCP_INFO, (char*) &info, &length) != 0) {
+        throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+    }
+
+    return (int) info.tcpi_rtt;
+#else
+    return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpSocket::toPlatformOption(int option, int& level, int& name) {
+
+    if (option == SocketOptions::SOCKET_OPTION_BUSY_POLL) {
+#if defined(SO_BUSY_POLL)
+        level = SOL_SOCKET;
+        name = SO_BUSY_POLL;
+        return true;
+#endif
+    } else if (option == SocketOptions::SOCKET_OPTION_TCP_QUICKACK) {
+#if defined(TCP_QUICKACK)
+        level = IPPROTO_TCP;
+        name = TCP_QUICKACK;
+        return true;
+#endif
+    } else if (option == SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT) {
+#if defined(TCP_NOTSENT_LOWAT)
+        level = IPPROTO_TCP;
+        name = TCP_NOTSENT_LOWAT;
+        return true;
+#endif
+    }
+
+    return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpSocket::checkResult(apr_status_t value) const {
 
@@ -691,6 +819,8 @@ int TcpSocket::read(unsigned char* buffer, int size, int offset, int length) {
                 "Socket Read Error - %s", SocketError::getErrorString().c_str());
         }
 
+        rearmTcpQuickAck();
+
         return (int) aprSize;
     }
     DECAF_CATCH_RETHROW(IOException)
@@ -699,6 +829,115 @@ int TcpSocket::read(unsigned char* buffer, int size, int offset, int length) {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::rearmTcpQuickAck() {
+
+    if (!this->impl->tcpQuickAck) {
+        return;
+    }
+
+    // A setsockopt after every read costs a system call per read on a busy stream,
+    // so the mode is only asked for again when the data ends an idle period.
+    long long now = System::nanoTime();
+    if (this->impl->lastReadTime == 0 || now - this->impl->lastReadTime > QUICK_ACK_IDLE_TIME) {
+        setPlatformOption(SocketOptions::SOCKET_OPTION_TCP_QUICKACK, 1);
+    }
+
+    this->impl->lastReadTime = now;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocket::readAvailable(unsigned char* buffer, int size, int offset, int length) {
+
+    try {
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "The Stream has been closed");
+        }
+
+        if (this->impl->inputShutdown == true) {
+            return -1;
+        }
+
+        if (length == 0) {
+            return 0;
+        }
+
+        if (buffer == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Buffer passed is Null");
+        }
+
+        if (size < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__,
+                "size parameter out of Bounds: %d.", size);
+        }
+
+        if (offset > size || offset < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__,
+                "offset parameter out of Bounds: %d.", offset);
+        }
+
+        if (length < 0 || length > size - offset) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__,
+                "length parameter out of Bounds: %d.", length);
+        }
+
+        apr_os_sock_t oss;
+        apr_os_sock_get(&oss, impl->socketHandle);
+
+#if defined(MSG_DONTWAIT)
+
+        // The flag makes just this call non-blocking, writers on other threads
+        // keep their blocking sends.
+        int result = (int) ::recv(oss, (char*) buffer + offset, (std::size_t) length, MSG_DONTWAIT);
+
+        if (result == 0) {
+            this->impl->inputShutdown = true;
+            return -1;
+        }
+
+        if (result < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return 0;
+            }
+
+            throw IOException(__FILE__, __LINE__,
+                "Socket Read Error - %s", SocketError::getErrorString().c_str());
+        }
+
+        rearmTcpQuickAck();
+
+        return result;
+
+#else
+
+        // Only what is already buffered is read.  A socket that polls readable with
+        // nothing buffered is at end of stream or in error, which read reports at once.
+        int buffered = available();
+        if (buffered > 0) {
+            return read(buffer, size, offset, buffered < length ? buffered : length);
+        }
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(oss, &readable);
+        struct timeval none;
+        none.tv_sec = 0;
+        none.tv_usec = 0;
+
+        if (::select((int) oss + 1, &readable, NULL, NULL, &none) <= 0) {
+            return 0;
+        }
+
+        return read(buffer, size, offset, length);
+
+#endif
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpSocket::write(const unsigned char* buffer, int size, int offset, int length) {
 
@@ -760,6 +999,78 @@ void TcpSocket::write(const unsigned char* buffer, int size, int offset, int len
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::writev(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    try {
+
+        if (count < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__,
+                "count parameter out of Bounds: %d.", count);
+        }
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__,
+                "TcpSocket::writev - This Stream has been closed.");
+        }
+
+        std::vector<struct iovec> vectors;
+        vectors.reserve(count);
+
+        for (int i = 0; i < count; ++i) {
+
+            if (lengths[i] < 0) {
+                throw IndexOutOfBoundsException(__FILE__, __LINE__,
+                    "length parameter out of Bounds: %d.", lengths[i]);
+            }
+
+            if (lengths[i] == 0) {
+                continue;
+            }
+
+            if (buffers[i] == NULL) {
+                throw NullPointerException(__FILE__, __LINE__,
+                    "TcpSocket::writev - passed buffer is null");
+            }
+
+            struct iovec vector;
+            vector.iov_base = (char*) buffers[i];
+            vector.iov_len = (std::size_t) lengths[i];
+            vectors.push_back(vector);
+        }
+
+        std::size_t next = 0;
+
+        while (next < vectors.size() && !isClosed()) {
+
+            // On return sent is the amount actually written, which can end part
+            // way through one of the buffers.
+            apr_size_t sent = 0;
+            apr_status_t result = apr_socket_sendv(this->impl->socketHandle, &vectors[next],
+                                                   (apr_int32_t) (vectors.size() - next), &sent);
+
+            if (result != APR_SUCCESS || isClosed()) {
+                throw IOException(__FILE__, __LINE__,
+                    "TcpSocketOutputStream::write - %s", SocketError::getErrorString().c_str());
+            }
+
+            while (next < vectors.size() && sent >= vectors[next].iov_len) {
+                sent -= vectors[next].iov_len;
+                next++;
+            }
+
+            if (sent > 0) {
+                vectors[next].iov_base = (char*) vectors[next].iov_base + sent;
+                vectors[next].iov_len -= sent;
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool TcpSocket::isConnected() const {
     return this->impl->connected;
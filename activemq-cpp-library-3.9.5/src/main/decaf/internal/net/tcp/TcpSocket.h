@@ -184,10 +184,66 @@ namespace tcp {
          */
         void write(const unsigned char* buffer, int size, int offset, int length);
 
+        /**
+         * Writes several buffers to the Socket with a single gathering send, the data
+         * is taken directly from the given buffers in order without first being copied
+         * into one contiguous block.
+         *
+         * @param buffers
+         *      The buffers to write to the socket.
+         * @param lengths
+         *      The number of bytes to write from each of the buffers.
+         * @param count
+         *      The number of buffers given.
+         *
+         * @throw IOException if an I/O error occurs during the write.
+         * @throw NullPointerException if a buffer with a non zero length is Null.
+         * @throw IndexOutOfBoundsException if count or one of the lengths is negative.
+         */
+        void writev(const unsigned char* const* buffers, const int* lengths, int count);
+
+        /**
+         * Reads whatever data the Socket already holds without ever waiting for more,
+         * the socket itself stays in blocking mode for other readers and writers.
+         *
+         * @param buffer
+         *      The buffer to read into
+         * @param size
+         *      The size of the specified buffer
+         * @param offset
+         *      The offset into the buffer where reading should start filling.
+         * @param length
+         *      The maximum number of bytes past offset to fill with data.
+         *
+         * @return the number of bytes read, zero if there was nothing to read yet or
+         *         -1 if at EOF.
+         *
+         * @throw IOException if an I/O error occurs during the read.
+         * @throw NullPointerException if buffer is Null.
+         * @throw IndexOutOfBoundsException if offset + length is greater than buffer size.
+         */
+        int readAvailable(unsigned char* buffer, int size, int offset, int length);
+
     protected:
 
         void checkResult(apr_status_t value) const;
 
+    private:
+
+        // Options that APR doesn't expose are applied directly to the OS socket.
+        int getPlatformOption(int option) const;
+        void setPlatformOption(int option, int value);
+
+        // Smoothed round trip time in microseconds as measured by the platform.
+        int getRoundTripTime() const;
+
+        // Asks for quick ACK mode again after a read that ended an idle period.
+        void rearmTcpQuickAck();
+
+        // Maps a SocketOptions value to its native level and name, returns false
+        // when the current platform has no equivalent option.
+        static bool toPlatformOption(int option, int& level, int& name);
+
     };
 
 }}}}
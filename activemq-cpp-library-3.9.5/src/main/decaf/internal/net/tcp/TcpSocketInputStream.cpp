@@ -125,3 +125,20 @@ long long TcpSocketInputStream::skip(long long num) {
     DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
     DECAF_CATCHALL_THROW(IOException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocketInputStream::readAvailable(unsigned char* buffer, int size, int offset, int length) {
+
+    if (closed) {
+        throw IOException(__FILE__, __LINE__, "The stream is closed");
+    }
+
+    try {
+        return this->socket->readAvailable(buffer, size, offset, length);
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
@@ -82,6 +82,24 @@ namespace tcp {
          */
         virtual long long skip(long long num);
 
+        /**
+         * Reads only the data the socket already holds, never waiting for more.
+         *
+         * @param buffer
+         *      The buffer to read into.
+         * @param size
+         *      The size of the buffer.
+         * @param offset
+         *      The offset into the buffer to start filling at.
+         * @param length
+         *      The maximum number of bytes to read.
+         *
+         * @return the number of bytes read, zero if none were waiting or -1 at EOF.
+         *
+         * @throws IOException if an I/O error occurs or the stream is closed.
+         */
+        int readAvailable(unsigned char* buffer, int size, int offset, int length);
+
     protected:
 
         virtual int doReadByte();
@@ -100,3 +100,21 @@ void TcpSocketOutputStream::doWriteArrayBounded(const unsigned char* buffer, int
     DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
     DECAF_CATCHALL_THROW(IOException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocketOutputStream::writev(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    try {
+
+        if (closed) {
+            throw IOException(__FILE__, __LINE__,
+                "TcpSocketOutputStream::writev - This Stream has been closed.");
+        }
+
+        this->socket->writev(buffers, lengths, count);
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
@@ -59,6 +59,21 @@ namespace tcp {
 
         virtual void close();
 
+        /**
+         * Writes the given buffers to the socket in order using a single gathering
+         * send, none of the data is copied before it is handed to the socket.
+         *
+         * @param buffers
+         *      The buffers to write to the socket.
+         * @param lengths
+         *      The number of bytes to write from each of the buffers.
+         * @param count
+         *      The number of buffers given.
+         *
+         * @throws IOException if an I/O error occurs or the stream is closed.
+         */
+        void writev(const unsigned char* const* buffers, const int* lengths, int count);
+
     protected:
 
         virtual void doWriteByte(unsigned char c);
@@ -686,6 +686,129 @@ void Socket::setOOBInline( bool value ) {
     DECAF_CATCHALL_THROW( SocketException )
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int Socket::getBusyPoll() const {
+
+    checkClosed();
+
+    try{
+        ensureCreated();
+        return this->impl->getOption( SocketOptions::SOCKET_OPTION_BUSY_POLL );
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Socket::getTcpQuickAck() const {
+
+    checkClosed();
+
+    try{
+        ensureCreated();
+        return this->impl->getOption( SocketOptions::SOCKET_OPTION_TCP_QUICKACK ) != 0;
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Socket::setTcpQuickAck( bool value ) {
+
+    checkClosed();
+
+    try{
+        ensureCreated();
+        this->impl->setOption( SocketOptions::SOCKET_OPTION_TCP_QUICKACK, value ? 1 : 0 );
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Socket::getTcpNotSentLowWatermark() const {
+
+    checkClosed();
+
+    try{
+        ensureCreated();
+        return this->impl->getOption( SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT );
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Socket::setTcpNotSentLowWatermark( int value ) {
+
+    checkClosed();
+
+    if( value < 0 ) {
+        throw IllegalArgumentException(
+            __FILE__, __LINE__, "Not sent low watermark given was invalid: %d", value );
+    }
+
+    try{
+        ensureCreated();
+        this->impl->setOption( SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT, value );
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_RETHROW( IllegalArgumentException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Socket::getRoundTripTime() const {
+
+    checkClosed();
+
+    try{
+        ensureCreated();
+        return this->impl->getOption( SocketOptions::SOCKET_OPTION_TCP_RTT );
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Socket::setBusyPoll( int value ) {
+
+    checkClosed();
+
+    if( value < 0 ) {
+        throw IllegalArgumentException(
+            __FILE__, __LINE__, "Busy poll time given was invalid: %d", value );
+    }
+
+    try{
+        ensureCreated();
+        this->impl->setOption( SocketOptions::SOCKET_OPTION_BUSY_POLL, value );
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_RETHROW( IllegalArgumentException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const FileDescriptor* Socket::getFileDescriptor() const {
+
+    checkClosed();
+
+    try{
+        return this->impl->getFileDescriptor();
+    }
+    DECAF_CATCH_RETHROW( SocketException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, SocketException )
+    DECAF_CATCHALL_THROW( SocketException )
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Socket::sendUrgentData( int data ) {
 
@@ -23,6 +23,7 @@
 #include <decaf/io/InputStream.h>
 #include <decaf/io/OutputStream.h>
 #include <decaf/io/Closeable.h>
+#include <decaf/io/FileDescriptor.h>
 #include <decaf/util/Config.h>
 
 #include <decaf/lang/exceptions/NullPointerException.h>
@@ -530,6 +531,92 @@ namespace net{
          */
         virtual void setOOBInline(bool value);
 
+        /**
+         * Gets the SO_BUSY_POLL setting for this socket.
+         *
+         * @return the busy poll time in microseconds, zero if disabled or not supported.
+         *
+         * @throws SocketException if an error is encountered while performing this operation.
+         */
+        virtual int getBusyPoll() const;
+
+        /**
+         * Sets the SO_BUSY_POLL setting for this socket, a blocking read will busy poll the
+         * device queue for up to the given number of microseconds before it sleeps.  On
+         * platforms without support for this option the value is ignored.
+         *
+         * @param value
+         *      The busy poll time in microseconds, zero disables busy polling.
+         *
+         * @throws SocketException if an error is encountered while performing this operation.
+         * @throws IllegalArgumentException if the value is negative.
+         */
+        virtual void setBusyPoll(int value);
+
+        /**
+         * Gets the TCP_QUICKACK setting for this socket.
+         *
+         * @return true if quick acknowledgments are enabled, false if disabled or not supported.
+         *
+         * @throws SocketException if an error is encountered while performing this operation.
+         */
+        virtual bool getTcpQuickAck() const;
+
+        /**
+         * Sets the TCP_QUICKACK setting for this socket, when enabled received data is
+         * acknowledged immediately rather than waiting to piggyback the ACK on outgoing
+         * data.  On platforms without support for this option the value is ignored.
+         *
+         * @param value
+         *      True to enable quick acknowledgments.
+         *
+         * @throws SocketException if an error is encountered while performing this operation.
+         */
+        virtual void setTcpQuickAck(bool value);
+
+        /**
+         * Gets the TCP_NOTSENT_LOWAT setting for this socket.
+         *
+         * @return the limit in bytes on unsent data, zero if not set or not supported.
+         *
+         * @throws SocketException if an error is encountered while performing this operation.
+         */
+        virtual int getTcpNotSentLowWatermark() const;
+
+        /**
+         * Sets the TCP_NOTSENT_LOWAT setting for this socket, limiting how many bytes of
+         * written but unsent data the send buffer holds.  On platforms without support for
+         * this option the value is ignored.
+         *
+         * @param value
+         *      The limit in bytes.
+         *
+         * @throws SocketException if an error is encountered while performing this operation.
+         * @throws IllegalArgumentException if the value is negative.
+         */
+        virtual void setTcpNotSentLowWatermark(int value);
+
+        /**
+         * Gets the smoothed round trip time measured by the platform for this connection.
+         *
+         * @return the round trip time in microseconds, zero if not known or not supported.
+         *
+         * @throws SocketException if an error is encountered while performing this operation.
+         */
+        virtual int getRoundTripTime() const;
+
+        /**
+         * Gets the FileDescriptor of the platform socket backing this Socket, this allows
+         * the Socket to be registered with an event notification mechanism such as the
+         * internal SocketPoller.  The returned pointer is owned by the Socket and becomes
+         * invalid once the Socket is closed.
+         *
+         * @return the FileDescriptor for this Socket or NULL if it is not yet created.
+         *
+         * @throws SocketException if the Socket is closed.
+         */
+        const decaf::io::FileDescriptor* getFileDescriptor() const;
+
         /**
          * Sends on byte of urgent data to the Socket.
          *
@@ -148,6 +148,45 @@ namespace net {
          */
         static const int SOCKET_OPTION_OOBINLINE;
 
+        /**
+         * Sets SO_BUSY_POLL for a socket.  The value is the approximate time in microseconds
+         * that a blocking receive will busy poll the device queue before sleeping.  This is a
+         * Linux specific option, on platforms that lack support setting it has no effect and
+         * the value reported is always zero.
+         *
+         * Valid only for TCP socket: SocketImpl
+         */
+        static const int SOCKET_OPTION_BUSY_POLL;
+
+        /**
+         * Sets TCP_QUICKACK for a socket.  When enabled acknowledgments are sent as soon as
+         * data arrives instead of being delayed.  The platform clears this setting on its own
+         * so the socket applies it again after each read while it is enabled.  This is a
+         * Linux specific option, elsewhere setting it has no effect and it reads as disabled.
+         *
+         * Valid only for TCP socket: SocketImpl
+         */
+        static const int SOCKET_OPTION_TCP_QUICKACK;
+
+        /**
+         * Sets TCP_NOTSENT_LOWAT for a socket.  The value limits the number of bytes that can
+         * sit unsent in the socket send buffer, which keeps large send buffers from adding
+         * queuing delay to newly written data.  On platforms that lack support setting it has
+         * no effect and the value reported is always zero.
+         *
+         * Valid only for TCP socket: SocketImpl
+         */
+        static const int SOCKET_OPTION_TCP_NOTSENT_LOWAT;
+
+        /**
+         * Gets the smoothed round trip time the platform has measured for a connected TCP
+         * socket in microseconds.  This option can only be read, on platforms that do not
+         * expose the measurement the value reported is always zero.
+         *
+         * Valid only for TCP socket: SocketImpl
+         */
+        static const int SOCKET_OPTION_TCP_RTT;
+
     public:
 
         virtual ~SocketOptions();
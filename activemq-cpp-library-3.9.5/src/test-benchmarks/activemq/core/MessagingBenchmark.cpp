@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessagingBenchmark.h"
+
+#include <activemq/core/ActiveMQConnectionFactory.h>
+
+#include <cms/BytesMessage.h>
+#include <cms/Connection.h>
+#include <cms/DeliveryMode.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageListener.h>
+#include <cms/MessageProducer.h>
+#include <cms/Session.h>
+
+#include <decaf/lang/System.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::mock;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int MESSAGE_SIZES[] = { 128, 1024, 16 * 1024 };
+    const int MESSAGE_COUNTS[] = { 5000, 5000, 1000 };
+    const int NUM_SIZES = 3;
+
+    const std::string SENT_AT = "benchmarkSentAt";
+
+    class LatencyListener : public cms::MessageListener {
+    private:
+
+        LatencyListener(const LatencyListener&);
+        LatencyListener& operator= (const LatencyListener&);
+
+    public:
+
+        Mutex mutex;
+        std::vector<long long> latencies;
+        CountDownLatch done;
+
+        LatencyListener(int count) : mutex(), latencies(), done(count) {
+            latencies.reserve(count);
+        }
+
+        virtual ~LatencyListener() {}
+
+        virtual void onMessage(const cms::Message* message) {
+
+            long long now = System::nanoTime();
+
+            synchronized(&mutex) {
+                latencies.push_back(now - message->getLongProperty(SENT_AT));
+            }
+
+            done.countDown();
+        }
+    };
+
+    long long percentile(const std::vector<long long>& sorted, int percent) {
+
+        if (sorted.empty()) {
+            return 0;
+        }
+
+        std::size_t index = (sorted.size() * percent) / 100;
+        if (index >= sorted.size()) {
+            index = sorted.size() - 1;
+        }
+
+        return sorted[index];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessagingBenchmark::MessagingBenchmark() : broker() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessagingBenchmark::~MessagingBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::setUp() {
+    this->broker.reset(new EchoBrokerService());
+    this->broker->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::tearDown() {
+    this->broker->stop();
+    this->broker.reset(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testSyncPersistent() {
+    runAllSizes(true, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testSyncNonPersistent() {
+    runAllSizes(true, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testAsyncPersistent() {
+    runAllSizes(false, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testAsyncNonPersistent() {
+    runAllSizes(false, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::runAllSizes(bool sync, bool persistent) {
+
+    for (int i = 0; i < NUM_SIZES; ++i) {
+        runBenchmark(sync, persistent, MESSAGE_SIZES[i], MESSAGE_COUNTS[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::runBenchmark(bool sync, bool persistent, int messageSize, int messageCount) {
+
+    ActiveMQConnectionFactory factory(this->broker->getConnectString());
+
+    // Force the send mode, otherwise it follows the delivery mode.
+    factory.setAlwaysSyncSend(sync);
+    factory.setUseAsyncSend(!sync);
+
+    std::auto_ptr<cms::Connection> connection(factory.createConnection());
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("benchmark.echo"));
+
+    LatencyListener listener(messageCount);
+
+    std::auto_ptr<cms::MessageConsumer> consumer(session->createConsumer(queue.get()));
+    consumer->setMessageListener(&listener);
+
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(queue.get()));
+    producer->setDeliveryMode(persistent ? cms::DeliveryMode::PERSISTENT : cms::DeliveryMode::NON_PERSISTENT);
+
+    connection->start();
+
+    std::vector<unsigned char> body(messageSize, 'a');
+    std::auto_ptr<cms::BytesMessage> message(session->createBytesMessage());
+    message->setBodyBytes(&body[0], messageSize);
+
+    long long start = System::nanoTime();
+
+    for (int i = 0; i < messageCount; ++i) {
+        message->setLongProperty(SENT_AT, System::nanoTime());
+        producer->send(message.get());
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Not all messages were echoed back", listener.done.await(60000));
+
+    long long elapsed = System::nanoTime() - start;
+
+    connection->close();
+
+    std::vector<long long> latencies;
+    synchronized(&listener.mutex) {
+        latencies = listener.latencies;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    double rate = elapsed > 0 ? (double) messageCount * 1000000000.0 / (double) elapsed : 0.0;
+
+    std::cout << "Messaging Benchmark [" << (sync ? "sync" : "async") << ", "
+              << (persistent ? "persistent" : "non-persistent") << ", "
+              << messageSize << " bytes] "
+              << (long long) rate << " msgs/sec, latency usecs"
+              << " p50 = " << percentile(latencies, 50) / 1000
+              << " p90 = " << percentile(latencies, 90) / 1000
+              << " p99 = " << percentile(latencies, 99) / 1000
+              << " max = " << (latencies.empty() ? 0 : latencies.back() / 1000)
+              << std::endl;
+}
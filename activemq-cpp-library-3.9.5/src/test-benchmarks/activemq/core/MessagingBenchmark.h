@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_MESSAGINGBENCHMARK_H_
+#define _ACTIVEMQ_CORE_MESSAGINGBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/mock/EchoBrokerService.h>
+
+#include <memory>
+#include <string>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * Times the whole messaging path, produce, marshal, socket, unmarshal, dispatch and
+     * acknowledge, against an EchoBrokerService on a loopback port.  Each case reports
+     * the message rate and the send to receive latency percentiles for a range of
+     * message sizes.
+     */
+    class MessagingBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( MessagingBenchmark );
+        CPPUNIT_TEST( testSyncPersistent );
+        CPPUNIT_TEST( testSyncNonPersistent );
+        CPPUNIT_TEST( testAsyncPersistent );
+        CPPUNIT_TEST( testAsyncNonPersistent );
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+
+        std::auto_ptr<activemq::mock::EchoBrokerService> broker;
+
+    private:
+
+        MessagingBenchmark(const MessagingBenchmark&);
+        MessagingBenchmark& operator= (const MessagingBenchmark&);
+
+    public:
+
+        MessagingBenchmark();
+        virtual ~MessagingBenchmark();
+
+        void setUp();
+        void tearDown();
+
+        void testSyncPersistent();
+        void testSyncNonPersistent();
+        void testAsyncPersistent();
+        void testAsyncNonPersistent();
+
+    private:
+
+        void runAllSizes(bool sync, bool persistent);
+
+        void runBenchmark(bool sync, bool persistent, int messageSize, int messageCount);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_MESSAGINGBENCHMARK_H_ */
@@ -0,0 +1,369 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EchoBrokerService.h"
+
+#include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/OpenWireResponseBuilder.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <activemq/commands/Command.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/RemoveInfo.h>
+#include <activemq/commands/WireFormatInfo.h>
+#include <activemq/transport/mock/MockTransport.h>
+
+#include <decaf/net/ServerSocket.h>
+#include <decaf/net/Socket.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/LinkedList.h>
+#include <decaf/util/Properties.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/io/BufferedInputStream.h>
+#include <decaf/io/BufferedOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+
+#include <map>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::mock;
+using namespace activemq::commands;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::transport::mock;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::io;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace mock {
+
+    class EchoConnection : public lang::Thread {
+    private:
+
+        EchoConnection(const EchoConnection&);
+        EchoConnection& operator= (const EchoConnection&);
+
+    private:
+
+        Pointer<Socket> socket;
+        Pointer<OpenWireFormat> wireFormat;
+        Pointer<OpenWireResponseBuilder> responseBuilder;
+        std::map<std::string, Pointer<ConsumerId> > consumers;
+        Mutex* counterMutex;
+        long long* echoCount;
+
+    public:
+
+        EchoConnection(Pointer<Socket> socket, Mutex* counterMutex, long long* echoCount) :
+            Thread(), socket(socket), wireFormat(), responseBuilder(), consumers(),
+            counterMutex(counterMutex), echoCount(echoCount) {
+
+            // Each connection negotiates its own settings.
+            Properties properties;
+            this->wireFormat = OpenWireFormatFactory().createWireFormat(properties).dynamicCast<OpenWireFormat>();
+            this->responseBuilder.reset(new OpenWireResponseBuilder());
+        }
+
+        virtual ~EchoConnection() {}
+
+        void close() {
+            try {
+                socket->close();
+            } catch (...) {}
+        }
+
+        virtual void run() {
+            try {
+
+                // The wire format wants a Transport to marshal for, it is never used.
+                MockTransport mock(this->wireFormat, this->responseBuilder);
+
+                BufferedOutputStream bufferedOut(socket->getOutputStream());
+                DataOutputStream dataOut(&bufferedOut);
+
+                BufferedInputStream bufferedIn(socket->getInputStream());
+                DataInputStream dataIn(&bufferedIn);
+
+                wireFormat->marshal(wireFormat->getPreferedWireFormatInfo(), &mock, &dataOut);
+                dataOut.flush();
+
+                while (true) {
+
+                    Pointer<Command> command = wireFormat->unmarshal(&mock, &dataIn);
+
+                    if (command->isWireFormatInfo()) {
+                        // Ours was sent on connect, only the settings need to be agreed.
+                        wireFormat->renegotiateWireFormat(*command.dynamicCast<WireFormatInfo>());
+                        continue;
+                    }
+
+                    if (command->isShutdownInfo()) {
+                        break;
+                    }
+
+                    LinkedList< Pointer<Command> > replies;
+                    responseBuilder->buildIncomingCommands(command, replies);
+
+                    if (command->isConsumerInfo()) {
+                        Pointer<ConsumerInfo> info = command.dynamicCast<ConsumerInfo>();
+                        if (info->getDestination() != NULL && !info->isBrowser()) {
+                            consumers[keyOf(info->getDestination().get())] = info->getConsumerId();
+                        }
+                    } else if (command->isRemoveInfo()) {
+                        removeConsumer(command.dynamicCast<RemoveInfo>()->getObjectId());
+                    } else if (command->isMessage()) {
+                        echo(command.dynamicCast<Message>(), replies);
+                    }
+
+                    while (!replies.isEmpty()) {
+                        wireFormat->marshal(replies.pop(), &mock, &dataOut);
+                    }
+
+                    dataOut.flush();
+                }
+
+            } catch (...) {
+            }
+
+            close();
+        }
+
+    private:
+
+        void echo(const Pointer<Message> message, LinkedList< Pointer<Command> >& replies) {
+
+            if (message->getDestination() == NULL) {
+                return;
+            }
+
+            std::map<std::string, Pointer<ConsumerId> >::const_iterator iter =
+                consumers.find(keyOf(message->getDestination().get()));
+
+            if (iter == consumers.end()) {
+                return;
+            }
+
+            Pointer<MessageDispatch> dispatch(new MessageDispatch());
+            dispatch->setConsumerId(iter->second);
+            dispatch->setDestination(message->getDestination());
+            dispatch->setMessage(message);
+            dispatch->setRedeliveryCounter(0);
+            replies.push(dispatch);
+
+            synchronized(counterMutex) {
+                (*echoCount)++;
+            }
+        }
+
+        void removeConsumer(const Pointer<DataStructure> id) {
+
+            if (id == NULL || id->getDataStructureType() != ConsumerId::ID_CONSUMERID) {
+                return;
+            }
+
+            std::string value = id.dynamicCast<ConsumerId>()->toString();
+
+            std::map<std::string, Pointer<ConsumerId> >::iterator iter = consumers.begin();
+            for (; iter != consumers.end(); ++iter) {
+                if (iter->second->toString() == value) {
+                    consumers.erase(iter);
+                    return;
+                }
+            }
+        }
+
+        static std::string keyOf(const ActiveMQDestination* destination) {
+            return Integer::toString((int) destination->getDestinationType()) + ":" + destination->getPhysicalName();
+        }
+    };
+
+    class EchoServer : public lang::Thread {
+    private:
+
+        EchoServer(const EchoServer&);
+        EchoServer& operator= (const EchoServer&);
+
+    private:
+
+        volatile bool done;
+        Pointer<ServerSocket> server;
+        Mutex mutex;
+        std::vector< Pointer<EchoConnection> > connections;
+
+    public:
+
+        Mutex counterMutex;
+        long long echoCount;
+
+    public:
+
+        EchoServer() : Thread(), done(false), server(), mutex(), connections(), counterMutex(), echoCount(0) {}
+
+        virtual ~EchoServer() {
+            stop();
+        }
+
+        void bind() {
+            if (this->server == NULL) {
+                this->server.reset(new ServerSocket(0));
+            }
+        }
+
+        int getLocalPort() {
+            if (this->server != NULL) {
+                return this->server->getLocalPort();
+            }
+
+            return 0;
+        }
+
+        void stop() {
+
+            if (done) {
+                return;
+            }
+
+            done = true;
+
+            try {
+                if (this->server != NULL) {
+                    this->server->close();
+                }
+            } catch (...) {}
+
+            if (this->isAlive()) {
+                this->join();
+            }
+
+            std::vector< Pointer<EchoConnection> > current;
+            synchronized(&mutex) {
+                current.swap(this->connections);
+            }
+
+            std::vector< Pointer<EchoConnection> >::iterator iter = current.begin();
+            for (; iter != current.end(); ++iter) {
+                (*iter)->close();
+                (*iter)->join();
+            }
+        }
+
+        virtual void run() {
+
+            while (!done) {
+
+                Pointer<Socket> socket;
+                try {
+                    socket.reset(server->accept());
+                    socket->setTcpNoDelay(true);
+                } catch (...) {
+                    continue;
+                }
+
+                Pointer<EchoConnection> connection(new EchoConnection(socket, &counterMutex, &echoCount));
+
+                synchronized(&mutex) {
+                    if (done) {
+                        socket->close();
+                        break;
+                    }
+
+                    this->connections.push_back(connection);
+                }
+
+                connection->start();
+            }
+        }
+    };
+
+    class EchoBrokerServiceImpl {
+    private:
+
+        EchoBrokerServiceImpl(const EchoBrokerServiceImpl&);
+        EchoBrokerServiceImpl& operator= (const EchoBrokerServiceImpl&);
+
+    public:
+
+        Pointer<EchoServer> server;
+
+    public:
+
+        EchoBrokerServiceImpl() : server(new EchoServer()) {}
+
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+EchoBrokerService::EchoBrokerService() : impl(new EchoBrokerServiceImpl()) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+EchoBrokerService::~EchoBrokerService() {
+    try {
+        stop();
+    }
+    AMQ_CATCHALL_NOTHROW()
+
+    try {
+        delete impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EchoBrokerService::start() {
+    // Bound before the accept thread starts so the port is known once start returns.
+    this->impl->server->bind();
+    this->impl->server->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void EchoBrokerService::stop() {
+    this->impl->server->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int EchoBrokerService::getPort() const {
+    return this->impl->server->getLocalPort();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string EchoBrokerService::getConnectString() const {
+    return std::string("tcp://localhost:") + Integer::toString(getPort());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long EchoBrokerService::getEchoCount() const {
+
+    synchronized(&this->impl->server->counterMutex) {
+        return this->impl->server->echoCount;
+    }
+
+    return 0;
+}
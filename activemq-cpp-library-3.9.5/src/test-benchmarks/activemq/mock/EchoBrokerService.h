@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_MOCK_ECHOBROKERSERVICE_H_
+#define _ACTIVEMQ_MOCK_ECHOBROKERSERVICE_H_
+
+#include <activemq/util/Config.h>
+
+#include <string>
+
+namespace activemq {
+namespace mock {
+
+    class EchoBrokerServiceImpl;
+
+    /**
+     * A stand in for a broker that listens on a loopback TCP port and speaks just
+     * enough OpenWire for a client to connect, send and consume.  Each connection is
+     * served by its own thread, the OpenWireResponseBuilder answers the commands that
+     * need a Response and every Message that is sent is echoed back as a dispatch to a
+     * consumer of the same destination on the same connection.  Nothing is stored, a
+     * Message that no consumer is waiting for is dropped.
+     *
+     * Used by the benchmarks to time the full messaging path, marshal, socket,
+     * unmarshal and dispatch, without an external broker.
+     */
+    class EchoBrokerService {
+    private:
+
+        EchoBrokerService(const EchoBrokerService&);
+        EchoBrokerService& operator= (const EchoBrokerService&);
+
+    private:
+
+        EchoBrokerServiceImpl* impl;
+
+    public:
+
+        EchoBrokerService();
+
+        virtual ~EchoBrokerService();
+
+    public:
+
+        void start();
+
+        void stop();
+
+        std::string getConnectString() const;
+
+        int getPort() const;
+
+        /**
+         * @return the number of Messages that have been echoed back so far.
+         */
+        long long getEchoCount() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_MOCK_ECHOBROKERSERVICE_H_ */
@@ -17,15 +17,19 @@
 
 #include "PrimitiveMapBenchmark.h"
 
+#include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
+
 #include <string>
+#include <vector>
 #include <decaf/lang/Thread.h>
 
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
+using namespace activemq::wireformat::openwire::marshal;
 
 ////////////////////////////////////////////////////////////////////////////////
-PrimitiveMapBenchmark::PrimitiveMapBenchmark() : map(), testString(), byteBuffer() {}
+PrimitiveMapBenchmark::PrimitiveMapBenchmark() : map(), properties(), testString(), byteBuffer() {}
 
 ////////////////////////////////////////////////////////////////////////////////
 PrimitiveMapBenchmark::~PrimitiveMapBenchmark() {}
@@ -36,6 +40,15 @@ void PrimitiveMapBenchmark::setUp(){
         testString += "a";
         byteBuffer.push_back( 'a' );
     }
+
+    // The kind of properties a typical application message carries.
+    properties.setString( "JMSXGroupID", "orders" );
+    properties.setInt( "JMSXGroupSeq", 42 );
+    properties.setInt( "JMSXDeliveryCount", 1 );
+    properties.setString( "region", "emea" );
+    properties.setLong( "createdAt", 1234567890123LL );
+    properties.setBool( "priorityCustomer", true );
+    properties.setString( "correlationKey", "c0ffee-0000-1111" );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -120,4 +133,18 @@ void PrimitiveMapBenchmark::run() {
         PrimitiveMap theCopy;
         theCopy.copy( map );
     }
+
+    std::vector<unsigned char> marshaled;
+
+    for( int i = 0; i < numRuns * 10; ++i ){
+        marshaled.clear();
+        PrimitiveTypesMarshaller::marshal( &properties, marshaled );
+        PrimitiveMap theCopy;
+        PrimitiveTypesMarshaller::unmarshal( &theCopy, marshaled );
+    }
+
+    PrimitiveMap result;
+    PrimitiveTypesMarshaller::unmarshal( &result, marshaled );
+    CPPUNIT_ASSERT(result.size() == properties.size());
+    CPPUNIT_ASSERT(result.getString( "JMSXGroupID" ) == "orders");
 }
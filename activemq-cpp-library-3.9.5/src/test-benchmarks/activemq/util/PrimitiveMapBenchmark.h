@@ -32,6 +32,7 @@ namespace util{
     private:
 
         PrimitiveMap map;
+        PrimitiveMap properties;
         std::string testString;
         std::vector<unsigned char> byteBuffer;
 
@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BooleanStreamBenchmark.h"
+
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataInputStream.h>
+
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // About what a large message with a broker path writes: two bits for each
+    // long field and runs of flags between the other fields.
+    const int LONGS_PER_FRAME = 24;
+    const int FLAG_RUNS_PER_FRAME = 8;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BooleanStreamBenchmark::BooleanStreamBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BooleanStreamBenchmark::run() {
+
+    int numRuns = 5000;
+
+    std::vector<unsigned char> frame;
+
+    for( int i = 0; i < numRuns; ++i ) {
+
+        BooleanStream bs;
+
+        for( int j = 0; j < LONGS_PER_FRAME; ++j ) {
+            bs.writeBits( (unsigned int)( i + j ) & 0x03, 2 );
+        }
+        for( int j = 0; j < FLAG_RUNS_PER_FRAME; ++j ) {
+            bs.writeBits( (unsigned int)( i ^ j ), 5 );
+        }
+
+        frame.clear();
+        bs.marshal( frame );
+    }
+
+    for( int i = 0; i < numRuns; ++i ) {
+
+        decaf::io::ByteArrayInputStream bytesIn( frame );
+        decaf::io::DataInputStream dataIn( &bytesIn );
+
+        BooleanStream bs;
+        bs.unmarshal( &dataIn );
+
+        unsigned int result = 0;
+        for( int j = 0; j < LONGS_PER_FRAME; ++j ) {
+            result += bs.readBits( 2 );
+        }
+        for( int j = 0; j < FLAG_RUNS_PER_FRAME; ++j ) {
+            result += bs.readBits( 5 );
+        }
+        CPPUNIT_ASSERT( result > 0 );
+    }
+
+    // The same frame a boolean at a time, for comparison.
+    for( int i = 0; i < numRuns; ++i ) {
+
+        BooleanStream bs;
+
+        for( int j = 0; j < LONGS_PER_FRAME * 2 + FLAG_RUNS_PER_FRAME * 5; ++j ) {
+            bs.writeBoolean( ( ( i + j ) & 0x01 ) != 0 );
+        }
+
+        frame.clear();
+        bs.marshal( frame );
+    }
+
+    for( int i = 0; i < numRuns; ++i ) {
+
+        decaf::io::ByteArrayInputStream bytesIn( frame );
+        decaf::io::DataInputStream dataIn( &bytesIn );
+
+        BooleanStream bs;
+        bs.unmarshal( &dataIn );
+
+        int result = 0;
+        for( int j = 0; j < LONGS_PER_FRAME * 2 + FLAG_RUNS_PER_FRAME * 5; ++j ) {
+            result += bs.readBoolean() ? 1 : 0;
+        }
+        CPPUNIT_ASSERT( result > 0 );
+    }
+}
@@ -17,6 +17,10 @@
 
 #include <activemq/util/PrimitiveMapBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::PrimitiveMapBenchmark );
+#include <activemq/core/MessagingBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::MessagingBenchmark );
+#include <activemq/wireformat/openwire/utils/BooleanStreamBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::BooleanStreamBenchmark );
 
 #include <decaf/lang/BooleanBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::lang::BooleanBenchmark );
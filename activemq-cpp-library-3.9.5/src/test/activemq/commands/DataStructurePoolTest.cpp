@@ -0,0 +1,279 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataStructurePoolTest.h"
+
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/DataStructurePool.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/Properties.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::wireformat::openwire;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<MessageDispatch> createDispatch(int sequence) {
+
+        Pointer<ProducerId> producerId(new ProducerId("ID:test-connection-1:1:1"));
+
+        Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+        message->setMessageId(Pointer<MessageId>(new MessageId(producerId, sequence)));
+        message->setProducerId(producerId);
+        message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+        message->setText("message body");
+
+        Pointer<MessageDispatch> dispatch(new MessageDispatch());
+        dispatch->setConsumerId(Pointer<ConsumerId>(new ConsumerId(SessionId(producerId.get()), 1)));
+        dispatch->setDestination(message->getDestination());
+        dispatch->setMessage(message);
+        dispatch->setRedeliveryCounter(0);
+        return dispatch;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testAllocateAndRelease() {
+
+    void* block = DataStructurePool::allocate(100);
+    CPPUNIT_ASSERT(block != NULL);
+    std::memset(block, 0xAB, 100);
+    DataStructurePool::release(block, 100);
+
+    long long pooled = DataStructurePool::getPooledCount();
+    long long allocations = DataStructurePool::getAllocationCount();
+    long long heapAllocations = DataStructurePool::getHeapAllocationCount();
+
+    // A block of the same size class is reused rather than allocated.
+    void* reused = DataStructurePool::allocate(110);
+    CPPUNIT_ASSERT(reused == block);
+    CPPUNIT_ASSERT_EQUAL(allocations + 1, DataStructurePool::getAllocationCount());
+    CPPUNIT_ASSERT_EQUAL(heapAllocations, DataStructurePool::getHeapAllocationCount());
+    CPPUNIT_ASSERT_EQUAL(pooled - 1, DataStructurePool::getPooledCount());
+
+    std::memset(reused, 0xCD, 110);
+    DataStructurePool::release(reused, 110);
+    CPPUNIT_ASSERT_EQUAL(pooled, DataStructurePool::getPooledCount());
+
+    DataStructurePool::release(NULL, 100);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testLargeBlocks() {
+
+    std::size_t size = DataStructurePool::MAX_BLOCK_SIZE + 1;
+
+    long long pooled = DataStructurePool::getPooledCount();
+    long long heapAllocations = DataStructurePool::getHeapAllocationCount();
+
+    void* block = DataStructurePool::allocate(size);
+    CPPUNIT_ASSERT(block != NULL);
+    std::memset(block, 0, size);
+    CPPUNIT_ASSERT_EQUAL(heapAllocations + 1, DataStructurePool::getHeapAllocationCount());
+
+    DataStructurePool::release(block, size);
+    CPPUNIT_ASSERT_EQUAL(pooled, DataStructurePool::getPooledCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testThreadCache() {
+
+    // A size no command uses so that only this test's blocks are in its lists.
+    const std::size_t SIZE = DataStructurePool::MAX_BLOCK_SIZE - 4;
+    const int COUNT = 32;
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < COUNT; ++i) {
+        blocks.push_back(DataStructurePool::allocate(SIZE));
+    }
+    for (int i = 0; i < COUNT; ++i) {
+        DataStructurePool::release(blocks[i], SIZE);
+    }
+    blocks.clear();
+
+    long long pooled = DataStructurePool::getPooledCount();
+    long long allocations = DataStructurePool::getAllocationCount();
+    long long heapAllocations = DataStructurePool::getHeapAllocationCount();
+
+    // Served from this thread's list and the batches it takes from the shared ones.
+    for (int i = 0; i < COUNT; ++i) {
+        blocks.push_back(DataStructurePool::allocate(SIZE));
+        std::memset(blocks.back(), 0, SIZE);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(heapAllocations, DataStructurePool::getHeapAllocationCount());
+    CPPUNIT_ASSERT_EQUAL(pooled - COUNT, DataStructurePool::getPooledCount());
+
+    // Each block is counted once as it is handed out, not as a batch is moved.
+    CPPUNIT_ASSERT_EQUAL(allocations + COUNT, DataStructurePool::getAllocationCount());
+
+    for (int i = 0; i < COUNT; ++i) {
+        DataStructurePool::release(blocks[i], SIZE);
+    }
+    blocks.clear();
+
+    CPPUNIT_ASSERT_EQUAL(pooled, DataStructurePool::getPooledCount());
+
+    // The block this thread released last is the next one it gets.
+    void* block = DataStructurePool::allocate(SIZE);
+    DataStructurePool::release(block, SIZE);
+    CPPUNIT_ASSERT(DataStructurePool::allocate(SIZE) == block);
+    DataStructurePool::release(block, SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class ReleasingThread : public Thread {
+    private:
+
+        std::vector<void*>& blocks;
+        std::size_t size;
+
+    private:
+
+        ReleasingThread(const ReleasingThread&);
+        ReleasingThread& operator=(const ReleasingThread&);
+
+    public:
+
+        ReleasingThread(std::vector<void*>& blocks, std::size_t size) : Thread(), blocks(blocks), size(size) {}
+
+        virtual ~ReleasingThread() {}
+
+        virtual void run() {
+            for (std::size_t i = 0; i < blocks.size(); ++i) {
+                DataStructurePool::release(blocks[i], size);
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testReleaseOnAnotherThread() {
+
+    const std::size_t SIZE = DataStructurePool::MAX_BLOCK_SIZE - 20;
+    const int COUNT = 64;
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < COUNT; ++i) {
+        blocks.push_back(DataStructurePool::allocate(SIZE));
+    }
+
+    // A thread that only releases hands its blocks back a batch at a time.
+    ReleasingThread releaser(blocks, SIZE);
+    releaser.start();
+    releaser.join();
+    blocks.clear();
+
+    long long heapAllocations = DataStructurePool::getHeapAllocationCount();
+
+    for (int i = 0; i < COUNT; ++i) {
+        blocks.push_back(DataStructurePool::allocate(SIZE));
+    }
+
+    // Only the few blocks the releasing thread still held when it ended are lost.
+    CPPUNIT_ASSERT(DataStructurePool::getHeapAllocationCount() - heapAllocations < COUNT / 4);
+
+    for (int i = 0; i < COUNT; ++i) {
+        DataStructurePool::release(blocks[i], SIZE);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testCommandsAreRecycled() {
+
+    // Warm up the pool with one of each.
+    {
+        Pointer<MessageDispatch> dispatch = createDispatch(0);
+        Pointer<MessageAck> ack(new MessageAck(dispatch, core::ActiveMQConstants::ACK_TYPE_CONSUMED, 1));
+    }
+
+    long long heapAllocations = DataStructurePool::getHeapAllocationCount();
+    long long allocations = DataStructurePool::getAllocationCount();
+
+    const int ITERATIONS = 1000;
+    for (int i = 1; i <= ITERATIONS; ++i) {
+        Pointer<MessageDispatch> dispatch = createDispatch(i);
+        Pointer<MessageAck> ack(new MessageAck(dispatch, core::ActiveMQConstants::ACK_TYPE_CONSUMED, 1));
+        CPPUNIT_ASSERT_EQUAL((long long) i, ack->getLastMessageId()->getProducerSequenceId());
+    }
+
+    CPPUNIT_ASSERT(DataStructurePool::getAllocationCount() - allocations >= ITERATIONS * 7);
+    CPPUNIT_ASSERT_MESSAGE("Steady state commands should come from the pool",
+                           DataStructurePool::getHeapAllocationCount() - heapAllocations < ITERATIONS / 10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testUnmarshalSteadyState() {
+
+    Properties properties;
+    OpenWireFormat format(properties);
+    IOTransport transport;
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+    format.marshal(createDispatch(1), &transport, &dataOut);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    std::vector<unsigned char> frame(array.first, array.first + array.second);
+    delete [] array.first;
+
+    // The first unmarshal fills the pool with everything a dispatch needs.
+    {
+        ByteArrayInputStream bytesIn(frame);
+        DataInputStream dataIn(&bytesIn);
+        CPPUNIT_ASSERT(format.unmarshal(&transport, &dataIn)->isMessageDispatch());
+    }
+
+    long long heapAllocations = DataStructurePool::getHeapAllocationCount();
+
+    const int ITERATIONS = 1000;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        ByteArrayInputStream bytesIn(frame);
+        DataInputStream dataIn(&bytesIn);
+        Pointer<Command> command = format.unmarshal(&transport, &dataIn);
+        CPPUNIT_ASSERT(command->isMessageDispatch());
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Steady state unmarshaling should be served from the pool",
+                           DataStructurePool::getHeapAllocationCount() - heapAllocations < ITERATIONS / 10);
+}
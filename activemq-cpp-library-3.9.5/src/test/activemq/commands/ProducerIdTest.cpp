@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProducerIdTest.h"
+
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/SessionId.h>
+#include <decaf/lang/Pointer.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+void ProducerIdTest::testToString() {
+
+    ProducerId producerId("ID:host-1234-1:7:3");
+
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1"), producerId.getConnectionId());
+    CPPUNIT_ASSERT_EQUAL(7LL, producerId.getSessionId());
+    CPPUNIT_ASSERT_EQUAL(3LL, producerId.getValue());
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1:7:3"), producerId.toString());
+
+    SessionId sessionId(&producerId);
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1:7"), sessionId.toString());
+
+    ConsumerId consumerId(sessionId, -2);
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1:7:-2"), consumerId.toString());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ProducerIdTest::testEquals() {
+
+    ProducerId producerId("ID:host-1234-1:7:3");
+    ProducerId other("ID:host-1234-1:7:3");
+
+    CPPUNIT_ASSERT(producerId.equals(other));
+
+    // Hashing one side first must not change the outcome.
+    producerId.getHashCode();
+    CPPUNIT_ASSERT(producerId.equals(other));
+    other.getHashCode();
+    CPPUNIT_ASSERT(producerId.equals(other));
+
+    other.setConnectionId("ID:host-1234-2");
+    CPPUNIT_ASSERT(!producerId.equals(other));
+    other.getHashCode();
+    CPPUNIT_ASSERT(!producerId.equals(other));
+
+    // A change made through the mutable accessor drops the cached hash too.
+    other.getConnectionId() = "ID:host-1234-1";
+    CPPUNIT_ASSERT(producerId.equals(other));
+    CPPUNIT_ASSERT_EQUAL(producerId.getHashCode(), other.getHashCode());
+
+    ConsumerId consumerId(SessionId(&producerId), 5);
+    ConsumerId otherConsumer(SessionId(&producerId), 5);
+    otherConsumer.setConnectionId("ID:host-1234-2");
+    otherConsumer.getHashCode();
+    otherConsumer.getConnectionId() = "ID:host-1234-1";
+    CPPUNIT_ASSERT_EQUAL(consumerId.getHashCode(), otherConsumer.getHashCode());
+
+    SessionId sessionId(&producerId);
+    SessionId otherSession(&producerId);
+    otherSession.setConnectionId("ID:host-1234-2");
+    otherSession.getHashCode();
+    otherSession.getConnectionId() = "ID:host-1234-1";
+    CPPUNIT_ASSERT_EQUAL(sessionId.getHashCode(), otherSession.getHashCode());
+
+    other.setValue(4);
+    CPPUNIT_ASSERT(!producerId.equals(other));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ProducerIdTest::testCompareTo() {
+
+    ProducerId producerId("ID:host-1234-1:7:3");
+    ProducerId sameConnection("ID:host-1234-1:7:4");
+    ProducerId otherCase("id:HOST-1234-1:7:3");
+    ProducerId otherConnection("ID:host-1234-2:1:1");
+
+    CPPUNIT_ASSERT_EQUAL(0, producerId.compareTo(producerId));
+    CPPUNIT_ASSERT_EQUAL(-1, producerId.compareTo(sameConnection));
+    CPPUNIT_ASSERT_EQUAL(1, sameConnection.compareTo(producerId));
+    CPPUNIT_ASSERT_EQUAL(0, producerId.compareTo(otherCase));
+    CPPUNIT_ASSERT(producerId < otherConnection);
+    CPPUNIT_ASSERT(!(otherConnection < producerId));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ProducerIdTest::testHashCode() {
+
+    ProducerId producerId("ID:host-1234-1:7:3");
+    ProducerId other(producerId);
+
+    CPPUNIT_ASSERT(producerId.getHashCode() != 0);
+    CPPUNIT_ASSERT_EQUAL(producerId.getHashCode(), other.getHashCode());
+
+    int hash = other.getHashCode();
+    other.setValue(4);
+    CPPUNIT_ASSERT(hash != other.getHashCode());
+    other.setValue(3);
+    CPPUNIT_ASSERT_EQUAL(hash, other.getHashCode());
+
+    other.setSessionId(8);
+    CPPUNIT_ASSERT(hash != other.getHashCode());
+
+    ConsumerId consumerId(SessionId(&producerId), 3);
+    ConsumerId otherConsumer(consumerId);
+    CPPUNIT_ASSERT_EQUAL(consumerId.getHashCode(), otherConsumer.getHashCode());
+    otherConsumer.setConnectionId("ID:host-1234-2");
+    CPPUNIT_ASSERT(consumerId.getHashCode() != otherConsumer.getHashCode());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ProducerIdTest::testMessageIdHashCode() {
+
+    Pointer<ProducerId> producerId(new ProducerId("ID:host-1234-1:7:3"));
+    MessageId messageId(producerId, 10);
+    MessageId other(producerId, 10);
+
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1:7:3:10"), messageId.toString());
+    CPPUNIT_ASSERT_EQUAL(messageId.getHashCode(), other.getHashCode());
+    CPPUNIT_ASSERT(messageId.equals(other));
+
+    // Changing the sequence drops the cached key and hash.
+    int hash = other.getHashCode();
+    other.setProducerSequenceId(11);
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1:7:3:11"), other.toString());
+    CPPUNIT_ASSERT(hash != other.getHashCode());
+    CPPUNIT_ASSERT(!messageId.equals(other));
+
+    // As does writing the text view through its mutable accessor.
+    MessageId textId;
+    textId.setTextView("ID:host-1234-1:7:3:12");
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1:7:3:12"), textId.toString());
+    textId.getTextView() = "ID:host-1234-1:7:3:13";
+    CPPUNIT_ASSERT_EQUAL(string("ID:host-1234-1:7:3:13"), textId.toString());
+}
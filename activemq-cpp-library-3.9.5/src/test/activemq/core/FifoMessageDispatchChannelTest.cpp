@@ -230,3 +230,35 @@ void FifoMessageDispatchChannelTest::testRemoveAll() {
     CPPUNIT_ASSERT( channel.size() == 0 );
     CPPUNIT_ASSERT( channel.isEmpty() == true );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void FifoMessageDispatchChannelTest::testDequeueWithSpin() {
+
+    FifoMessageDispatchChannel channel;
+    channel.setSpinTime( 1000 );
+    CPPUNIT_ASSERT( channel.getSpinTime() == 1000 );
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+
+    channel.start();
+
+    channel.enqueue( dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeue( -1 ) == dispatch1 );
+    CPPUNIT_ASSERT( channel.getSpinCount() == 1 );
+    CPPUNIT_ASSERT( channel.getParkCount() == 0 );
+
+    // Spinning must not extend the caller's timeout.
+    long long timeStarted = System::currentTimeMillis();
+    CPPUNIT_ASSERT( channel.dequeue( 100 ) == NULL );
+    CPPUNIT_ASSERT( System::currentTimeMillis() - timeStarted < 1000 );
+    CPPUNIT_ASSERT( channel.getParkCount() == 1 );
+
+    // A no wait dequeue never spins.
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == NULL );
+    CPPUNIT_ASSERT( channel.getParkCount() == 1 );
+
+    channel.enqueue( dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeue( 1000 ) == dispatch2 );
+    CPPUNIT_ASSERT( channel.getSpinCount() == 2 );
+}
@@ -37,6 +37,7 @@ namespace core {
         CPPUNIT_TEST( testDequeueNoWait );
         CPPUNIT_TEST( testDequeue );
         CPPUNIT_TEST( testRemoveAll );
+        CPPUNIT_TEST( testDequeueWithSpin );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -54,6 +55,7 @@ namespace core {
         void testDequeueNoWait();
         void testDequeue();
         void testRemoveAll();
+        void testDequeueWithSpin();
 
     };
 
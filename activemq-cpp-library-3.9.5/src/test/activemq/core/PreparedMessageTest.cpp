@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PreparedMessageTest.h"
+
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/core/ActiveMQProducer.h>
+#include <activemq/core/PreparedMessage.h>
+#include <decaf/lang/Pointer.h>
+
+#include <cms/BytesMessage.h>
+#include <cms/Connection.h>
+#include <cms/DeliveryMode.h>
+#include <cms/IllegalStateException.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageFormatException.h>
+#include <cms/MessageProducer.h>
+#include <cms/Session.h>
+#include <cms/TextMessage.h>
+
+#include <memory>
+#include <set>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageTest::testSendPrepared() {
+
+    ActiveMQConnectionFactory factory("vm://prepared");
+
+    std::auto_ptr<cms::Connection> connection(factory.createConnection());
+    connection->start();
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TEST.PREPARED"));
+    std::auto_ptr<cms::Queue> replyTo(session->createQueue("TEST.PREPARED.REPLIES"));
+    std::auto_ptr<cms::MessageConsumer> consumer(session->createConsumer(queue.get()));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(queue.get()));
+
+    ActiveMQProducer* amqProducer = dynamic_cast<ActiveMQProducer*>(producer.get());
+    CPPUNIT_ASSERT(amqProducer != NULL);
+
+    std::auto_ptr<cms::TextMessage> prototype(session->createTextMessage("not sent"));
+    prototype->setCMSType("prepared");
+    prototype->setCMSCorrelationID("correlation");
+    prototype->setCMSReplyTo(replyTo.get());
+    prototype->setStringProperty("prototypeOnly", "value");
+
+    Pointer<PreparedMessage> prepared =
+        amqProducer->prepare(prototype.get(), cms::DeliveryMode::NON_PERSISTENT, 8, 0);
+
+    std::set<std::string> messageIds;
+
+    for (int i = 0; i < 3; ++i) {
+
+        std::auto_ptr<cms::TextMessage> message(session->createTextMessage("body"));
+        message->setText(std::string("body ") + (char)('0' + i));
+        message->setIntProperty("index", i);
+        message->setCMSCorrelationID("ignored");
+        amqProducer->send(prepared, message.get());
+
+        std::auto_ptr<cms::Message> received(consumer->receive(2000));
+        CPPUNIT_ASSERT(received.get() != NULL);
+
+        cms::TextMessage* text = dynamic_cast<cms::TextMessage*>(received.get());
+        CPPUNIT_ASSERT(text != NULL);
+
+        // The body and properties come from each send.
+        CPPUNIT_ASSERT_EQUAL(std::string("body ") + (char)('0' + i), text->getText());
+        CPPUNIT_ASSERT_EQUAL(i, text->getIntProperty("index"));
+        CPPUNIT_ASSERT(!text->propertyExists("prototypeOnly"));
+
+        // The headers come from the prepared message.
+        CPPUNIT_ASSERT_EQUAL(std::string("prepared"), text->getCMSType());
+        CPPUNIT_ASSERT_EQUAL(std::string("correlation"), text->getCMSCorrelationID());
+        CPPUNIT_ASSERT(text->getCMSReplyTo() != NULL);
+        CPPUNIT_ASSERT(text->getCMSReplyTo()->equals(*replyTo));
+        CPPUNIT_ASSERT_EQUAL(8, text->getCMSPriority());
+        CPPUNIT_ASSERT_EQUAL((int) cms::DeliveryMode::NON_PERSISTENT, text->getCMSDeliveryMode());
+
+        CPPUNIT_ASSERT(messageIds.insert(text->getCMSMessageID()).second);
+    }
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageTest::testPrepareForDestination() {
+
+    ActiveMQConnectionFactory factory("vm://prepared");
+
+    std::auto_ptr<cms::Connection> connection(factory.createConnection());
+    connection->start();
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TEST.PREPARED.DESTINATION"));
+    std::auto_ptr<cms::MessageConsumer> consumer(session->createConsumer(queue.get()));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(NULL));
+
+    ActiveMQProducer* amqProducer = dynamic_cast<ActiveMQProducer*>(producer.get());
+    CPPUNIT_ASSERT(amqProducer != NULL);
+
+    std::auto_ptr<cms::TextMessage> prototype(session->createTextMessage());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        amqProducer->prepare(prototype.get()),
+        cms::UnsupportedOperationException);
+
+    Pointer<PreparedMessage> prepared = amqProducer->prepare(
+        queue.get(), prototype.get(), cms::DeliveryMode::PERSISTENT, 4, 0);
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("to the queue"));
+    amqProducer->send(prepared, message.get());
+
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+    CPPUNIT_ASSERT(received->getCMSDestination()->equals(*queue));
+    CPPUNIT_ASSERT_EQUAL((int) cms::DeliveryMode::PERSISTENT, received->getCMSDeliveryMode());
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageTest::testSendWithOtherProducer() {
+
+    ActiveMQConnectionFactory factory("vm://prepared");
+
+    std::auto_ptr<cms::Connection> connection(factory.createConnection());
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TEST.PREPARED.OTHER"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(queue.get()));
+    std::auto_ptr<cms::MessageProducer> other(session->createProducer(queue.get()));
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("text"));
+    Pointer<PreparedMessage> prepared = dynamic_cast<ActiveMQProducer*>(producer.get())->prepare(message.get());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        dynamic_cast<ActiveMQProducer*>(other.get())->send(prepared, message.get()),
+        cms::IllegalStateException);
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageTest::testSendOtherMessageType() {
+
+    ActiveMQConnectionFactory factory("vm://prepared");
+
+    std::auto_ptr<cms::Connection> connection(factory.createConnection());
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TEST.PREPARED.TYPE"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(queue.get()));
+
+    ActiveMQProducer* amqProducer = dynamic_cast<ActiveMQProducer*>(producer.get());
+
+    std::auto_ptr<cms::TextMessage> prototype(session->createTextMessage("text"));
+    Pointer<PreparedMessage> prepared = amqProducer->prepare(prototype.get());
+
+    std::auto_ptr<cms::BytesMessage> message(session->createBytesMessage());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageFormatException",
+        amqProducer->send(prepared, message.get()),
+        cms::MessageFormatException);
+
+    connection->close();
+}
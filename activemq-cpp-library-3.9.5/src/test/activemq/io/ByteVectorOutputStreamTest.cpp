@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ByteVectorOutputStreamTest.h"
+
+#include <activemq/io/ByteVectorOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::io;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteVectorOutputStreamTest::testWrite() {
+
+    std::vector<unsigned char> buffer;
+    ByteVectorOutputStream stream(buffer);
+
+    unsigned char data[] = { 1, 2, 3, 4, 5 };
+
+    stream.write(0x7F);
+    stream.write(data, 5);
+    stream.write(data, 5, 1, 3);
+
+    CPPUNIT_ASSERT_EQUAL(9LL, stream.size());
+    CPPUNIT_ASSERT_EQUAL(9, (int) buffer.size());
+    CPPUNIT_ASSERT(&buffer == &stream.getBuffer());
+
+    unsigned char expected[] = { 0x7F, 1, 2, 3, 4, 5, 2, 3, 4 };
+    CPPUNIT_ASSERT(std::vector<unsigned char>(expected, expected + 9) == buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteVectorOutputStreamTest::testAppendsToBuffer() {
+
+    std::vector<unsigned char> buffer(2, 0xFF);
+    ByteVectorOutputStream stream(buffer);
+    DataOutputStream dataOut(&stream);
+
+    dataOut.writeInt(0x01020304);
+
+    CPPUNIT_ASSERT_EQUAL(6, (int) buffer.size());
+    CPPUNIT_ASSERT_EQUAL(0xFF, (int) buffer[1]);
+    CPPUNIT_ASSERT_EQUAL(0x01, (int) buffer[2]);
+    CPPUNIT_ASSERT_EQUAL(0x04, (int) buffer[5]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteVectorOutputStreamTest::testWriteInvalidArguments() {
+
+    std::vector<unsigned char> buffer;
+    ByteVectorOutputStream stream(buffer);
+
+    unsigned char data[] = { 1, 2, 3 };
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        stream.write(NULL, 3, 0, 3),
+        NullPointerException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IndexOutOfBoundsException",
+        stream.write(data, 3, 2, 2),
+        IndexOutOfBoundsException);
+
+    CPPUNIT_ASSERT(buffer.empty());
+}
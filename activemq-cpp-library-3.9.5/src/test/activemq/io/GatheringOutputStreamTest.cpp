@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GatheringOutputStreamTest.h"
+
+#include <activemq/io/GatheringOutputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/net/Socket.h>
+#include <decaf/net/ServerSocket.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::io;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector<unsigned char> createData(int size, int seed) {
+        std::vector<unsigned char> data(size);
+        for (int i = 0; i < size; ++i) {
+            data[i] = (unsigned char) (i + seed);
+        }
+        return data;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStreamTest::testSmallWritesAreBuffered() {
+
+    ByteArrayOutputStream target;
+    GatheringOutputStream stream(&target, 16, 64);
+
+    std::vector<unsigned char> data = createData(10, 0);
+    stream.write(&data[0], (int) data.size());
+    stream.write('a');
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Small writes should stay in the buffer", 0, (int) target.size());
+
+    // Overflowing the buffer writes out the buffered bytes.
+    stream.write(&data[0], (int) data.size());
+    CPPUNIT_ASSERT_EQUAL(16, (int) target.size());
+
+    stream.flush();
+    CPPUNIT_ASSERT_EQUAL(21, (int) target.size());
+    CPPUNIT_ASSERT_EQUAL(0LL, stream.getGatheredWriteCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStreamTest::testLargeWritesBypassBuffer() {
+
+    ByteArrayOutputStream target;
+    GatheringOutputStream stream(&target, 16, 64);
+
+    std::vector<unsigned char> header = createData(8, 0);
+    std::vector<unsigned char> body = createData(1000, 7);
+
+    stream.write(&header[0], (int) header.size());
+    stream.write(&body[0], (int) body.size(), 0, (int) body.size());
+
+    CPPUNIT_ASSERT_EQUAL(1LL, stream.getGatheredWriteCount());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Header and body should be written without a flush", 1008, (int) target.size());
+
+    std::pair<unsigned char*, int> array = target.toByteArray();
+    std::vector<unsigned char> written(array.first, array.first + array.second);
+    delete [] array.first;
+
+    CPPUNIT_ASSERT(std::equal(header.begin(), header.end(), written.begin()));
+    CPPUNIT_ASSERT(std::equal(body.begin(), body.end(), written.begin() + 8));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStreamTest::testGatherDisabled() {
+
+    ByteArrayOutputStream target;
+    GatheringOutputStream stream(&target, 16, 0);
+
+    std::vector<unsigned char> body = createData(1000, 0);
+    stream.write(&body[0], (int) body.size());
+    stream.flush();
+
+    CPPUNIT_ASSERT_EQUAL(0LL, stream.getGatheredWriteCount());
+    CPPUNIT_ASSERT_EQUAL(1000, (int) target.size());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        GatheringOutputStream(&target, 0, 0),
+        decaf::lang::exceptions::IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GatheringOutputStreamTest::testGatheredSocketWrite() {
+
+    ServerSocket server(0);
+    Socket client("localhost", server.getLocalPort());
+    std::auto_ptr<Socket> worker(server.accept());
+
+    std::vector<unsigned char> header = createData(10, 0);
+    std::vector<unsigned char> body = createData(32 * 1024, 3);
+
+    {
+        GatheringOutputStream stream(client.getOutputStream(), 64, 128);
+
+        stream.write(&header[0], (int) header.size());
+        stream.write(&body[0], (int) body.size());
+        stream.write(&header[0], (int) header.size());
+        stream.flush();
+
+        CPPUNIT_ASSERT_EQUAL(1LL, stream.getGatheredWriteCount());
+
+        std::vector<unsigned char> received(header.size() * 2 + body.size());
+        std::size_t offset = 0;
+        while (offset < received.size()) {
+            int count = worker->getInputStream()->read(
+                &received[0], (int) received.size(), (int) offset, (int) (received.size() - offset));
+            CPPUNIT_ASSERT(count > 0);
+            offset += count;
+        }
+
+        CPPUNIT_ASSERT(std::equal(header.begin(), header.end(), received.begin()));
+        CPPUNIT_ASSERT(std::equal(body.begin(), body.end(), received.begin() + header.size()));
+        CPPUNIT_ASSERT(std::equal(header.begin(), header.end(), received.begin() + header.size() + body.size()));
+    }
+
+    worker->close();
+    client.close();
+    server.close();
+}
@@ -26,7 +26,10 @@
 #include <activemq/commands/Message.h>
 #include <activemq/commands/ConnectionInfo.h>
 #include <activemq/commands/SessionInfo.h>
+#include <activemq/commands/ConsumerControl.h>
+#include <activemq/commands/RemoveInfo.h>
 #include <activemq/commands/Message.h>
+#include <decaf/io/IOException.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <decaf/util/LinkedList.h>
@@ -53,6 +56,8 @@ namespace {
         LinkedList< Pointer<Command> > consumers;
         LinkedList< Pointer<Command> > messages;
         LinkedList< Pointer<Command> > messagePulls;
+        LinkedList< Pointer<Command> > controls;
+        LinkedList< Pointer<Command> > removes;
 
     public:
 
@@ -77,6 +82,10 @@ namespace {
                 messages.add(command);
             } else if (command->isMessagePull()) {
                 messagePulls.add(command);
+            } else if (command->isConsumerControl()) {
+                controls.add(command);
+            } else if (command->isRemoveInfo()) {
+                removes.add(command);
             }
         }
 
@@ -143,6 +152,42 @@ namespace {
 
     };
 
+    /**
+     * Tracks another consumer while the tracked state is being written to it, as a
+     * sender on another thread can once the tracker's locks are released.
+     */
+    class CatchUpTransport : public TrackingTransport {
+    public:
+
+        ConnectionStateTracker* tracker;
+        Pointer<ConsumerInfo> lateConsumer;
+        bool failing;
+
+    public:
+
+        CatchUpTransport(ConnectionStateTracker* tracker) : tracker(tracker), lateConsumer(), failing(false) {}
+
+        virtual ~CatchUpTransport() {}
+
+        virtual void oneway(const Pointer<Command> command) {
+
+            if (failing) {
+                throw decaf::io::IOException(__FILE__, __LINE__, "Standby write failed");
+            }
+
+            TrackingTransport::oneway(command);
+
+            if (lateConsumer != NULL) {
+                Pointer<ConsumerInfo> consumer = lateConsumer;
+                lateConsumer.reset(NULL);
+                tracker->track(consumer);
+
+                // Not installed until the late registration has been written too.
+                CPPUNIT_ASSERT(tracker->getStandby() == NULL);
+            }
+        }
+    };
+
     class ConnectionData {
     public:
 
@@ -190,6 +235,20 @@ namespace {
         return conn;
     }
 
+    Pointer<ConsumerInfo> createConsumer(long long value, int prefetch) {
+
+        Pointer<ConsumerId> consumerId(new ConsumerId);
+        consumerId->setConnectionId("CONNECTION");
+        consumerId->setSessionId(12345);
+        consumerId->setValue(value);
+
+        Pointer<ConsumerInfo> consumer(new ConsumerInfo);
+        consumer->setConsumerId(consumerId);
+        consumer->setPrefetchSize(prefetch);
+
+        return consumer;
+    }
+
     void clearConnectionState(ConnectionStateTracker& tracker, ConnectionData& conn) {
         tracker.processRemoveProducer(conn.producer->getProducerId().get());
         tracker.processRemoveConsumer(conn.consumer->getConsumerId().get());
@@ -266,3 +325,119 @@ void ConnectionStateTrackerTest::testMessagePullCache() {
 
     CPPUNIT_ASSERT_EQUAL_MESSAGE("Should only be three message pulls", 10, transport->messagePulls.size());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testStandby() {
+
+    Pointer<TrackingTransport> standby(new TrackingTransport);
+    ConnectionStateTracker tracker;
+
+    ConnectionData conn = createConnectionState(tracker);
+
+    Pointer<ConsumerInfo> prefetching = createConsumer(43, 1000);
+    tracker.track(prefetching);
+
+    tracker.setStandby(standby);
+    CPPUNIT_ASSERT(tracker.getStandby() == standby);
+
+    CPPUNIT_ASSERT_EQUAL(1, standby->connections.size());
+    CPPUNIT_ASSERT_EQUAL(1, standby->sessions.size());
+    CPPUNIT_ASSERT_EQUAL(1, standby->producers.size());
+    CPPUNIT_ASSERT_EQUAL(2, standby->consumers.size());
+
+    // Consumers are mirrored without prefetch and the original is left alone.
+    Pointer<ConsumerInfo> mirrored = standby->consumers.getLast().dynamicCast<ConsumerInfo>();
+    CPPUNIT_ASSERT_EQUAL(0, mirrored->getPrefetchSize());
+    CPPUNIT_ASSERT_EQUAL(1000, prefetching->getPrefetchSize());
+
+    // Registrations tracked from now on are mirrored as they happen.
+    Pointer<ConsumerInfo> consumer = createConsumer(44, 500);
+    consumer->setResponseRequired(true);
+    tracker.track(consumer);
+
+    CPPUNIT_ASSERT_EQUAL(3, standby->consumers.size());
+    CPPUNIT_ASSERT(!standby->consumers.getLast()->isResponseRequired());
+    CPPUNIT_ASSERT(consumer->isResponseRequired());
+
+    tracker.track(conn.producer->createRemoveCommand());
+    CPPUNIT_ASSERT_EQUAL(1, standby->removes.size());
+
+    // Promotion raises the prefetch of the two prefetching consumers once
+    // interruption processing is done.
+    tracker.transportInterrupted();
+    tracker.promoteStandby(standby);
+
+    CPPUNIT_ASSERT(tracker.getStandby() == NULL);
+    CPPUNIT_ASSERT_EQUAL(3, standby->consumers.size());
+    CPPUNIT_ASSERT_EQUAL(0, standby->controls.size());
+
+    tracker.connectionInterruptProcessingComplete(standby.get(), conn.connection->getConnectionId());
+    CPPUNIT_ASSERT_EQUAL(2, standby->controls.size());
+
+    // Nothing more is mirrored after promotion.
+    tracker.track(consumer->createRemoveCommand());
+    CPPUNIT_ASSERT_EQUAL(1, standby->removes.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testStandbySkipsDurableAndExclusive() {
+
+    Pointer<TrackingTransport> standby(new TrackingTransport);
+    ConnectionStateTracker tracker;
+
+    ConnectionData conn = createConnectionState(tracker);
+
+    Pointer<ConsumerInfo> durable = createConsumer(43, 1000);
+    durable->setSubscriptionName("durable");
+    tracker.track(durable);
+
+    tracker.setStandby(standby);
+    CPPUNIT_ASSERT_EQUAL(1, standby->consumers.size());
+
+    Pointer<ConsumerInfo> exclusive = createConsumer(44, 1000);
+    exclusive->setExclusive(true);
+    tracker.track(exclusive);
+    CPPUNIT_ASSERT_EQUAL(1, standby->consumers.size());
+
+    // The removal of a consumer that was never mirrored isn't either.
+    tracker.track(exclusive->createRemoveCommand());
+    CPPUNIT_ASSERT_EQUAL(0, standby->removes.size());
+
+    tracker.track(conn.consumer->createRemoveCommand());
+    CPPUNIT_ASSERT_EQUAL(1, standby->removes.size());
+
+    // Promotion registers the durable subscriber that was kept off the standby.
+    tracker.promoteStandby(standby);
+
+    CPPUNIT_ASSERT_EQUAL(2, standby->consumers.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("durable"),
+        standby->consumers.getLast().dynamicCast<ConsumerInfo>()->getSubscriptionName());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testStandbyCatchesUp() {
+
+    ConnectionStateTracker tracker;
+    Pointer<CatchUpTransport> standby(new CatchUpTransport(&tracker));
+
+    createConnectionState(tracker);
+
+    standby->lateConsumer = createConsumer(43, 1000);
+    tracker.setStandby(standby);
+
+    CPPUNIT_ASSERT(tracker.getStandby() == standby);
+    CPPUNIT_ASSERT_EQUAL(2, standby->consumers.size());
+    CPPUNIT_ASSERT_EQUAL(0, standby->consumers.getLast().dynamicCast<ConsumerInfo>()->getPrefetchSize());
+
+    // A standby that can't be written to is never installed.
+    Pointer<CatchUpTransport> broken(new CatchUpTransport(&tracker));
+    broken->failing = true;
+
+    CPPUNIT_ASSERT_THROW(tracker.setStandby(broken), decaf::io::IOException);
+    CPPUNIT_ASSERT(tracker.getStandby() == NULL);
+
+    // Registrations are no longer recorded for it.
+    broken->failing = false;
+    tracker.track(createConsumer(44, 1000));
+    CPPUNIT_ASSERT_EQUAL(0, broken->consumers.size());
+}
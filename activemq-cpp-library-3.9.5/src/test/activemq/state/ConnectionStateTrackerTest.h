@@ -30,6 +30,9 @@ namespace state {
         CPPUNIT_TEST( test );
         CPPUNIT_TEST( testMessageCache );
         CPPUNIT_TEST( testMessagePullCache );
+        CPPUNIT_TEST( testStandby );
+        CPPUNIT_TEST( testStandbySkipsDurableAndExclusive );
+        CPPUNIT_TEST( testStandbyCatchesUp );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +43,9 @@ namespace state {
         void test();
         void testMessageCache();
         void testMessagePullCache();
+        void testStandby();
+        void testStandbySkipsDurableAndExclusive();
+        void testStandbyCatchesUp();
 
     };
 
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageCacheTest.h"
+
+#include <activemq/state/MessageCache.h>
+#include <activemq/commands/Message.h>
+#include <decaf/lang/Pointer.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::state;
+using namespace activemq::commands;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<Command> createMessage(int commandId) {
+        Pointer<Message> message(new Message());
+        message->setCommandId(commandId);
+        return message;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCacheTest::testAddAndEvict() {
+
+    MessageCache cache;
+
+    for (int i = 1; i <= 10; ++i) {
+        cache.add(createMessage(i), 100, 300);
+    }
+
+    // Eviction happens while the cache is over its limit before a message is added.
+    CPPUNIT_ASSERT_EQUAL(4, cache.size());
+    CPPUNIT_ASSERT_EQUAL(400LL, cache.getCurrentSize());
+
+    std::vector< Pointer<Command> > messages;
+    cache.getMessages(messages);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 4, messages.size());
+    for (int i = 0; i < 4; ++i) {
+        CPPUNIT_ASSERT_EQUAL(7 + i, messages[i]->getCommandId());
+    }
+
+    cache.clear();
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+    CPPUNIT_ASSERT_EQUAL(0LL, cache.getCurrentSize());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCacheTest::testGrow() {
+
+    MessageCache cache;
+
+    int capacity = cache.getCapacity();
+
+    // Move the head away from the start of the ring before it grows.
+    for (int i = 1; i <= capacity / 2; ++i) {
+        cache.add(createMessage(i), 1, 1000000);
+    }
+    cache.releaseUpTo(capacity / 4);
+
+    int first = capacity / 4 + 1;
+    int last = first + capacity * 2;
+    for (int i = capacity / 2 + 1; i < last; ++i) {
+        cache.add(createMessage(i), 1, 1000000);
+    }
+
+    CPPUNIT_ASSERT(cache.getCapacity() > capacity);
+    CPPUNIT_ASSERT_EQUAL(last - first, cache.size());
+
+    std::vector< Pointer<Command> > messages;
+    cache.getMessages(messages);
+    for (int i = 0; i < (int) messages.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(first + i, messages[i]->getCommandId());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCacheTest::testReleaseUpTo() {
+
+    MessageCache cache;
+
+    long long sequence = 0;
+    for (int i = 1; i <= 10; ++i) {
+        long long next = cache.add(createMessage(i), 10, 1000);
+        CPPUNIT_ASSERT(next > sequence);
+        sequence = next;
+        if (i == 6) {
+            CPPUNIT_ASSERT_EQUAL(6, cache.releaseUpTo(next));
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(4, cache.size());
+    CPPUNIT_ASSERT_EQUAL(40LL, cache.getCurrentSize());
+    CPPUNIT_ASSERT_EQUAL(0, cache.releaseUpTo(0));
+    CPPUNIT_ASSERT_EQUAL(4, cache.releaseUpTo(sequence));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageCacheTest::testAcknowledge() {
+
+    MessageCache cache;
+
+    // 1 and 2 are sent before 4 is added, 3 is still in flight.
+    cache.add(createMessage(1), 10, 1000);
+    cache.sent(1);
+    cache.add(createMessage(2), 10, 1000);
+    cache.sent(2);
+    cache.add(createMessage(3), 10, 1000);
+    cache.add(createMessage(4), 10, 1000);
+    cache.sent(4);
+    cache.sent(3);
+
+    CPPUNIT_ASSERT_EQUAL(0, cache.acknowledge(42));
+
+    // Message 3 was not on the wire ahead of 4 so the release stops before it.
+    CPPUNIT_ASSERT_EQUAL(2, cache.acknowledge(4));
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+
+    CPPUNIT_ASSERT_EQUAL(1, cache.acknowledge(3));
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+
+    std::vector< Pointer<Command> > messages;
+    cache.getMessages(messages);
+    CPPUNIT_ASSERT_EQUAL(4, messages.front()->getCommandId());
+
+    CPPUNIT_ASSERT_EQUAL(1, cache.acknowledge(4));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+}
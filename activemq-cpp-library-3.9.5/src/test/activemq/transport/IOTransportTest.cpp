@@ -297,6 +297,46 @@ void IOTransportTest::testRead(){
     transport.close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testReadWithSpin(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener(10);
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+    transport.setReadSpinTime( 100 );
+
+    CPPUNIT_ASSERT( transport.getReadSpinTime() == 100 );
+
+    transport.start();
+
+    decaf::lang::Thread::sleep( 10 );
+
+    unsigned char buffer[10] = { '1', '2', '3', '4', '5', '6', '7', '8', '9', '0' };
+    try{
+        synchronized( &is ){
+            is.setByteArray( buffer, 10 );
+        }
+    }catch( decaf::lang::Exception& ex ){
+        ex.setMark( __FILE__, __LINE__ );
+    }
+
+    listener.await();
+
+    CPPUNIT_ASSERT( listener.str == "1234567890" );
+    CPPUNIT_ASSERT( transport.getReadSpinCount() + transport.getReadParkCount() > 0 );
+
+    transport.close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransportTest::testWrite(){
 
@@ -342,6 +382,54 @@ void IOTransportTest::testWrite(){
     transport.close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testBatchedWrite() {
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::BufferedOutputStream buffered(&os);
+    decaf::io::DataInputStream input(&is);
+    decaf::io::DataOutputStream output(&buffered);
+
+    Pointer<MyWireFormat> wireFormat(new MyWireFormat());
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream(&input);
+    transport.setOutputStream(&output);
+    transport.setTransportListener(&listener);
+    transport.setWireFormat(wireFormat);
+
+    transport.start();
+
+    transport.beginBatch();
+    CPPUNIT_ASSERT(transport.isBatching());
+
+    Pointer<MyCommand> cmd(new MyCommand());
+    for (char c = '1'; c <= '5'; ++c) {
+        cmd->c = c;
+        transport.oneway(cmd);
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Batched commands should not be flushed", 0, (int) os.size());
+
+    transport.endBatch();
+    CPPUNIT_ASSERT(!transport.isBatching());
+
+    std::pair<const unsigned char*, int> array = os.toByteArray();
+    CPPUNIT_ASSERT_EQUAL(5, array.second);
+    for (int i = 0; i < 5; ++i) {
+        CPPUNIT_ASSERT_EQUAL((unsigned char) ('1' + i), array.first[i]);
+    }
+    delete [] array.first;
+
+    // Back to flushing every command once the batch has ended.
+    cmd->c = '6';
+    transport.oneway(cmd);
+    CPPUNIT_ASSERT_EQUAL(6, (int) os.size());
+
+    transport.close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransportTest::testException(){
 
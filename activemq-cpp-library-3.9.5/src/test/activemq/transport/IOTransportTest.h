@@ -31,7 +31,9 @@ namespace transport{
         CPPUNIT_TEST( testStartClose );
         CPPUNIT_TEST( testStressTransportStartClose );
         CPPUNIT_TEST( testRead );
+        CPPUNIT_TEST( testReadWithSpin );
         CPPUNIT_TEST( testWrite );
+        CPPUNIT_TEST( testBatchedWrite );
         CPPUNIT_TEST( testException );
         CPPUNIT_TEST( testNarrow );
         CPPUNIT_TEST_SUITE_END();
@@ -42,7 +44,9 @@ namespace transport{
 
         void testException();
         void testWrite();
+        void testBatchedWrite();
         void testRead();
+        void testReadWithSpin();
         void testStartClose();
         void testStressTransportStartClose();
         void testNarrow();
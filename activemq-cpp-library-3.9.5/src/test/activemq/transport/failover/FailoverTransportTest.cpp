@@ -27,10 +27,13 @@
 #include <activemq/mock/MockBrokerService.h>
 #include <decaf/util/concurrent/CountDownLatch.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Thread.h>
 #include <decaf/util/UUID.h>
 
+#include <vector>
+
 using namespace activemq;
 using namespace activemq::mock;
 using namespace activemq::commands;
@@ -261,6 +264,175 @@ void FailoverTransportTest::testSendOnewayMessage() {
     transport->close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class ConcurrentMessageCountingListener : public DefaultTransportListener {
+    public:
+
+        decaf::util::concurrent::atomic::AtomicInteger numMessages;
+
+        ConcurrentMessageCountingListener() : numMessages(0) {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            if (command->isMessage()) {
+                numMessages.incrementAndGet();
+            }
+        }
+    };
+
+    class SendingThread : public Thread {
+    private:
+
+        Transport* transport;
+        int count;
+
+    public:
+
+        bool failed;
+
+        SendingThread(Transport* transport, int count) : Thread(), transport(transport), count(count), failed(false) {}
+
+        virtual ~SendingThread() {}
+
+        virtual void run() {
+            try {
+                for (int i = 0; i < count; ++i) {
+                    transport->oneway(Pointer<Command>(new ActiveMQMessage()));
+                }
+            } catch (...) {
+                failed = true;
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransportTest::testConcurrentOnewaySends() {
+
+    std::string uri = "failover://(mock://localhost:61616)?randomize=false";
+
+    const int numThreads = 4;
+    const int numMessages = 250;
+
+    ConcurrentMessageCountingListener messageCounter;
+    DefaultTransportListener listener;
+    FailoverTransportFactory factory;
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport != NULL);
+    transport->setTransportListener(&listener);
+
+    FailoverTransport* failover =
+        dynamic_cast<FailoverTransport*>(transport->narrow(typeid(FailoverTransport)));
+    CPPUNIT_ASSERT(failover != NULL);
+
+    transport->start();
+
+    Thread::sleep(1000);
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    MockTransport* mock = NULL;
+    while (mock == NULL) {
+        mock = dynamic_cast<MockTransport*>(transport->narrow(typeid(MockTransport)));
+    }
+    mock->setOutgoingListener(&messageCounter);
+
+    std::vector<SendingThread*> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.push_back(new SendingThread(transport.get(), numMessages));
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        threads[i]->start();
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        threads[i]->join();
+        CPPUNIT_ASSERT_MESSAGE("Send should not have failed", !threads[i]->failed);
+        delete threads[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL(numThreads * numMessages, messageCounter.numMessages.get());
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransportTest::testRaceConnect() {
+
+    std::string uri = "failover://(mock://localhost:61616?failOnCreate=true,"
+                                   "mock://localhost:61617?failOnCreate=true,"
+                                   "mock://localhost:61618?name=Live)?randomize=false&raceConnectCount=3";
+
+    DefaultTransportListener listener;
+    FailoverTransportFactory factory;
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport != NULL);
+    transport->setTransportListener(&listener);
+
+    FailoverTransport* failover =
+        dynamic_cast<FailoverTransport*>(transport->narrow(typeid(FailoverTransport)));
+    CPPUNIT_ASSERT(failover != NULL);
+    CPPUNIT_ASSERT_EQUAL(3, failover->getRaceConnectCount());
+
+    transport->start();
+
+    Thread::sleep(1000);
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    MockTransport* mock = dynamic_cast<MockTransport*>(transport->narrow(typeid(MockTransport)));
+    CPPUNIT_ASSERT(mock != NULL);
+    CPPUNIT_ASSERT_EQUAL(std::string("Live"), mock->getName());
+
+    transport->oneway(Pointer<Command>(new ActiveMQMessage()));
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransportTest::testRaceConnectCountChanged() {
+
+    std::string uri = "failover://(mock://localhost:61616?name=First&failOnSendMessage=true,"
+                                   "mock://localhost:61617?failOnCreate=true,"
+                                   "mock://localhost:61618?failOnCreate=true,"
+                                   "mock://localhost:61619?name=Live)?randomize=false&raceConnectCount=2";
+
+    DefaultTransportListener listener;
+    FailoverTransportFactory factory;
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport != NULL);
+    transport->setTransportListener(&listener);
+
+    FailoverTransport* failover =
+        dynamic_cast<FailoverTransport*>(transport->narrow(typeid(FailoverTransport)));
+    CPPUNIT_ASSERT(failover != NULL);
+
+    transport->start();
+
+    Thread::sleep(1000);
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    MockTransport* mock = dynamic_cast<MockTransport*>(transport->narrow(typeid(MockTransport)));
+    CPPUNIT_ASSERT(mock != NULL);
+    CPPUNIT_ASSERT_EQUAL(std::string("First"), mock->getName());
+
+    // The next race runs on an executor sized for the new count.
+    failover->setRaceConnectCount(3);
+    transport->oneway(Pointer<Command>(new ActiveMQMessage()));
+
+    Thread::sleep(1000);
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    mock = dynamic_cast<MockTransport*>(transport->narrow(typeid(MockTransport)));
+    CPPUNIT_ASSERT(mock != NULL);
+    CPPUNIT_ASSERT_EQUAL(std::string("Live"), mock->getName());
+
+    transport->close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void FailoverTransportTest::testSendRequestMessage() {
 
@@ -47,6 +47,9 @@ namespace failover {
         CPPUNIT_TEST( testFailingBackupCreation );
         CPPUNIT_TEST( testSendOnewayMessage );
         CPPUNIT_TEST( testSendRequestMessage );
+        CPPUNIT_TEST( testConcurrentOnewaySends );
+        CPPUNIT_TEST( testRaceConnect );
+        CPPUNIT_TEST( testRaceConnectCountChanged );
         CPPUNIT_TEST( testSendOnewayMessageFail );
         CPPUNIT_TEST( testSendRequestMessageFail );
         CPPUNIT_TEST( testWithOpewireCommands );
@@ -74,6 +77,9 @@ namespace failover {
         void testFailingBackupCreation();
         void testSendOnewayMessage();
         void testSendRequestMessage();
+        void testConcurrentOnewaySends();
+        void testRaceConnect();
+        void testRaceConnectCountChanged();
         void testSendOnewayMessageFail();
         void testSendRequestMessageFail();
         void testWithOpewireCommands();
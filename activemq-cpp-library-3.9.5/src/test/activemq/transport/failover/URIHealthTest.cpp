@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "URIHealthTest.h"
+
+#include <activemq/transport/failover/URIHealth.h>
+#include <activemq/transport/failover/URIPool.h>
+
+#include <decaf/lang/Thread.h>
+#include <decaf/net/URI.h>
+#include <decaf/util/LinkedList.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::failover;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::net;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealthTest::testSelectFastest() {
+
+    URIHealth health;
+
+    LinkedList<URI> uris;
+    uris.add(URI("tcp://broker1:61616"));
+    uris.add(URI("tcp://broker2:61616"));
+    uris.add(URI("tcp://broker3:61616"));
+
+    health.connected(URI("tcp://broker1:61616"), 50);
+    health.handshakeCompleted(URI("tcp://broker1:61616"), 40);
+    health.connected(URI("tcp://broker2:61616"), 5);
+    health.handshakeCompleted(URI("tcp://broker2:61616"), 4);
+    health.connected(URI("tcp://broker3:61616"), 20);
+    health.handshakeCompleted(URI("tcp://broker3:61616"), 20);
+
+    CPPUNIT_ASSERT_EQUAL(1, health.select(uris));
+
+    // A failure on the fastest broker outweighs its latency advantage.
+    health.failed(URI("tcp://broker2:61616"));
+    CPPUNIT_ASSERT(health.getScore(URI("tcp://broker2:61616")) > health.getScore(URI("tcp://broker3:61616")));
+    CPPUNIT_ASSERT_EQUAL(2, health.select(uris));
+
+    LinkedList<URI> empty;
+    CPPUNIT_ASSERT_EQUAL(-1, health.select(empty));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealthTest::testUnknownPreferred() {
+
+    URIHealth health;
+
+    LinkedList<URI> uris;
+    uris.add(URI("tcp://broker1:61616"));
+    uris.add(URI("tcp://broker2:61616"));
+
+    health.connected(URI("tcp://broker1:61616"), 1);
+
+    CPPUNIT_ASSERT_EQUAL(0.0, health.getScore(URI("tcp://broker2:61616")));
+    CPPUNIT_ASSERT_EQUAL(1, health.select(uris));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealthTest::testQuarantine() {
+
+    URIHealth health;
+    health.setFailureHalfLife(0);
+    health.setQuarantineThreshold(2.0);
+
+    LinkedList<URI> uris;
+    uris.add(URI("tcp://broker1:61616"));
+    uris.add(URI("tcp://broker2:61616"));
+
+    health.connected(URI("tcp://broker2:61616"), 100000);
+
+    health.failed(URI("tcp://broker1:61616"));
+    CPPUNIT_ASSERT(!health.isQuarantined(URI("tcp://broker1:61616")));
+    health.failed(URI("tcp://broker1:61616"));
+    CPPUNIT_ASSERT(health.isQuarantined(URI("tcp://broker1:61616")));
+
+    // The slow broker is still better than one that keeps failing.
+    CPPUNIT_ASSERT_EQUAL(1, health.select(uris));
+
+    // With everything quarantined the one with the fewest failures is used.
+    health.failed(URI("tcp://broker2:61616"));
+    health.failed(URI("tcp://broker2:61616"));
+    health.failed(URI("tcp://broker2:61616"));
+    CPPUNIT_ASSERT(health.isQuarantined(URI("tcp://broker2:61616")));
+    CPPUNIT_ASSERT_EQUAL(0, health.select(uris));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealthTest::testFailureDecay() {
+
+    URIHealth health;
+    health.setFailureHalfLife(50);
+    health.setQuarantineThreshold(1.0);
+
+    URI uri("tcp://broker1:61616");
+
+    health.failed(uri);
+    CPPUNIT_ASSERT(health.isQuarantined(uri) || health.getScore(uri) > 0);
+
+    Thread::sleep(300);
+
+    CPPUNIT_ASSERT(!health.isQuarantined(uri));
+    CPPUNIT_ASSERT(health.getScore(uri) < (double) health.getFailurePenalty() / 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIHealthTest::testURIPoolSelection() {
+
+    Pointer<URIHealth> health(new URIHealth());
+
+    URIPool pool;
+    pool.addURI(URI("tcp://broker1:61616"));
+    pool.addURI(URI("tcp://broker2:61616"));
+    pool.addURI(URI("tcp://broker3:61616"));
+    pool.setRandomize(false);
+    pool.setHealth(health);
+
+    health->connected(URI("tcp://broker1:61616"), 30);
+    health->connected(URI("tcp://broker2:61616"), 10);
+    health->connected(URI("tcp://broker3:61616"), 20);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("tcp://broker2:61616"), pool.getURI().toString());
+    CPPUNIT_ASSERT_EQUAL(std::string("tcp://broker3:61616"), pool.getURI().toString());
+    CPPUNIT_ASSERT_EQUAL(std::string("tcp://broker1:61616"), pool.getURI().toString());
+}
@@ -18,11 +18,13 @@
 #include "InactivityMonitorTest.h"
 
 #include <activemq/transport/inactivity/InactivityMonitor.h>
+#include <activemq/transport/inactivity/RoundTripHistogram.h>
 #include <activemq/transport/mock/MockTransport.h>
 #include <activemq/transport/mock/MockTransportFactory.h>
 #include <activemq/transport/TransportListener.h>
 #include <activemq/commands/WireFormatInfo.h>
 #include <activemq/commands/ActiveMQMessage.h>
+#include <activemq/wireformat/openwire/OpenWireResponseBuilder.h>
 
 #include <decaf/net/URI.h>
 #include <decaf/lang/Thread.h>
@@ -35,6 +37,7 @@ using namespace activemq::transport;
 using namespace activemq::transport::mock;
 using namespace activemq::transport::inactivity;
 using namespace activemq::exceptions;
+using namespace activemq::wireformat::openwire;
 using namespace decaf;
 using namespace decaf::net;
 using namespace decaf::io;
@@ -71,6 +74,21 @@ namespace {
         }
     };
 
+    ////////////////////////////////////////////////////////////////////////////////
+    class SilentPeerResponseBuilder : public OpenWireResponseBuilder {
+    public:
+
+        virtual ~SilentPeerResponseBuilder() {}
+
+        virtual void buildIncomingCommands(const Pointer<Command> command, decaf::util::LinkedList<Pointer<Command> >& queue) {
+
+            // Complete the handshake but never answer a heartbeat.
+            if (!command->isKeepAliveInfo()) {
+                OpenWireResponseBuilder::buildIncomingCommands(command, queue);
+            }
+        }
+    };
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,3 +203,47 @@ void InactivityMonitorTest::testNonFailureSendCase() {
     // Channel should have been inactive for to long.
     CPPUNIT_ASSERT( listener.exceptionFired == false );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitorTest::testHeartbeatRoundTrip() {
+
+    MyTransportListener listener;
+    InactivityMonitor monitor( this->transport, this->transport->getWireFormat() );
+    monitor.setHeartbeatInterval( 100 );
+    monitor.setHeartbeatMaxMissed( 3 );
+    monitor.setTransportListener( &listener );
+    monitor.start();
+
+    monitor.oneway( this->localWireFormatInfo );
+
+    Thread::sleep( 1500 );
+
+    CPPUNIT_ASSERT( listener.exceptionFired == false );
+    CPPUNIT_ASSERT( monitor.getRoundTripHistogram().getCount() > 2 );
+    CPPUNIT_ASSERT_EQUAL( 0, monitor.getMissedHeartbeats() );
+
+    // Only the remote WireFormatInfo is passed on, the heartbeat replies are not.
+    CPPUNIT_ASSERT_EQUAL( 1, listener.commandsReceived );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitorTest::testHeartbeatsMissed() {
+
+    this->transport->setResponseBuilder( Pointer<mock::ResponseBuilder>( new SilentPeerResponseBuilder() ) );
+
+    MyTransportListener listener;
+    InactivityMonitor monitor( this->transport, this->transport->getWireFormat() );
+    monitor.setHeartbeatInterval( 100 );
+    monitor.setHeartbeatMaxMissed( 3 );
+    monitor.setTransportListener( &listener );
+    monitor.start();
+
+    monitor.oneway( this->localWireFormatInfo );
+
+    // Well before the 3 second read check could notice the silent peer.
+    Thread::sleep( 1500 );
+
+    CPPUNIT_ASSERT( listener.exceptionFired == true );
+    CPPUNIT_ASSERT( monitor.getMissedHeartbeats() >= 3 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, monitor.getRoundTripHistogram().getCount() );
+}
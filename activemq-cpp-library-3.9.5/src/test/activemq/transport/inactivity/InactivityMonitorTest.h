@@ -38,6 +38,8 @@ namespace inactivity {
         CPPUNIT_TEST( testReadTimeout );
         CPPUNIT_TEST( testWriteMessageFail );
         CPPUNIT_TEST( testNonFailureSendCase );
+        CPPUNIT_TEST( testHeartbeatRoundTrip );
+        CPPUNIT_TEST( testHeartbeatsMissed );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -58,6 +60,8 @@ namespace inactivity {
         void testReadTimeout();
         void testWriteMessageFail();
         void testNonFailureSendCase();
+        void testHeartbeatRoundTrip();
+        void testHeartbeatsMissed();
 
     };
 
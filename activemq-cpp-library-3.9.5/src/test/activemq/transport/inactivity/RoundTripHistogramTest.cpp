@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RoundTripHistogramTest.h"
+
+#include <activemq/transport/inactivity/RoundTripHistogram.h>
+
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::inactivity;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+void RoundTripHistogramTest::testBuckets() {
+
+    RoundTripHistogram histogram;
+
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(2);
+    histogram.record(3);
+    histogram.record(1000);
+    histogram.record(-5);
+    histogram.record(1LL << 40);
+
+    CPPUNIT_ASSERT_EQUAL(7LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(3LL, histogram.getBucket(0));
+    CPPUNIT_ASSERT_EQUAL(2LL, histogram.getBucket(1));
+    CPPUNIT_ASSERT_EQUAL(1LL, histogram.getBucket(9));
+    CPPUNIT_ASSERT_EQUAL(1LL, histogram.getBucket(RoundTripHistogram::BUCKET_COUNT - 1));
+
+    CPPUNIT_ASSERT_EQUAL(2LL, RoundTripHistogram::getBucketUpperBound(0));
+    CPPUNIT_ASSERT_EQUAL(1024LL, RoundTripHistogram::getBucketUpperBound(9));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IndexOutOfBoundsException",
+        histogram.getBucket(RoundTripHistogram::BUCKET_COUNT),
+        IndexOutOfBoundsException);
+
+    histogram.reset();
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getBucket(0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RoundTripHistogramTest::testStatistics() {
+
+    RoundTripHistogram histogram;
+
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMean());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getPercentile(50));
+
+    histogram.record(300);
+    histogram.record(100);
+    histogram.record(200);
+
+    CPPUNIT_ASSERT_EQUAL(100LL, histogram.getMinimum());
+    CPPUNIT_ASSERT_EQUAL(300LL, histogram.getMaximum());
+    CPPUNIT_ASSERT_EQUAL(200LL, histogram.getMean());
+    CPPUNIT_ASSERT_EQUAL(200LL, histogram.getLast());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RoundTripHistogramTest::testPercentile() {
+
+    RoundTripHistogram histogram;
+
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(100);
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(5000);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(128LL, histogram.getPercentile(50));
+    CPPUNIT_ASSERT_EQUAL(128LL, histogram.getPercentile(90));
+    CPPUNIT_ASSERT_EQUAL(5000LL, histogram.getPercentile(99));
+    CPPUNIT_ASSERT_EQUAL(5000LL, histogram.getPercentile(100));
+}
@@ -0,0 +1,325 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SharedTransportTest.h"
+
+#include <activemq/transport/shared/SharedTransport.h>
+#include <activemq/transport/shared/SharedTransportChannel.h>
+#include <activemq/transport/mock/MockTransport.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/commands/BrokerInfo.h>
+#include <activemq/commands/ConnectionInfo.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/KeepAliveInfo.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/ProducerAck.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/ShutdownInfo.h>
+#include <decaf/net/URI.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <typeinfo>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::mock;
+using namespace activemq::transport::shared;
+using namespace decaf;
+using namespace decaf::net;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RecordingListener : public DefaultTransportListener {
+    private:
+
+        RecordingListener(const RecordingListener&);
+        RecordingListener& operator=(const RecordingListener&);
+
+    public:
+
+        Mutex mutex;
+        std::vector< Pointer<Command> > commands;
+        int exceptions;
+
+        RecordingListener() : DefaultTransportListener(), mutex(), commands(), exceptions(0) {}
+
+        virtual ~RecordingListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            synchronized(&mutex) {
+                commands.push_back(command);
+            }
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
+            synchronized(&mutex) {
+                exceptions++;
+            }
+        }
+
+        int count() {
+            synchronized(&mutex) {
+                return (int) commands.size();
+            }
+
+            return 0;
+        }
+    };
+
+    Pointer<SharedTransportChannel> createChannel(const std::string& uri, TransportListener* listener) {
+        Pointer<SharedTransportChannel> channel =
+            SharedTransport::createChannel(URI(uri)).dynamicCast<SharedTransportChannel>();
+        channel->setTransportListener(listener);
+        return channel;
+    }
+
+    MockTransport* mockOf(const Pointer<SharedTransportChannel> channel) {
+        return dynamic_cast<MockTransport*>(channel->narrow(typeid(MockTransport)));
+    }
+
+    void connect(const Pointer<SharedTransportChannel> channel, const std::string& connectionId) {
+        Pointer<ConnectionInfo> info(new ConnectionInfo());
+        Pointer<ConnectionId> id(new ConnectionId());
+        id->setValue(connectionId);
+        info->setConnectionId(id);
+        channel->oneway(info);
+    }
+
+    Pointer<Command> createDispatch(const std::string& connectionId) {
+        Pointer<MessageDispatch> dispatch(new MessageDispatch());
+        Pointer<ConsumerId> id(new ConsumerId());
+        id->setConnectionId(connectionId);
+        id->setSessionId(1);
+        id->setValue(1);
+        dispatch->setConsumerId(id);
+        return dispatch;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportTest::testChannelsShareTransport() {
+
+    int before = SharedTransport::getSharedTransportCount();
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+    RecordingListener listener3;
+
+    Pointer<SharedTransportChannel> channel1 = createChannel("mock://share?wireformat=openwire", &listener1);
+    Pointer<SharedTransportChannel> channel2 = createChannel("mock://share?wireformat=openwire", &listener2);
+    Pointer<SharedTransportChannel> other = createChannel("mock://other?wireformat=openwire", &listener3);
+
+    CPPUNIT_ASSERT_EQUAL(before + 2, SharedTransport::getSharedTransportCount());
+    CPPUNIT_ASSERT(channel1->getSharedTransport() == channel2->getSharedTransport());
+    CPPUNIT_ASSERT(channel1->getSharedTransport() != other->getSharedTransport());
+    CPPUNIT_ASSERT_EQUAL(2, channel1->getSharedTransport()->getChannelCount());
+
+    CPPUNIT_ASSERT(mockOf(channel1) != NULL);
+    CPPUNIT_ASSERT(mockOf(channel1) == mockOf(channel2));
+    CPPUNIT_ASSERT(mockOf(channel1) != mockOf(other));
+    CPPUNIT_ASSERT(channel1->narrow(typeid(SharedTransportChannel)) == channel1.get());
+
+    channel1->start();
+    channel2->start();
+    other->start();
+
+    channel1->close();
+    channel2->close();
+    other->close();
+
+    CPPUNIT_ASSERT_EQUAL(before, SharedTransport::getSharedTransportCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportTest::testRouteByConnectionId() {
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+
+    Pointer<SharedTransportChannel> channel1 = createChannel("mock://route?wireformat=openwire", &listener1);
+    Pointer<SharedTransportChannel> channel2 = createChannel("mock://route?wireformat=openwire", &listener2);
+
+    channel1->start();
+    channel2->start();
+
+    connect(channel1, "ID:connection-1");
+    connect(channel2, "ID:connection-2");
+
+    MockTransport* mock = mockOf(channel1);
+
+    mock->fireCommand(createDispatch("ID:connection-2"));
+    CPPUNIT_ASSERT_EQUAL(0, listener1.count());
+    CPPUNIT_ASSERT_EQUAL(1, listener2.count());
+    CPPUNIT_ASSERT(listener2.commands[0]->isMessageDispatch());
+
+    Pointer<ProducerAck> ack(new ProducerAck());
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:connection-1");
+    ack->setProducerId(producerId);
+
+    mock->fireCommand(ack);
+    CPPUNIT_ASSERT_EQUAL(1, listener1.count());
+    CPPUNIT_ASSERT_EQUAL(1, listener2.count());
+    CPPUNIT_ASSERT(listener1.commands[0]->isProducerAck());
+
+    // Addressed to a connection that is not on this transport.
+    mock->fireCommand(createDispatch("ID:connection-3"));
+    CPPUNIT_ASSERT_EQUAL(1, listener1.count());
+    CPPUNIT_ASSERT_EQUAL(1, listener2.count());
+
+    // Once closed the channel receives nothing more.
+    channel2->close();
+    mock->fireCommand(createDispatch("ID:connection-2"));
+    CPPUNIT_ASSERT_EQUAL(1, listener2.count());
+
+    channel1->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportTest::testBroadcast() {
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+
+    Pointer<SharedTransportChannel> channel1 = createChannel("mock://broadcast?wireformat=openwire", &listener1);
+    Pointer<SharedTransportChannel> channel2 = createChannel("mock://broadcast?wireformat=openwire", &listener2);
+
+    channel1->start();
+    channel2->start();
+
+    connect(channel1, "ID:connection-1");
+
+    mockOf(channel1)->fireCommand(Pointer<Command>(new KeepAliveInfo()));
+
+    CPPUNIT_ASSERT_EQUAL(1, listener1.count());
+    CPPUNIT_ASSERT_EQUAL(1, listener2.count());
+
+    // A stopped channel is skipped.
+    channel2->stop();
+    mockOf(channel1)->fireCommand(Pointer<Command>(new KeepAliveInfo()));
+
+    CPPUNIT_ASSERT_EQUAL(2, listener1.count());
+    CPPUNIT_ASSERT_EQUAL(1, listener2.count());
+
+    channel1->close();
+    channel2->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportTest::testLateChannelGetsBrokerInfo() {
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+
+    Pointer<SharedTransportChannel> channel1 = createChannel("mock://late?wireformat=openwire", &listener1);
+    channel1->start();
+
+    mockOf(channel1)->fireCommand(Pointer<Command>(new BrokerInfo()));
+    CPPUNIT_ASSERT_EQUAL(1, listener1.count());
+
+    Pointer<SharedTransportChannel> channel2 = createChannel("mock://late?wireformat=openwire", &listener2);
+    CPPUNIT_ASSERT_EQUAL(0, listener2.count());
+
+    channel2->start();
+    CPPUNIT_ASSERT_EQUAL(1, listener2.count());
+    CPPUNIT_ASSERT(listener2.commands[0]->isBrokerInfo());
+    CPPUNIT_ASSERT_EQUAL(1, listener1.count());
+
+    channel1->close();
+    channel2->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportTest::testShutdownInfoNotSent() {
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+    RecordingListener outgoing;
+
+    Pointer<SharedTransportChannel> channel1 = createChannel("mock://shutdown?wireformat=openwire", &listener1);
+    Pointer<SharedTransportChannel> channel2 = createChannel("mock://shutdown?wireformat=openwire", &listener2);
+
+    channel1->start();
+    channel2->start();
+
+    mockOf(channel1)->setOutgoingListener(&outgoing);
+
+    channel1->oneway(Pointer<Command>(new ShutdownInfo()));
+    CPPUNIT_ASSERT_EQUAL(0, outgoing.count());
+
+    channel1->oneway(Pointer<Command>(new KeepAliveInfo()));
+    CPPUNIT_ASSERT_EQUAL(1, outgoing.count());
+
+    Pointer<SharedTransport> shared = channel1->getSharedTransport();
+
+    channel1->close();
+    CPPUNIT_ASSERT(channel1->isClosed());
+    CPPUNIT_ASSERT(!shared->getTransport()->isClosed());
+    CPPUNIT_ASSERT_EQUAL(1, shared->getChannelCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException once closed",
+        channel1->oneway(Pointer<Command>(new KeepAliveInfo())),
+        decaf::io::IOException);
+
+    channel2->oneway(Pointer<Command>(new KeepAliveInfo()));
+    CPPUNIT_ASSERT_EQUAL(2, outgoing.count());
+
+    mockOf(channel2)->setOutgoingListener(NULL);
+
+    channel2->close();
+    CPPUNIT_ASSERT(shared->getTransport()->isClosed());
+    CPPUNIT_ASSERT_EQUAL(0, shared->getChannelCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedTransportTest::testFailedTransportReplaced() {
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+
+    Pointer<SharedTransportChannel> channel1 = createChannel("mock://failed?wireformat=openwire", &listener1);
+    Pointer<SharedTransportChannel> channel2 = createChannel("mock://failed?wireformat=openwire", &listener2);
+
+    channel1->start();
+    channel2->start();
+
+    mockOf(channel1)->fireException(ActiveMQException(__FILE__, __LINE__, "Connection Lost"));
+
+    CPPUNIT_ASSERT_EQUAL(1, listener1.exceptions);
+    CPPUNIT_ASSERT_EQUAL(1, listener2.exceptions);
+    CPPUNIT_ASSERT(channel1->getSharedTransport()->isFailed());
+
+    RecordingListener listener3;
+    Pointer<SharedTransportChannel> channel3 = createChannel("mock://failed?wireformat=openwire", &listener3);
+
+    CPPUNIT_ASSERT(channel3->getSharedTransport() != channel1->getSharedTransport());
+    CPPUNIT_ASSERT(!channel3->getSharedTransport()->isFailed());
+
+    channel3->start();
+
+    channel1->close();
+    channel2->close();
+    channel3->close();
+}
@@ -0,0 +1,289 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ReactorIOTransportTest.h"
+
+#include <activemq/transport/tcp/ReactorIOTransport.h>
+#include <activemq/transport/tcp/TcpReactor.h>
+#include <activemq/transport/tcp/TcpTransport.h>
+#include <activemq/transport/tcp/TcpTransportFactory.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/commands/KeepAliveInfo.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/net/Socket.h>
+#include <decaf/net/ServerSocket.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/util/Properties.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+
+#include <vector>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::net;
+using namespace decaf::io;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+
+////////////////////////////////////////////////////////////////////////////////
+ReactorIOTransportTest::ReactorIOTransportTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ReactorIOTransportTest::~ReactorIOTransportTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int FRAME_COUNT = 10;
+
+    /**
+     * Accepts a number of connections and writes the same set of OpenWire frames to
+     * each of them in small chunks so that frames arrive split across many reads.
+     */
+    class FrameServer : public Thread {
+    private:
+
+        ServerSocket server;
+        int connections;
+        bool closeAfterWrite;
+        std::vector<Socket*> sockets;
+        std::vector<unsigned char> frames;
+
+    public:
+
+        FrameServer(int connections, bool closeAfterWrite) :
+            Thread(), server(0), connections(connections), closeAfterWrite(closeAfterWrite), sockets(), frames() {
+
+            Properties properties;
+            OpenWireFormat wireFormat(properties);
+            IOTransport transport;
+            ByteArrayOutputStream bytesOut;
+            DataOutputStream dataOut(&bytesOut);
+
+            for (int i = 0; i < FRAME_COUNT - 1; ++i) {
+                wireFormat.marshal(Pointer<Command>(new KeepAliveInfo()), &transport, &dataOut);
+            }
+
+            // One frame larger than the reactor's initial receive buffer.
+            Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+            message->setText(std::string(20000, 'a'));
+            wireFormat.marshal(message, &transport, &dataOut);
+
+            std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+            frames.assign(array.first, array.first + array.second);
+            delete [] array.first;
+        }
+
+        virtual ~FrameServer() {
+            std::vector<Socket*>::iterator iter = sockets.begin();
+            for (; iter != sockets.end(); ++iter) {
+                try {
+                    (*iter)->close();
+                } catch (...) {}
+                delete *iter;
+            }
+
+            try {
+                server.close();
+            } catch (...) {}
+        }
+
+        int getLocalPort() {
+            return server.getLocalPort();
+        }
+
+        virtual void run() {
+            try {
+
+                for (int i = 0; i < connections; ++i) {
+                    sockets.push_back(server.accept());
+                }
+
+                std::vector<Socket*>::iterator iter = sockets.begin();
+                for (; iter != sockets.end(); ++iter) {
+
+                    OutputStream* out = (*iter)->getOutputStream();
+
+                    std::size_t offset = 0;
+                    while (offset < frames.size()) {
+                        std::size_t chunk = frames.size() - offset < 100 ? frames.size() - offset : 100;
+                        out->write(&frames[0], (int) frames.size(), (int) offset, (int) chunk);
+                        out->flush();
+                        offset += chunk;
+                        Thread::sleep(1);
+                    }
+
+                    if (closeAfterWrite) {
+                        (*iter)->close();
+                    }
+                }
+
+            } catch (...) {
+            }
+        }
+    };
+
+    class CountingListener : public DefaultTransportListener {
+    public:
+
+        CountDownLatch commands;
+        CountDownLatch exceptions;
+        Pointer<Command> last;
+
+        CountingListener(int count) : DefaultTransportListener(), commands(count), exceptions(1), last() {}
+
+        virtual ~CountingListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            last = command;
+            commands.countDown();
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
+            exceptions.countDown();
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransportTest::testReadPartialFrames() {
+
+    FrameServer server(1, false);
+    server.start();
+
+    URI uri("tcp://localhost:" + Integer::toString(server.getLocalPort()));
+
+    Properties properties;
+    Pointer<WireFormat> wireFormat(new OpenWireFormat(properties));
+    Pointer<ReactorIOTransport> reactorTransport(new ReactorIOTransport(wireFormat));
+    TcpTransport transport(reactorTransport, uri);
+
+    CountingListener listener(FRAME_COUNT);
+    transport.setTransportListener(&listener);
+    transport.start();
+
+    CPPUNIT_ASSERT_MESSAGE("Transport should be driven by the reactor", reactorTransport->isReactorDriven());
+    CPPUNIT_ASSERT_MESSAGE("Should have received all frames", listener.commands.await(10, TimeUnit::SECONDS));
+    CPPUNIT_ASSERT_MESSAGE("Should not have reported an error", listener.exceptions.getCount() == 1);
+
+    Pointer<ActiveMQTextMessage> message = listener.last.dynamicCast<ActiveMQTextMessage>();
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 20000, message->getText().size());
+
+    transport.close();
+    CPPUNIT_ASSERT(!reactorTransport->isReactorDriven());
+
+    server.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransportTest::testManyTransportsShareReactor() {
+
+    const int CONNECTIONS = 16;
+
+    FrameServer server(CONNECTIONS, false);
+    server.start();
+
+    URI uri("tcp://localhost:" + Integer::toString(server.getLocalPort()));
+
+    int channelsBefore = TcpReactor::getInstance().getChannelCount();
+
+    std::vector<TcpTransport*> transports;
+    std::vector<CountingListener*> listeners;
+
+    Properties properties;
+    for (int i = 0; i < CONNECTIONS; ++i) {
+        Pointer<WireFormat> wireFormat(new OpenWireFormat(properties));
+        TcpTransport* transport = new TcpTransport(Pointer<Transport>(new ReactorIOTransport(wireFormat)), uri);
+        CountingListener* listener = new CountingListener(FRAME_COUNT);
+        transport->setTransportListener(listener);
+        transport->start();
+        transports.push_back(transport);
+        listeners.push_back(listener);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(channelsBefore + CONNECTIONS, TcpReactor::getInstance().getChannelCount());
+    CPPUNIT_ASSERT(TcpReactor::getInstance().getActiveThreadCount() <= TcpReactor::getInstance().getThreadCount());
+
+    for (int i = 0; i < CONNECTIONS; ++i) {
+        CPPUNIT_ASSERT_MESSAGE("Should have received all frames", listeners[i]->commands.await(10, TimeUnit::SECONDS));
+    }
+
+    for (int i = 0; i < CONNECTIONS; ++i) {
+        transports[i]->close();
+        delete transports[i];
+        delete listeners[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL(channelsBefore, TcpReactor::getInstance().getChannelCount());
+
+    server.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReactorIOTransportTest::testPeerCloseIsReported() {
+
+    FrameServer server(1, true);
+    server.start();
+
+    URI uri("tcp://localhost:" + Integer::toString(server.getLocalPort()) + "?transport.useReactor=true");
+
+    TcpTransportFactory factory;
+    Pointer<Transport> transport = factory.createComposite(uri);
+    CPPUNIT_ASSERT(transport->narrow(typeid(ReactorIOTransport)) != NULL);
+    CPPUNIT_ASSERT(transport->narrow(typeid(IOTransport)) != NULL);
+
+    Properties properties;
+    Pointer<WireFormat> wireFormat(new OpenWireFormat(properties));
+    Pointer<ReactorIOTransport> reactorTransport(new ReactorIOTransport(wireFormat));
+    TcpTransport tcpTransport(reactorTransport, uri);
+
+    int channelsBefore = TcpReactor::getInstance().getChannelCount();
+
+    CountingListener listener(FRAME_COUNT);
+    tcpTransport.setTransportListener(&listener);
+    tcpTransport.start();
+
+    CPPUNIT_ASSERT_MESSAGE("Should have received all frames", listener.commands.await(10, TimeUnit::SECONDS));
+    CPPUNIT_ASSERT_MESSAGE("Should have reported the closed connection", listener.exceptions.await(10, TimeUnit::SECONDS));
+
+    // The reactor drops the channel itself once it reports the close, the error
+    // is fired just before so allow it a moment.
+    for (int i = 0; i < 100 && TcpReactor::getInstance().getChannelCount() != channelsBefore; ++i) {
+        Thread::sleep(50);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(channelsBefore, TcpReactor::getInstance().getChannelCount());
+
+    tcpTransport.close();
+    server.join();
+}
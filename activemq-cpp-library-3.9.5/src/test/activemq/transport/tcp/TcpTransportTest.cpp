@@ -21,6 +21,7 @@
 #include <activemq/transport/tcp/TcpTransport.h>
 
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/transport/DefaultTransportListener.h>
 
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Integer.h>
@@ -192,3 +193,41 @@ void TcpTransportTest::testTransportCreateWithRadomFailures() {
         } catch (Exception& ex) {}
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testSocketTuningOptions() {
+
+    ServerSocket broker(0);
+
+    TcpTransportFactory factory;
+    URI connectUri("tcp://localhost:" + Integer::toString(broker.getLocalPort()) +
+                   "?soBufferAutoTune=true&soBufferAutoTuneBandwidth=100000&soBufferAutoTuneRoundTripTime=500"
+                   "&tcpQuickAck=true&tcpNotSentLowWatermark=16384");
+
+    Pointer<Transport> transport = factory.createComposite(connectUri);
+    TcpTransport* tcpTransport = dynamic_cast<TcpTransport*>(transport->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(tcpTransport != NULL);
+
+    CPPUNIT_ASSERT(tcpTransport->isBufferAutoTune());
+    CPPUNIT_ASSERT_EQUAL(100000, tcpTransport->getBufferAutoTuneBandwidth());
+    CPPUNIT_ASSERT_EQUAL(500, tcpTransport->getBufferAutoTuneRoundTripTime());
+    CPPUNIT_ASSERT(tcpTransport->isTcpQuickAck());
+    CPPUNIT_ASSERT_EQUAL(16384, tcpTransport->getTcpNotSentLowWatermark());
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Nothing to report before connecting", -1, tcpTransport->getEffectiveReceiveBufferSize());
+    CPPUNIT_ASSERT_EQUAL(-1, tcpTransport->getMeasuredRoundTripTime());
+
+    DefaultTransportListener listener;
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    std::auto_ptr<Socket> worker(broker.accept());
+
+    CPPUNIT_ASSERT(tcpTransport->getMeasuredRoundTripTime() > 0);
+    CPPUNIT_ASSERT(tcpTransport->getEffectiveReceiveBufferSize() > 0);
+    CPPUNIT_ASSERT(tcpTransport->getEffectiveSendBufferSize() > 0);
+
+    transport->close();
+    worker->close();
+    broker.close();
+}
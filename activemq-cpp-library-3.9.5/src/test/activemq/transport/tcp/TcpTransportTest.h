@@ -30,6 +30,7 @@ namespace tcp {
 
         CPPUNIT_TEST_SUITE( TcpTransportTest );
         CPPUNIT_TEST( testTransportCreateWithRadomFailures );
+        CPPUNIT_TEST( testSocketTuningOptions );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -41,6 +42,7 @@ namespace tcp {
         virtual void tearDown();
 
         void testTransportCreateWithRadomFailures();
+        void testSocketTuningOptions();
 
     };
 
@@ -0,0 +1,380 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VMTransportTest.h"
+
+#include <activemq/transport/vm/VMBroker.h>
+#include <activemq/transport/vm/VMTransport.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/ConnectionId.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/LocalTransactionId.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/TransactionInfo.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/Properties.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <cms/Connection.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageProducer.h>
+#include <cms/Session.h>
+#include <cms/TextMessage.h>
+
+#include <memory>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::core;
+using namespace activemq::transport;
+using namespace activemq::transport::vm;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RecordingListener : public DefaultTransportListener {
+    private:
+
+        RecordingListener(const RecordingListener&);
+        RecordingListener& operator=(const RecordingListener&);
+
+    public:
+
+        Mutex mutex;
+        std::vector< Pointer<Command> > commands;
+        std::vector< Pointer<MessageDispatch> > dispatches;
+        Thread* responseThread;
+
+        RecordingListener() : DefaultTransportListener(), mutex(), commands(), dispatches(), responseThread(NULL) {}
+
+        virtual ~RecordingListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            synchronized(&mutex) {
+                commands.push_back(command);
+                if (command->isMessageDispatch()) {
+                    dispatches.push_back(command.dynamicCast<MessageDispatch>());
+                }
+                if (command->isResponse()) {
+                    responseThread = Thread::currentThread();
+                }
+                mutex.notifyAll();
+            }
+        }
+
+        int dispatchCount() {
+            synchronized(&mutex) {
+                return (int) dispatches.size();
+            }
+
+            return 0;
+        }
+
+        bool waitForDispatches(int count) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 50 && (int) dispatches.size() < count; ++i) {
+                    mutex.wait(100);
+                }
+                return (int) dispatches.size() >= count;
+            }
+
+            return false;
+        }
+
+        bool waitForCommands(int count) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 50 && (int) commands.size() < count; ++i) {
+                    mutex.wait(100);
+                }
+                return (int) commands.size() >= count;
+            }
+
+            return false;
+        }
+    };
+
+    Pointer<VMTransport> createTransport(const std::string& name, TransportListener* listener) {
+        Pointer<VMTransport> transport(new VMTransport(name, Pointer<WireFormat>(new OpenWireFormat(Properties()))));
+        transport->setTransportListener(listener);
+        transport->start();
+        return transport;
+    }
+
+    Pointer<ConsumerInfo> createConsumer(const std::string& connectionId, long long value,
+                                         const Pointer<ActiveMQDestination> destination) {
+
+        Pointer<ConsumerId> id(new ConsumerId());
+        id->setConnectionId(connectionId);
+        id->setSessionId(1);
+        id->setValue(value);
+
+        Pointer<ConsumerInfo> info(new ConsumerInfo());
+        info->setConsumerId(id);
+        info->setDestination(destination);
+        info->setResponseRequired(true);
+        return info;
+    }
+
+    Pointer<Message> createMessage(const Pointer<ActiveMQDestination> destination, const std::string& text) {
+        Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+        message->setDestination(destination);
+        message->setText(text);
+        return message;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testBrokerInfoOnStart() {
+
+    RecordingListener listener;
+    Pointer<VMTransport> transport = createTransport("brokerInfo", &listener);
+
+    CPPUNIT_ASSERT(listener.waitForCommands(1));
+    CPPUNIT_ASSERT(listener.commands[0]->isBrokerInfo());
+    CPPUNIT_ASSERT(transport->isConnected());
+    CPPUNIT_ASSERT_EQUAL(std::string("vm://brokerInfo"), transport->getRemoteAddress());
+
+    transport->close();
+    CPPUNIT_ASSERT(transport->isClosed());
+    CPPUNIT_ASSERT(!transport->isConnected());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testResponseOnSendingThread() {
+
+    RecordingListener listener;
+    Pointer<VMTransport> transport = createTransport("response", &listener);
+    CPPUNIT_ASSERT(listener.waitForCommands(1));
+
+    Pointer<ConsumerInfo> info = createConsumer("ID:connection-1", 1, Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST")));
+    info->setCommandId(42);
+    transport->oneway(info);
+
+    CPPUNIT_ASSERT_EQUAL(2, (int) listener.commands.size());
+    CPPUNIT_ASSERT(listener.commands[1]->isResponse());
+    CPPUNIT_ASSERT_EQUAL(42, listener.commands[1].dynamicCast<Response>()->getCorrelationId());
+    CPPUNIT_ASSERT(listener.responseThread == Thread::currentThread());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        transport->request(info),
+        decaf::lang::exceptions::UnsupportedOperationException);
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testQueueHeldUntilConsumer() {
+
+    Pointer<ActiveMQDestination> queue(new ActiveMQQueue("TEST.HELD"));
+
+    RecordingListener listener;
+    Pointer<VMTransport> transport = createTransport("held", &listener);
+
+    Pointer<Message> message = createMessage(queue, "held");
+    transport->oneway(message);
+    CPPUNIT_ASSERT_EQUAL(1, transport->getBroker()->getPendingCount());
+
+    transport->oneway(createConsumer("ID:connection-1", 1, queue));
+    CPPUNIT_ASSERT(listener.waitForDispatches(1));
+    CPPUNIT_ASSERT_EQUAL(0, transport->getBroker()->getPendingCount());
+    CPPUNIT_ASSERT_EQUAL(1, transport->getBroker()->getConsumerCount());
+
+    // The instance that was sent is the one that is dispatched.
+    CPPUNIT_ASSERT(listener.dispatches[0]->getMessage() == message);
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testQueueRoundRobin() {
+
+    Pointer<ActiveMQDestination> queue(new ActiveMQQueue("TEST.ROUNDROBIN"));
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+    Pointer<VMTransport> transport1 = createTransport("roundRobin", &listener1);
+    Pointer<VMTransport> transport2 = createTransport("roundRobin", &listener2);
+
+    CPPUNIT_ASSERT(transport1->getBroker() == transport2->getBroker());
+
+    transport1->oneway(createConsumer("ID:connection-1", 1, queue));
+    transport2->oneway(createConsumer("ID:connection-2", 1, queue));
+
+    for (int i = 0; i < 4; ++i) {
+        transport1->oneway(createMessage(queue, "message"));
+    }
+
+    CPPUNIT_ASSERT(listener1.waitForDispatches(2));
+    CPPUNIT_ASSERT(listener2.waitForDispatches(2));
+    CPPUNIT_ASSERT_EQUAL(2, listener1.dispatchCount());
+    CPPUNIT_ASSERT_EQUAL(2, listener2.dispatchCount());
+
+    transport1->close();
+    transport2->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testTopicFanOut() {
+
+    Pointer<ActiveMQDestination> topic(new ActiveMQTopic("TEST.FANOUT"));
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+    Pointer<VMTransport> transport1 = createTransport("fanOut", &listener1);
+    Pointer<VMTransport> transport2 = createTransport("fanOut", &listener2);
+
+    // Nobody is subscribed yet so the message is dropped.
+    transport1->oneway(createMessage(topic, "dropped"));
+    CPPUNIT_ASSERT_EQUAL(0, transport1->getBroker()->getPendingCount());
+
+    transport1->oneway(createConsumer("ID:connection-1", 1, topic));
+    transport2->oneway(createConsumer("ID:connection-2", 1, topic));
+
+    Pointer<Message> message = createMessage(topic, "fanOut");
+    transport1->oneway(message);
+
+    CPPUNIT_ASSERT(listener1.waitForDispatches(1));
+    CPPUNIT_ASSERT(listener2.waitForDispatches(1));
+    CPPUNIT_ASSERT_EQUAL(1, listener1.dispatchCount());
+    CPPUNIT_ASSERT_EQUAL(1, listener2.dispatchCount());
+
+    Pointer<Message> first = listener1.dispatches[0]->getMessage();
+    Pointer<Message> second = listener2.dispatches[0]->getMessage();
+
+    CPPUNIT_ASSERT(first == message);
+    CPPUNIT_ASSERT(second != message);
+    CPPUNIT_ASSERT_EQUAL(std::string("fanOut"), second.dynamicCast<ActiveMQTextMessage>()->getText());
+
+    transport1->close();
+    transport2->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testTransactedSendHeldUntilCommit() {
+
+    Pointer<ActiveMQDestination> queue(new ActiveMQQueue("TEST.TRANSACTED"));
+
+    RecordingListener listener;
+    Pointer<VMTransport> transport = createTransport("transacted", &listener);
+    transport->oneway(createConsumer("ID:connection-1", 1, queue));
+
+    Pointer<ConnectionId> connectionId(new ConnectionId());
+    connectionId->setValue("ID:connection-1");
+
+    Pointer<LocalTransactionId> txId(new LocalTransactionId());
+    txId->setConnectionId(connectionId);
+    txId->setValue(1);
+
+    Pointer<Message> rolledBack = createMessage(queue, "rolledBack");
+    rolledBack->setTransactionId(txId);
+    transport->oneway(rolledBack);
+
+    Pointer<TransactionInfo> rollback(new TransactionInfo());
+    rollback->setConnectionId(connectionId);
+    rollback->setTransactionId(txId);
+    rollback->setType(ActiveMQConstants::TRANSACTION_STATE_ROLLBACK);
+    transport->oneway(rollback);
+
+    Pointer<Message> committed = createMessage(queue, "committed");
+    committed->setTransactionId(txId);
+    transport->oneway(committed);
+
+    Thread::sleep(100);
+    CPPUNIT_ASSERT_EQUAL(0, listener.dispatchCount());
+
+    Pointer<TransactionInfo> commit(new TransactionInfo());
+    commit->setConnectionId(connectionId);
+    commit->setTransactionId(txId);
+    commit->setType(ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE);
+    transport->oneway(commit);
+
+    CPPUNIT_ASSERT(listener.waitForDispatches(1));
+    Thread::sleep(100);
+    CPPUNIT_ASSERT_EQUAL(1, listener.dispatchCount());
+    CPPUNIT_ASSERT(listener.dispatches[0]->getMessage() == committed);
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testLastDisconnectDropsBroker() {
+
+    int before = VMBroker::getBrokerCount();
+
+    RecordingListener listener1;
+    RecordingListener listener2;
+    Pointer<VMTransport> transport1 = createTransport("disconnect", &listener1);
+    Pointer<VMTransport> transport2 = createTransport("disconnect", &listener2);
+
+    Pointer<VMBroker> broker = transport1->getBroker();
+    CPPUNIT_ASSERT_EQUAL(before + 1, VMBroker::getBrokerCount());
+    CPPUNIT_ASSERT_EQUAL(2, broker->getTransportCount());
+
+    transport2->oneway(createConsumer("ID:connection-2", 1, Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST"))));
+    CPPUNIT_ASSERT_EQUAL(1, broker->getConsumerCount());
+
+    // Closing a transport removes its consumers.
+    transport2->close();
+    CPPUNIT_ASSERT_EQUAL(1, broker->getTransportCount());
+    CPPUNIT_ASSERT_EQUAL(0, broker->getConsumerCount());
+    CPPUNIT_ASSERT_EQUAL(before + 1, VMBroker::getBrokerCount());
+
+    transport1->close();
+    CPPUNIT_ASSERT_EQUAL(0, broker->getTransportCount());
+    CPPUNIT_ASSERT_EQUAL(before, VMBroker::getBrokerCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VMTransportTest::testSendReceiveThroughConnection() {
+
+    ActiveMQConnectionFactory factory("vm://connection");
+
+    std::auto_ptr<cms::Connection> connection(factory.createConnection());
+    connection->start();
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TEST.CONNECTION"));
+    std::auto_ptr<cms::MessageConsumer> consumer(session->createConsumer(queue.get()));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(queue.get()));
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("Hello vm://"));
+    producer->send(message.get());
+
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+
+    cms::TextMessage* text = dynamic_cast<cms::TextMessage*>(received.get());
+    CPPUNIT_ASSERT(text != NULL);
+    CPPUNIT_ASSERT_EQUAL(std::string("Hello vm://"), text->getText());
+
+    connection->close();
+}
@@ -336,3 +336,63 @@ void MarshallingSupportTest::testReadString32() {
 
     delete [] array.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallingSupportTest::testWritePropertyName() {
+
+    const char* names[] = { "JMSXGroupID", "customProperty", "", "emb\0ed", "caf\xC3\xA9", "\xFF" };
+    const std::size_t lengths[] = { 11, 14, 0, 6, 5, 1 };
+
+    for (std::size_t i = 0; i < sizeof(lengths) / sizeof(std::size_t); ++i) {
+
+        string name(names[i], lengths[i]);
+
+        ByteArrayOutputStream expectedOut;
+        DataOutputStream expectedData(&expectedOut);
+        expectedData.writeUTF(name);
+
+        ByteArrayOutputStream bytesOut;
+        DataOutputStream dataOut(&bytesOut);
+        MarshallingSupport::writePropertyName(dataOut, name);
+
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Should match the writeUTF encoding",
+                                     expectedOut.toString(), bytesOut.toString());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallingSupportTest::testReadPropertyName() {
+
+    string longName(200, 'n');
+    string encodedNull("emb\0ed", 6);
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    dataOut.writeUTF("JMSXGroupID");
+    dataOut.writeUTF("customProperty");
+    dataOut.writeUTF(longName);
+    dataOut.writeUTF(encodedNull);
+    dataOut.writeUTF("");
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    CPPUNIT_ASSERT_EQUAL(string("JMSXGroupID"), MarshallingSupport::readPropertyName(dataIn));
+    CPPUNIT_ASSERT_EQUAL(string("customProperty"), MarshallingSupport::readPropertyName(dataIn));
+    CPPUNIT_ASSERT_EQUAL(longName, MarshallingSupport::readPropertyName(dataIn));
+    CPPUNIT_ASSERT_EQUAL(encodedNull, MarshallingSupport::readPropertyName(dataIn));
+    CPPUNIT_ASSERT_EQUAL(string(), MarshallingSupport::readPropertyName(dataIn));
+    CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+
+    // A truncated name is an error rather than a short read.
+    unsigned char truncated[] = { 0x00, 0x08, 'J', 'M', 'S' };
+    ByteArrayInputStream shortIn(truncated, 5);
+    DataInputStream shortData(&shortIn);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException for a truncated name",
+        MarshallingSupport::readPropertyName(shortData),
+        IOException);
+}
@@ -34,6 +34,8 @@ namespace util {
         CPPUNIT_TEST( testReadString32 );
         CPPUNIT_TEST( testAsciiToModifiedUtf8 );
         CPPUNIT_TEST( testModifiedUtf8ToAscii );
+        CPPUNIT_TEST( testWritePropertyName );
+        CPPUNIT_TEST( testReadPropertyName );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -48,6 +50,8 @@ namespace util {
         void testReadString32();
         void testAsciiToModifiedUtf8();
         void testModifiedUtf8ToAscii();
+        void testWritePropertyName();
+        void testReadPropertyName();
 
     private:
 
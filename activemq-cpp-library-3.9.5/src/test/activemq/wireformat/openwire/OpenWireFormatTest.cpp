@@ -22,11 +22,21 @@
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
 
 #include <activemq/core/ActiveMQConnectionMetaData.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/IOException.h>
 
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::transport;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::util;
@@ -50,3 +60,63 @@ void OpenWireFormatTest::testProviderInfoInWireFormat() {
             myWireFormat->getPreferedWireFormatInfo()->getProperties().getString("ProviderVersion"));
     CPPUNIT_ASSERT(!myWireFormat->getPreferedWireFormatInfo()->getProperties().getString("PlatformDetails").empty());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testMaxFrameSize() {
+
+    OpenWireFormatFactory factory;
+    Properties properties;
+
+    Pointer<OpenWireFormat> wireFormat =
+            factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+    CPPUNIT_ASSERT_EQUAL(OpenWireFormat::DEFAULT_MAX_FRAME_SIZE, wireFormat->getMaxFrameSize());
+
+    properties.setProperty("wireFormat.maxFrameSize", "1024");
+    wireFormat = factory.createWireFormat(properties).dynamicCast<OpenWireFormat>();
+    CPPUNIT_ASSERT_EQUAL(1024LL, wireFormat->getMaxFrameSize());
+
+    IOTransport transport;
+
+    // A size prefix over the limit is refused without reading the frame body.
+    unsigned char oversized[] = { 0x00, 0x00, 0x04, 0x01 };
+    ByteArrayInputStream oversizedBytes(oversized, (int) sizeof(oversized));
+    DataInputStream oversizedIn(&oversizedBytes);
+    CPPUNIT_ASSERT_THROW(wireFormat->unmarshal(&transport, &oversizedIn), IOException);
+
+    unsigned char negative[] = { 0x80, 0x00, 0x00, 0x00 };
+    ByteArrayInputStream negativeBytes(negative, (int) sizeof(negative));
+    DataInputStream negativeIn(&negativeBytes);
+    CPPUNIT_ASSERT_THROW(wireFormat->unmarshal(&transport, &negativeIn), IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testUnmarshalLargeFrame() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    IOTransport transport;
+
+    // Larger than the pooled frame buffers, read into a buffer of its own.
+    std::string text(200 * 1024, 'a');
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setText(text);
+    message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    for (int i = 0; i < 2; ++i) {
+        wireFormat.marshal(message, &transport, &dataOut);
+    }
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    for (int i = 0; i < 2; ++i) {
+        Pointer<ActiveMQTextMessage> received =
+            wireFormat.unmarshal(&transport, &dataIn).dynamicCast<ActiveMQTextMessage>();
+        CPPUNIT_ASSERT(received->getText() == text);
+    }
+}
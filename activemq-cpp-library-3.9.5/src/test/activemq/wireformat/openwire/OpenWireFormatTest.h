@@ -29,6 +29,8 @@ namespace openwire {
 
         CPPUNIT_TEST_SUITE( OpenWireFormatTest );
         CPPUNIT_TEST( testProviderInfoInWireFormat );
+        CPPUNIT_TEST( testMaxFrameSize );
+        CPPUNIT_TEST( testUnmarshalLargeFrame );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +39,8 @@ namespace openwire {
         virtual ~OpenWireFormatTest() {}
 
         virtual void testProviderInfoInWireFormat();
+        virtual void testMaxFrameSize();
+        virtual void testUnmarshalLargeFrame();
 
     };
 
@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenWireFrameDecoderTest.h"
+
+#include <activemq/wireformat/openwire/OpenWireFrameDecoder.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/Properties.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int NUM_MESSAGES = 3;
+
+    std::vector<unsigned char> marshalMessages(OpenWireFormat& wireFormat) {
+
+        IOTransport transport;
+        ByteArrayOutputStream bytesOut;
+        DataOutputStream dataOut(&bytesOut);
+
+        for (int i = 0; i < NUM_MESSAGES; ++i) {
+            Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+            message->setText("Message " + Integer::toString(i));
+            message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+            wireFormat.marshal(message, &transport, &dataOut);
+        }
+
+        std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+        std::vector<unsigned char> bytes(array.first, array.first + array.second);
+        delete [] array.first;
+
+        return bytes;
+    }
+
+    void assertMessages(const std::vector< Pointer<Command> >& commands) {
+
+        CPPUNIT_ASSERT_EQUAL(NUM_MESSAGES, (int) commands.size());
+
+        for (int i = 0; i < NUM_MESSAGES; ++i) {
+            Pointer<ActiveMQTextMessage> message = commands[i].dynamicCast<ActiveMQTextMessage>();
+            CPPUNIT_ASSERT_EQUAL("Message " + Integer::toString(i), message->getText());
+            CPPUNIT_ASSERT_EQUAL(std::string("TEST.QUEUE"), message->getDestination()->getPhysicalName());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoderTest::testDecodeWholeFrames() {
+
+    Properties properties;
+    Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+    std::vector<unsigned char> bytes = marshalMessages(*wireFormat);
+
+    OpenWireFrameDecoder decoder(wireFormat);
+    std::vector< Pointer<Command> > commands;
+
+    CPPUNIT_ASSERT_EQUAL(0, decoder.decode(NULL, 0, commands));
+    CPPUNIT_ASSERT_EQUAL(NUM_MESSAGES, decoder.decode(&bytes[0], (int) bytes.size(), commands));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, decoder.getBufferedBytes());
+
+    assertMessages(commands);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoderTest::testDecodeSplitFrames() {
+
+    Properties properties;
+    Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+    std::vector<unsigned char> bytes = marshalMessages(*wireFormat);
+
+    // Every chunk size, from a byte at a time up to all of them at once, splits the
+    // size prefixes and the frames at different points.
+    for (std::size_t chunkSize = 1; chunkSize <= bytes.size(); ++chunkSize) {
+
+        OpenWireFrameDecoder decoder(wireFormat);
+        std::vector< Pointer<Command> > commands;
+
+        for (std::size_t offset = 0; offset < bytes.size(); offset += chunkSize) {
+            std::size_t length = std::min(chunkSize, bytes.size() - offset);
+            decoder.decode(&bytes[offset], (int) length, commands);
+        }
+
+        CPPUNIT_ASSERT_EQUAL((std::size_t) 0, decoder.getBufferedBytes());
+        assertMessages(commands);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoderTest::testInvalidFrameSize() {
+
+    Properties properties;
+    Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+    std::vector<unsigned char> bytes = marshalMessages(*wireFormat);
+
+    // A complete frame followed by one with a negative size.
+    int frameLength = 4 + ((bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3]);
+    bytes.resize(frameLength);
+    bytes.push_back(0x80);
+    bytes.push_back(0x00);
+    bytes.push_back(0x00);
+    bytes.push_back(0x00);
+
+    OpenWireFrameDecoder decoder(wireFormat);
+    std::vector< Pointer<Command> > commands;
+
+    CPPUNIT_ASSERT_THROW(decoder.decode(&bytes[0], (int) bytes.size(), commands), IOException);
+
+    // The frame ahead of the bad one was still decoded.
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, commands.size());
+
+    CPPUNIT_ASSERT_THROW(decoder.decode(NULL, 1, commands), decaf::lang::exceptions::IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW(decoder.decode(&bytes[0], -1, commands), decaf::lang::exceptions::IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoderTest::testMaxFrameSize() {
+
+    Properties properties;
+    Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+    std::vector<unsigned char> bytes = marshalMessages(*wireFormat);
+
+    int frameSize = (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+    wireFormat->setMaxFrameSize(frameSize - 1);
+
+    OpenWireFrameDecoder decoder(wireFormat);
+    std::vector< Pointer<Command> > commands;
+
+    // Refused as soon as the size prefix is seen, nothing of the frame is held.
+    CPPUNIT_ASSERT_THROW(decoder.decode(&bytes[0], 4, commands), IOException);
+    CPPUNIT_ASSERT(commands.empty());
+
+    decoder.reset();
+    wireFormat->setMaxFrameSize(frameSize);
+    CPPUNIT_ASSERT_EQUAL(NUM_MESSAGES, decoder.decode(&bytes[0], (int) bytes.size(), commands));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoderTest::testSizePrefixDisabled() {
+
+    Properties properties;
+    Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+    std::vector<unsigned char> bytes = marshalMessages(*wireFormat);
+
+    wireFormat->setSizePrefixDisabled(true);
+
+    OpenWireFrameDecoder decoder(wireFormat);
+    std::vector< Pointer<Command> > commands;
+
+    CPPUNIT_ASSERT_THROW(decoder.decode(&bytes[0], (int) bytes.size(), commands), IOException);
+    CPPUNIT_ASSERT(commands.empty());
+
+    Pointer<OpenWireFormat> nullFormat;
+    CPPUNIT_ASSERT_THROW(OpenWireFrameDecoder nullDecoder(nullFormat),
+                         decaf::lang::exceptions::NullPointerException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFrameDecoderTest::testReset() {
+
+    Properties properties;
+    Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+    std::vector<unsigned char> bytes = marshalMessages(*wireFormat);
+
+    OpenWireFrameDecoder decoder(wireFormat);
+    std::vector< Pointer<Command> > commands;
+
+    // Half of the first frame is held until the rest arrives.
+    CPPUNIT_ASSERT_EQUAL(0, decoder.decode(&bytes[0], 10, commands));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 10, decoder.getBufferedBytes());
+
+    // After a reset the decoder starts over on a new stream.
+    decoder.reset();
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, decoder.getBufferedBytes());
+
+    CPPUNIT_ASSERT_EQUAL(NUM_MESSAGES, decoder.decode(&bytes[0], (int) bytes.size(), commands));
+    assertMessages(commands);
+}
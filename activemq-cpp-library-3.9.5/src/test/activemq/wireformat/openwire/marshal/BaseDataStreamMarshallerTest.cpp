@@ -21,6 +21,8 @@
 #include <activemq/wireformat/openwire/marshal/BaseDataStreamMarshaller.h>
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshaller.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
 #include <decaf/util/Properties.h>
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/DataOutputStream.h>
@@ -37,6 +39,8 @@ using namespace activemq::wireformat;
 using namespace activemq::wireformat::openwire;
 using namespace activemq::wireformat::openwire::utils;
 using namespace activemq::wireformat::openwire::marshal;
+using namespace activemq::wireformat::openwire::marshal::generated;
+using namespace activemq::commands;
 
 ////////////////////////////////////////////////////////////////////////////////
 void BaseDataStreamMarshallerTest::setUp(){
@@ -167,3 +171,109 @@ void BaseDataStreamMarshallerTest::testTightMarshal()
 
     delete [] array.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshallerTest::testUnmarshalByteArrayInPlace() {
+
+    Properties props;
+    OpenWireFormat openWireFormat(props);
+    ActiveMQBytesMessageMarshaller marshaller;
+
+    std::vector<unsigned char> body;
+    for (int i = 0; i < 64; ++i) {
+        body.push_back((unsigned char) i);
+    }
+
+    ActiveMQBytesMessage withBody;
+    withBody.setContent(body);
+    ActiveMQBytesMessage withoutBody;
+
+    for (int tight = 0; tight < 2; ++tight) {
+
+        openWireFormat.setTightEncodingEnabled(tight == 1);
+
+        // The target already holds a larger body and properties, both must be
+        // replaced by what was read and not appended to or left behind.
+        ActiveMQBytesMessage target;
+        target.setContent(std::vector<unsigned char>(1024, 0xFF));
+        target.setMarshalledProperties(std::vector<unsigned char>(32, 0xFF));
+
+        ActiveMQBytesMessage* sources[] = { &withBody, &withoutBody };
+
+        for (int i = 0; i < 2; ++i) {
+
+            ByteArrayOutputStream baos;
+            DataOutputStream dataOut(&baos);
+            BooleanStream bs;
+
+            if (tight == 1) {
+                marshaller.tightMarshal1(&openWireFormat, sources[i], &bs);
+                bs.marshal(&dataOut);
+                marshaller.tightMarshal2(&openWireFormat, sources[i], &dataOut, &bs);
+            } else {
+                marshaller.looseMarshal(&openWireFormat, sources[i], &dataOut);
+            }
+
+            std::pair<unsigned char*, int> array = baos.toByteArray();
+            ByteArrayInputStream bais(array.first, array.second, true);
+            DataInputStream dataIn(&bais);
+
+            if (tight == 1) {
+                BooleanStream inBs;
+                inBs.unmarshal(&dataIn);
+                marshaller.tightUnmarshal(&openWireFormat, &target, &dataIn, &inBs);
+            } else {
+                marshaller.looseUnmarshal(&openWireFormat, &target, &dataIn);
+            }
+
+            CPPUNIT_ASSERT(sources[i]->getContent() == target.getContent());
+            CPPUNIT_ASSERT(target.getMarshalledProperties().empty());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshallerTest::testTightMarshalNonAsciiStrings() {
+
+    Properties props;
+    OpenWireFormat openWireFormat(props);
+    openWireFormat.setTightEncodingEnabled(true);
+    ActiveMQBytesMessageMarshaller marshaller;
+
+    // Mix ASCII and non ASCII strings so the recorded lengths are interleaved
+    // with strings that do not record one.
+    std::string nul("with");
+    nul += '\0';
+    nul += "nul";
+
+    ActiveMQBytesMessage outCommand;
+    outCommand.setGroupID("caf\xC3\xA9");
+    outCommand.setCorrelationId("plain ascii");
+    outCommand.setType(nul);
+    outCommand.setUserID("\xFF\x80user");
+
+    ByteArrayOutputStream baos;
+    DataOutputStream dataOut(&baos);
+    BooleanStream bs;
+
+    int size = marshaller.tightMarshal1(&openWireFormat, &outCommand, &bs);
+    size += bs.marshalledSize();
+    bs.marshal(&dataOut);
+    marshaller.tightMarshal2(&openWireFormat, &outCommand, &dataOut, &bs);
+
+    CPPUNIT_ASSERT_EQUAL(size, (int) baos.size());
+
+    std::pair<unsigned char*, int> array = baos.toByteArray();
+    ByteArrayInputStream bais(array.first, array.second, true);
+    DataInputStream dataIn(&bais);
+
+    ActiveMQBytesMessage inCommand;
+    BooleanStream inBs;
+    inBs.unmarshal(&dataIn);
+    marshaller.tightUnmarshal(&openWireFormat, &inCommand, &dataIn, &inBs);
+
+    CPPUNIT_ASSERT_EQUAL(outCommand.getGroupID(), inCommand.getGroupID());
+    CPPUNIT_ASSERT_EQUAL(outCommand.getCorrelationId(), inCommand.getCorrelationId());
+    CPPUNIT_ASSERT_EQUAL(outCommand.getType(), inCommand.getType());
+    CPPUNIT_ASSERT_EQUAL(outCommand.getUserID(), inCommand.getUserID());
+}
@@ -0,0 +1,243 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PreparedMessageMarshallerTest.h"
+
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/marshal/PreparedMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQTextMessageMarshaller.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/LocalTransactionId.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/Properties.h>
+
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace activemq::wireformat::openwire::marshal::generated;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector<unsigned char> looseMarshal(OpenWireFormat* format, DataStreamMarshaller* marshaller, DataStructure* object) {
+
+        ByteArrayOutputStream baos;
+        DataOutputStream dataOut(&baos);
+
+        marshaller->looseMarshal(format, object, &dataOut);
+
+        std::pair<unsigned char*, int> array = baos.toByteArray();
+        std::vector<unsigned char> result(array.first, array.first + array.second);
+        delete [] array.first;
+        return result;
+    }
+
+    std::vector<unsigned char> marshalFrame(OpenWireFormat* format, const Pointer<Command> command) {
+
+        IOTransport transport;
+        ByteArrayOutputStream baos;
+        DataOutputStream dataOut(&baos);
+
+        format->marshal(command, &transport, &dataOut);
+
+        std::pair<unsigned char*, int> array = baos.toByteArray();
+        std::vector<unsigned char> result(array.first, array.first + array.second);
+        delete [] array.first;
+        return result;
+    }
+
+    Pointer<ActiveMQTextMessage> createPrototype() {
+
+        Pointer<ProducerId> producerId(new ProducerId());
+        producerId->setConnectionId("ID:test-connection:1");
+        producerId->setSessionId(2);
+        producerId->setValue(3);
+
+        Pointer<ActiveMQTextMessage> prototype(new ActiveMQTextMessage());
+        prototype->setProducerId(producerId);
+        prototype->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+        prototype->setReplyTo(Pointer<ActiveMQDestination>(new ActiveMQTopic("TEST.REPLIES")));
+        prototype->setCorrelationId("correlation");
+        prototype->setType("prepared");
+        prototype->setGroupID("group");
+        prototype->setGroupSequence(5);
+        prototype->setPersistent(true);
+        prototype->setPriority(7);
+        prototype->setUserID("user");
+        return prototype;
+    }
+
+    Pointer<ActiveMQTextMessage> createSend(const PreparedMessageMarshaller& marshaller, long long sequence) {
+
+        const Pointer<Message>& prototype = marshaller.getPrototype();
+
+        Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+        message->setCommandId((int) sequence);
+        message->setMessageId(Pointer<MessageId>(new MessageId(prototype->getProducerId(), sequence)));
+        message->setProducerId(prototype->getProducerId());
+        message->setDestination(prototype->getDestination());
+        message->setTimestamp(1234567890LL + sequence);
+        message->setExpiration(sequence % 2 == 0 ? 0 : 1234599999LL);
+        message->setText(std::string((std::size_t) sequence * 10, 'a'));
+        message->getMessageProperties().setLong("sequence", sequence);
+        marshaller.apply(message.get());
+        return message;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshallerTest::testConstructor() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        PreparedMessageMarshaller(Pointer<Message>()),
+        NullPointerException);
+
+    Pointer<ActiveMQTextMessage> prototype = createPrototype();
+    prototype->setDestination(Pointer<ActiveMQDestination>());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        PreparedMessageMarshaller marshaller(prototype),
+        NullPointerException);
+
+    PreparedMessageMarshaller marshaller(createPrototype());
+    CPPUNIT_ASSERT(marshaller.getDataStructureType() == ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE);
+
+    Pointer<DataStructure> object(marshaller.createObject());
+    CPPUNIT_ASSERT(object->getDataStructureType() == ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshallerTest::testLooseMatchesGenerated() {
+
+    ActiveMQTextMessageMarshaller generated;
+    PreparedMessageMarshaller marshaller(createPrototype());
+
+    Pointer<LocalTransactionId> txId(new LocalTransactionId());
+    txId->setConnectionId(Pointer<ConnectionId>(new ConnectionId()));
+    txId->getConnectionId()->setValue("ID:test-connection:1");
+    txId->setValue(12);
+
+    // Run through the versions twice, the runs are laid out again on each change.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int version = 1; version <= OpenWireFormat::MAX_SUPPORTED_VERSION; ++version) {
+
+            Properties props;
+            OpenWireFormat format(props);
+            format.setVersion(version);
+            format.setTightEncodingEnabled(false);
+
+            for (long long sequence = 1; sequence <= 3; ++sequence) {
+
+                Pointer<ActiveMQTextMessage> message = createSend(marshaller, sequence);
+                if (sequence == 3) {
+                    message->setTransactionId(txId);
+                }
+
+                CPPUNIT_ASSERT(marshaller.isPreparedFor(message.get()));
+
+                std::vector<unsigned char> expected = looseMarshal(&format, &generated, message.get());
+                std::vector<unsigned char> actual = looseMarshal(&format, &marshaller, message.get());
+
+                CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+                CPPUNIT_ASSERT(expected == actual);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshallerTest::testIsPreparedFor() {
+
+    PreparedMessageMarshaller marshaller(createPrototype());
+    const Pointer<Message>& prototype = marshaller.getPrototype();
+
+    CPPUNIT_ASSERT(marshaller.isPreparedFor(createSend(marshaller, 1).get()));
+
+    // An equal ProducerId that is not the prototype's own.
+    Pointer<ActiveMQTextMessage> message = createSend(marshaller, 1);
+    message->setProducerId(Pointer<ProducerId>(prototype->getProducerId()->cloneDataStructure()));
+    CPPUNIT_ASSERT(!marshaller.isPreparedFor(message.get()));
+
+    message = createSend(marshaller, 1);
+    message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    CPPUNIT_ASSERT(!marshaller.isPreparedFor(message.get()));
+
+    message = createSend(marshaller, 1);
+    message->setMessageId(Pointer<MessageId>());
+    CPPUNIT_ASSERT(!marshaller.isPreparedFor(message.get()));
+
+    message = createSend(marshaller, 1);
+    message->getMessageId()->setTextView("ID:text-view");
+    CPPUNIT_ASSERT(!marshaller.isPreparedFor(message.get()));
+
+    message = createSend(marshaller, 1);
+    message->getMessageId()->setBrokerSequenceId(99);
+    CPPUNIT_ASSERT(!marshaller.isPreparedFor(message.get()));
+
+    ActiveMQBytesMessage bytes;
+    bytes.setMessageId(Pointer<MessageId>(new MessageId(prototype->getProducerId(), 1)));
+    bytes.setProducerId(prototype->getProducerId());
+    bytes.setDestination(prototype->getDestination());
+    CPPUNIT_ASSERT(!marshaller.isPreparedFor(&bytes));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PreparedMessageMarshallerTest::testWireFormatUsesPrepared() {
+
+    Pointer<PreparedMessageMarshaller> marshaller(new PreparedMessageMarshaller(createPrototype()));
+
+    for (int tight = 0; tight < 2; ++tight) {
+
+        Properties props;
+        OpenWireFormat format(props);
+        format.setTightEncodingEnabled(tight == 1);
+
+        Pointer<ActiveMQTextMessage> plain = createSend(*marshaller, 2);
+        Pointer<ActiveMQTextMessage> prepared = createSend(*marshaller, 2);
+        prepared->setPreparedMarshaller(marshaller);
+
+        CPPUNIT_ASSERT(marshalFrame(&format, plain) == marshalFrame(&format, prepared));
+    }
+
+    // The marshaller is not carried over to copies of the Message.
+    Pointer<ActiveMQTextMessage> message = createSend(*marshaller, 1);
+    message->setPreparedMarshaller(marshaller);
+    Pointer<ActiveMQTextMessage> copy(message->cloneDataStructure());
+    CPPUNIT_ASSERT(copy->getPreparedMarshaller() == NULL);
+}
@@ -0,0 +1,362 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VersionedMarshallerFactoryTest.h"
+
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/marshal/DataStreamMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/VersionedMarshallerFactory.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQTextMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/MessageAckMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/MessageDispatchMarshaller.h>
+#include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/Properties.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace activemq::wireformat::openwire::marshal::generated;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class MarshallerList {
+    private:
+
+        MarshallerList(const MarshallerList&);
+        MarshallerList& operator=(const MarshallerList&);
+
+    public:
+
+        std::vector<DataStreamMarshaller*> marshallers;
+
+        MarshallerList(int version) : marshallers() {
+            VersionedMarshallerFactory::create(version, marshallers);
+        }
+
+        ~MarshallerList() {
+            for (std::size_t i = 0; i < marshallers.size(); ++i) {
+                delete marshallers[i];
+            }
+        }
+
+        DataStreamMarshaller* find(unsigned char type) const {
+            for (std::size_t i = 0; i < marshallers.size(); ++i) {
+                if (marshallers[i]->getDataStructureType() == type) {
+                    return marshallers[i];
+                }
+            }
+
+            return NULL;
+        }
+    };
+
+    std::vector<unsigned char> tightMarshal(OpenWireFormat* format, DataStreamMarshaller* marshaller, DataStructure* object) {
+
+        ByteArrayOutputStream baos;
+        DataOutputStream dataOut(&baos);
+        BooleanStream bs;
+
+        marshaller->tightMarshal1(format, object, &bs);
+        bs.marshal(&dataOut);
+        marshaller->tightMarshal2(format, object, &dataOut, &bs);
+
+        std::pair<unsigned char*, int> array = baos.toByteArray();
+        std::vector<unsigned char> result(array.first, array.first + array.second);
+        delete [] array.first;
+        return result;
+    }
+
+    void tightUnmarshal(OpenWireFormat* format, DataStreamMarshaller* marshaller,
+                        DataStructure* object, const std::vector<unsigned char>& bytes) {
+
+        ByteArrayInputStream bais(&bytes[0], (int) bytes.size());
+        DataInputStream dataIn(&bais);
+        BooleanStream bs;
+
+        bs.unmarshal(&dataIn);
+        marshaller->tightUnmarshal(format, object, &dataIn, &bs);
+    }
+
+    std::vector<unsigned char> looseMarshal(OpenWireFormat* format, DataStreamMarshaller* marshaller, DataStructure* object) {
+
+        ByteArrayOutputStream baos;
+        DataOutputStream dataOut(&baos);
+
+        marshaller->looseMarshal(format, object, &dataOut);
+
+        std::pair<unsigned char*, int> array = baos.toByteArray();
+        std::vector<unsigned char> result(array.first, array.first + array.second);
+        delete [] array.first;
+        return result;
+    }
+
+    void looseUnmarshal(OpenWireFormat* format, DataStreamMarshaller* marshaller,
+                        DataStructure* object, const std::vector<unsigned char>& bytes) {
+
+        ByteArrayInputStream bais(&bytes[0], (int) bytes.size());
+        DataInputStream dataIn(&bais);
+
+        marshaller->looseUnmarshal(format, object, &dataIn);
+    }
+
+    Pointer<ActiveMQTextMessage> createTextMessage() {
+
+        Pointer<ProducerId> producerId(new ProducerId());
+        producerId->setConnectionId("ID:test-connection:1");
+        producerId->setSessionId(2);
+        producerId->setValue(3);
+
+        Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+        message->setMessageId(Pointer<MessageId>(new MessageId(producerId, 42)));
+        message->setProducerId(producerId);
+        message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+        message->setCorrelationId("correlation");
+        message->setPriority(7);
+        message->setTimestamp(1234567890LL);
+        message->setGroupID("group");
+        message->setGroupSequence(5);
+        message->setText("Versioned marshaller test message");
+        message->getMessageProperties().setString("stringKey", "value");
+        message->getMessageProperties().setInt("intKey", 65536);
+        return message;
+    }
+
+    Pointer<ActiveMQBytesMessage> createBytesMessage() {
+
+        Pointer<ActiveMQBytesMessage> message(new ActiveMQBytesMessage());
+        message->setMessageId(Pointer<MessageId>(new MessageId("ID:test-producer:1:1:1", 7)));
+        message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.BYTES")));
+        message->setPersistent(true);
+        message->setExpiration(99999LL);
+
+        unsigned char body[256];
+        for (int i = 0; i < 256; ++i) {
+            body[i] = (unsigned char) i;
+        }
+        message->setBodyBytes(body, 256);
+        return message;
+    }
+
+    Pointer<MessageDispatch> createDispatch() {
+
+        Pointer<ConsumerId> consumerId(new ConsumerId());
+        consumerId->setConnectionId("ID:test-connection:1");
+        consumerId->setSessionId(1);
+        consumerId->setValue(9);
+
+        Pointer<MessageDispatch> dispatch(new MessageDispatch());
+        dispatch->setConsumerId(consumerId);
+        dispatch->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+        dispatch->setMessage(createTextMessage());
+        dispatch->setRedeliveryCounter(3);
+        return dispatch;
+    }
+
+    Pointer<MessageAck> createAck() {
+
+        Pointer<ConsumerId> consumerId(new ConsumerId());
+        consumerId->setConnectionId("ID:test-connection:1");
+        consumerId->setSessionId(1);
+        consumerId->setValue(9);
+
+        Pointer<MessageAck> ack(new MessageAck());
+        ack->setConsumerId(consumerId);
+        ack->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+        ack->setAckType(2);
+        ack->setFirstMessageId(Pointer<MessageId>(new MessageId("ID:test-producer:1:1:1", 1)));
+        ack->setLastMessageId(Pointer<MessageId>(new MessageId("ID:test-producer:1:1:1", 10)));
+        ack->setMessageCount(10);
+        return ack;
+    }
+
+    void assertSameEncoding(OpenWireFormat* format, DataStreamMarshaller* generated,
+                            DataStreamMarshaller* versioned, DataStructure* object, bool tight) {
+
+        std::vector<unsigned char> expected;
+        std::vector<unsigned char> actual;
+
+        if (tight) {
+            expected = tightMarshal(format, generated, object);
+            actual = tightMarshal(format, versioned, object);
+        } else {
+            expected = looseMarshal(format, generated, object);
+            actual = looseMarshal(format, versioned, object);
+        }
+
+        CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+        CPPUNIT_ASSERT(expected == actual);
+    }
+
+    void assertAllMatchGenerated(bool tight) {
+
+        ActiveMQBytesMessageMarshaller bytesMarshaller;
+        ActiveMQTextMessageMarshaller textMarshaller;
+        MessageDispatchMarshaller dispatchMarshaller;
+        MessageAckMarshaller ackMarshaller;
+
+        for (int version = VersionedMarshallerFactory::MIN_VERSION;
+             version <= VersionedMarshallerFactory::MAX_VERSION; ++version) {
+
+            Properties props;
+            OpenWireFormat format(props);
+            format.setVersion(version);
+            format.setTightEncodingEnabled(tight);
+
+            MarshallerList list(version);
+
+            assertSameEncoding(&format, &bytesMarshaller,
+                list.find(ActiveMQBytesMessage::ID_ACTIVEMQBYTESMESSAGE), createBytesMessage().get(), tight);
+            assertSameEncoding(&format, &textMarshaller,
+                list.find(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE), createTextMessage().get(), tight);
+            assertSameEncoding(&format, &dispatchMarshaller,
+                list.find(MessageDispatch::ID_MESSAGEDISPATCH), createDispatch().get(), tight);
+            assertSameEncoding(&format, &ackMarshaller,
+                list.find(MessageAck::ID_MESSAGEACK), createAck().get(), tight);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VersionedMarshallerFactoryTest::testCreate() {
+
+    {
+        MarshallerList list(VersionedMarshallerFactory::MIN_VERSION - 1);
+        CPPUNIT_ASSERT(list.marshallers.empty());
+    }
+    {
+        MarshallerList list(VersionedMarshallerFactory::MAX_VERSION + 1);
+        CPPUNIT_ASSERT(list.marshallers.empty());
+    }
+
+    for (int version = VersionedMarshallerFactory::MIN_VERSION;
+         version <= VersionedMarshallerFactory::MAX_VERSION; ++version) {
+
+        MarshallerList list(version);
+        CPPUNIT_ASSERT_EQUAL((std::size_t) 4, list.marshallers.size());
+        CPPUNIT_ASSERT(list.find(MessageDispatch::ID_MESSAGEDISPATCH) != NULL);
+        CPPUNIT_ASSERT(list.find(MessageAck::ID_MESSAGEACK) != NULL);
+        CPPUNIT_ASSERT(list.find(ActiveMQBytesMessage::ID_ACTIVEMQBYTESMESSAGE) != NULL);
+        CPPUNIT_ASSERT(list.find(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE) != NULL);
+
+        std::auto_ptr<DataStructure> object(list.find(MessageAck::ID_MESSAGEACK)->createObject());
+        CPPUNIT_ASSERT(object->getDataStructureType() == MessageAck::ID_MESSAGEACK);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VersionedMarshallerFactoryTest::testTightMatchesGenerated() {
+    assertAllMatchGenerated(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VersionedMarshallerFactoryTest::testLooseMatchesGenerated() {
+    assertAllMatchGenerated(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VersionedMarshallerFactoryTest::testRoundTrip() {
+
+    for (int tight = 0; tight < 2; ++tight) {
+
+        Properties props;
+        OpenWireFormat format(props);
+        format.setVersion(VersionedMarshallerFactory::MAX_VERSION);
+        format.setTightEncodingEnabled(tight == 1);
+
+        MarshallerList list(VersionedMarshallerFactory::MAX_VERSION);
+        DataStreamMarshaller* marshaller = list.find(MessageDispatch::ID_MESSAGEDISPATCH);
+
+        Pointer<MessageDispatch> outCommand = createDispatch();
+        MessageDispatch inCommand;
+
+        if (tight == 1) {
+            tightUnmarshal(&format, marshaller, &inCommand, tightMarshal(&format, marshaller, outCommand.get()));
+        } else {
+            looseUnmarshal(&format, marshaller, &inCommand, looseMarshal(&format, marshaller, outCommand.get()));
+        }
+
+        CPPUNIT_ASSERT(inCommand.getConsumerId()->equals(outCommand->getConsumerId().get()));
+        CPPUNIT_ASSERT_EQUAL(3, inCommand.getRedeliveryCounter());
+        CPPUNIT_ASSERT(inCommand.getMessage() != NULL);
+
+        Pointer<ActiveMQTextMessage> message = inCommand.getMessage().dynamicCast<ActiveMQTextMessage>();
+        CPPUNIT_ASSERT_EQUAL(std::string("Versioned marshaller test message"), message->getText());
+        CPPUNIT_ASSERT_EQUAL(std::string("correlation"), message->getCorrelationId());
+        CPPUNIT_ASSERT_EQUAL(std::string("group"), message->getGroupID());
+        CPPUNIT_ASSERT_EQUAL(5, message->getGroupSequence());
+        CPPUNIT_ASSERT_EQUAL(65536, message->getMessageProperties().getInt("intKey"));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VersionedMarshallerFactoryTest::testWireFormatRenegotiate() {
+
+    Properties props;
+    OpenWireFormat format(props);
+    format.setTightEncodingEnabled(true);
+
+    int versions[] = { 1, VersionedMarshallerFactory::MAX_VERSION, VersionedMarshallerFactory::MIN_VERSION, 1 };
+
+    for (int i = 0; i < 4; ++i) {
+
+        format.setVersion(versions[i]);
+
+        Pointer<MessageAck> outCommand = createAck();
+
+        ByteArrayOutputStream baos;
+        DataOutputStream dataOut(&baos);
+        BooleanStream bs;
+        format.tightMarshalNestedObject1(outCommand.get(), &bs);
+        bs.marshal(&dataOut);
+        format.tightMarshalNestedObject2(outCommand.get(), &dataOut, &bs);
+
+        std::pair<unsigned char*, int> array = baos.toByteArray();
+        ByteArrayInputStream bais(array.first, array.second, true);
+        DataInputStream dataIn(&bais);
+        BooleanStream inBs;
+        inBs.unmarshal(&dataIn);
+
+        std::auto_ptr<DataStructure> inCommand(format.tightUnmarshalNestedObject(&dataIn, &inBs));
+        CPPUNIT_ASSERT(inCommand.get() != NULL);
+        CPPUNIT_ASSERT(inCommand->equals(outCommand.get()));
+    }
+}
@@ -22,6 +22,7 @@
 #include <decaf/io/ByteArrayInputStream.h>
 #include <decaf/io/DataOutputStream.h>
 #include <decaf/io/DataInputStream.h>
+#include <decaf/io/IOException.h>
 
 using namespace decaf;
 using namespace decaf::io;
@@ -99,3 +100,111 @@ void BooleanStreamTest::test2(){
 
     delete [] array.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BooleanStreamTest::testRecordedLengths() {
+
+    BooleanStream bs;
+
+    io::ByteArrayOutputStream baoStream;
+    io::DataOutputStream daoStream( &baoStream );
+
+    bs.writeBoolean( true );
+    bs.writeLength( 12 );
+    bs.writeBoolean( false );
+    bs.writeLength( 65535 );
+
+    int size = bs.marshalledSize();
+    bs.marshal( &daoStream );
+
+    // Recorded lengths never reach the wire.
+    CPPUNIT_ASSERT_EQUAL( size, (int)baoStream.size() );
+
+    // Marshaling rewinds the stream so the second pass replays what was recorded.
+    CPPUNIT_ASSERT( bs.readBoolean() == true );
+    CPPUNIT_ASSERT_EQUAL( 12, bs.readLength() );
+    CPPUNIT_ASSERT( bs.readBoolean() == false );
+    CPPUNIT_ASSERT_EQUAL( 65535, bs.readLength() );
+
+    CPPUNIT_ASSERT_THROW( bs.readLength(), decaf::io::IOException );
+
+    bs.clear();
+    CPPUNIT_ASSERT_EQUAL( 12, bs.readLength() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BooleanStreamTest::testBits() {
+
+    BooleanStream bitStream;
+    BooleanStream boolStream;
+
+    // Runs of every length written at every offset into a byte.
+    unsigned int pattern = 0xA5C3F00Fu;
+    for( int count = 0; count <= 32; ++count ) {
+        unsigned int bits = pattern ^ (unsigned int)count;
+        bitStream.writeBits( bits, count );
+        for( int i = 0; i < count; ++i ) {
+            boolStream.writeBoolean( ( ( bits >> i ) & 0x01 ) != 0 );
+        }
+    }
+
+    // Both forms produce the same marshaled bytes.
+    io::ByteArrayOutputStream bitOut;
+    io::DataOutputStream bitDataOut( &bitOut );
+    io::ByteArrayOutputStream boolOut;
+    io::DataOutputStream boolDataOut( &boolOut );
+
+    CPPUNIT_ASSERT_EQUAL( boolStream.marshalledSize(), bitStream.marshalledSize() );
+    bitStream.marshal( &bitDataOut );
+    boolStream.marshal( &boolDataOut );
+
+    std::pair<unsigned char*, int> bitArray = bitOut.toByteArray();
+    std::pair<unsigned char*, int> boolArray = boolOut.toByteArray();
+    CPPUNIT_ASSERT_EQUAL( boolArray.second, bitArray.second );
+    for( int i = 0; i < bitArray.second; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( (int)boolArray.first[i], (int)bitArray.first[i] );
+    }
+
+    BooleanStream readStream;
+    decaf::io::ByteArrayInputStream baiStream( bitArray.first, bitArray.second );
+    io::DataInputStream daiStream( &baiStream );
+    readStream.unmarshal( &daiStream );
+
+    for( int count = 0; count <= 32; ++count ) {
+        unsigned int expected = pattern ^ (unsigned int)count;
+        if( count < 32 ) {
+            expected &= ( 1u << count ) - 1;
+        }
+        CPPUNIT_ASSERT_EQUAL( expected, readStream.readBits( count ) );
+    }
+
+    CPPUNIT_ASSERT_THROW( readStream.readBits( 8 ), decaf::io::IOException );
+    CPPUNIT_ASSERT_THROW( readStream.readBits( 33 ), decaf::io::IOException );
+    CPPUNIT_ASSERT_THROW( readStream.writeBits( 0, -1 ), decaf::io::IOException );
+
+    delete [] bitArray.first;
+    delete [] boolArray.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BooleanStreamTest::testSkipBits() {
+
+    BooleanStream bs;
+
+    bs.writeBoolean( true );
+    bs.writeBits( 0x05, 3 );
+    bs.writeBits( 0x1FF, 9 );
+    bs.writeBoolean( true );
+
+    io::ByteArrayOutputStream baoStream;
+    io::DataOutputStream daoStream( &baoStream );
+    bs.marshal( &daoStream );
+
+    // The second marshal pass skips the runs the first one wrote.
+    CPPUNIT_ASSERT( bs.readBoolean() == true );
+    bs.skipBits( 3 );
+    CPPUNIT_ASSERT_EQUAL( 0x1FFu, bs.readBits( 9 ) );
+    CPPUNIT_ASSERT( bs.readBoolean() == true );
+
+    CPPUNIT_ASSERT_THROW( bs.skipBits( 3 ), decaf::io::IOException );
+}
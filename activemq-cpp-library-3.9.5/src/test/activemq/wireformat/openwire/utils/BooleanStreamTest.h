@@ -31,6 +31,9 @@ namespace utils{
         CPPUNIT_TEST_SUITE( BooleanStreamTest );
         CPPUNIT_TEST( test );
         CPPUNIT_TEST( test2 );
+        CPPUNIT_TEST( testRecordedLengths );
+        CPPUNIT_TEST( testBits );
+        CPPUNIT_TEST( testSkipBits );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +43,9 @@ namespace utils{
 
         void test();
         void test2();
+        void testRecordedLengths();
+        void testBits();
+        void testSkipBits();
     };
 
 }}}}
@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameBufferPoolTest.h"
+
+#include <activemq/wireformat/openwire/utils/FrameBufferPool.h>
+
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameBufferPoolTest::testAcquireRelease() {
+
+    FrameBufferPool pool(2, 1024);
+
+    std::vector<unsigned char>* buffer = pool.acquire(100);
+    CPPUNIT_ASSERT(buffer != NULL);
+    CPPUNIT_ASSERT(buffer->size() >= 100);
+    CPPUNIT_ASSERT_EQUAL(1LL, pool.getAllocationCount());
+
+    pool.release(buffer);
+    CPPUNIT_ASSERT_EQUAL(1, pool.getPooledCount());
+
+    // The same buffer comes back and is grown as needed.
+    std::vector<unsigned char>* again = pool.acquire(200);
+    CPPUNIT_ASSERT(again == buffer);
+    CPPUNIT_ASSERT(again->size() >= 200);
+    CPPUNIT_ASSERT_EQUAL(1LL, pool.getAllocationCount());
+    CPPUNIT_ASSERT_EQUAL(0, pool.getPooledCount());
+
+    pool.release(again);
+    pool.release(NULL);
+    CPPUNIT_ASSERT_EQUAL(1, pool.getPooledCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameBufferPoolTest::testOversizedBufferNotRetained() {
+
+    FrameBufferPool pool(2, 1024);
+
+    pool.release(pool.acquire(4096));
+    CPPUNIT_ASSERT_EQUAL(0, pool.getPooledCount());
+
+    pool.release(pool.acquire(512));
+    CPPUNIT_ASSERT_EQUAL(1, pool.getPooledCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameBufferPoolTest::testPoolLimit() {
+
+    FrameBufferPool pool(2, 1024);
+
+    std::vector<unsigned char>* buffer1 = pool.acquire(10);
+    std::vector<unsigned char>* buffer2 = pool.acquire(10);
+    std::vector<unsigned char>* buffer3 = pool.acquire(10);
+    CPPUNIT_ASSERT_EQUAL(3LL, pool.getAllocationCount());
+
+    pool.release(buffer1);
+    pool.release(buffer2);
+    pool.release(buffer3);
+    CPPUNIT_ASSERT_EQUAL(2, pool.getPooledCount());
+}
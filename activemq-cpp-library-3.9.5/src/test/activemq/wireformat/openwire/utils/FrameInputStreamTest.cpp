@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameInputStreamTest.h"
+
+#include <activemq/wireformat/openwire/utils/FrameInputStream.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/EOFException.h>
+#include <decaf/util/Properties.h>
+
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameInputStreamTest::testReadPrimitives() {
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    dataOut.writeBoolean(true);
+    dataOut.writeByte((unsigned char) 0x7F);
+    dataOut.writeShort((short) -2);
+    dataOut.writeUnsignedShort(65535);
+    dataOut.writeInt(-123456);
+    dataOut.writeLong(0x0102030405060708LL);
+    dataOut.writeFloat(1.5f);
+    dataOut.writeDouble(-2.25);
+    dataOut.writeUTF("frame");
+    dataOut.write((const unsigned char*) "xyz", 3, 0, 3);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    FrameInputStream frameIn(array.first, array.second);
+
+    CPPUNIT_ASSERT_EQUAL(true, frameIn.readBoolean());
+    CPPUNIT_ASSERT_EQUAL((char) 0x7F, frameIn.readByte());
+    CPPUNIT_ASSERT_EQUAL((short) -2, frameIn.readShort());
+    CPPUNIT_ASSERT_EQUAL((unsigned short) 65535, frameIn.readUnsignedShort());
+    CPPUNIT_ASSERT_EQUAL(-123456, frameIn.readInt());
+    CPPUNIT_ASSERT_EQUAL(0x0102030405060708LL, frameIn.readLong());
+    CPPUNIT_ASSERT_EQUAL(1.5f, frameIn.readFloat());
+    CPPUNIT_ASSERT_EQUAL(-2.25, frameIn.readDouble());
+    CPPUNIT_ASSERT_EQUAL(std::string("frame"), frameIn.readUTF());
+
+    CPPUNIT_ASSERT_EQUAL(3, frameIn.getRemaining());
+    CPPUNIT_ASSERT_EQUAL(3, frameIn.available());
+
+    unsigned char tail[3];
+    frameIn.readFully(tail, 3);
+    CPPUNIT_ASSERT_EQUAL('x', (char) tail[0]);
+    CPPUNIT_ASSERT_EQUAL('z', (char) tail[2]);
+    CPPUNIT_ASSERT_EQUAL(array.second, frameIn.getPosition());
+    CPPUNIT_ASSERT_EQUAL(-1, frameIn.read());
+
+    delete [] array.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameInputStreamTest::testReadPastEndOfFrame() {
+
+    unsigned char data[] = { 0, 0, 0 };
+    FrameInputStream frameIn(data, 3);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException",
+        frameIn.readInt(),
+        decaf::io::EOFException);
+
+    // A failed read does not consume anything.
+    CPPUNIT_ASSERT_EQUAL(0, frameIn.getPosition());
+    CPPUNIT_ASSERT_EQUAL((short) 0, frameIn.readShort());
+
+    unsigned char buffer[4];
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an EOFException",
+        frameIn.readFully(buffer, 4),
+        decaf::io::EOFException);
+
+    CPPUNIT_ASSERT_EQUAL(1LL, frameIn.skipBytes(10));
+    CPPUNIT_ASSERT_EQUAL(0, frameIn.getRemaining());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameInputStreamTest::testSetFrame() {
+
+    unsigned char first[] = { 1, 2 };
+    unsigned char second[] = { 3 };
+
+    FrameInputStream frameIn;
+    CPPUNIT_ASSERT_EQUAL(0, frameIn.getRemaining());
+
+    frameIn.setFrame(first, 2);
+    CPPUNIT_ASSERT_EQUAL((char) 1, frameIn.readByte());
+
+    frameIn.setFrame(second, 1);
+    CPPUNIT_ASSERT_EQUAL(0, frameIn.getPosition());
+    CPPUNIT_ASSERT_EQUAL((char) 3, frameIn.readByte());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        frameIn.setFrame(first, -1),
+        decaf::lang::exceptions::IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameInputStreamTest::testUnmarshalFromFrame() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    IOTransport transport;
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setText("Hello World");
+    message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+    wireFormat.marshal(message, &transport, &dataOut);
+    wireFormat.marshal(message, &transport, &dataOut);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+
+    // Read through a plain stream, frames are copied into pooled buffers.
+    ByteArrayInputStream bytesIn(array.first, array.second);
+    DataInputStream dataIn(&bytesIn);
+
+    for (int i = 0; i < 2; ++i) {
+        Pointer<ActiveMQTextMessage> result =
+            wireFormat.unmarshal(NULL, &dataIn).dynamicCast<ActiveMQTextMessage>();
+        CPPUNIT_ASSERT_EQUAL(std::string("Hello World"), result->getText());
+        CPPUNIT_ASSERT_EQUAL(std::string("TEST.QUEUE"), result->getDestination()->getPhysicalName());
+    }
+
+    // Decoded in place when the caller already holds the frame.
+    FrameInputStream frameIn(array.first, array.second / 2);
+    Pointer<ActiveMQTextMessage> result =
+        wireFormat.unmarshal(NULL, &frameIn).dynamicCast<ActiveMQTextMessage>();
+    CPPUNIT_ASSERT_EQUAL(std::string("Hello World"), result->getText());
+    CPPUNIT_ASSERT_EQUAL(0, frameIn.getRemaining());
+
+    delete [] array.first;
+}
@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SocketPollerTest.h"
+
+#include <decaf/internal/net/SocketPoller.h>
+#include <decaf/net/Socket.h>
+#include <decaf/net/ServerSocket.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/System.h>
+
+#include <memory>
+#include <vector>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::net;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+SocketPollerTest::SocketPollerTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SocketPollerTest::~SocketPollerTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SocketPollerTest::testPollReadable() {
+
+    ServerSocket server(0);
+    Socket client("localhost", server.getLocalPort());
+    std::auto_ptr<Socket> worker(server.accept());
+
+    SocketPoller poller(4);
+    std::vector<void*> ready;
+    int attachment = 42;
+
+    poller.add(client.getFileDescriptor(), &attachment);
+    CPPUNIT_ASSERT_EQUAL(1, poller.size());
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Socket should not be readable yet", 0, poller.poll(100, ready));
+
+    worker->getOutputStream()->write('a');
+
+    CPPUNIT_ASSERT_EQUAL(1, poller.poll(2000, ready));
+    CPPUNIT_ASSERT_EQUAL((void*) &attachment, ready.front());
+
+    CPPUNIT_ASSERT_EQUAL('a', (char) client.getInputStream()->read());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Socket should not be readable once drained", 0, poller.poll(100, ready));
+
+    worker->close();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("End of stream should be reported as readable", 1, poller.poll(2000, ready));
+
+    poller.remove(client.getFileDescriptor());
+    client.close();
+    server.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SocketPollerTest::testRemove() {
+
+    ServerSocket server(0);
+    Socket client("localhost", server.getLocalPort());
+    std::auto_ptr<Socket> worker(server.accept());
+
+    SocketPoller poller(4);
+    std::vector<void*> ready;
+    int attachment = 42;
+
+    poller.add(client.getFileDescriptor(), &attachment);
+    poller.remove(client.getFileDescriptor());
+    CPPUNIT_ASSERT_EQUAL(0, poller.size());
+
+    // Removing twice is allowed.
+    poller.remove(client.getFileDescriptor());
+
+    worker->getOutputStream()->write('a');
+    CPPUNIT_ASSERT_EQUAL(0, poller.poll(100, ready));
+
+    // Can be added again after removal.
+    poller.add(client.getFileDescriptor(), &attachment);
+    CPPUNIT_ASSERT_EQUAL(1, poller.poll(2000, ready));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when added twice",
+        poller.add(client.getFileDescriptor(), &attachment),
+        decaf::io::IOException);
+
+    client.close();
+    worker->close();
+    server.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class PollingThread : public Thread {
+    private:
+
+        SocketPoller* poller;
+
+    public:
+
+        long long elapsed;
+
+        PollingThread(SocketPoller* poller) : Thread(), poller(poller), elapsed(0) {}
+
+        virtual ~PollingThread() {}
+
+        virtual void run() {
+            std::vector<void*> ready;
+            long long start = System::currentTimeMillis();
+            poller->poll(-1, ready);
+            elapsed = System::currentTimeMillis() - start;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SocketPollerTest::testWakeup() {
+
+    SocketPoller poller(4);
+    PollingThread thread(&poller);
+
+    thread.start();
+    Thread::sleep(100);
+    poller.wakeup();
+    thread.join(5000);
+
+    CPPUNIT_ASSERT_MESSAGE("Poll should have returned after wakeup", !thread.isAlive());
+    CPPUNIT_ASSERT(thread.elapsed < 5000);
+}
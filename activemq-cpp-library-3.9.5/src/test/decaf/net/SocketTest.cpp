@@ -23,6 +23,7 @@
 #include <decaf/net/SocketFactory.h>
 
 #include <decaf/net/ServerSocket.h>
+#include <decaf/internal/net/tcp/TcpSocketInputStream.h>
 #include <decaf/util/concurrent/Concurrent.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/lang/Thread.h>
@@ -213,6 +214,35 @@ void SocketTest::testGetTcpNoDelay() {
                                   false, client.getTcpNoDelay() );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SocketTest::testTcpTuningOptions() {
+
+    ServerSocket server(0);
+    Socket client( "localhost", server.getLocalPort() );
+    std::auto_ptr<Socket> worker( server.accept() );
+
+    // These are hints that are ignored where the platform lacks them, so only
+    // check that they are accepted and read back sensibly.
+    client.setTcpQuickAck( true );
+    client.setTcpNotSentLowWatermark( 16384 );
+
+    CPPUNIT_ASSERT( client.getTcpNotSentLowWatermark() >= 0 );
+    CPPUNIT_ASSERT( client.getRoundTripTime() >= 0 );
+
+    client.setTcpQuickAck( false );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Returned incorrect TCP_QUICKACK value, should be false",
+                                  false, client.getTcpQuickAck() );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        client.setTcpNotSentLowWatermark( -1 ),
+        IllegalArgumentException );
+
+    client.close();
+    worker->close();
+    server.close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void SocketTest::testIsConnected() {
 
@@ -294,6 +324,56 @@ void SocketTest::testIsInputShutdown() {
     theOutput->close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SocketTest::testReadAvailable() {
+
+    ServerSocket server(0);
+    Socket client("localhost", server.getLocalPort());
+
+    std::auto_ptr<Socket> worker(server.accept());
+
+    decaf::internal::net::tcp::TcpSocketInputStream* input =
+        dynamic_cast<decaf::internal::net::tcp::TcpSocketInputStream*>(client.getInputStream());
+    CPPUNIT_ASSERT(input != NULL);
+
+    unsigned char buffer[16];
+
+    // Nothing has been sent so this has to come straight back empty handed.
+    CPPUNIT_ASSERT_EQUAL(0, input->readAvailable(buffer, 16, 0, 16));
+
+    const unsigned char data[] = { 1, 2, 3 };
+    worker->getOutputStream()->write(data, 3);
+    worker->getOutputStream()->flush();
+
+    int total = 0;
+    for (int i = 0; i < 100 && total < 3; ++i) {
+        int count = input->readAvailable(buffer, 16, total, 16 - total);
+        CPPUNIT_ASSERT(count >= 0);
+        if (count == 0) {
+            Thread::sleep(10);
+        }
+        total += count;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(3, total);
+    CPPUNIT_ASSERT_EQUAL(3, (int) buffer[2]);
+
+    worker->close();
+
+    int result = 0;
+    for (int i = 0; i < 100 && result == 0; ++i) {
+        result = input->readAvailable(buffer, 16, 0, 16);
+        if (result == 0) {
+            Thread::sleep(10);
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(-1, result);
+
+    client.close();
+    server.close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void SocketTest::testIsOutputShutdown() {
 
@@ -39,10 +39,12 @@ namespace net{
         CPPUNIT_TEST( testGetSoLinger );
         CPPUNIT_TEST( testGetSoTimeout );
         CPPUNIT_TEST( testGetTcpNoDelay );
+        CPPUNIT_TEST( testTcpTuningOptions );
         CPPUNIT_TEST( testIsConnected );
         CPPUNIT_TEST( testIsClosed );
         CPPUNIT_TEST( testIsInputShutdown );
         CPPUNIT_TEST( testIsOutputShutdown );
+        CPPUNIT_TEST( testReadAvailable );
         CPPUNIT_TEST( testConnectPortOutOfRange );
 
         CPPUNIT_TEST( testTx );
@@ -67,10 +69,12 @@ namespace net{
         void testGetSoLinger();
         void testGetSoTimeout();
         void testGetTcpNoDelay();
+        void testTcpTuningOptions();
         void testIsConnected();
         void testIsClosed();
         void testIsInputShutdown();
         void testIsOutputShutdown();
+        void testReadAvailable();
         void testConnectPortOutOfRange();
 
         // Old Tests
@@ -19,11 +19,28 @@
 // enable them easily in one place.
 
 
+#include <activemq/commands/DataStructurePoolTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::DataStructurePoolTest );
+#include <activemq/commands/ProducerIdTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::ProducerIdTest );
+
+#include <activemq/core/PreparedMessageTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::PreparedMessageTest );
+
+#include <activemq/io/ByteVectorOutputStreamTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::io::ByteVectorOutputStreamTest );
+#include <activemq/io/GatheringOutputStreamTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::io::GatheringOutputStreamTest );
+
 #include <activemq/transport/failover/FailoverTransportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::failover::FailoverTransportTest );
+#include <activemq/transport/failover/URIHealthTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::failover::URIHealthTest );
 
 #include <activemq/transport/tcp/TcpTransportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::tcp::TcpTransportTest );
+#include <activemq/transport/tcp/ReactorIOTransportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::tcp::ReactorIOTransportTest );
 
 #include <activemq/transport/correlator/ResponseCorrelatorTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::correlator::ResponseCorrelatorTest );
@@ -31,14 +48,24 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::correlator::ResponseCorrel
 #include <activemq/transport/mock/MockTransportFactoryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::mock::MockTransportFactoryTest );
 
+#include <activemq/transport/shared/SharedTransportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::shared::SharedTransportTest );
+#include <activemq/transport/vm/VMTransportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::vm::VMTransportTest );
+
 #include <activemq/transport/inactivity/InactivityMonitorTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::inactivity::InactivityMonitorTest );
+#include <activemq/transport/inactivity/RoundTripHistogramTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::inactivity::RoundTripHistogramTest );
 
 #include <activemq/transport/TransportRegistryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::TransportRegistryTest );
 #include <activemq/transport/IOTransportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::IOTransportTest );
 
+#include <activemq/state/MessageCacheTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::state::MessageCacheTest );
+
 #include <activemq/exceptions/ActiveMQExceptionTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::exceptions::ActiveMQExceptionTest );
 
@@ -104,6 +131,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::nio::ShortArrayBufferTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::URIEncoderDecoderTest );
 #include <decaf/internal/net/URIHelperTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::URIHelperTest );
+#include <decaf/internal/net/SocketPollerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::SocketPollerTest );
 
 #include <decaf/nio/BufferTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::nio::BufferTest );
@@ -322,6 +351,17 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::security::MessageDigestTest );
 // Marshaler Tests
 //
 
+#include <activemq/wireformat/openwire/OpenWireFrameDecoderTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::OpenWireFrameDecoderTest );
+#include <activemq/wireformat/openwire/utils/FrameBufferPoolTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::FrameBufferPoolTest );
+#include <activemq/wireformat/openwire/utils/FrameInputStreamTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::FrameInputStreamTest );
+#include <activemq/wireformat/openwire/marshal/VersionedMarshallerFactoryTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::marshal::VersionedMarshallerFactoryTest );
+#include <activemq/wireformat/openwire/marshal/PreparedMessageMarshallerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::marshal::PreparedMessageMarshallerTest );
+
 #include <activemq/wireformat/openwire/marshal/generated/ActiveMQBlobMessageMarshallerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::marshal::generated::ActiveMQBlobMessageMarshallerTest );
 #include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshallerTest.h>